@@ -0,0 +1,22 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# cxxrt middleware routes C++ operator new/delete, exceptions and static guards
+# to a static pool instead of newlib malloc, see README.md in this directory
+MIDDLEWARE_CXXRT := $(NUCLEI_SDK_MIDDLEWARE)/cxxrt
+
+C_SRCDIRS += $(MIDDLEWARE_CXXRT)
+CXX_SRCDIRS += $(MIDDLEWARE_CXXRT)
+
+INCDIRS += $(MIDDLEWARE_CXXRT)
+
+# Pool of operator new, tlsf or block
+CXXRT_POOL ?= tlsf
+ifeq ($(CXXRT_POOL),block)
+COMMON_FLAGS += -DCXXRT_POOL_BLOCK
+else
+COMMON_FLAGS += -DCXXRT_POOL_TLSF
+endif
+
+# TLSF pool size in bytes
+ifneq ($(CXXRT_POOL_SIZE),)
+COMMON_FLAGS += -DCXXRT_POOL_SIZE=$(CXXRT_POOL_SIZE)
+endif
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * C++ ABI functions replacing the ones of libsupc++:
+ *
+ * - __cxa_guard_* guard the initialization of function local statics
+ * - __cxa_allocate_exception and friends allocate thrown exceptions from
+ *   the cxxrt pool, and from emergency buffers when the pool is exhausted,
+ *   so the malloc based emergency pool of libstdc++ is not linked
+ */
+#include <cstring>
+#include <exception>
+#include <cxxabi.h>
+#include "nuclei_sdk_soc.h"
+#include "cxxrt_api.h"
+
+/*
+ * Guard layout, the 64 bit guard object is zero initialized:
+ * - byte 0 is set when the static is initialized, the compiler inlines an
+ *   acquire load of it before calling __cxa_guard_acquire, so initialized
+ *   statics never get here
+ * - word 1 is set while one hart or task is running the initializer
+ */
+#define GUARD_DONE(g)           ((volatile uint8_t *)(g))
+#define GUARD_BUSY(g)           ((volatile uint32_t *)(g) + 1)
+
+/* Claim busy word, return its old value, 0 when claimed */
+static uint32_t guard_claim(volatile uint32_t *busy)
+{
+#if defined(__riscv_atomic)
+    return __CAS_W(busy, 0, 1);
+#else
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    uint32_t old = *busy;
+
+    *busy = 1;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return old;
+#endif
+}
+
+namespace __cxxabiv1 {
+
+extern "C" int __cxa_guard_acquire(__guard *g)
+{
+    while (*GUARD_DONE(g) == 0) {
+        if (guard_claim(GUARD_BUSY(g)) == 0) {
+            __SMP_RWMB();
+            /* initialized by another hart between the check and the claim */
+            if (*GUARD_DONE(g) != 0) {
+                *GUARD_BUSY(g) = 0;
+                return 0;
+            }
+            return 1;
+        }
+        cxxrt_guard_wait();
+    }
+    __SMP_RWMB();
+    return 0;
+}
+
+extern "C" void __cxa_guard_release(__guard *g) _GLIBCXX_NOTHROW
+{
+    /* publish the initialized static before done byte, and done byte before busy word */
+    __SMP_RWMB();
+    *GUARD_DONE(g) = 1;
+    __SMP_RWMB();
+    *GUARD_BUSY(g) = 0;
+}
+
+extern "C" void __cxa_guard_abort(__guard *g) _GLIBCXX_NOTHROW
+{
+    __SMP_RWMB();
+    *GUARD_BUSY(g) = 0;
+}
+
+} // namespace __cxxabiv1
+
+#if CXXRT_EH_BUF_NUM > 32
+#error "CXXRT_EH_BUF_NUM must be no more than 32"
+#endif
+
+#define EH_BUF_BYTES            (CXXRT_EH_HEADER_SIZE + CXXRT_EH_BUF_SIZE)
+
+static uint8_t eh_bufs[CXXRT_EH_BUF_NUM][EH_BUF_BYTES] __attribute__((aligned(CXXRT_ALIGN)));
+/* bit n set when eh_bufs[n] is in use */
+static volatile uint32_t eh_buf_map;
+
+static void *eh_buf_get(std::size_t size)
+{
+    uint32_t map, bit;
+
+    if (size > EH_BUF_BYTES) {
+        return nullptr;
+    }
+    while ((map = eh_buf_map) != (uint32_t)((1ULL << CXXRT_EH_BUF_NUM) - 1)) {
+        bit = __builtin_ctz(~map);
+#if defined(__riscv_atomic)
+        if (__CAS_W(&eh_buf_map, map, map | (1UL << bit)) != map) {
+            continue;
+        }
+#else
+        rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+        if (eh_buf_map != map) {
+            __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+            continue;
+        }
+        eh_buf_map = map | (1UL << bit);
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+#endif
+        cxxrt_stat_emergency();
+        return eh_bufs[bit];
+    }
+    return nullptr;
+}
+
+static void eh_buf_put(void *buf)
+{
+    uint32_t bit = ((uint8_t *)buf - &eh_bufs[0][0]) / EH_BUF_BYTES;
+
+#if defined(__riscv_atomic)
+    __AMOAND_W((volatile int32_t *)&eh_buf_map, ~(1UL << bit));
+#else
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    eh_buf_map &= ~(1UL << bit);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+#endif
+}
+
+static void *eh_alloc(std::size_t size)
+{
+    void *buf = cxxrt_malloc(size);
+
+    if (buf == nullptr) {
+        buf = eh_buf_get(size);
+    }
+    if (buf == nullptr) {
+        std::terminate();
+    }
+    return buf;
+}
+
+static void eh_free(void *buf)
+{
+    if (((uint8_t *)buf >= &eh_bufs[0][0]) && ((uint8_t *)buf < &eh_bufs[0][0] + sizeof(eh_bufs))) {
+        eh_buf_put(buf);
+    } else {
+        cxxrt_free(buf);
+    }
+}
+
+namespace __cxxabiv1 {
+
+/* The exception header of libstdc++ is placed just before the returned thrown object */
+extern "C" void *__cxa_allocate_exception(std::size_t thrown_size) _GLIBCXX_NOTHROW
+{
+    uint8_t *buf = (uint8_t *)eh_alloc(thrown_size + CXXRT_EH_HEADER_SIZE);
+
+    memset(buf, 0, CXXRT_EH_HEADER_SIZE);
+    return buf + CXXRT_EH_HEADER_SIZE;
+}
+
+extern "C" void __cxa_free_exception(void *vptr) _GLIBCXX_NOTHROW
+{
+    eh_free((uint8_t *)vptr - CXXRT_EH_HEADER_SIZE);
+}
+
+extern "C" __cxa_dependent_exception *__cxa_allocate_dependent_exception() _GLIBCXX_NOTHROW
+{
+    void *buf = eh_alloc(CXXRT_EH_HEADER_SIZE);
+
+    memset(buf, 0, CXXRT_EH_HEADER_SIZE);
+    return (__cxa_dependent_exception *)buf;
+}
+
+extern "C" void __cxa_free_dependent_exception(__cxa_dependent_exception *vptr) _GLIBCXX_NOTHROW
+{
+    eh_free(vptr);
+}
+
+} // namespace __cxxabiv1
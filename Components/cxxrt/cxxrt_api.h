@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _CXXRT_API_H_
+#define _CXXRT_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Allocation-free C++ runtime support
+ *
+ * Without this middleware, operator new, thrown exceptions and the emergency
+ * exception pool of libstdc++ are all allocated by newlib malloc from the
+ * heap grown by _sbrk, whose latency depends on the heap history.
+ *
+ * With it, operator new/delete are served by a static pool with bounded
+ * latency, either a fixed block pool or a TLSF pool, thrown exceptions are
+ * allocated from the same pool and fall back to preallocated emergency
+ * buffers, and function local statics are guarded by a hart-safe guard
+ * which only checks one byte once initialized, see README.md.
+ *
+ * The pool is initialized on first allocation, so global constructors run
+ * by __libc_init_array may already use operator new.
+ */
+
+/* Select pool by CXXRT_POOL=tlsf or CXXRT_POOL=block in Makefile, default is tlsf */
+#if !defined(CXXRT_POOL_TLSF) && !defined(CXXRT_POOL_BLOCK)
+#define CXXRT_POOL_TLSF
+#endif
+
+/* Alignment of all allocations, same as __STDCPP_DEFAULT_NEW_ALIGNMENT__ of riscv */
+#define CXXRT_ALIGN                 16
+
+/* TLSF pool size in bytes, multiple of CXXRT_ALIGN and less than 16MB */
+#ifndef CXXRT_POOL_SIZE
+#define CXXRT_POOL_SIZE             16384
+#endif
+
+/*
+ * Fixed block classes as X(block size, block count), block sizes must be
+ * multiples of CXXRT_ALIGN in ascending order, a request is served by the
+ * smallest class with a free block which is large enough
+ */
+#ifndef CXXRT_BLOCK_CLASSES
+#define CXXRT_BLOCK_CLASSES(X)      X(16, 64) X(32, 64) X(64, 32) X(128, 16) X(256, 8) X(512, 4)
+#endif
+
+/*
+ * Emergency exception buffers used when the pool is exhausted, each buffer
+ * holds a thrown object up to CXXRT_EH_BUF_SIZE bytes, at most 32 buffers
+ */
+#ifndef CXXRT_EH_BUF_NUM
+#define CXXRT_EH_BUF_NUM            4
+#endif
+#ifndef CXXRT_EH_BUF_SIZE
+#define CXXRT_EH_BUF_SIZE           256
+#endif
+
+/*
+ * Bytes reserved before a thrown object for the exception header of libstdc++,
+ * must be no less than sizeof(__cxa_refcounted_exception), which is 96 on rv32
+ * and 128 on rv64 for gcc, multiple of CXXRT_ALIGN, it is also the size of
+ * dependent exceptions allocated by std::rethrow_exception
+ */
+#ifndef CXXRT_EH_HEADER_SIZE
+#define CXXRT_EH_HEADER_SIZE        160
+#endif
+
+/* Pool statistics, sizes include block overhead */
+typedef struct cxxrt_stat {
+    uint32_t allocs;            /* successful allocations */
+    uint32_t frees;             /* frees of pool memory */
+    uint32_t fails;             /* allocations failed */
+    uint32_t size;              /* total pool size */
+    uint32_t used;              /* bytes in use */
+    uint32_t peak;              /* max bytes in use */
+    uint32_t eh_emergency;      /* exceptions allocated from emergency buffers */
+} cxxrt_stat_t;
+
+/*
+ * Allocate size bytes aligned to CXXRT_ALIGN from the pool, NULL when exhausted,
+ * safe to be called from multiple harts and interrupts
+ */
+void *cxxrt_malloc(size_t size);
+/* Free memory allocated by cxxrt_malloc, NULL is ignored */
+void cxxrt_free(void *ptr);
+/* Return 1 if ptr is inside the pool */
+int32_t cxxrt_owns(const void *ptr);
+/* Get pool statistics */
+void cxxrt_get_stat(cxxrt_stat_t *stat);
+/* Clear counters of pool statistics, used and size are kept */
+void cxxrt_clear_stat(void);
+/* Print pool type and statistics */
+void cxxrt_dump_stat(void);
+
+/*
+ * Called by operator new when the pool is exhausted, before throwing
+ * std::bad_alloc or aborting, weak and empty by default
+ */
+void cxxrt_alloc_failed(size_t size);
+/*
+ * Called in the wait loop of a guard whose static is being initialized by
+ * another hart or task, weak and relaxing the hart by default, in RTOS
+ * override it to yield, otherwise a higher priority task spins forever
+ * on a guard held by a preempted task of the same hart
+ */
+void cxxrt_guard_wait(void);
+
+/* Internal, count one exception allocated from emergency buffers */
+void cxxrt_stat_emergency(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_CXXRT_API_H_ */
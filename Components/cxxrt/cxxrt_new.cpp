@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * Replaceable global operator new and delete served by the cxxrt pool,
+ * they replace the ones of libstdc++ which call malloc.
+ *
+ * std::new_handler is not called, the pool is static and a handler can't
+ * make more memory available, cxxrt_alloc_failed is called instead.
+ */
+#include <new>
+#include <cstdlib>
+#include "cxxrt_api.h"
+
+[[noreturn]] static void cxxrt_new_failed(std::size_t size)
+{
+    cxxrt_alloc_failed(size);
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    abort();
+#endif
+}
+
+static void *cxxrt_new(std::size_t size)
+{
+    void *ptr = cxxrt_malloc(size);
+
+    if (ptr == nullptr) {
+        cxxrt_new_failed(size);
+    }
+    return ptr;
+}
+
+static void *cxxrt_new_nothrow(std::size_t size)
+{
+    void *ptr = cxxrt_malloc(size);
+
+    if (ptr == nullptr) {
+        cxxrt_alloc_failed(size);
+    }
+    return ptr;
+}
+
+void *operator new(std::size_t size)
+{
+    return cxxrt_new(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return cxxrt_new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return cxxrt_new_nothrow(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return cxxrt_new_nothrow(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+#if defined(__cpp_aligned_new)
+/*
+ * Over-aligned types, the pool only provides CXXRT_ALIGN alignment,
+ * a larger alignment fails like an exhausted pool
+ */
+void *operator new(std::size_t size, std::align_val_t align)
+{
+    if (static_cast<std::size_t>(align) > CXXRT_ALIGN) {
+        cxxrt_new_failed(size);
+    }
+    return cxxrt_new(size);
+}
+
+void *operator new[](std::size_t size, std::align_val_t align)
+{
+    return operator new(size, align);
+}
+
+void *operator new(std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    if (static_cast<std::size_t>(align) > CXXRT_ALIGN) {
+        cxxrt_alloc_failed(size);
+        return nullptr;
+    }
+    return cxxrt_new_nothrow(size);
+}
+
+void *operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t &nt) noexcept
+{
+    return operator new(size, align, nt);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    cxxrt_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    cxxrt_free(ptr);
+}
+#endif
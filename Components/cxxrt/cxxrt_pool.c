@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "cxxrt_api.h"
+
+static cxxrt_stat_t cxxrt_stat;
+static uint32_t pool_ready = 0;
+
+/*
+ * Pool lock, interrupts of the calling hart are disabled while the pool is
+ * changed, and harts are serialized by a ticket lock when atomic is present
+ */
+#if defined(__riscv_atomic)
+static SMP_TicketLock_Type pool_lock;
+#endif
+
+__STATIC_FORCEINLINE rv_csr_t pool_lock_acquire(void)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+#if defined(__riscv_atomic)
+    SMP_TicketLock_Acquire(&pool_lock);
+#endif
+    return mstatus;
+}
+
+__STATIC_FORCEINLINE void pool_lock_release(rv_csr_t mstatus)
+{
+#if defined(__riscv_atomic)
+    SMP_TicketLock_Release(&pool_lock);
+#endif
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+#if defined(CXXRT_POOL_TLSF)
+/*
+ * Two level segregated fit pool, free blocks are kept in lists indexed by
+ * the first level of power of two and TLSF_SL_COUNT second level ranges,
+ * with bitmaps of non-empty lists, so searching a fit block, splitting it
+ * and merging a freed block with its neighbors are all O(1).
+ */
+#if (CXXRT_POOL_SIZE % CXXRT_ALIGN) != 0 || CXXRT_POOL_SIZE >= (1 << 24)
+#error "CXXRT_POOL_SIZE must be multiple of CXXRT_ALIGN and less than 16MB"
+#endif
+
+#define TLSF_SL_LOG2        3
+#define TLSF_SL_COUNT       (1 << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT       7   /* log2 of TLSF_SMALL */
+#define TLSF_SMALL          (1 << TLSF_FL_SHIFT)
+#define TLSF_FL_COUNT       (24 - TLSF_FL_SHIFT + 1)
+#define TLSF_FREE           0x1UL
+
+/* block header, payload follows it and is CXXRT_ALIGN aligned */
+typedef struct tlsf_block {
+    size_t size;                    /* block size with header, TLSF_FREE set when free */
+    struct tlsf_block *prev_phys;   /* previous block in memory, NULL for the first one */
+} __attribute__((aligned(CXXRT_ALIGN))) tlsf_block_t;
+
+/* free list links stored in the payload of free blocks */
+typedef struct tlsf_link {
+    tlsf_block_t *next;
+    tlsf_block_t *prev;
+} tlsf_link_t;
+
+#define TLSF_HDR            sizeof(tlsf_block_t)
+#define TLSF_MIN_BLOCK      (TLSF_HDR + CXXRT_ALIGN)
+#define TLSF_LINK(b)        ((tlsf_link_t *)((uint8_t *)(b) + TLSF_HDR))
+#define TLSF_SIZE(b)        ((b)->size & ~TLSF_FREE)
+#define TLSF_NEXT(b)        ((tlsf_block_t *)((uint8_t *)(b) + TLSF_SIZE(b)))
+
+static uint8_t tlsf_pool[CXXRT_POOL_SIZE] __attribute__((aligned(CXXRT_ALIGN)));
+static uint32_t tlsf_fl_map;
+static uint32_t tlsf_sl_map[TLSF_FL_COUNT];
+static tlsf_block_t *tlsf_heads[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+__STATIC_FORCEINLINE uint32_t tlsf_fls(size_t size)
+{
+    return 31 - __builtin_clz((uint32_t)size);
+}
+
+static void tlsf_mapping(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    uint32_t bit;
+
+    if (size < TLSF_SMALL) {
+        *fl = 0;
+        *sl = size / (TLSF_SMALL / TLSF_SL_COUNT);
+    } else {
+        bit = tlsf_fls(size);
+        *sl = (size >> (bit - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = bit - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+static void tlsf_insert(tlsf_block_t *block)
+{
+    uint32_t fl, sl;
+    tlsf_block_t *head;
+
+    tlsf_mapping(TLSF_SIZE(block), &fl, &sl);
+    head = tlsf_heads[fl][sl];
+    TLSF_LINK(block)->next = head;
+    TLSF_LINK(block)->prev = NULL;
+    if (head != NULL) {
+        TLSF_LINK(head)->prev = block;
+    }
+    tlsf_heads[fl][sl] = block;
+    tlsf_fl_map |= (1UL << fl);
+    tlsf_sl_map[fl] |= (1UL << sl);
+}
+
+static void tlsf_remove(tlsf_block_t *block)
+{
+    uint32_t fl, sl;
+    tlsf_block_t *next = TLSF_LINK(block)->next;
+    tlsf_block_t *prev = TLSF_LINK(block)->prev;
+
+    tlsf_mapping(TLSF_SIZE(block), &fl, &sl);
+    if (next != NULL) {
+        TLSF_LINK(next)->prev = prev;
+    }
+    if (prev != NULL) {
+        TLSF_LINK(prev)->next = next;
+    } else {
+        tlsf_heads[fl][sl] = next;
+        if (next == NULL) {
+            tlsf_sl_map[fl] &= ~(1UL << sl);
+            if (tlsf_sl_map[fl] == 0) {
+                tlsf_fl_map &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+static void pool_init(void)
+{
+    tlsf_block_t *block = (tlsf_block_t *)tlsf_pool;
+    tlsf_block_t *sentinel;
+
+    /* one free block, and a used sentinel of header size at the end */
+    block->size = (CXXRT_POOL_SIZE - TLSF_HDR) | TLSF_FREE;
+    block->prev_phys = NULL;
+    sentinel = TLSF_NEXT(block);
+    sentinel->size = 0;
+    sentinel->prev_phys = block;
+    tlsf_insert(block);
+    cxxrt_stat.size = CXXRT_POOL_SIZE;
+}
+
+static void *pool_alloc(size_t size)
+{
+    uint32_t fl, sl, map;
+    size_t need, rest;
+    tlsf_block_t *block, *remain;
+
+    if (size > CXXRT_POOL_SIZE) {
+        return NULL;
+    }
+    need = ((size + CXXRT_ALIGN - 1) & ~(size_t)(CXXRT_ALIGN - 1)) + TLSF_HDR;
+    need = (need < TLSF_MIN_BLOCK) ? TLSF_MIN_BLOCK : need;
+    /* round up to the next list, any block in it or above fits */
+    rest = need;
+    if (rest >= TLSF_SMALL) {
+        rest += (1UL << (tlsf_fls(rest) - TLSF_SL_LOG2)) - 1;
+    }
+    tlsf_mapping(rest, &fl, &sl);
+    if (fl >= TLSF_FL_COUNT) {
+        return NULL;
+    }
+    map = tlsf_sl_map[fl] & (~0UL << sl);
+    if (map == 0) {
+        map = (fl + 1 < TLSF_FL_COUNT) ? (tlsf_fl_map & (~0UL << (fl + 1))) : 0;
+        if (map == 0) {
+            return NULL;
+        }
+        fl = __builtin_ctz(map);
+        map = tlsf_sl_map[fl];
+    }
+    sl = __builtin_ctz(map);
+    block = tlsf_heads[fl][sl];
+    tlsf_remove(block);
+
+    rest = TLSF_SIZE(block) - need;
+    if (rest >= TLSF_MIN_BLOCK) {
+        remain = (tlsf_block_t *)((uint8_t *)block + need);
+        remain->size = rest | TLSF_FREE;
+        remain->prev_phys = block;
+        TLSF_NEXT(remain)->prev_phys = remain;
+        tlsf_insert(remain);
+        block->size = need;
+    } else {
+        block->size = TLSF_SIZE(block);
+    }
+    cxxrt_stat.used += block->size;
+    return (uint8_t *)block + TLSF_HDR;
+}
+
+static void pool_free(void *ptr)
+{
+    tlsf_block_t *block = (tlsf_block_t *)((uint8_t *)ptr - TLSF_HDR);
+    tlsf_block_t *near;
+
+    cxxrt_stat.used -= block->size;
+    near = block->prev_phys;
+    if ((near != NULL) && (near->size & TLSF_FREE)) {
+        tlsf_remove(near);
+        near->size += block->size;
+        block = near;
+    }
+    near = TLSF_NEXT(block);
+    if (near->size & TLSF_FREE) {
+        tlsf_remove(near);
+        block->size += TLSF_SIZE(near);
+    }
+    block->size |= TLSF_FREE;
+    TLSF_NEXT(block)->prev_phys = block;
+    tlsf_insert(block);
+}
+
+int32_t cxxrt_owns(const void *ptr)
+{
+    return ((const uint8_t *)ptr >= tlsf_pool) && ((const uint8_t *)ptr < tlsf_pool + CXXRT_POOL_SIZE);
+}
+
+static void pool_dump(void)
+{
+    printf("cxxrt tlsf pool, %lu bytes\n", (unsigned long)CXXRT_POOL_SIZE);
+}
+
+#else /* CXXRT_POOL_BLOCK */
+/*
+ * Fixed block pool, each class is an array of equal blocks with a singly
+ * linked free list, a request takes the first free block of the smallest
+ * fit class, and a freed block finds its class by address range.
+ */
+typedef struct block_class {
+    uint32_t size;
+    uint32_t count;
+    uint8_t *mem;
+    void *free;                 /* first free block, which holds the next one */
+    uint32_t used;              /* blocks in use */
+    uint32_t peak;              /* max blocks in use */
+} block_class_t;
+
+#define BLOCK_STORAGE(size, count)                                              \
+    static uint8_t block_mem_##size[(size) * (count)] __attribute__((aligned(CXXRT_ALIGN)));
+#define BLOCK_CLASS(size, count)    { (size), (count), block_mem_##size, NULL, 0, 0 },
+#define BLOCK_BYTES(size, count)    + (size) * (count)
+
+CXXRT_BLOCK_CLASSES(BLOCK_STORAGE)
+
+static block_class_t block_classes[] = {
+    CXXRT_BLOCK_CLASSES(BLOCK_CLASS)
+};
+
+#define BLOCK_CLASS_NUM     (sizeof(block_classes) / sizeof(block_classes[0]))
+#define BLOCK_POOL_SIZE     (0 CXXRT_BLOCK_CLASSES(BLOCK_BYTES))
+
+static void pool_init(void)
+{
+    block_class_t *cls;
+    uint8_t *blk;
+
+    for (cls = block_classes; cls < block_classes + BLOCK_CLASS_NUM; cls++) {
+        cls->free = NULL;
+        for (blk = cls->mem + cls->size * cls->count; blk > cls->mem; ) {
+            blk -= cls->size;
+            *(void **)blk = cls->free;
+            cls->free = blk;
+        }
+    }
+    cxxrt_stat.size = BLOCK_POOL_SIZE;
+}
+
+static void *pool_alloc(size_t size)
+{
+    block_class_t *cls;
+    void *blk;
+
+    for (cls = block_classes; cls < block_classes + BLOCK_CLASS_NUM; cls++) {
+        if ((cls->size >= size) && (cls->free != NULL)) {
+            blk = cls->free;
+            cls->free = *(void **)blk;
+            cls->used++;
+            cls->peak = (cls->used > cls->peak) ? cls->used : cls->peak;
+            cxxrt_stat.used += cls->size;
+            return blk;
+        }
+    }
+    return NULL;
+}
+
+static block_class_t *block_find(const void *ptr)
+{
+    block_class_t *cls;
+
+    for (cls = block_classes; cls < block_classes + BLOCK_CLASS_NUM; cls++) {
+        if (((const uint8_t *)ptr >= cls->mem) && ((const uint8_t *)ptr < cls->mem + cls->size * cls->count)) {
+            return cls;
+        }
+    }
+    return NULL;
+}
+
+static void pool_free(void *ptr)
+{
+    block_class_t *cls = block_find(ptr);
+
+    *(void **)ptr = cls->free;
+    cls->free = ptr;
+    cls->used--;
+    cxxrt_stat.used -= cls->size;
+}
+
+int32_t cxxrt_owns(const void *ptr)
+{
+    return block_find(ptr) != NULL;
+}
+
+static void pool_dump(void)
+{
+    block_class_t *cls;
+
+    printf("cxxrt block pool, %lu bytes\n", (unsigned long)BLOCK_POOL_SIZE);
+    for (cls = block_classes; cls < block_classes + BLOCK_CLASS_NUM; cls++) {
+        printf("  class %4lu: %lu blocks, used %lu, peak %lu\n", (unsigned long)cls->size,
+               (unsigned long)cls->count, (unsigned long)cls->used, (unsigned long)cls->peak);
+    }
+}
+#endif /* CXXRT_POOL_TLSF */
+
+void *cxxrt_malloc(size_t size)
+{
+    rv_csr_t mstatus = pool_lock_acquire();
+    void *ptr;
+
+    if (pool_ready == 0) {
+        pool_init();
+        pool_ready = 1;
+    }
+    ptr = pool_alloc(size);
+    if (ptr != NULL) {
+        cxxrt_stat.allocs++;
+        cxxrt_stat.peak = (cxxrt_stat.used > cxxrt_stat.peak) ? cxxrt_stat.used : cxxrt_stat.peak;
+    } else {
+        cxxrt_stat.fails++;
+    }
+    pool_lock_release(mstatus);
+    return ptr;
+}
+
+void cxxrt_free(void *ptr)
+{
+    rv_csr_t mstatus;
+
+    if (ptr == NULL) {
+        return;
+    }
+    mstatus = pool_lock_acquire();
+    pool_free(ptr);
+    cxxrt_stat.frees++;
+    pool_lock_release(mstatus);
+}
+
+void cxxrt_get_stat(cxxrt_stat_t *stat)
+{
+    rv_csr_t mstatus = pool_lock_acquire();
+
+    *stat = cxxrt_stat;
+    pool_lock_release(mstatus);
+}
+
+void cxxrt_clear_stat(void)
+{
+    rv_csr_t mstatus = pool_lock_acquire();
+
+    cxxrt_stat.allocs = 0;
+    cxxrt_stat.frees = 0;
+    cxxrt_stat.fails = 0;
+    cxxrt_stat.eh_emergency = 0;
+    cxxrt_stat.peak = cxxrt_stat.used;
+    pool_lock_release(mstatus);
+}
+
+void cxxrt_stat_emergency(void)
+{
+    rv_csr_t mstatus = pool_lock_acquire();
+
+    cxxrt_stat.eh_emergency++;
+    pool_lock_release(mstatus);
+}
+
+void cxxrt_dump_stat(void)
+{
+    cxxrt_stat_t stat;
+
+    cxxrt_get_stat(&stat);
+    pool_dump();
+    printf("  allocs %lu, frees %lu, fails %lu, used %lu, peak %lu, emergency exceptions %lu\n",
+           (unsigned long)stat.allocs, (unsigned long)stat.frees, (unsigned long)stat.fails,
+           (unsigned long)stat.used, (unsigned long)stat.peak, (unsigned long)stat.eh_emergency);
+}
+
+__WEAK void cxxrt_alloc_failed(size_t size)
+{
+}
+
+__WEAK void cxxrt_guard_wait(void)
+{
+    __NOP();
+}
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# gemm middleware provides cache blocked matrix multiply over NMSIS-DSP,
+# NMSIS_LIB must contain nmsis_dsp, see README.md in this directory
+MIDDLEWARE_GEMM := $(NUCLEI_SDK_MIDDLEWARE)/gemm
+
+C_SRCDIRS += $(MIDDLEWARE_GEMM)
+
+INCDIRS += $(MIDDLEWARE_GEMM)
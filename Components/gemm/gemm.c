@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "gemm_api.h"
+
+#define GEMM_ROUND8(x)          (((x) + 7) & ~7UL)
+#define GEMM_MIN_ROWS           4
+#define GEMM_MIN_COLS           4
+#define GEMM_MIN_INNER          8
+
+/* block product of packed buffers, c(m x n) = a(m x k) * b(k x n) */
+typedef void (*gemm_kernel_t)(const void *a, const void *b, void *c, uint16_t m, uint16_t k, uint16_t n, void *state);
+/* c += t for n elements */
+typedef void (*gemm_accum_t)(void *c, const void *t, uint32_t n);
+
+static const uint8_t gemm_elem_size[] = {sizeof(float32_t), sizeof(q31_t), sizeof(q15_t)};
+
+void gemm_plan_init(gemm_plan_t *plan)
+{
+    uint32_t l1 = 0;
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+    CacheInfo_Type info;
+
+    if ((__RV_CSR_READ(CSR_MCFG_INFO) & MCFG_INFO_DCACHE) && GetDCacheInfo(&info) == 0) {
+        l1 = info.size;
+    }
+#endif
+    memset(plan, 0, sizeof(gemm_plan_t));
+    plan->l1_size = (l1 != 0) ? l1 : GEMM_DEFAULT_L1_SIZE;
+#if defined(__SMPCC_PRESENT) && (__SMPCC_PRESENT == 1)
+    if (__RV_CSR_READ(CSR_MCFG_INFO) & MCFG_INFO_SMP) {
+        plan->l2_size = SMPCC_GetCCacheSetNum() * SMPCC_GetCCacheWayNum() * SMPCC_GetCCacheLineSize();
+    }
+#endif
+    plan->work_max = GEMM_DEFAULT_WORK_MAX;
+}
+
+/*
+ * Work buffer layout, a buffer is only needed when the blocks are not
+ * already contiguous in the source or destination matrix:
+ * packed A (mc x kc), packed B (kc x nc), C tile (mc x nc), q15 state (kc x nc)
+ */
+static uint32_t gemm_work_bytes(uint32_t type, uint32_t K, uint32_t N, uint32_t mc, uint32_t kc, uint32_t nc)
+{
+    uint32_t e = gemm_elem_size[type], bytes = 0;
+
+    if (kc != K) {
+        bytes += GEMM_ROUND8(mc * kc * e);
+    }
+    if (kc != K || nc != N) {
+        bytes += GEMM_ROUND8(kc * nc * e);
+        bytes += GEMM_ROUND8(mc * nc * e);
+    }
+    if (type == GEMM_Q15) {
+        bytes += GEMM_ROUND8(kc * nc * e);
+    }
+    return bytes;
+}
+
+uint32_t gemm_plan_tiles(gemm_plan_t *plan, uint16_t type, uint32_t M, uint32_t K, uint32_t N, uint32_t parts)
+{
+    uint32_t e, budget, rows, mc, kc, nc, work;
+
+    plan->work_size = 0;
+    if (type > GEMM_Q15 || M == 0 || K == 0 || N == 0 || parts == 0) {
+        return 0;
+    }
+    e = gemm_elem_size[type];
+    /* B block is reused by every row of A block, keep it in half of L1 */
+    budget = plan->l1_size / 2 / e;
+    if (type == GEMM_F32) {
+        for (kc = GEMM_MIN_INNER; (kc + GEMM_MIN_INNER) * (kc + GEMM_MIN_INNER) <= budget; kc += GEMM_MIN_INNER);
+        nc = kc;
+    } else {
+        /* inner dimension is not split, so the rounding is the same as riscv_mat_mult_q15/q31 */
+        kc = K;
+        nc = budget / K / GEMM_MIN_COLS * GEMM_MIN_COLS;
+    }
+    kc = (kc > K) ? K : kc;
+    nc = (nc < GEMM_MIN_COLS) ? GEMM_MIN_COLS : nc;
+    nc = (nc > N) ? N : nc;
+    /* A block is reused by every B block, keep it in cluster cache, or a quarter of L1 */
+    budget = ((plan->l2_size != 0) ? plan->l2_size : plan->l1_size) / 4 / e;
+    mc = budget / kc / GEMM_MIN_ROWS * GEMM_MIN_ROWS;
+    mc = (mc < GEMM_MIN_ROWS) ? GEMM_MIN_ROWS : mc;
+    rows = (M + parts - 1) / parts;
+    mc = (mc > rows) ? rows : mc;
+
+    while ((work = gemm_work_bytes(type, K, N, mc, kc, nc)) > plan->work_max) {
+        if (mc > GEMM_MIN_ROWS) {
+            mc = mc / 2;
+        } else if (nc > GEMM_MIN_COLS) {
+            nc = nc / 2;
+        } else if (type == GEMM_F32 && kc > GEMM_MIN_INNER) {
+            kc = kc / 2;
+        } else {
+            return 0;
+        }
+    }
+    plan->type = type;
+    plan->mc = mc;
+    plan->kc = kc;
+    plan->nc = nc;
+    plan->work_size = (work != 0) ? work : 8;
+    return plan->work_size;
+}
+
+static riscv_status gemm_run(const gemm_plan_t *plan, uint32_t type, const uint8_t *A, const uint8_t *B, uint8_t *C,
+                             uint32_t M, uint32_t K, uint32_t N, uint8_t *work, uint32_t part, uint32_t parts,
+                             gemm_kernel_t kernel, gemm_accum_t accum)
+{
+    uint32_t e = gemm_elem_size[type];
+    uint32_t mc = plan->mc, kc = plan->kc, nc = plan->nc;
+    uint32_t rows, row0, row1, ic, pc, jc, mb, kb, nb, r;
+    uint8_t *pack_a = NULL, *pack_b = NULL, *tile = NULL, *state = NULL;
+    const uint8_t *a, *b;
+
+    if (plan->type != type || plan->work_size == 0 || work == NULL || part >= parts) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    if (kc != K) {
+        pack_a = work;
+        work += GEMM_ROUND8(mc * kc * e);
+    }
+    if (kc != K || nc != N) {
+        pack_b = work;
+        work += GEMM_ROUND8(kc * nc * e);
+        tile = work;
+        work += GEMM_ROUND8(mc * nc * e);
+    }
+    state = work;
+
+    rows = (M + parts - 1) / parts;
+    row0 = part * rows;
+    row1 = (row0 + rows > M) ? M : row0 + rows;
+    for (pc = 0; pc < K; pc += kc) {
+        kb = (K - pc > kc) ? kc : K - pc;
+        for (ic = row0; ic < row1; ic += mc) {
+            mb = (row1 - ic > mc) ? mc : row1 - ic;
+            if (pack_a != NULL) {
+                for (r = 0; r < mb; r++) {
+                    memcpy(pack_a + r * kb * e, A + ((ic + r) * K + pc) * e, kb * e);
+                }
+                a = pack_a;
+            } else {
+                a = A + ic * K * e;
+            }
+            for (jc = 0; jc < N; jc += nc) {
+                nb = (N - jc > nc) ? nc : N - jc;
+                if (tile == NULL) {
+                    /* whole B and rows of C are contiguous */
+                    kernel(a, B, C + ic * N * e, mb, kb, nb, state);
+                    continue;
+                }
+                for (r = 0; r < kb; r++) {
+                    memcpy(pack_b + r * nb * e, B + ((pc + r) * N + jc) * e, nb * e);
+                }
+                b = pack_b;
+                kernel(a, b, tile, mb, kb, nb, state);
+                for (r = 0; r < mb; r++) {
+                    if (pc == 0) {
+                        memcpy(C + ((ic + r) * N + jc) * e, tile + r * nb * e, nb * e);
+                    } else {
+                        accum(C + ((ic + r) * N + jc) * e, tile + r * nb * e, nb);
+                    }
+                }
+            }
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+static void gemm_kernel_f32(const void *a, const void *b, void *c, uint16_t m, uint16_t k, uint16_t n, void *state)
+{
+    riscv_matrix_instance_f32 sa, sb, sc;
+
+    (void)state;
+    riscv_mat_init_f32(&sa, m, k, (float32_t *)a);
+    riscv_mat_init_f32(&sb, k, n, (float32_t *)b);
+    riscv_mat_init_f32(&sc, m, n, (float32_t *)c);
+    riscv_mat_mult_f32(&sa, &sb, &sc);
+}
+
+static void gemm_accum_f32(void *c, const void *t, uint32_t n)
+{
+    riscv_add_f32((const float32_t *)c, (const float32_t *)t, (float32_t *)c, n);
+}
+
+static void gemm_kernel_q31(const void *a, const void *b, void *c, uint16_t m, uint16_t k, uint16_t n, void *state)
+{
+    riscv_matrix_instance_q31 sa, sb, sc;
+
+    (void)state;
+    riscv_mat_init_q31(&sa, m, k, (q31_t *)a);
+    riscv_mat_init_q31(&sb, k, n, (q31_t *)b);
+    riscv_mat_init_q31(&sc, m, n, (q31_t *)c);
+    riscv_mat_mult_q31(&sa, &sb, &sc);
+}
+
+static void gemm_kernel_q15(const void *a, const void *b, void *c, uint16_t m, uint16_t k, uint16_t n, void *state)
+{
+    riscv_matrix_instance_q15 sa, sb, sc;
+
+    riscv_mat_init_q15(&sa, m, k, (q15_t *)a);
+    riscv_mat_init_q15(&sb, k, n, (q15_t *)b);
+    riscv_mat_init_q15(&sc, m, n, (q15_t *)c);
+    riscv_mat_mult_q15(&sa, &sb, &sc, (q15_t *)state);
+}
+
+#define GEMM_CHECK_SIZE(A, B, C)                                                        \
+    if ((A)->numCols != (B)->numRows || (A)->numRows != (C)->numRows ||                 \
+        (B)->numCols != (C)->numCols) {                                                 \
+        return RISCV_MATH_SIZE_MISMATCH;                                                \
+    }
+
+riscv_status gemm_mat_mult_f32(const gemm_plan_t *plan, const riscv_matrix_instance_f32 *pSrcA,
+                               const riscv_matrix_instance_f32 *pSrcB, riscv_matrix_instance_f32 *pDst,
+                               void *work, uint32_t part, uint32_t parts)
+{
+    GEMM_CHECK_SIZE(pSrcA, pSrcB, pDst);
+    return gemm_run(plan, GEMM_F32, (const uint8_t *)pSrcA->pData, (const uint8_t *)pSrcB->pData,
+                    (uint8_t *)pDst->pData, pSrcA->numRows, pSrcA->numCols, pSrcB->numCols,
+                    (uint8_t *)work, part, parts, gemm_kernel_f32, gemm_accum_f32);
+}
+
+riscv_status gemm_mat_mult_q31(const gemm_plan_t *plan, const riscv_matrix_instance_q31 *pSrcA,
+                               const riscv_matrix_instance_q31 *pSrcB, riscv_matrix_instance_q31 *pDst,
+                               void *work, uint32_t part, uint32_t parts)
+{
+    GEMM_CHECK_SIZE(pSrcA, pSrcB, pDst);
+    /* inner dimension is never split for q31, so no accumulation */
+    return gemm_run(plan, GEMM_Q31, (const uint8_t *)pSrcA->pData, (const uint8_t *)pSrcB->pData,
+                    (uint8_t *)pDst->pData, pSrcA->numRows, pSrcA->numCols, pSrcB->numCols,
+                    (uint8_t *)work, part, parts, gemm_kernel_q31, NULL);
+}
+
+riscv_status gemm_mat_mult_q15(const gemm_plan_t *plan, const riscv_matrix_instance_q15 *pSrcA,
+                               const riscv_matrix_instance_q15 *pSrcB, riscv_matrix_instance_q15 *pDst,
+                               void *work, uint32_t part, uint32_t parts)
+{
+    GEMM_CHECK_SIZE(pSrcA, pSrcB, pDst);
+    return gemm_run(plan, GEMM_Q15, (const uint8_t *)pSrcA->pData, (const uint8_t *)pSrcB->pData,
+                    (uint8_t *)pDst->pData, pSrcA->numRows, pSrcA->numCols, pSrcB->numCols,
+                    (uint8_t *)work, part, parts, gemm_kernel_q15, NULL);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _GEMM_API_H_
+#define _GEMM_API_H_
+
+#include "riscv_math.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+ * Cache blocked matrix multiply front end of NMSIS-DSP riscv_mat_mult_*
+ *
+ * C = A * B is split into blocks, the block of B (kc x nc) is packed into
+ * a contiguous buffer which fits in half of L1 D-Cache, so it stays in
+ * cache while every row of the A block (mc x kc) is multiplied with it,
+ * the A block is packed once for all the B blocks, and sized to stay in
+ * the cluster cache when present. Each block product is done by the
+ * optimized riscv_mat_mult_* of NMSIS-DSP on the packed buffers.
+ *
+ * For q15 and q31, the inner dimension is not split, so the result is
+ * exactly the same as riscv_mat_mult_q15/q31.
+ *
+ * The rows of C can be split into parts computed on different harts,
+ * each part uses its own work buffer.
+ */
+
+/* L1 D-Cache size in bytes used when it can't be probed */
+#ifndef GEMM_DEFAULT_L1_SIZE
+#define GEMM_DEFAULT_L1_SIZE    (16 * 1024)
+#endif
+
+/* default max work buffer size in bytes of each part */
+#ifndef GEMM_DEFAULT_WORK_MAX
+#define GEMM_DEFAULT_WORK_MAX   (64 * 1024)
+#endif
+
+/* element type */
+#define GEMM_F32                0
+#define GEMM_Q31                1
+#define GEMM_Q15                2
+
+typedef struct gemm_plan {
+    uint32_t l1_size;           /* L1 D-Cache size in bytes */
+    uint32_t l2_size;           /* cluster cache size in bytes, 0 if not present */
+    uint32_t work_max;          /* max work buffer size in bytes of each part */
+    uint32_t work_size;         /* work buffer size in bytes of each part, set by gemm_plan_tiles */
+    uint16_t mc;                /* rows of A block */
+    uint16_t kc;                /* columns of A block and rows of B block */
+    uint16_t nc;                /* columns of B block */
+    uint16_t type;              /* GEMM_F32, GEMM_Q31 or GEMM_Q15 */
+} gemm_plan_t;
+
+/*
+ * Probe L1 D-Cache and cluster cache size, and set work_max to GEMM_DEFAULT_WORK_MAX,
+ * the fields can be changed before gemm_plan_tiles
+ */
+void gemm_plan_init(gemm_plan_t *plan);
+
+/*
+ * Choose block sizes for C(M x N) = A(M x K) * B(K x N) in parts,
+ * return work buffer size in bytes needed by each part, or 0 if the work_max is too small
+ */
+uint32_t gemm_plan_tiles(gemm_plan_t *plan, uint16_t type, uint32_t M, uint32_t K, uint32_t N, uint32_t parts);
+
+/*
+ * Compute the rows of C in part (0 ~ parts-1) with the plan made by gemm_plan_tiles,
+ * work must have plan->work_size bytes and 8 bytes aligned,
+ * all parts must be finished before C is used
+ */
+riscv_status gemm_mat_mult_f32(const gemm_plan_t *plan, const riscv_matrix_instance_f32 *pSrcA,
+                               const riscv_matrix_instance_f32 *pSrcB, riscv_matrix_instance_f32 *pDst,
+                               void *work, uint32_t part, uint32_t parts);
+riscv_status gemm_mat_mult_q31(const gemm_plan_t *plan, const riscv_matrix_instance_q31 *pSrcA,
+                               const riscv_matrix_instance_q31 *pSrcB, riscv_matrix_instance_q31 *pDst,
+                               void *work, uint32_t part, uint32_t parts);
+riscv_status gemm_mat_mult_q15(const gemm_plan_t *plan, const riscv_matrix_instance_q15 *pSrcA,
+                               const riscv_matrix_instance_q15 *pSrcB, riscv_matrix_instance_q15 *pDst,
+                               void *work, uint32_t part, uint32_t parts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_GEMM_API_H_ */
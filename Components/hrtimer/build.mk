@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# hrtimer middleware provides high resolution timers over SysTimer compare,
+# see README.md in this directory
+MIDDLEWARE_HRTIMER := $(NUCLEI_SDK_MIDDLEWARE)/hrtimer
+
+C_SRCDIRS += $(MIDDLEWARE_HRTIMER)
+
+INCDIRS += $(MIDDLEWARE_HRTIMER)
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "nuclei_sdk_soc.h"
+#include "hrtimer_api.h"
+
+#if !defined(__SYSTIMER_PRESENT) || (__SYSTIMER_PRESENT != 1)
+#error "hrtimer requires CPU System Timer feature"
+#endif
+
+#ifdef SMODE_RTOS
+#error "hrtimer programs machine mode SysTimer compare, S-Mode RTOS is not supported"
+#endif
+
+#define HRTIMER_NEVER           UINT64_MAX
+
+/* timers of one hart, heap[0] has the earliest deadline */
+typedef struct hrtimer_cpu {
+    hrtimer_t *heap[HRTIMER_MAX_TIMERS];
+    uint32_t count;
+    hrtimer_t *deferred_head;
+    hrtimer_t *deferred_tail;
+    hrtimer_t tick;
+    void (*tick_handler)(void);
+    hrtimer_stats_t stats;
+} hrtimer_cpu_t;
+
+static hrtimer_cpu_t hrtimer_cpus[HRTIMER_MAX_CORES];
+
+static inline hrtimer_cpu_t *hrtimer_this_cpu(void)
+{
+#if HRTIMER_MAX_CORES > 1
+    return &hrtimer_cpus[__get_hart_index()];
+#else
+    return &hrtimer_cpus[0];
+#endif
+}
+
+/* Heap is also touched in timer interrupt, and by nested interrupts */
+static inline rv_csr_t hrtimer_lock(void)
+{
+    return __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+}
+
+static inline void hrtimer_unlock(rv_csr_t mstatus)
+{
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+static void hrtimer_heap_set(hrtimer_cpu_t *cpu, uint32_t idx, hrtimer_t *timer)
+{
+    cpu->heap[idx] = timer;
+    timer->index = (int32_t)idx;
+}
+
+static void hrtimer_sift_up(hrtimer_cpu_t *cpu, uint32_t idx)
+{
+    hrtimer_t *timer = cpu->heap[idx];
+    uint32_t parent;
+
+    while (idx > 0) {
+        parent = (idx - 1) / 2;
+        if (cpu->heap[parent]->expires <= timer->expires) {
+            break;
+        }
+        hrtimer_heap_set(cpu, idx, cpu->heap[parent]);
+        idx = parent;
+    }
+    hrtimer_heap_set(cpu, idx, timer);
+}
+
+static void hrtimer_sift_down(hrtimer_cpu_t *cpu, uint32_t idx)
+{
+    hrtimer_t *timer = cpu->heap[idx];
+    uint32_t child;
+
+    while ((child = 2 * idx + 1) < cpu->count) {
+        if (child + 1 < cpu->count && cpu->heap[child + 1]->expires < cpu->heap[child]->expires) {
+            child++;
+        }
+        if (timer->expires <= cpu->heap[child]->expires) {
+            break;
+        }
+        hrtimer_heap_set(cpu, idx, cpu->heap[child]);
+        idx = child;
+    }
+    hrtimer_heap_set(cpu, idx, timer);
+}
+
+static void hrtimer_heap_remove(hrtimer_cpu_t *cpu, hrtimer_t *timer)
+{
+    uint32_t idx = (uint32_t)timer->index;
+    hrtimer_t *last = cpu->heap[--cpu->count];
+
+    timer->index = -1;
+    if (last == timer) {
+        return;
+    }
+    hrtimer_heap_set(cpu, idx, last);
+    if (idx > 0 && cpu->heap[(idx - 1) / 2]->expires > last->expires) {
+        hrtimer_sift_up(cpu, idx);
+    } else {
+        hrtimer_sift_down(cpu, idx);
+    }
+}
+
+static void hrtimer_deferred_remove(hrtimer_cpu_t *cpu, hrtimer_t *timer)
+{
+    hrtimer_t **pp = &cpu->deferred_head;
+    hrtimer_t *prev = NULL;
+
+    while (*pp != NULL && *pp != timer) {
+        prev = *pp;
+        pp = &(*pp)->next;
+    }
+    if (*pp == timer) {
+        *pp = timer->next;
+        if (cpu->deferred_tail == timer) {
+            cpu->deferred_tail = prev;
+        }
+    }
+    timer->next = NULL;
+    timer->pending = 0;
+}
+
+/* Program SysTimer compare to the earliest deadline, timer interrupt is taken at once if it is passed */
+static void hrtimer_program(hrtimer_cpu_t *cpu)
+{
+    SysTimer_SetCompareValue(cpu->count ? cpu->heap[0]->expires : HRTIMER_NEVER);
+}
+
+uint64_t hrtimer_now(void)
+{
+    return SysTimer_GetLoadValue();
+}
+
+void hrtimer_init(hrtimer_t *timer, hrtimer_cb_t callback, void *arg, uint32_t flags)
+{
+    timer->expires = 0;
+    timer->period = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->next = NULL;
+    timer->index = -1;
+    timer->flags = (uint16_t)flags;
+    timer->pending = 0;
+}
+
+int hrtimer_start(hrtimer_t *timer, uint64_t expires, uint64_t period)
+{
+    hrtimer_cpu_t *cpu = hrtimer_this_cpu();
+    rv_csr_t mstatus;
+    int ret = HRTIMER_OK;
+
+    if (timer == NULL || timer->callback == NULL) {
+        return HRTIMER_EINVAL;
+    }
+    mstatus = hrtimer_lock();
+    if (timer->index >= 0) {
+        hrtimer_heap_remove(cpu, timer);
+    }
+    if (cpu->count < HRTIMER_MAX_TIMERS) {
+        timer->expires = expires;
+        timer->period = period;
+        cpu->heap[cpu->count] = timer;
+        hrtimer_sift_up(cpu, cpu->count++);
+    } else {
+        ret = HRTIMER_EFULL;
+    }
+    /* Only reprogram when the earliest deadline is changed */
+    if (timer->index == 0) {
+        hrtimer_program(cpu);
+    }
+    hrtimer_unlock(mstatus);
+    return ret;
+}
+
+int hrtimer_start_rel(hrtimer_t *timer, uint64_t delay, uint64_t period)
+{
+    return hrtimer_start(timer, hrtimer_now() + delay, period);
+}
+
+int hrtimer_cancel(hrtimer_t *timer)
+{
+    hrtimer_cpu_t *cpu = hrtimer_this_cpu();
+    rv_csr_t mstatus;
+    int ret = HRTIMER_EINVAL;
+
+    if (timer == NULL) {
+        return HRTIMER_EINVAL;
+    }
+    mstatus = hrtimer_lock();
+    if (timer->pending) {
+        hrtimer_deferred_remove(cpu, timer);
+    }
+    if (timer->index >= 0) {
+        /* The interrupt of the removed earliest deadline does no harm, so compare is not reprogrammed */
+        hrtimer_heap_remove(cpu, timer);
+        ret = HRTIMER_OK;
+    }
+    hrtimer_unlock(mstatus);
+    return ret;
+}
+
+int hrtimer_active(const hrtimer_t *timer)
+{
+    return timer->index >= 0;
+}
+
+static void hrtimer_tick_callback(hrtimer_t *timer, void *arg)
+{
+    hrtimer_cpu_t *cpu = (hrtimer_cpu_t *)arg;
+
+    cpu->tick_handler();
+}
+
+void hrtimer_tick_config(uint64_t ticks, void (*tick_handler)(void))
+{
+    hrtimer_cpu_t *cpu = hrtimer_this_cpu();
+
+    cpu->tick_handler = tick_handler;
+    hrtimer_init(&cpu->tick, hrtimer_tick_callback, cpu, 0);
+    hrtimer_start_rel(&cpu->tick, ticks, ticks);
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+    ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
+    ECLIC_SetLevelIRQ(SysTimer_IRQn, 0);
+    ECLIC_EnableIRQ(SysTimer_IRQn);
+#endif
+}
+
+void hrtimer_irq_handler(void)
+{
+    hrtimer_cpu_t *cpu = hrtimer_this_cpu();
+    hrtimer_t *timer;
+    rv_csr_t mstatus;
+    uint64_t now, deadline;
+    uint32_t late, deferred = 0;
+
+    cpu->stats.irqs++;
+    mstatus = hrtimer_lock();
+    now = hrtimer_now();
+    while (cpu->count && cpu->heap[0]->expires <= now) {
+        timer = cpu->heap[0];
+        deadline = timer->expires;
+        /* Periodic timer is re-armed from its deadline, so the period doesn't drift */
+        if (timer->period) {
+            timer->expires += timer->period;
+            hrtimer_sift_down(cpu, 0);
+        } else {
+            hrtimer_heap_remove(cpu, timer);
+        }
+        cpu->stats.fired++;
+        if (timer->flags & HRTIMER_FLAG_DEFERRED) {
+            if (timer->pending == 0) {
+                timer->pending = 1;
+                timer->next = NULL;
+                if (cpu->deferred_tail) {
+                    cpu->deferred_tail->next = timer;
+                } else {
+                    cpu->deferred_head = timer;
+                }
+                cpu->deferred_tail = timer;
+                deferred++;
+            }
+            continue;
+        }
+        /* Callback can start or cancel timers, including itself */
+        hrtimer_unlock(mstatus);
+        late = (uint32_t)(hrtimer_now() - deadline);
+        if (late > cpu->stats.late_max) {
+            cpu->stats.late_max = late;
+        }
+        timer->callback(timer, timer->arg);
+        mstatus = hrtimer_lock();
+        now = hrtimer_now();
+    }
+    hrtimer_program(cpu);
+    hrtimer_unlock(mstatus);
+    if (deferred) {
+        hrtimer_deferred_notify();
+    }
+}
+
+uint32_t hrtimer_run_deferred(void)
+{
+    hrtimer_cpu_t *cpu = hrtimer_this_cpu();
+    hrtimer_t *timer;
+    rv_csr_t mstatus;
+    uint32_t cnt = 0;
+
+    while (1) {
+        mstatus = hrtimer_lock();
+        timer = cpu->deferred_head;
+        if (timer != NULL) {
+            cpu->deferred_head = timer->next;
+            if (cpu->deferred_head == NULL) {
+                cpu->deferred_tail = NULL;
+            }
+            timer->next = NULL;
+            timer->pending = 0;
+        }
+        hrtimer_unlock(mstatus);
+        if (timer == NULL) {
+            break;
+        }
+        timer->callback(timer, timer->arg);
+        cnt++;
+    }
+    return cnt;
+}
+
+void hrtimer_get_stats(hrtimer_stats_t *stats)
+{
+    if (stats != NULL) {
+        *stats = hrtimer_this_cpu()->stats;
+    }
+}
+
+__WEAK void hrtimer_deferred_notify(void)
+{
+}
+
+#ifndef HRTIMER_NO_IRQ_HANDLER
+/* SysTimer interrupt is owned by hrtimer, RTOS tick is one of its timers */
+void eclic_mtip_handler(void)
+{
+    hrtimer_irq_handler();
+}
+#endif
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _HRTIMER_API_H_
+#define _HRTIMER_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * High resolution timer over SysTimer compare
+ *
+ * Armed timers of each hart are kept in a min-heap ordered by their deadline
+ * in 64-bit SysTimer counter units, and the SysTimer compare of the hart is
+ * programmed to the earliest one, so the timer interrupt is only taken when
+ * a timer really expires, independent of the RTOS tick.
+ *
+ * The RTOS tick of FreeRTOS, RT-Thread, ThreadX and uC/OS-II Nuclei ports is
+ * a periodic timer of this service when this component is used, so the tick
+ * rate can be lowered while sub-tick deadlines are still met.
+ *
+ * Callbacks run in timer interrupt by default, or in deferred context when
+ * HRTIMER_FLAG_DEFERRED is set, see hrtimer_run_deferred.
+ *
+ * A timer is run on the hart which started it, start and cancel it on the same hart.
+ */
+
+/* max number of harts, hart index must be less than it */
+#ifndef HRTIMER_MAX_CORES
+#ifdef SMP_CPU_CNT
+#define HRTIMER_MAX_CORES       SMP_CPU_CNT
+#else
+#define HRTIMER_MAX_CORES       1
+#endif
+#endif
+
+/* max number of armed timers of each hart, including the RTOS tick */
+#ifndef HRTIMER_MAX_TIMERS
+#define HRTIMER_MAX_TIMERS      16
+#endif
+
+/* convert time to SysTimer counter units */
+#define HRTIMER_US(us)          ((uint64_t)(us) * SOC_TIMER_FREQ / 1000000)
+#define HRTIMER_MS(ms)          ((uint64_t)(ms) * SOC_TIMER_FREQ / 1000)
+
+/* timer flags passed to hrtimer_init */
+#define HRTIMER_FLAG_DEFERRED   0x1     /* run callback in hrtimer_run_deferred instead of interrupt */
+
+/* return values */
+#define HRTIMER_OK              0
+#define HRTIMER_EINVAL          (-1)
+#define HRTIMER_EFULL           (-2)
+
+struct hrtimer;
+typedef void (*hrtimer_cb_t)(struct hrtimer *timer, void *arg);
+
+/* timer object, treat members as private */
+typedef struct hrtimer {
+    uint64_t expires;           /* absolute deadline in SysTimer counter units */
+    uint64_t period;            /* reload period, 0 for one-shot */
+    hrtimer_cb_t callback;
+    void *arg;
+    struct hrtimer *next;       /* deferred list link */
+    int32_t index;              /* position in heap, -1 if not armed */
+    uint16_t flags;
+    uint16_t pending;           /* in deferred list */
+} hrtimer_t;
+
+/* statistics of timers of one hart */
+typedef struct hrtimer_stats {
+    uint32_t fired;             /* timers expired */
+    uint32_t irqs;              /* timer interrupts taken */
+    uint32_t late_max;          /* max counter units from deadline to callback in interrupt */
+} hrtimer_stats_t;
+
+/* Get current SysTimer counter */
+uint64_t hrtimer_now(void);
+
+/* Init a timer with its callback, flags is HRTIMER_FLAG_* */
+void hrtimer_init(hrtimer_t *timer, hrtimer_cb_t callback, void *arg, uint32_t flags);
+/*
+ * Arm timer to expire at absolute counter value expires, then every period
+ * counter units if period is not 0, an armed timer is re-armed,
+ * return HRTIMER_OK, HRTIMER_EINVAL or HRTIMER_EFULL
+ */
+int hrtimer_start(hrtimer_t *timer, uint64_t expires, uint64_t period);
+/* Arm timer to expire delay counter units later, see hrtimer_start */
+int hrtimer_start_rel(hrtimer_t *timer, uint64_t delay, uint64_t period);
+/* Disarm timer and drop its pending deferred callback, return HRTIMER_OK or HRTIMER_EINVAL if not armed */
+int hrtimer_cancel(hrtimer_t *timer);
+/* Return 1 if timer is armed */
+int hrtimer_active(const hrtimer_t *timer);
+
+/*
+ * Start RTOS tick of current hart as a periodic timer of ticks counter units,
+ * tick_handler is called in timer interrupt, and it must not reload SysTimer,
+ * it also sets up SysTimer interrupt as non-vector interrupt with level 0
+ */
+void hrtimer_tick_config(uint64_t ticks, void (*tick_handler)(void));
+
+/* Run deferred callbacks of current hart, return number of callbacks run */
+uint32_t hrtimer_run_deferred(void);
+
+/* Get statistics of current hart */
+void hrtimer_get_stats(hrtimer_stats_t *stats);
+
+/* SysTimer interrupt handler, it is eclic_mtip_handler unless HRTIMER_NO_IRQ_HANDLER is defined */
+void hrtimer_irq_handler(void);
+
+/*
+ * Weak hook can be overridden for RTOS:
+ * - hrtimer_deferred_notify: called in timer interrupt when deferred callbacks are queued,
+ *   such as give a semaphore to the task calling hrtimer_run_deferred
+ */
+void hrtimer_deferred_notify(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_HRTIMER_API_H_ */
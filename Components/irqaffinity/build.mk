@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# irqaffinity middleware routes external interrupts to harts via CIDU,
+# see README.md in this directory
+MIDDLEWARE_IRQAFFINITY := $(NUCLEI_SDK_MIDDLEWARE)/irqaffinity
+
+C_SRCDIRS += $(MIDDLEWARE_IRQAFFINITY)
+
+INCDIRS += $(MIDDLEWARE_IRQAFFINITY)
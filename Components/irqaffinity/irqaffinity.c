@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "irqaffinity_api.h"
+
+#if defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1) && defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+
+#if IRQAFF_MAX_HARTS > 32
+#error "IRQAFF_MAX_HARTS must not be larger than 32"
+#endif
+
+#define IRQAFF_HARTS_MASK       ((IRQAFF_MAX_HARTS >= 32) ? 0xFFFFFFFFUL : ((1UL << IRQAFF_MAX_HARTS) - 1))
+
+typedef struct irqaff_entry {
+    void (*handler)(void);
+    IRQn_Type irq;
+    uint8_t used;
+    uint8_t level;
+    uint8_t priority;
+    uint8_t policy;
+    uint32_t hart_mask;                         /* allowed harts */
+    volatile uint32_t route;                    /* harts currently routed to */
+    volatile irqaff_stats_t stats[IRQAFF_MAX_HARTS]; /* each one only written by its hart */
+    uint64_t last_cycles[IRQAFF_MAX_HARTS];     /* cycles when last balanced */
+} irqaff_entry_t;
+
+static irqaff_entry_t irqaff_table[IRQAFF_MAX_IRQS];
+static volatile uint32_t irqaff_harts_ready = 0;
+
+static irqaff_entry_t *irqaff_find(IRQn_Type irq)
+{
+    for (uint32_t i = 0; i < IRQAFF_MAX_IRQS; i++) {
+        if (irqaff_table[i].used && irqaff_table[i].irq == irq) {
+            return &irqaff_table[i];
+        }
+    }
+    return NULL;
+}
+
+/* read 64bit counter written by another hart, retry if it is torn on rv32 */
+static uint64_t irqaff_read_cycles(volatile irqaff_stats_t *stats)
+{
+    uint64_t val;
+
+    do {
+        val = stats->cycles;
+    } while (val != stats->cycles);
+    return val;
+}
+
+static uint32_t irqaff_lowest_hart(uint32_t mask)
+{
+    return (mask == 0) ? 0 : (uint32_t)__builtin_ctz(mask);
+}
+
+/* pick the allowed hart which has least interrupts in IRQAFF_BALANCE routed */
+static uint32_t irqaff_pick_hart(irqaff_entry_t *entry)
+{
+    uint32_t count[IRQAFF_MAX_HARTS] = {0};
+    uint32_t i, hart, best = irqaff_lowest_hart(entry->hart_mask);
+
+    for (i = 0; i < IRQAFF_MAX_IRQS; i++) {
+        if (irqaff_table[i].used && &irqaff_table[i] != entry && irqaff_table[i].policy == IRQAFF_BALANCE) {
+            count[irqaff_lowest_hart(irqaff_table[i].route)]++;
+        }
+    }
+    for (hart = 0; hart < IRQAFF_MAX_HARTS; hart++) {
+        if ((entry->hart_mask & (1UL << hart)) && count[hart] < count[best]) {
+            best = hart;
+        }
+    }
+    return best;
+}
+
+static void irqaff_route(irqaff_entry_t *entry, uint32_t route)
+{
+    entry->route = route;
+    __RWMB();
+    CIDU_BroadcastExtInterrupt(IRQn_MAP_TO_EXT_ID(entry->irq), route);
+}
+
+static void irqaff_apply(irqaff_entry_t *entry)
+{
+    uint32_t route;
+
+    switch (entry->policy) {
+        case IRQAFF_SPREAD:
+            route = entry->hart_mask;
+            break;
+        case IRQAFF_BALANCE:
+            route = 1UL << irqaff_pick_hart(entry);
+            break;
+        default:
+            route = 1UL << irqaff_lowest_hart(entry->hart_mask);
+            break;
+    }
+    CIDU_ResetFirstClaimMode(IRQn_MAP_TO_EXT_ID(entry->irq));
+    irqaff_route(entry, route);
+}
+
+/*
+ * Common handler of all managed interrupts, registered as non-vector interrupt,
+ * mcause holds the interrupt id, and it is restored by the interrupt entry
+ * if preempted by a higher level interrupt.
+ */
+static void irqaff_dispatch(void)
+{
+    IRQn_Type irq = (IRQn_Type)(__RV_CSR_READ(CSR_MCAUSE) & MCAUSE_CAUSE);
+    uint32_t hart = __get_hart_index();
+    irqaff_entry_t *entry = irqaff_find(irq);
+    uint64_t start;
+
+    if (entry == NULL || hart >= IRQAFF_MAX_HARTS) {
+        return;
+    }
+    if (entry->policy == IRQAFF_SPREAD) {
+        if (CIDU_SetFirstClaimMode(IRQn_MAP_TO_EXT_ID(irq), hart) != 0) {
+            entry->stats[hart].claim_lost++;
+            return;
+        }
+    }
+    start = __get_rv_cycle();
+    entry->handler();
+    entry->stats[hart].cycles += __get_rv_cycle() - start;
+    entry->stats[hart].count++;
+    if (entry->policy == IRQAFF_SPREAD) {
+        CIDU_ResetFirstClaimMode(IRQn_MAP_TO_EXT_ID(irq));
+    }
+}
+
+int irqaff_register(IRQn_Type irq, void (*handler)(void), uint8_t level, uint8_t priority,
+                    uint32_t policy, uint32_t hart_mask)
+{
+    irqaff_entry_t *entry;
+    uint32_t i;
+
+    if (handler == NULL || irq < SOC_EXTERNAL_MAP_TO_ECLIC_IRQn_OFFSET || policy > IRQAFF_BALANCE) {
+        return -1;
+    }
+    hart_mask &= IRQAFF_HARTS_MASK;
+    if (hart_mask == 0) {
+        return -1;
+    }
+    entry = irqaff_find(irq);
+    for (i = 0; entry == NULL && i < IRQAFF_MAX_IRQS; i++) {
+        if (irqaff_table[i].used == 0) {
+            entry = &irqaff_table[i];
+        }
+    }
+    if (entry == NULL) {
+        return -1;
+    }
+    entry->handler = handler;
+    entry->irq = irq;
+    entry->level = level;
+    entry->priority = priority;
+    entry->policy = policy;
+    entry->hart_mask = hart_mask;
+    entry->used = 1;
+    irqaff_apply(entry);
+    __SMP_RWMB();
+
+    ECLIC_Register_IRQ(irq, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER,
+                       level, priority, (void *)irqaff_dispatch);
+    return 0;
+}
+
+void irqaff_hart_init(void)
+{
+    uint32_t hart = __get_hart_index();
+
+    if (hart >= IRQAFF_MAX_HARTS) {
+        return;
+    }
+    __SMP_RWMB();
+    for (uint32_t i = 0; i < IRQAFF_MAX_IRQS; i++) {
+        if (irqaff_table[i].used) {
+            ECLIC_Register_IRQ(irqaff_table[i].irq, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER,
+                               irqaff_table[i].level, irqaff_table[i].priority, (void *)irqaff_dispatch);
+        }
+    }
+    __AMOOR_W((volatile int32_t *)&irqaff_harts_ready, (int32_t)(1UL << hart));
+}
+
+int irqaff_set_affinity(IRQn_Type irq, uint32_t policy, uint32_t hart_mask)
+{
+    irqaff_entry_t *entry = irqaff_find(irq);
+
+    hart_mask &= IRQAFF_HARTS_MASK;
+    if (entry == NULL || hart_mask == 0 || policy > IRQAFF_BALANCE) {
+        return -1;
+    }
+    entry->policy = policy;
+    entry->hart_mask = hart_mask;
+    irqaff_apply(entry);
+    return 0;
+}
+
+uint32_t irqaff_get_route(IRQn_Type irq)
+{
+    irqaff_entry_t *entry = irqaff_find(irq);
+
+    return (entry == NULL) ? 0 : entry->route;
+}
+
+int irqaff_balance(void)
+{
+    uint64_t hart_load[IRQAFF_MAX_HARTS] = {0};
+    uint64_t irq_load[IRQAFF_MAX_IRQS] = {0};
+    uint64_t now, delta, gap, gain, best_gain;
+    uint32_t i, hart, busiest, idlest, ready;
+    irqaff_entry_t *entry;
+    int best, moved = 0;
+
+    /* load of each hart and each balanced interrupt since last call */
+    for (i = 0; i < IRQAFF_MAX_IRQS; i++) {
+        entry = &irqaff_table[i];
+        if (entry->used == 0) {
+            continue;
+        }
+        for (hart = 0; hart < IRQAFF_MAX_HARTS; hart++) {
+            now = irqaff_read_cycles(&entry->stats[hart]);
+            delta = now - entry->last_cycles[hart];
+            entry->last_cycles[hart] = now;
+            hart_load[hart] += delta;
+            if (entry->policy == IRQAFF_BALANCE) {
+                irq_load[i] += delta;
+            }
+        }
+    }
+
+    ready = irqaff_harts_ready;
+    for (uint32_t round = 0; round < IRQAFF_MAX_IRQS; round++) {
+        busiest = idlest = irqaff_lowest_hart(ready);
+        for (hart = 0; hart < IRQAFF_MAX_HARTS; hart++) {
+            if ((ready & (1UL << hart)) == 0) {
+                continue;
+            }
+            if (hart_load[hart] > hart_load[busiest]) {
+                busiest = hart;
+            }
+            if (hart_load[hart] < hart_load[idlest]) {
+                idlest = hart;
+            }
+        }
+        gap = hart_load[busiest] - hart_load[idlest];
+        if (gap == 0 || gap * 100 <= hart_load[busiest] * IRQAFF_IMBALANCE_PCT) {
+            break;
+        }
+        /* move the interrupt which brings the two harts closest, it must be lighter than the gap */
+        best = -1;
+        best_gain = 0;
+        for (i = 0; i < IRQAFF_MAX_IRQS; i++) {
+            entry = &irqaff_table[i];
+            if (entry->used == 0 || entry->policy != IRQAFF_BALANCE || entry->route != (1UL << busiest)
+                || (entry->hart_mask & (1UL << idlest)) == 0 || irq_load[i] == 0 || irq_load[i] >= gap) {
+                continue;
+            }
+            gain = (irq_load[i] < gap - irq_load[i]) ? irq_load[i] : (gap - irq_load[i]);
+            if (gain > best_gain) {
+                best_gain = gain;
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        irqaff_route(&irqaff_table[best], 1UL << idlest);
+        hart_load[busiest] -= irq_load[best];
+        hart_load[idlest] += irq_load[best];
+        moved++;
+    }
+    return moved;
+}
+
+int irqaff_get_stats(IRQn_Type irq, uint32_t hart, irqaff_stats_t *stats)
+{
+    irqaff_entry_t *entry = irqaff_find(irq);
+
+    if (entry == NULL || hart >= IRQAFF_MAX_HARTS || stats == NULL) {
+        return -1;
+    }
+    stats->count = entry->stats[hart].count;
+    stats->claim_lost = entry->stats[hart].claim_lost;
+    stats->cycles = irqaff_read_cycles(&entry->stats[hart]);
+    return 0;
+}
+
+uint64_t irqaff_hart_load(uint32_t hart)
+{
+    uint64_t load = 0;
+
+    if (hart >= IRQAFF_MAX_HARTS) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < IRQAFF_MAX_IRQS; i++) {
+        if (irqaff_table[i].used) {
+            load += irqaff_read_cycles(&irqaff_table[i].stats[hart]);
+        }
+    }
+    return load;
+}
+
+void irqaff_dump(void)
+{
+    irqaff_entry_t *entry;
+    uint32_t i, hart;
+
+    for (i = 0; i < IRQAFF_MAX_IRQS; i++) {
+        entry = &irqaff_table[i];
+        if (entry->used == 0) {
+            continue;
+        }
+        printf("IRQ %d: policy %u, allowed 0x%lx, route 0x%lx\n", (int)entry->irq, entry->policy,
+               (unsigned long)entry->hart_mask, (unsigned long)entry->route);
+        for (hart = 0; hart < IRQAFF_MAX_HARTS; hart++) {
+            printf("    hart %lu: count %lu, claim lost %lu, cycles %llu\n", (unsigned long)hart,
+                   (unsigned long)entry->stats[hart].count, (unsigned long)entry->stats[hart].claim_lost,
+                   (unsigned long long)irqaff_read_cycles(&entry->stats[hart]));
+        }
+    }
+}
+
+#endif /* __CIDU_PRESENT && __ECLIC_PRESENT */
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRQAFFINITY_API_H_
+#define _IRQAFFINITY_API_H_
+
+#include "nuclei_sdk_soc.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * External interrupt affinity service
+ *
+ * External interrupts managed by this service are routed to harts by CIDU
+ * broadcast masks, and dispatched by a common handler which measures the
+ * cycles spent in each handler on each hart. irqaff_balance can be called
+ * periodically to move hot interrupts from the busiest hart to the least
+ * loaded hart, so one high rate device can't saturate a hart while others
+ * are idle.
+ */
+
+/* max number of harts, hart index must be less than it */
+#ifndef IRQAFF_MAX_HARTS
+#ifdef SMP_CPU_CNT
+#define IRQAFF_MAX_HARTS        SMP_CPU_CNT
+#else
+#define IRQAFF_MAX_HARTS        2
+#endif
+#endif
+
+/* max number of external interrupts managed */
+#ifndef IRQAFF_MAX_IRQS
+#define IRQAFF_MAX_IRQS         16
+#endif
+
+/* harts are rebalanced only when busiest hart load exceeds least loaded one by this percentage of busiest */
+#ifndef IRQAFF_IMBALANCE_PCT
+#define IRQAFF_IMBALANCE_PCT    25
+#endif
+
+/* affinity policy */
+#define IRQAFF_PIN              0   /* routed to the first hart in mask only, never moved */
+#define IRQAFF_SPREAD           1   /* routed to all harts in mask, first hart claims it via CIDU first claim mode */
+#define IRQAFF_BALANCE          2   /* routed to one hart in mask, moved by irqaff_balance */
+
+/* handler statistics of one interrupt on one hart */
+typedef struct irqaff_stats {
+    uint32_t count;             /* handled times */
+    uint32_t claim_lost;        /* times lost first claim in IRQAFF_SPREAD policy */
+    uint64_t cycles;            /* cycles spent in handler */
+} irqaff_stats_t;
+
+/*
+ * Register external interrupt handler with affinity policy and allowed hart mask,
+ * it can be called on any hart, the interrupt is enabled on harts which have
+ * called irqaff_hart_init, return 0 if successful, otherwise -1
+ */
+int irqaff_register(IRQn_Type irq, void (*handler)(void), uint8_t level, uint8_t priority,
+                    uint32_t policy, uint32_t hart_mask);
+
+/* Enable managed interrupts on current hart, must be called on each hart */
+void irqaff_hart_init(void);
+
+/* Change affinity policy and allowed hart mask of a registered interrupt */
+int irqaff_set_affinity(IRQn_Type irq, uint32_t policy, uint32_t hart_mask);
+
+/* Get harts the interrupt is currently routed to, 0 if not registered */
+uint32_t irqaff_get_route(IRQn_Type irq);
+
+/*
+ * Rebalance interrupts in IRQAFF_BALANCE policy by their load since last call,
+ * call it periodically on one hart, return the number of moved interrupts
+ */
+int irqaff_balance(void);
+
+/* Get handler statistics of interrupt on hart since registered */
+int irqaff_get_stats(IRQn_Type irq, uint32_t hart, irqaff_stats_t *stats);
+
+/* Get cycles spent in managed handlers on hart since started */
+uint64_t irqaff_hart_load(uint32_t hart);
+
+/* Print route and per hart load of all managed interrupts */
+void irqaff_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_IRQAFFINITY_API_H_ */
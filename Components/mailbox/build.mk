@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# mailbox middleware provides inter core messaging over shared memory rings,
+# see README.md in this directory
+MIDDLEWARE_MAILBOX := $(NUCLEI_SDK_MIDDLEWARE)/mailbox
+
+C_SRCDIRS += $(MIDDLEWARE_MAILBOX)
+
+INCDIRS += $(MIDDLEWARE_MAILBOX)
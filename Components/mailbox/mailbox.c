@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "mailbox_api.h"
+
+#define MBOX_SLOT_MASK          (MBOX_SLOT_NUM - 1)
+
+#if (MBOX_SLOT_NUM & MBOX_SLOT_MASK) != 0
+#error "MBOX_SLOT_NUM must be power of 2"
+#endif
+
+#if (MBOX_MSG_SIZE % 8) != 0
+#error "MBOX_MSG_SIZE must be multiple of 8"
+#endif
+
+#if MBOX_MAX_CORES > 32
+#error "MBOX_MAX_CORES must not be larger than 32"
+#endif
+
+#define MBOX_IRQ_LEVEL          1
+#define MBOX_IRQ_PRIORITY       0
+
+typedef struct mbox_slot {
+    uint32_t len;
+    uint32_t reserved;
+    uint8_t data[MBOX_MSG_SIZE];
+} mbox_slot_t;
+
+/*
+ * Ring from one sender hart to one receiver hart.
+ * head is only written by sender and tail is only written by receiver,
+ * they are placed in different cache lines to avoid false sharing.
+ * head and tail are free running counters, ring is empty when head == tail.
+ */
+typedef struct mbox_ring {
+    volatile uint32_t head;
+    uint32_t batch;                         /* head when last flushed, sender private */
+    mbox_stats_t stats;                     /* sender private */
+    uint8_t pad0[MBOX_CACHE_LINE - 2 * sizeof(uint32_t) - sizeof(mbox_stats_t)];
+    volatile uint32_t tail;
+    uint8_t pad1[MBOX_CACHE_LINE - sizeof(uint32_t)];
+    mbox_slot_t slots[MBOX_SLOT_NUM];
+} mbox_ring_t;
+
+/* indexed by [sender][receiver], must be placed in memory shared by all harts */
+static mbox_ring_t mbox_rings[MBOX_MAX_CORES][MBOX_MAX_CORES] __ALIGNED(MBOX_CACHE_LINE);
+static volatile uint32_t mbox_doorbell_type = MBOX_DOORBELL_NONE;
+
+static void mbox_ring_doorbell(uint32_t dst)
+{
+    switch (mbox_doorbell_type) {
+#if defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1)
+        case MBOX_DOORBELL_CIDU:
+            CIDU_TriggerInterCoreInt(__get_hart_index(), dst);
+            break;
+#endif
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+        case MBOX_DOORBELL_CLINT:
+            SysTimer_SendIPI(dst);
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+void mbox_doorbell_handler(void)
+{
+    uint32_t src, mask;
+
+    /* clear doorbell before checking rings, so a doorbell rung after the check is not lost */
+    switch (mbox_doorbell_type) {
+#if defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1)
+        case MBOX_DOORBELL_CIDU:
+            mask = CIDU_QueryCoreIntSenderMask(__get_hart_index());
+            for (src = 0; mask != 0; src++, mask >>= 1) {
+                if (mask & 0x1) {
+                    CIDU_ClearInterCoreIntReq(src, __get_hart_index());
+                }
+            }
+            break;
+#endif
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+        case MBOX_DOORBELL_CLINT:
+            /* same hart index numbering as SysTimer_SendIPI in mbox_ring_doorbell */
+            SysTimer_ClearIPI(__get_hart_index());
+            break;
+#endif
+        default:
+            break;
+    }
+    __SMP_RWMB();
+
+    mask = mbox_pending();
+    for (src = 0; mask != 0; src++, mask >>= 1) {
+        if (mask & 0x1) {
+            mbox_notify(src);
+        }
+    }
+}
+
+int mbox_init(uint32_t doorbell)
+{
+    if (__get_hart_index() >= MBOX_MAX_CORES) {
+        return MBOX_EINVAL;
+    }
+    if (doorbell == MBOX_DOORBELL_AUTO) {
+#if defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1)
+        if (__RV_CSR_READ(CSR_MCFG_INFO) & MCFG_INFO_SMP) {
+            doorbell = MBOX_DOORBELL_CIDU;
+        } else
+#endif
+        {
+            doorbell = MBOX_DOORBELL_CLINT;
+        }
+    }
+
+    switch (doorbell) {
+        case MBOX_DOORBELL_NONE:
+            break;
+#if defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1)
+        case MBOX_DOORBELL_CIDU:
+            ECLIC_Register_IRQ(InterCore_IRQn, ECLIC_NON_VECTOR_INTERRUPT,
+                               ECLIC_LEVEL_TRIGGER, MBOX_IRQ_LEVEL, MBOX_IRQ_PRIORITY, (void *)mbox_doorbell_handler);
+            break;
+#endif
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+        case MBOX_DOORBELL_CLINT:
+            ECLIC_Register_IRQ(SysTimerSW_IRQn, ECLIC_NON_VECTOR_INTERRUPT,
+                               ECLIC_LEVEL_TRIGGER, MBOX_IRQ_LEVEL, MBOX_IRQ_PRIORITY, (void *)mbox_doorbell_handler);
+            break;
+#endif
+        default:
+            return MBOX_EINVAL;
+    }
+    mbox_doorbell_type = doorbell;
+    __SMP_RWMB();
+    return (int)doorbell;
+}
+
+void *mbox_alloc(uint32_t dst)
+{
+    mbox_ring_t *ring;
+    uint32_t head;
+
+    if (dst >= MBOX_MAX_CORES) {
+        return NULL;
+    }
+    ring = &mbox_rings[__get_hart_index()][dst];
+    head = ring->head;
+    if ((head - ring->tail) >= MBOX_SLOT_NUM) {
+        ring->stats.full++;
+        return NULL;
+    }
+    return ring->slots[head & MBOX_SLOT_MASK].data;
+}
+
+void mbox_commit(uint32_t dst, uint32_t len)
+{
+    mbox_ring_t *ring = &mbox_rings[__get_hart_index()][dst];
+    uint32_t head = ring->head;
+
+    ring->slots[head & MBOX_SLOT_MASK].len = len;
+    ring->stats.posted++;
+    /* message must be visible before head moves */
+    __SMP_RWMB();
+    ring->head = head + 1;
+}
+
+void mbox_flush(uint32_t dst)
+{
+    mbox_ring_t *ring;
+
+    if (dst >= MBOX_MAX_CORES) {
+        return;
+    }
+    ring = &mbox_rings[__get_hart_index()][dst];
+    if (ring->head == ring->batch) {
+        return;
+    }
+    /*
+     * Order head store before tail load, receiver orders them the other way,
+     * so either receiver sees the new head, or we see it has drained the
+     * messages before this batch and may be waiting, then ring the doorbell.
+     */
+    __SMP_RWMB();
+    if (ring->tail == ring->batch) {
+        mbox_ring_doorbell(dst);
+        ring->stats.doorbells++;
+    }
+    ring->batch = ring->head;
+}
+
+int mbox_post(uint32_t dst, const void *msg, uint32_t len)
+{
+    void *slot;
+
+    if (len > MBOX_MSG_SIZE) {
+        return MBOX_EINVAL;
+    }
+    slot = mbox_alloc(dst);
+    if (slot == NULL) {
+        return (dst >= MBOX_MAX_CORES) ? MBOX_EINVAL : MBOX_FULL;
+    }
+    memcpy(slot, msg, len);
+    mbox_commit(dst, len);
+    return MBOX_OK;
+}
+
+int mbox_send(uint32_t dst, const void *msg, uint32_t len)
+{
+    int ret = mbox_post(dst, msg, len);
+
+    if (ret == MBOX_OK) {
+        mbox_flush(dst);
+    }
+    return ret;
+}
+
+const void *mbox_peek(uint32_t src, uint32_t *len)
+{
+    mbox_ring_t *ring;
+    mbox_slot_t *slot;
+    uint32_t tail;
+
+    if (src >= MBOX_MAX_CORES) {
+        return NULL;
+    }
+    ring = &mbox_rings[src][__get_hart_index()];
+    tail = ring->tail;
+    if (ring->head == tail) {
+        return NULL;
+    }
+    /* read message after head */
+    __SMP_RWMB();
+    slot = &ring->slots[tail & MBOX_SLOT_MASK];
+    if (len != NULL) {
+        *len = slot->len;
+    }
+    return slot->data;
+}
+
+void mbox_release(uint32_t src)
+{
+    mbox_ring_t *ring = &mbox_rings[src][__get_hart_index()];
+
+    /* message must be consumed before the slot is given back */
+    __SMP_RWMB();
+    ring->tail = ring->tail + 1;
+    /* order tail store before next head load, see mbox_flush */
+    __SMP_RWMB();
+}
+
+int mbox_tryrecv(uint32_t src, void *buf, uint32_t size)
+{
+    const void *msg;
+    uint32_t len;
+
+    msg = mbox_peek(src, &len);
+    if (msg == NULL) {
+        return (src >= MBOX_MAX_CORES) ? MBOX_EINVAL : MBOX_EMPTY;
+    }
+    if (len > size) {
+        len = size;
+    }
+    memcpy(buf, msg, len);
+    mbox_release(src);
+    return (int)len;
+}
+
+int mbox_recv(uint32_t src, void *buf, uint32_t size)
+{
+    int ret;
+
+    while ((ret = mbox_tryrecv(src, buf, size)) == MBOX_EMPTY) {
+        mbox_wait(src);
+    }
+    return ret;
+}
+
+uint32_t mbox_pending(void)
+{
+    uint32_t me = __get_hart_index();
+    uint32_t src, mask = 0;
+
+    for (src = 0; src < MBOX_MAX_CORES; src++) {
+        if (mbox_rings[src][me].head != mbox_rings[src][me].tail) {
+            mask |= (1UL << src);
+        }
+    }
+    return mask;
+}
+
+void mbox_get_stats(uint32_t dst, mbox_stats_t *stats)
+{
+    if (dst >= MBOX_MAX_CORES || stats == NULL) {
+        return;
+    }
+    *stats = mbox_rings[__get_hart_index()][dst].stats;
+}
+
+__WEAK void mbox_notify(uint32_t src)
+{
+    (void)src;
+}
+
+__WEAK void mbox_wait(uint32_t src)
+{
+    if (mbox_doorbell_type == MBOX_DOORBELL_NONE) {
+        return;
+    }
+    /*
+     * Check again with interrupt disabled, a doorbell rung after the check
+     * stays pending and wakes up wfi, then it is handled after enabled
+     */
+    __disable_irq();
+    if ((mbox_pending() & (1UL << src)) == 0) {
+        __WFI();
+    }
+    __enable_irq();
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _MAILBOX_API_H_
+#define _MAILBOX_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Inter core mailbox
+ *
+ * Each (sender hart, receiver hart) pair owns a lock-free single producer
+ * single consumer ring in shared memory, so sending and receiving never take
+ * a lock or disable interrupts. The receiver is woken by a doorbell interrupt,
+ * which is CIDU inter core interrupt if present, or CLINT MSIP otherwise.
+ *
+ * Messages can be posted in batches and the doorbell is only rung when the
+ * receiver has drained all the messages before the batch, so a busy receiver
+ * takes no doorbell interrupt at all.
+ *
+ * Only one context on the sender hart may send to the same receiver hart,
+ * and only one context on the receiver hart may receive from the same
+ * sender hart, protect it by yourself if more contexts are used.
+ */
+
+/* max number of harts, hart index must be less than it */
+#ifndef MBOX_MAX_CORES
+#ifdef SMP_CPU_CNT
+#define MBOX_MAX_CORES          SMP_CPU_CNT
+#else
+#define MBOX_MAX_CORES          2
+#endif
+#endif
+
+/* number of message slots in each ring, must be power of 2 */
+#ifndef MBOX_SLOT_NUM
+#define MBOX_SLOT_NUM           16
+#endif
+
+/* max message size in bytes, slot size is MBOX_MSG_SIZE + 8 */
+#ifndef MBOX_MSG_SIZE
+#define MBOX_MSG_SIZE           56
+#endif
+
+/* cache line size, ring head and tail are placed in different cache lines */
+#ifndef MBOX_CACHE_LINE
+#define MBOX_CACHE_LINE         64
+#endif
+
+/* doorbell used to wake up receiver, passed to mbox_init */
+#define MBOX_DOORBELL_NONE      0   /* no doorbell, receiver polls or calls mbox_doorbell_handler by itself */
+#define MBOX_DOORBELL_CIDU      1   /* CIDU inter core interrupt */
+#define MBOX_DOORBELL_CLINT     2   /* CLINT MSIP software interrupt */
+#define MBOX_DOORBELL_AUTO      3   /* CIDU if present, otherwise CLINT */
+
+/* return values */
+#define MBOX_OK                 0
+#define MBOX_EMPTY              (-1)
+#define MBOX_FULL               (-2)
+#define MBOX_EINVAL             (-3)
+
+/* sender side statistics of one ring */
+typedef struct mbox_stats {
+    uint32_t posted;            /* messages posted */
+    uint32_t doorbells;         /* doorbells rung */
+    uint32_t full;              /* post failed due to ring full */
+} mbox_stats_t;
+
+/*
+ * Init mailbox on current hart, must be called on each hart using mailbox,
+ * it registers the doorbell interrupt handler of current hart,
+ * return the doorbell really used, or MBOX_EINVAL if it is not available
+ */
+int mbox_init(uint32_t doorbell);
+
+/* Copy a message to ring of dst hart without ringing doorbell, return MBOX_OK or MBOX_FULL */
+int mbox_post(uint32_t dst, const void *msg, uint32_t len);
+/* Ring doorbell of dst hart if it may sleep on messages posted since last flush */
+void mbox_flush(uint32_t dst);
+/* Post a message and flush it */
+int mbox_send(uint32_t dst, const void *msg, uint32_t len);
+
+/* Get next free slot to dst hart to fill message in place, return NULL if ring is full */
+void *mbox_alloc(uint32_t dst);
+/* Publish the slot got by mbox_alloc with len bytes, need mbox_flush to ring doorbell */
+void mbox_commit(uint32_t dst, uint32_t len);
+
+/* Receive a message from src hart, return message length or MBOX_EMPTY */
+int mbox_tryrecv(uint32_t src, void *buf, uint32_t size);
+/* Receive a message from src hart, wait in mbox_wait until there is one */
+int mbox_recv(uint32_t src, void *buf, uint32_t size);
+
+/* Get next message from src hart in place, return NULL if no message */
+const void *mbox_peek(uint32_t src, uint32_t *len);
+/* Free the message got by mbox_peek */
+void mbox_release(uint32_t src);
+
+/* Return bit mask of sender harts which have messages to current hart */
+uint32_t mbox_pending(void);
+
+/* Get sender side statistics of ring from current hart to dst hart */
+void mbox_get_stats(uint32_t dst, mbox_stats_t *stats);
+
+/* Doorbell interrupt handler, call it in your own handler when MBOX_DOORBELL_NONE is used */
+void mbox_doorbell_handler(void);
+
+/*
+ * Weak hooks can be overridden for RTOS:
+ * - mbox_notify: called in doorbell interrupt for each sender hart which has messages,
+ *   such as give a semaphore
+ * - mbox_wait: called by mbox_recv when no message from src hart, such as take a semaphore,
+ *   default one waits for interrupt
+ */
+void mbox_notify(uint32_t src);
+void mbox_wait(uint32_t src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_MAILBOX_API_H_ */
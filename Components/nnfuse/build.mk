@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# nnfuse middleware provides fused conv + activation + pooling executor for NMSIS-NN,
+# NMSIS_LIB must contain nmsis_nn, see README.md in this directory
+MIDDLEWARE_NNFUSE := $(NUCLEI_SDK_MIDDLEWARE)/nnfuse
+
+C_SRCDIRS += $(MIDDLEWARE_NNFUSE)
+
+INCDIRS += $(MIDDLEWARE_NNFUSE)
@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "nmsis_bench.h"
+#include "nnfuse_api.h"
+
+BENCH_DECLARE_VAR();
+HPM_DECLARE_VAR(4);
+
+#define NNFUSE_HPM_EVENT        HPM_EVENT(EVENT_SEL_MEMORY_ACCESS, EVENT_MEMORY_ACCESS_DCACHE_MISS, MSU_EVENT_ENABLE)
+#define NNFUSE_ALIGN4(x)        (((x) + 3) & ~(uint32_t)3)
+#define NNFUSE_ACT_CHUNK        32768
+
+static const char *nnfuse_names[] = {"conv", "relu", "relu6", "maxpool", "avgpool"};
+
+static uint32_t nnfuse_bytes(const nmsis_nn_dims *dims)
+{
+    return (uint32_t)dims->h * dims->w * dims->c;
+}
+
+static int nnfuse_is_act(const nnfuse_op_t *op)
+{
+    return op->type == NNFUSE_RELU || op->type == NNFUSE_RELU6;
+}
+
+static int nnfuse_is_pool(const nnfuse_op_t *op)
+{
+    return op->type == NNFUSE_MAXPOOL || op->type == NNFUSE_AVGPOOL;
+}
+
+static int32_t nnfuse_validate(const nnfuse_graph_t *graph)
+{
+    const nnfuse_op_t *op, *prev;
+    uint32_t i;
+
+    if (graph == NULL || graph->ops == NULL || graph->op_cnt == 0 || graph->tile == NULL
+        || graph->act[0] == NULL || graph->act[1] == NULL || graph->act[0] == graph->act[1]) {
+        return NNFUSE_EINVAL;
+    }
+    for (i = 0; i < graph->op_cnt; i++) {
+        op = &graph->ops[i];
+        if (op->type > NNFUSE_AVGPOOL || (!nnfuse_is_act(op) && op->param == NULL)) {
+            return NNFUSE_EINVAL;
+        }
+        if (nnfuse_is_act(op) && memcmp(&op->in, &op->out, sizeof(op->in)) != 0) {
+            return NNFUSE_EINVAL;
+        }
+        if (i > 0) {
+            prev = &graph->ops[i - 1];
+            if (prev->out.h != op->in.h || prev->out.w != op->in.w || prev->out.c != op->in.c) {
+                return NNFUSE_EINVAL;
+            }
+        }
+    }
+    return NNFUSE_OK;
+}
+
+/*
+ * Get the input rows [in_start, in_start + in_cnt) needed by output rows
+ * [out_start, out_start + out_cnt) of a window op, and the top padding to
+ * use on the slice, rows out of input are padded like on the whole input
+ */
+static void nnfuse_slice(int32_t out_start, int32_t out_cnt, int32_t stride, int32_t pad, int32_t extent,
+                         int32_t in_h, int32_t *in_start, int32_t *in_cnt, int32_t *pad_top)
+{
+    int32_t start = out_start * stride - pad;
+    int32_t end = (out_start + out_cnt - 1) * stride - pad + extent;
+
+    *in_start = (start < 0) ? 0 : start;
+    *pad_top = *in_start - start;
+    *in_cnt = ((end > in_h) ? in_h : end) - *in_start;
+}
+
+static void nnfuse_act(const nnfuse_op_t *op, int8_t *data, uint32_t size)
+{
+    uint32_t cnt;
+
+    while (size > 0) {
+        cnt = (size > NNFUSE_ACT_CHUNK) ? NNFUSE_ACT_CHUNK : size;
+        if (op->type == NNFUSE_RELU6) {
+            riscv_relu6_s8(data, cnt);
+        } else {
+            riscv_relu_q7(data, cnt);
+        }
+        data += cnt;
+        size -= cnt;
+    }
+}
+
+static int32_t nnfuse_conv_rows(const nnfuse_op_t *op, const int8_t *input, int32_t row, int32_t cnt,
+                                int8_t *output, nmsis_nn_context *ctx, uint32_t *read_bytes)
+{
+    const nnfuse_conv_t *p = op->param;
+    nmsis_nn_conv_params conv = p->conv;
+    nmsis_nn_dims in = op->in, out = op->out;
+    int32_t in_start, in_cnt, pad_top;
+
+    nnfuse_slice(row, cnt, conv.stride.h, conv.padding.h, conv.dilation.h * (p->filter.h - 1) + 1,
+                 op->in.h, &in_start, &in_cnt, &pad_top);
+    conv.padding.h = pad_top;
+    in.h = in_cnt;
+    out.h = cnt;
+    if (riscv_convolve_wrapper_s8_get_buffer_size(&conv, &in, &p->filter, &out) > ctx->size) {
+        return NNFUSE_ETILE;
+    }
+    *read_bytes += nnfuse_bytes(&in);
+    if (riscv_convolve_wrapper_s8(ctx, &conv, &p->quant, &in, input + in_start * in.w * in.c, &p->filter,
+                                  p->weights, &p->bias, p->bias_data, &out, output) != RISCV_NMSIS_NN_SUCCESS) {
+        return NNFUSE_ERUN;
+    }
+    return NNFUSE_OK;
+}
+
+/* input holds rows [in_row, in_row + in_h) of pool input */
+static int32_t nnfuse_pool_rows(const nnfuse_op_t *op, const int8_t *input, int32_t in_row, int32_t row,
+                                int32_t cnt, int8_t *output, nmsis_nn_context *ctx)
+{
+    const nnfuse_pool_t *p = op->param;
+    nmsis_nn_pool_params pool = p->pool;
+    nmsis_nn_dims in = op->in, out = op->out;
+    int32_t in_start, in_cnt, pad_top;
+    riscv_nmsis_nn_status status;
+
+    nnfuse_slice(row, cnt, pool.stride.h, pool.padding.h, p->filter.h, op->in.h, &in_start, &in_cnt, &pad_top);
+    pool.padding.h = pad_top;
+    in.h = in_cnt;
+    out.h = cnt;
+    input += (in_start - in_row) * in.w * in.c;
+    if (op->type == NNFUSE_MAXPOOL) {
+        status = riscv_max_pool_s8(ctx, &pool, &in, input, &p->filter, &out, output);
+    } else {
+        status = riscv_avgpool_s8(ctx, &pool, &in, input, &p->filter, &out, output);
+    }
+    return (status == RISCV_NMSIS_NN_SUCCESS) ? NNFUSE_OK : NNFUSE_ERUN;
+}
+
+/* scratch in bytes needed by conv and pool ops, 4 bytes aligned */
+static uint32_t nnfuse_scratch(const nnfuse_op_t *conv, const nnfuse_op_t *pool)
+{
+    const nnfuse_conv_t *p;
+    int32_t size = 0, psize;
+
+    if (conv != NULL) {
+        p = conv->param;
+        size = riscv_convolve_wrapper_s8_get_buffer_size(&p->conv, &conv->in, &p->filter, &conv->out);
+    }
+    if (pool != NULL && pool->type == NNFUSE_AVGPOOL) {
+        psize = riscv_avgpool_s8_get_buffer_size(pool->out.w, pool->in.c);
+        size = (psize > size) ? psize : size;
+    }
+    return NNFUSE_ALIGN4((uint32_t)size);
+}
+
+/*
+ * Get pool output rows (or conv output rows without pool) of each tile,
+ * so the conv rows needed fit in tile buffer with scratch, 0 if not possible
+ */
+static int32_t nnfuse_tile_rows(const nnfuse_graph_t *graph, const nnfuse_op_t *conv, const nnfuse_op_t *pool,
+                                uint32_t scratch)
+{
+    uint32_t row_bytes = (uint32_t)conv->out.w * conv->out.c;
+    int32_t rows, total, stride = 1, extent = 1, need;
+
+    if (graph->tile_size <= scratch) {
+        return 0;
+    }
+    if (pool != NULL) {
+        stride = ((const nnfuse_pool_t *)pool->param)->pool.stride.h;
+        extent = ((const nnfuse_pool_t *)pool->param)->filter.h;
+    }
+    total = (pool != NULL) ? pool->out.h : conv->out.h;
+    for (rows = total; rows > 0; rows--) {
+        need = (rows - 1) * stride + extent;
+        need = (need > conv->out.h) ? conv->out.h : need;
+        if ((uint32_t)need * row_bytes <= graph->tile_size - scratch) {
+            break;
+        }
+    }
+    return rows;
+}
+
+static int32_t nnfuse_run_fused(const nnfuse_graph_t *graph, const nnfuse_op_t *conv, const nnfuse_op_t *act,
+                                const nnfuse_op_t *pool, int32_t tile_rows, uint32_t scratch,
+                                const int8_t *input, int8_t *output, nnfuse_stats_t *stats)
+{
+    const nnfuse_pool_t *pp = (pool != NULL) ? pool->param : NULL;
+    uint32_t row_bytes = (uint32_t)conv->out.w * conv->out.c;
+    int32_t row, cnt, total, conv_row, conv_cnt, pad_top, ret;
+    nmsis_nn_context ctx;
+    int8_t *rows_buf;
+
+    ctx.buf = graph->tile + graph->tile_size - scratch;
+    ctx.size = scratch;
+    total = (pool != NULL) ? pool->out.h : conv->out.h;
+    for (row = 0; row < total; row += cnt) {
+        cnt = (total - row > tile_rows) ? tile_rows : total - row;
+        if (pool != NULL) {
+            nnfuse_slice(row, cnt, pp->pool.stride.h, pp->pool.padding.h, pp->filter.h, pool->in.h,
+                         &conv_row, &conv_cnt, &pad_top);
+            rows_buf = graph->tile;
+        } else {
+            /* without pooling, conv rows are written to output directly while act is applied in cache */
+            conv_row = row;
+            conv_cnt = cnt;
+            rows_buf = output + row * row_bytes;
+        }
+        ret = nnfuse_conv_rows(conv, input, conv_row, conv_cnt, rows_buf, &ctx, &stats->read_bytes);
+        if (ret != NNFUSE_OK) {
+            return ret;
+        }
+        if (act != NULL) {
+            nnfuse_act(act, rows_buf, conv_cnt * row_bytes);
+        }
+        if (pool != NULL) {
+            ret = nnfuse_pool_rows(pool, rows_buf, conv_row, row, cnt, output + row * pool->out.w * pool->out.c, &ctx);
+            if (ret != NNFUSE_OK) {
+                return ret;
+            }
+        }
+        stats->tiles++;
+    }
+    stats->write_bytes += nnfuse_bytes((pool != NULL) ? &pool->out : &conv->out);
+    return NNFUSE_OK;
+}
+
+static int32_t nnfuse_run_op(const nnfuse_graph_t *graph, const nnfuse_op_t *op, const int8_t *input,
+                             int8_t *output, nnfuse_stats_t *stats)
+{
+    nmsis_nn_context ctx;
+    uint32_t scratch;
+
+    stats->tiles = 1;
+    if (nnfuse_is_act(op)) {
+        /* in place, input is copied to output first when they are different */
+        if (input != output) {
+            memcpy(output, input, nnfuse_bytes(&op->in));
+            stats->read_bytes += nnfuse_bytes(&op->in);
+            stats->write_bytes += nnfuse_bytes(&op->out);
+        }
+        nnfuse_act(op, output, nnfuse_bytes(&op->out));
+        stats->read_bytes += nnfuse_bytes(&op->in);
+        stats->write_bytes += nnfuse_bytes(&op->out);
+        return NNFUSE_OK;
+    }
+    scratch = nnfuse_scratch((op->type == NNFUSE_CONV) ? op : NULL, nnfuse_is_pool(op) ? op : NULL);
+    if (scratch > graph->tile_size) {
+        return NNFUSE_ETILE;
+    }
+    ctx.buf = graph->tile;
+    ctx.size = graph->tile_size;
+    stats->write_bytes += nnfuse_bytes(&op->out);
+    if (op->type == NNFUSE_CONV) {
+        return nnfuse_conv_rows(op, input, 0, op->out.h, output, &ctx, &stats->read_bytes);
+    }
+    stats->read_bytes += nnfuse_bytes(&op->in);
+    return nnfuse_pool_rows(op, input, 0, 0, op->out.h, output, &ctx);
+}
+
+/* last group writes graph output, in place activation stays in its input unless it is graph input */
+static int8_t *nnfuse_dst(const nnfuse_graph_t *graph, uint32_t i, uint32_t n, const int8_t *src,
+                          const int8_t *input, int8_t *output)
+{
+    if (i + n == graph->op_cnt) {
+        return output;
+    }
+    if (n == 1 && nnfuse_is_act(&graph->ops[i]) && src != input) {
+        return (int8_t *)src;
+    }
+    return (src == graph->act[0]) ? graph->act[1] : graph->act[0];
+}
+
+int32_t nnfuse_run(const nnfuse_graph_t *graph, const int8_t *input, int8_t *output, int fuse,
+                   nnfuse_stats_t *stats)
+{
+    const nnfuse_op_t *op, *act, *pool;
+    nnfuse_stats_t local;
+    nnfuse_stats_t *st;
+    const int8_t *src = input;
+    int8_t *dst;
+    uint32_t i, n, scratch;
+    int32_t tile_rows, ret;
+
+    if (nnfuse_validate(graph) != NNFUSE_OK || input == NULL || output == NULL) {
+        return NNFUSE_EINVAL;
+    }
+    if (stats != NULL) {
+        memset(stats, 0, sizeof(nnfuse_stats_t) * graph->op_cnt);
+    }
+    for (i = 0; i < graph->op_cnt; i += n) {
+        op = &graph->ops[i];
+        act = pool = NULL;
+        n = 1;
+        if (fuse && op->type == NNFUSE_CONV) {
+            if (i + n < graph->op_cnt && nnfuse_is_act(&graph->ops[i + n])) {
+                act = &graph->ops[i + n];
+                n++;
+            }
+            if (i + n < graph->op_cnt && nnfuse_is_pool(&graph->ops[i + n])) {
+                pool = &graph->ops[i + n];
+                n++;
+            }
+        }
+        st = (stats != NULL) ? &stats[i] : &local;
+        memset(st, 0, sizeof(nnfuse_stats_t));
+        st->ops = n;
+        dst = nnfuse_dst(graph, i, n, src, input, output);
+
+        BENCH_START(nnfuse);
+        HPM_START(4, nnfuse, NNFUSE_HPM_EVENT);
+        ret = NNFUSE_OK;
+        if (n > 1) {
+            scratch = nnfuse_scratch(op, pool);
+            tile_rows = nnfuse_tile_rows(graph, op, pool, scratch);
+            if (tile_rows > 0) {
+                ret = nnfuse_run_fused(graph, op, act, pool, tile_rows, scratch, src, dst, st);
+            } else {
+                /* tile buffer is too small, run this conv alone */
+                n = 1;
+                st->ops = 1;
+                dst = nnfuse_dst(graph, i, n, src, input, output);
+            }
+        }
+        if (n == 1) {
+            ret = nnfuse_run_op(graph, op, src, dst, st);
+        }
+        BENCH_SAMPLE(nnfuse);
+        HPM_SAMPLE(4, nnfuse, NNFUSE_HPM_EVENT);
+        st->cycles = BENCH_GET_USECYC();
+        st->dcache_miss = HPM_GET_USECYC(4);
+        if (ret != NNFUSE_OK) {
+            return ret;
+        }
+        src = dst;
+    }
+    return NNFUSE_OK;
+}
+
+void nnfuse_report(const nnfuse_graph_t *graph, const nnfuse_stats_t *stats, const char *name)
+{
+    uint32_t i, k;
+    uint64_t cycles = 0, miss = 0;
+    uint32_t rd = 0, wr = 0;
+
+    printf("CSV, %s, ops, tiles, cycles, read bytes, write bytes, dcache miss\n", name);
+    for (i = 0; i < graph->op_cnt; i++) {
+        if (stats[i].ops == 0) {
+            continue;
+        }
+        printf("CSV, %s, ", name);
+        for (k = 0; k < stats[i].ops; k++) {
+            printf("%s%s", (k > 0) ? "+" : "", nnfuse_names[graph->ops[i + k].type]);
+        }
+        printf(", %u, %lu, %lu, %lu, %lu\n", stats[i].tiles, (unsigned long)stats[i].cycles,
+               (unsigned long)stats[i].read_bytes, (unsigned long)stats[i].write_bytes,
+               (unsigned long)stats[i].dcache_miss);
+        cycles += stats[i].cycles;
+        miss += stats[i].dcache_miss;
+        rd += stats[i].read_bytes;
+        wr += stats[i].write_bytes;
+    }
+    printf("CSV, %s, total, -, %lu, %lu, %lu, %lu\n", name, (unsigned long)cycles, (unsigned long)rd,
+           (unsigned long)wr, (unsigned long)miss);
+}
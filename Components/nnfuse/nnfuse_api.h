@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NNFUSE_API_H_
+#define _NNFUSE_API_H_
+
+#include <stdint.h>
+#include "riscv_nnfunctions.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+ * Fused conv + activation + pooling executor for NMSIS-NN int8 graphs
+ *
+ * A graph is a chain of ops, each reads the output of the previous one,
+ * all tensors are int8 NHWC with batch 1. When fuse is enabled, each
+ * convolution followed by an activation and/or a pooling is run row tile
+ * by row tile: the convolution rows needed by a tile of pooling rows are
+ * computed into the tile buffer, the activation is applied in place, and
+ * only the pooled rows are written to memory, so the full convolution
+ * output is never written and read back.
+ *
+ * The tile buffer also holds the scratch of NMSIS-NN functions, so it should
+ * be in DLM or other fast memory, the results are bit exact with running the
+ * ops one by one, since the same NMSIS-NN functions run on row slices.
+ */
+
+/* op type */
+#define NNFUSE_CONV             0   /* riscv_convolve_wrapper_s8, param is nnfuse_conv_t */
+#define NNFUSE_RELU             1   /* riscv_relu_q7, param is NULL */
+#define NNFUSE_RELU6            2   /* riscv_relu6_s8, param is NULL */
+#define NNFUSE_MAXPOOL          3   /* riscv_max_pool_s8, param is nnfuse_pool_t */
+#define NNFUSE_AVGPOOL          4   /* riscv_avgpool_s8, param is nnfuse_pool_t */
+
+/* return values */
+#define NNFUSE_OK               0
+#define NNFUSE_EINVAL           (-1)    /* invalid graph */
+#define NNFUSE_ETILE            (-2)    /* tile buffer is too small for scratch */
+#define NNFUSE_ERUN             (-3)    /* NMSIS-NN function failed */
+
+typedef struct nnfuse_conv {
+    nmsis_nn_conv_params conv;
+    nmsis_nn_per_channel_quant_params quant;
+    nmsis_nn_dims filter;               /* [C_OUT, HK, WK, C_IN] */
+    nmsis_nn_dims bias;                 /* [C_OUT] */
+    const int8_t *weights;
+    const int32_t *bias_data;
+} nnfuse_conv_t;
+
+typedef struct nnfuse_pool {
+    nmsis_nn_pool_params pool;
+    nmsis_nn_dims filter;               /* pooling window in h and w */
+} nnfuse_pool_t;
+
+typedef struct nnfuse_op {
+    uint16_t type;                      /* NNFUSE_CONV, NNFUSE_RELU, ... */
+    const void *param;
+    nmsis_nn_dims in;                   /* input dims [1, H, W, C] */
+    nmsis_nn_dims out;                  /* output dims [1, H, W, C], same as in for activation */
+} nnfuse_op_t;
+
+/* statistics of each op, or of a fused op group in the entry of its first op */
+typedef struct nnfuse_stats {
+    uint16_t ops;                       /* ops run in this group, 0 if this op is run in previous group */
+    uint16_t tiles;                     /* row tiles, 1 if not fused */
+    uint32_t read_bytes;                /* activation bytes read from memory */
+    uint32_t write_bytes;               /* activation bytes written to memory */
+    uint64_t cycles;                    /* cycles measured by nmsis_bench.h */
+    uint64_t dcache_miss;               /* D-Cache misses measured by HPM, 0 if not present */
+} nnfuse_stats_t;
+
+typedef struct nnfuse_graph {
+    const nnfuse_op_t *ops;
+    uint16_t op_cnt;
+    int8_t *tile;                       /* tile buffer, in DLM or other fast memory, 4 bytes aligned */
+    uint32_t tile_size;                 /* tile buffer size in bytes */
+    int8_t *act[2];                     /* ping-pong buffers for tensors between groups, each holds the largest one */
+} nnfuse_graph_t;
+
+/*
+ * Run graph from input to output, fuse conv + activation + pooling chains when fuse is not 0,
+ * stats can be NULL or have op_cnt entries, return NNFUSE_OK or other error code
+ */
+int32_t nnfuse_run(const nnfuse_graph_t *graph, const int8_t *input, int8_t *output, int fuse,
+                   nnfuse_stats_t *stats);
+
+/* Print stats of graph as CSV lines with name */
+void nnfuse_report(const nnfuse_graph_t *graph, const nnfuse_stats_t *stats, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_NNFUSE_API_H_ */
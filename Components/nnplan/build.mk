@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# nnplan middleware provides static arena planner for NMSIS-NN models,
+# NMSIS_LIB must contain nmsis_nn, see README.md in this directory
+MIDDLEWARE_NNPLAN := $(NUCLEI_SDK_MIDDLEWARE)/nnplan
+
+C_SRCDIRS += $(MIDDLEWARE_NNPLAN)
+
+INCDIRS += $(MIDDLEWARE_NNPLAN)
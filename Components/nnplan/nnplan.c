@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <ctype.h>
+#include "nnplan_api.h"
+
+#define NNPLAN_UNPLACED         0xFFFFFFFFUL
+#define NNPLAN_ALIGN_UP(x)      (((x) + NNPLAN_ALIGN - 1) & ~(uint32_t)(NNPLAN_ALIGN - 1))
+
+/* buffer i is tensor i when i < tensor_cnt, otherwise scratch of layer i - tensor_cnt */
+static uint32_t nnplan_size(const nnplan_t *plan, uint32_t i)
+{
+    if (i < plan->tensor_cnt) {
+        return plan->tensor_size[i];
+    }
+    return plan->layers[i - plan->tensor_cnt].scratch_size;
+}
+
+/* get the first and last layer where buffer i is live */
+static void nnplan_lifetime(const nnplan_t *plan, uint32_t i, uint32_t *first, uint32_t *last)
+{
+    const nnplan_layer_t *layer;
+    int32_t prod = -1, cons = -1;
+    uint32_t l, k;
+
+    if (i >= plan->tensor_cnt) {
+        *first = *last = i - plan->tensor_cnt;
+        return;
+    }
+    for (l = 0; l < plan->layer_cnt; l++) {
+        layer = &plan->layers[l];
+        if (layer->output == i) {
+            prod = l;
+        }
+        for (k = 0; k < NNPLAN_MAX_INPUTS; k++) {
+            if (layer->inputs[k] == i) {
+                cons = l;
+            }
+        }
+    }
+    /* model inputs are live from the first layer, model outputs to the last layer */
+    *first = (prod < 0) ? 0 : prod;
+    *last = (cons < 0) ? plan->layer_cnt - 1 : cons;
+}
+
+static int32_t nnplan_validate(const nnplan_t *plan)
+{
+    const nnplan_layer_t *layer;
+    uint32_t l, k, m, in;
+
+    if (plan == NULL || plan->layers == NULL || plan->tensor_size == NULL
+        || plan->layer_cnt == 0 || plan->tensor_cnt == 0 || plan->tensor_cnt == NNPLAN_NONE) {
+        return NNPLAN_EINVAL;
+    }
+    for (l = 0; l < plan->layer_cnt; l++) {
+        layer = &plan->layers[l];
+        if (layer->output >= plan->tensor_cnt) {
+            return NNPLAN_EINVAL;
+        }
+        for (k = 0; k < NNPLAN_MAX_INPUTS; k++) {
+            in = layer->inputs[k];
+            if (in == NNPLAN_NONE) {
+                continue;
+            }
+            if (in >= plan->tensor_cnt || in == layer->output) {
+                return NNPLAN_EINVAL;
+            }
+            /* input must be produced by an earlier layer or be a model input */
+            for (m = l; m < plan->layer_cnt; m++) {
+                if (plan->layers[m].output == in) {
+                    return NNPLAN_EINVAL;
+                }
+            }
+        }
+        /* each tensor is produced only once */
+        for (m = l + 1; m < plan->layer_cnt; m++) {
+            if (plan->layers[m].output == layer->output) {
+                return NNPLAN_EINVAL;
+            }
+        }
+    }
+    return NNPLAN_OK;
+}
+
+static int nnplan_live_together(uint32_t afirst, uint32_t alast, uint32_t bfirst, uint32_t blast)
+{
+    return afirst <= blast && bfirst <= alast;
+}
+
+int32_t nnplan_plan(nnplan_t *plan, uint32_t *offsets)
+{
+    uint32_t cnt, n, i, j, size, best, first, last, jfirst, jlast, offset, arena = 0;
+    int moved;
+
+    if (nnplan_validate(plan) != NNPLAN_OK || offsets == NULL) {
+        return NNPLAN_EINVAL;
+    }
+    cnt = NNPLAN_OFFSET_CNT(plan);
+    for (i = 0; i < cnt; i++) {
+        offsets[i] = NNPLAN_UNPLACED;
+    }
+    /* place the largest unplaced buffer first, at the lowest offset free during its lifetime */
+    for (n = 0; n < cnt; n++) {
+        best = cnt;
+        for (i = 0; i < cnt; i++) {
+            if (offsets[i] == NNPLAN_UNPLACED && (best == cnt || nnplan_size(plan, i) > nnplan_size(plan, best))) {
+                best = i;
+            }
+        }
+        size = nnplan_size(plan, best);
+        if (size == 0) {
+            offsets[best] = 0;
+            continue;
+        }
+        nnplan_lifetime(plan, best, &first, &last);
+        /*
+         * Move past each placed buffer which is live together and overlaps,
+         * every offset skipped overlaps that buffer, so the result is the lowest free one
+         */
+        offset = 0;
+        do {
+            moved = 0;
+            for (j = 0; j < cnt; j++) {
+                if (offsets[j] == NNPLAN_UNPLACED || j == best || nnplan_size(plan, j) == 0) {
+                    continue;
+                }
+                if (offset >= offsets[j] + nnplan_size(plan, j) || offsets[j] >= offset + size) {
+                    continue;
+                }
+                nnplan_lifetime(plan, j, &jfirst, &jlast);
+                if (nnplan_live_together(first, last, jfirst, jlast)) {
+                    offset = NNPLAN_ALIGN_UP(offsets[j] + nnplan_size(plan, j));
+                    moved = 1;
+                }
+            }
+        } while (moved);
+        offsets[best] = offset;
+        if (offset + size > arena) {
+            arena = offset + size;
+        }
+    }
+    plan->offsets = offsets;
+    plan->arena_size = NNPLAN_ALIGN_UP(arena);
+    return NNPLAN_OK;
+}
+
+int32_t nnplan_check(const nnplan_t *plan)
+{
+    uint32_t cnt, i, j, isize, jsize, ifirst, ilast, jfirst, jlast;
+
+    if (nnplan_validate(plan) != NNPLAN_OK || plan->offsets == NULL) {
+        return NNPLAN_EINVAL;
+    }
+    cnt = NNPLAN_OFFSET_CNT(plan);
+    for (i = 0; i < cnt; i++) {
+        isize = nnplan_size(plan, i);
+        if (isize == 0) {
+            continue;
+        }
+        if (plan->offsets[i] > plan->arena_size || isize > plan->arena_size - plan->offsets[i]) {
+            return NNPLAN_ESIZE;
+        }
+        nnplan_lifetime(plan, i, &ifirst, &ilast);
+        for (j = i + 1; j < cnt; j++) {
+            jsize = nnplan_size(plan, j);
+            if (jsize == 0 || plan->offsets[i] >= plan->offsets[j] + jsize
+                || plan->offsets[j] >= plan->offsets[i] + isize) {
+                continue;
+            }
+            nnplan_lifetime(plan, j, &jfirst, &jlast);
+            if (nnplan_live_together(ifirst, ilast, jfirst, jlast)) {
+                return NNPLAN_EOVERLAP;
+            }
+        }
+    }
+    return NNPLAN_OK;
+}
+
+uint32_t nnplan_naive_size(const nnplan_t *plan)
+{
+    uint32_t i, total = 0;
+
+    for (i = 0; i < NNPLAN_OFFSET_CNT(plan); i++) {
+        total += NNPLAN_ALIGN_UP(nnplan_size(plan, i));
+    }
+    return total;
+}
+
+void nnplan_dump(const nnplan_t *plan, const char *name)
+{
+    uint32_t i, first, last, cnt = NNPLAN_OFFSET_CNT(plan);
+    const char *c;
+
+    printf("nnplan %s: %u layers, %u tensors, arena %lu bytes, naive %lu bytes\n", name,
+           plan->layer_cnt, plan->tensor_cnt, (unsigned long)plan->arena_size, (unsigned long)nnplan_naive_size(plan));
+    for (i = 0; i < cnt; i++) {
+        nnplan_lifetime(plan, i, &first, &last);
+        printf("  %s %lu: layer %lu-%lu, size %lu, offset %lu\n", (i < plan->tensor_cnt) ? "tensor" : "scratch",
+               (unsigned long)((i < plan->tensor_cnt) ? i : i - plan->tensor_cnt), (unsigned long)first,
+               (unsigned long)last, (unsigned long)nnplan_size(plan, i), (unsigned long)plan->offsets[i]);
+    }
+    printf("#define ");
+    for (c = name; *c; c++) {
+        putchar(toupper((unsigned char)*c));
+    }
+    printf("_ARENA_SIZE %lu\n", (unsigned long)plan->arena_size);
+    printf("static const uint32_t %s_offsets[%lu] = {\n    /* tensors */\n   ", name, (unsigned long)cnt);
+    for (i = 0; i < cnt; i++) {
+        if (i == plan->tensor_cnt) {
+            printf("\n    /* scratch of layers */\n   ");
+        }
+        printf(" %lu,", (unsigned long)plan->offsets[i]);
+    }
+    printf("\n};\n");
+}
+
+riscv_nmsis_nn_status nnplan_invoke(const nnplan_t *plan, void *arena)
+{
+    const int8_t *inputs[NNPLAN_MAX_INPUTS];
+    const nnplan_layer_t *layer;
+    nmsis_nn_context ctx;
+    riscv_nmsis_nn_status status;
+    uint32_t l, k;
+
+    for (l = 0; l < plan->layer_cnt; l++) {
+        layer = &plan->layers[l];
+        if (layer->func == NULL) {
+            continue;
+        }
+        for (k = 0; k < NNPLAN_MAX_INPUTS; k++) {
+            inputs[k] = (layer->inputs[k] == NNPLAN_NONE) ? NULL : nnplan_tensor(plan, arena, layer->inputs[k]);
+        }
+        nnplan_context(plan, arena, l, &ctx);
+        status = layer->func(layer->param, &ctx, inputs, nnplan_tensor(plan, arena, layer->output));
+        if (status != RISCV_NMSIS_NN_SUCCESS) {
+            return status;
+        }
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NNPLAN_API_H_
+#define _NNPLAN_API_H_
+
+#include <stdint.h>
+#include "riscv_nn_types.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+ * Static arena planner for NMSIS-NN models
+ *
+ * A model is described as a list of layers in execution order, each layer
+ * reads up to NNPLAN_MAX_INPUTS tensors, writes one output tensor, and needs
+ * a scratch buffer of the size returned by the {API}_get_buffer_size() of
+ * the NMSIS-NN function it calls.
+ *
+ * A tensor is live from the layer producing it (or the first layer for model
+ * inputs) to the last layer reading it (or the last layer for model outputs),
+ * and the scratch of a layer is only live in that layer. nnplan_plan packs
+ * all of them into one arena, buffers whose lifetimes overlap never share
+ * memory, so the arena is usually much smaller than the sum of all buffers.
+ *
+ * The offsets can be planned at init, or planned once on host or target and
+ * printed by nnplan_dump as a constant table, then nnplan_invoke runs the
+ * model with the table and the arena, no memory is allocated.
+ */
+
+/* max input tensors of each layer */
+#ifndef NNPLAN_MAX_INPUTS
+#define NNPLAN_MAX_INPUTS       2
+#endif
+
+/* alignment in bytes of each buffer in arena, must be power of 2 */
+#ifndef NNPLAN_ALIGN
+#define NNPLAN_ALIGN            8
+#endif
+
+/* unused input tensor id */
+#define NNPLAN_NONE             0xFFFF
+
+/* return values */
+#define NNPLAN_OK               0
+#define NNPLAN_EINVAL           (-1)    /* invalid model description */
+#define NNPLAN_EOVERLAP         (-2)    /* offset table places live buffers in the same memory */
+#define NNPLAN_ESIZE            (-3)    /* buffer out of arena */
+
+/*
+ * Layer function called by nnplan_invoke, ctx is the scratch of this layer,
+ * its buf is NULL when scratch_size is 0, inputs are in the order of layer inputs
+ */
+typedef riscv_nmsis_nn_status (*nnplan_layer_func)(const void *param, const nmsis_nn_context *ctx,
+                                                   const int8_t *const *inputs, int8_t *output);
+
+typedef struct nnplan_layer {
+    nnplan_layer_func func;             /* layer function, can be NULL when only planning */
+    const void *param;                  /* parameter passed to func, such as weights and dims */
+    uint16_t inputs[NNPLAN_MAX_INPUTS]; /* input tensor ids, NNPLAN_NONE if unused */
+    uint16_t output;                    /* output tensor id, must not be any input of this layer */
+    uint32_t scratch_size;              /* scratch size in bytes from {API}_get_buffer_size(), 0 if none */
+} nnplan_layer_t;
+
+/*
+ * Model and its arena plan, offsets has tensor_cnt + layer_cnt entries,
+ * first the offset of each tensor, then the offset of scratch of each layer
+ */
+typedef struct nnplan {
+    const nnplan_layer_t *layers;       /* layers in execution order */
+    const uint32_t *tensor_size;        /* size in bytes of each tensor */
+    uint16_t layer_cnt;
+    uint16_t tensor_cnt;
+    const uint32_t *offsets;            /* offset table, set by nnplan_plan or to a table from nnplan_dump */
+    uint32_t arena_size;                /* arena size in bytes needed by the offset table */
+} nnplan_t;
+
+/* number of entries in offset table */
+#define NNPLAN_OFFSET_CNT(plan)         ((uint32_t)(plan)->tensor_cnt + (plan)->layer_cnt)
+
+/*
+ * Plan the arena for layers, tensor_size and counts set in plan, offsets must have
+ * NNPLAN_OFFSET_CNT(plan) entries, it is set to plan->offsets, and plan->arena_size
+ * is set, return NNPLAN_OK or NNPLAN_EINVAL
+ */
+int32_t nnplan_plan(nnplan_t *plan, uint32_t *offsets);
+
+/*
+ * Check the offset table and arena_size in plan against the model,
+ * such as a table from nnplan_dump after the model is changed,
+ * return NNPLAN_OK, NNPLAN_EINVAL, NNPLAN_EOVERLAP or NNPLAN_ESIZE
+ */
+int32_t nnplan_check(const nnplan_t *plan);
+
+/* Sum of all buffer sizes when each one has its own memory, to compare with arena_size */
+uint32_t nnplan_naive_size(const nnplan_t *plan);
+
+/* Print lifetime and offset of all buffers, and the offset table as C code named by name */
+void nnplan_dump(const nnplan_t *plan, const char *name);
+
+/* Get tensor in arena, such as to write model input or read model output */
+static inline int8_t *nnplan_tensor(const nnplan_t *plan, void *arena, uint16_t tensor)
+{
+    return (int8_t *)arena + plan->offsets[tensor];
+}
+
+/* Get scratch context of layer in arena */
+static inline void nnplan_context(const nnplan_t *plan, void *arena, uint16_t layer, nmsis_nn_context *ctx)
+{
+    uint32_t size = plan->layers[layer].scratch_size;
+
+    ctx->buf = size ? (int8_t *)arena + plan->offsets[plan->tensor_cnt + layer] : NULL;
+    ctx->size = (int32_t)size;
+}
+
+/*
+ * Run all layers with the tensors and scratch in arena, arena must have
+ * plan->arena_size bytes and NNPLAN_ALIGN aligned, model inputs must be written
+ * before, return the status of first failed layer or RISCV_NMSIS_NN_SUCCESS
+ */
+riscv_nmsis_nn_status nnplan_invoke(const nnplan_t *plan, void *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_NNPLAN_API_H_ */
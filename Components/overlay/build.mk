@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# overlay middleware loads groups of functions from flash into an ILM window at runtime,
+# see README.md in this directory
+MIDDLEWARE_OVERLAY := $(NUCLEI_SDK_MIDDLEWARE)/overlay
+
+C_SRCDIRS += $(MIDDLEWARE_OVERLAY)
+
+INCDIRS += $(MIDDLEWARE_OVERLAY)
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "overlay_api.h"
+
+overlay_t *overlay_resident = NULL;
+
+/* overlays loaded at least once, for statistics */
+static overlay_t *overlay_list = NULL;
+
+static void overlay_register(overlay_t *ovl)
+{
+    overlay_t *cur;
+
+    for (cur = overlay_list; cur != NULL; cur = cur->next) {
+        if (cur == ovl) {
+            return;
+        }
+    }
+    ovl->next = overlay_list;
+    overlay_list = ovl;
+}
+
+/* Copy word by word, overlay sections are 8 bytes aligned in ilm_overlay.ld */
+static void overlay_copy(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    uint32_t *wdst = (uint32_t *)dst;
+    const uint32_t *wsrc = (const uint32_t *)src;
+    size_t i;
+
+    if ((((unsigned long)dst | (unsigned long)src | size) & 0x3) != 0) {
+        memcpy(dst, src, size);
+        return;
+    }
+    for (i = 0; i < size / 4; i++) {
+        wdst[i] = wsrc[i];
+    }
+}
+
+int32_t overlay_load(overlay_t *ovl)
+{
+    uint64_t begin, cycles;
+    size_t size;
+
+    if (ovl == NULL) {
+        return OVERLAY_EINVAL;
+    }
+    if (overlay_resident == ovl) {
+        ovl->stat.hits++;
+        return OVERLAY_RESIDENT;
+    }
+    overlay_register(ovl);
+    if (overlay_resident != NULL) {
+        overlay_resident->stat.evicted++;
+    }
+    /* linker symbols are not defined when it is not linked as overlay */
+    if ((ovl->lma == NULL) || (ovl->lma == ovl->start)) {
+        overlay_resident = ovl;
+        ovl->stat.loads++;
+        return OVERLAY_INPLACE;
+    }
+
+    begin = __get_rv_cycle();
+    size = (size_t)(ovl->end - ovl->start);
+    /* mark window invalid while it is being overwritten */
+    overlay_resident = NULL;
+    overlay_copy(ovl->start, ovl->lma, size);
+    /* make sure the instruction fetch sees the new code, ILM is not cached */
+    __RWMB();
+    __FENCE_I();
+    overlay_resident = ovl;
+    cycles = __get_rv_cycle() - begin;
+
+    ovl->stat.loads++;
+    ovl->stat.bytes += size;
+    ovl->stat.cycles += cycles;
+    if (cycles > ovl->stat.max_cycles) {
+        ovl->stat.max_cycles = (uint32_t)cycles;
+    }
+    return OVERLAY_LOADED;
+}
+
+overlay_t *overlay_find(const char *name)
+{
+    overlay_t *cur;
+
+    for (cur = overlay_list; cur != NULL; cur = cur->next) {
+        if (strcmp(cur->name, name) == 0) {
+            return cur;
+        }
+    }
+    return NULL;
+}
+
+void overlay_get_stat(const overlay_t *ovl, overlay_stat_t *stat)
+{
+    if ((ovl != NULL) && (stat != NULL)) {
+        *stat = ovl->stat;
+    }
+}
+
+void overlay_clear_stats(void)
+{
+    overlay_t *cur;
+
+    for (cur = overlay_list; cur != NULL; cur = cur->next) {
+        memset(&cur->stat, 0, sizeof(cur->stat));
+    }
+}
+
+void overlay_dump_stats(void)
+{
+    overlay_t *cur;
+    unsigned long avg;
+
+    printf("CSV, Overlay, Size, Loads, Hits, Evicted, AvgLoadCycles, MaxLoadCycles\n");
+    for (cur = overlay_list; cur != NULL; cur = cur->next) {
+        avg = cur->stat.loads ? (unsigned long)(cur->stat.cycles / cur->stat.loads) : 0;
+        printf("CSV, %s, %lu, %lu, %lu, %lu, %lu, %lu\n", cur->name,
+               (unsigned long)(cur->end - cur->start), (unsigned long)cur->stat.loads,
+               (unsigned long)cur->stat.hits, (unsigned long)cur->stat.evicted,
+               avg, (unsigned long)cur->stat.max_cycles);
+    }
+}
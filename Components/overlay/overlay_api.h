@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _OVERLAY_API_H_
+#define _OVERLAY_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Runtime code overlay manager
+ *
+ * Functions are grouped into named overlays by OVERLAY_TEXT(name) section
+ * attribute, all overlays of an application share one window in ILM and are
+ * stored in flash, they are listed in ilm_overlay.ld of the application which
+ * is included by the flashxip linker script of evalsoc, see README.md.
+ *
+ * overlay_load copies an overlay from flash into the window, calls into an
+ * overlay go through OVERLAY_CALL which loads it only if it is not resident.
+ *
+ * When the application is not linked with overlays, such as in ilm download
+ * mode, the linker symbols of overlays are not defined, the overlay code runs
+ * in place and overlay_load copies nothing.
+ *
+ * The window is shared by all callers, so don't load overlays in interrupts,
+ * and in RTOS, load and call overlays in one task or hold a lock around them,
+ * otherwise a preempted task may return into code of another overlay.
+ */
+
+/* place function or rodata into overlay name */
+#define OVERLAY_TEXT(name)          __attribute__((section(".overlay." #name ".text"), noinline))
+#define OVERLAY_RODATA(name)        __attribute__((section(".overlay." #name ".rodata")))
+
+/* return values of overlay_load */
+#define OVERLAY_LOADED              0   /* copied into window */
+#define OVERLAY_RESIDENT            1   /* already in window */
+#define OVERLAY_INPLACE             2   /* not linked as overlay, run in place */
+#define OVERLAY_EINVAL              (-1)
+
+/* load statistics of one overlay, used to tune the grouping of functions */
+typedef struct overlay_stat {
+    uint32_t loads;             /* times copied into window */
+    uint32_t hits;              /* OVERLAY_CALL or overlay_load when already resident */
+    uint32_t evicted;           /* times replaced by another overlay */
+    uint32_t max_cycles;        /* max cycles of one load */
+    uint64_t cycles;            /* total cycles of loads */
+    uint64_t bytes;             /* total bytes copied */
+} overlay_stat_t;
+
+/* overlay object defined by OVERLAY_DEFINE, treat members as private */
+typedef struct overlay {
+    const char *name;
+    const uint8_t *lma;         /* load address in flash */
+    uint8_t *start;             /* run address in window */
+    uint8_t *end;
+    struct overlay *next;       /* list of overlays loaded at least once */
+    overlay_stat_t stat;
+} overlay_t;
+
+/*
+ * Define overlay name, its linker symbols are defined in ilm_overlay.ld:
+ * __overlay_<name>_lma, __overlay_<name>_start and __overlay_<name>_end
+ */
+#define OVERLAY_DEFINE(name)                                                            \
+    extern uint8_t __overlay_##name##_lma[] __attribute__((weak));                      \
+    extern uint8_t __overlay_##name##_start[] __attribute__((weak));                    \
+    extern uint8_t __overlay_##name##_end[] __attribute__((weak));                      \
+    overlay_t overlay_##name = { #name, __overlay_##name##_lma, __overlay_##name##_start, \
+                                 __overlay_##name##_end, NULL, { 0 } }
+#define OVERLAY_DECLARE(name)       extern overlay_t overlay_##name
+#define OVERLAY(name)               (&overlay_##name)
+
+/* overlay in window now, NULL if none */
+extern overlay_t *overlay_resident;
+
+/*
+ * Copy overlay into window if it is not resident, and execute fence.i,
+ * return OVERLAY_LOADED, OVERLAY_RESIDENT, OVERLAY_INPLACE or OVERLAY_EINVAL
+ */
+int32_t overlay_load(overlay_t *ovl);
+
+/* Veneer check before calling into overlay, only call overlay_load when it is not resident */
+static inline void overlay_ensure(overlay_t *ovl)
+{
+    if (overlay_resident == ovl) {
+        ovl->stat.hits++;
+    } else {
+        overlay_load(ovl);
+    }
+}
+
+/* Call func of overlay name through veneer check, such as OVERLAY_CALL(dsp, fir_run, buf, len) */
+#define OVERLAY_CALL(name, func, ...)   (overlay_ensure(OVERLAY(name)), func(__VA_ARGS__))
+
+/* Find an overlay loaded at least once by name, NULL if not found */
+overlay_t *overlay_find(const char *name);
+/* Get load statistics of an overlay */
+void overlay_get_stat(const overlay_t *ovl, overlay_stat_t *stat);
+/* Clear load statistics of all overlays loaded at least once */
+void overlay_clear_stats(void);
+/* Print size and load statistics of all overlays loaded at least once */
+void overlay_dump_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_OVERLAY_API_H_ */
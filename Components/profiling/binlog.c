@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "binlog_api.h"
+
+#define BINLOG_RING_MASK        (BINLOG_RING_WORDS - 1)
+#define BINLOG_HDR_WORDS        2   /* format address with arguments count, timestamp */
+#define BINLOG_NARGS_MASK       0x7UL
+#define BINLOG_CACHE_LINE       64
+/* records output in one binlog_drain call at most, so it returns when producers keep logging */
+#define BINLOG_DRAIN_MAX        (BINLOG_MAX_CORES * BINLOG_RING_WORDS / BINLOG_HDR_WORDS)
+
+#if (BINLOG_RING_WORDS & BINLOG_RING_MASK) != 0
+#error "BINLOG_RING_WORDS must be power of 2"
+#endif
+
+#if BINLOG_RING_WORDS < (BINLOG_HDR_WORDS + BINLOG_MAX_ARGS)
+#error "BINLOG_RING_WORDS is too small"
+#endif
+
+/*
+ * Ring of one hart, head is only written by the hart itself with interrupt
+ * disabled, tail is only written by the draining hart, they are placed in
+ * different cache lines to avoid false sharing.
+ * head and tail are free running word counters, ring is empty when head == tail.
+ */
+typedef struct binlog_ring {
+    volatile unsigned long head;
+    binlog_stats_t stats;                   /* producer private */
+    uint8_t pad0[BINLOG_CACHE_LINE - sizeof(unsigned long) - sizeof(binlog_stats_t)];
+    volatile unsigned long tail;
+    unsigned long reported;                 /* dropped records already reported, drainer private */
+    uint8_t pad1[BINLOG_CACHE_LINE - 2 * sizeof(unsigned long)];
+    unsigned long buf[BINLOG_RING_WORDS];
+} binlog_ring_t;
+
+/* must be placed in memory shared by all harts */
+static binlog_ring_t binlog_rings[BINLOG_MAX_CORES] __ALIGNED(BINLOG_CACHE_LINE);
+static volatile uint32_t binlog_draining = 0;
+static volatile uint32_t binlog_mode = BINLOG_DEFAULT_MODE;
+
+/*
+ * Timestamps of all harts must come from the same counter to merge the rings,
+ * only the low word is used since records are compared in wrap safe way
+ */
+#ifndef BINLOG_TIMESTAMP
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+#define BINLOG_TIMESTAMP()      (*(volatile unsigned long *)(&(SysTimer->MTIMER)))
+#else
+#define BINLOG_TIMESTAMP()      ((unsigned long)__get_rv_cycle())
+#endif
+#endif
+
+void binlog_write(const char *fmt, unsigned long nargs, const unsigned long *args)
+{
+    binlog_ring_t *ring;
+    unsigned long head, used, i;
+    unsigned long len = nargs + BINLOG_HDR_WORDS;
+    rv_csr_t mstatus;
+
+    /* interrupt disabled, so the record is not interleaved and the hart is not changed */
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+#if BINLOG_MAX_CORES > 1
+    i = __get_hart_index();
+    if (i >= BINLOG_MAX_CORES) {
+        __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+        return;
+    }
+    ring = &binlog_rings[i];
+#else
+    ring = &binlog_rings[0];
+#endif
+    head = ring->head;
+    used = head - ring->tail + len;
+    if (used > BINLOG_RING_WORDS) {
+        ring->stats.dropped++;
+    } else {
+        ring->buf[head & BINLOG_RING_MASK] = (unsigned long)fmt | nargs;
+        ring->buf[(head + 1) & BINLOG_RING_MASK] = BINLOG_TIMESTAMP();
+        for (i = 0; i < nargs; i++) {
+            ring->buf[(head + BINLOG_HDR_WORDS + i) & BINLOG_RING_MASK] = args[i];
+        }
+        ring->stats.written++;
+        if (used > ring->stats.max_used) {
+            ring->stats.max_used = used;
+        }
+        /* record must be visible before head moves */
+        __SMP_RWMB();
+        ring->head = head + len;
+    }
+    __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+}
+
+static int binlog_trylock(void)
+{
+#if defined(__riscv_atomic)
+    if (__AMOSWAP_W(&binlog_draining, 1) != 0) {
+        return -1;
+    }
+    __SMP_RWMB();
+    return 0;
+#else
+    int ret = -1;
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    if (binlog_draining == 0) {
+        binlog_draining = 1;
+        ret = 0;
+    }
+    __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+    return ret;
+#endif
+}
+
+static void binlog_unlock(void)
+{
+    __SMP_RWMB();
+    binlog_draining = 0;
+}
+
+static void binlog_output(unsigned long core, unsigned long hdr, unsigned long ts, const unsigned long *args)
+{
+    unsigned long i, nargs = hdr & BINLOG_NARGS_MASK;
+
+    if (binlog_mode == BINLOG_MODE_BINARY) {
+        printf(BINLOG_RECORD_TAG " %lu %lx %lx", core, ts, hdr);
+        for (i = 0; i < nargs; i++) {
+            printf(" %lx", args[i]);
+        }
+        printf("\n");
+    } else {
+        /* unused arguments are ignored by printf */
+        printf((const char *)(hdr & ~BINLOG_NARGS_MASK), args[0], args[1], args[2], args[3],
+               args[4], args[5], args[6]);
+    }
+}
+
+int binlog_drain(void)
+{
+    binlog_ring_t *ring;
+    unsigned long core, best, tail, hdr, ts, bestts = 0, i, nargs, dropped;
+    unsigned long args[BINLOG_MAX_ARGS];
+    int count;
+
+    if (binlog_trylock() != 0) {
+        return -1;
+    }
+    for (count = 0; count < BINLOG_DRAIN_MAX; count++) {
+        /* merge rings, choose the oldest record of all harts */
+        best = BINLOG_MAX_CORES;
+        for (core = 0; core < BINLOG_MAX_CORES; core++) {
+            ring = &binlog_rings[core];
+            if (ring->head == ring->tail) {
+                continue;
+            }
+            /* read record after head */
+            __SMP_RWMB();
+            ts = ring->buf[(ring->tail + 1) & BINLOG_RING_MASK];
+            if (best == BINLOG_MAX_CORES || (long)(ts - bestts) < 0) {
+                best = core;
+                bestts = ts;
+            }
+        }
+        if (best == BINLOG_MAX_CORES) {
+            break;
+        }
+        ring = &binlog_rings[best];
+        tail = ring->tail;
+        hdr = ring->buf[tail & BINLOG_RING_MASK];
+        nargs = hdr & BINLOG_NARGS_MASK;
+        for (i = 0; i < BINLOG_MAX_ARGS; i++) {
+            args[i] = (i < nargs) ? ring->buf[(tail + BINLOG_HDR_WORDS + i) & BINLOG_RING_MASK] : 0;
+        }
+        /* record must be consumed before the words are given back */
+        __SMP_RWMB();
+        ring->tail = tail + BINLOG_HDR_WORDS + nargs;
+        binlog_output(best, hdr, bestts, args);
+    }
+
+    for (core = 0; core < BINLOG_MAX_CORES; core++) {
+        ring = &binlog_rings[core];
+        dropped = ring->stats.dropped;
+        if (dropped != ring->reported) {
+            if (binlog_mode == BINLOG_MODE_BINARY) {
+                printf(BINLOG_DROP_TAG " %lu %lu\n", core, dropped - ring->reported);
+            } else {
+                printf("binlog: hart %lu dropped %lu records\n", core, dropped - ring->reported);
+            }
+            ring->reported = dropped;
+        }
+    }
+    binlog_unlock();
+    return count;
+}
+
+void binlog_set_mode(uint32_t mode)
+{
+    binlog_mode = mode;
+}
+
+int binlog_get_stats(uint32_t hart, binlog_stats_t *stats)
+{
+    if (hart >= BINLOG_MAX_CORES || stats == NULL) {
+        return -1;
+    }
+    *stats = binlog_rings[hart].stats;
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _BINLOG_API_H_
+#define _BINLOG_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Deferred binary logger
+ *
+ * BINLOG(fmt, ...) only stores the address of the format string, a
+ * timestamp and the raw arguments into the ring buffer of current hart,
+ * which costs tens of cycles, the formatting and uart output are done
+ * later by binlog_drain(), called in idle hook or a low priority task.
+ *
+ * binlog_drain() can print the formatted text directly, or print raw
+ * records in hex, which are decoded on host by binlog_parse.py using
+ * the format strings found in the elf file.
+ *
+ * Limitations:
+ * - at most 7 arguments, each one is stored as unsigned long, so float,
+ *   double and 64bit integer on rv32 are not supported
+ * - %s argument must point to a string which is not changed later,
+ *   and in binary mode it must be a constant string in the elf file
+ * - format must be a string literal
+ */
+
+/* max number of harts, hart index must be less than it */
+#ifndef BINLOG_MAX_CORES
+#ifdef SMP_CPU_CNT
+#define BINLOG_MAX_CORES        SMP_CPU_CNT
+#else
+#define BINLOG_MAX_CORES        1
+#endif
+#endif
+
+/* ring buffer size of each hart in unsigned long words, must be power of 2,
+ * when full, new records are dropped and counted */
+#ifndef BINLOG_RING_WORDS
+#define BINLOG_RING_WORDS       1024
+#endif
+
+/* max arguments of one record, arguments count is stored in low 3 bits of format address */
+#define BINLOG_MAX_ARGS         7
+
+/* output mode of binlog_drain */
+#define BINLOG_MODE_TEXT        0   /* print formatted text */
+#define BINLOG_MODE_BINARY      1   /* print raw records in hex, decoded by binlog_parse.py */
+
+#ifndef BINLOG_DEFAULT_MODE
+#define BINLOG_DEFAULT_MODE     BINLOG_MODE_TEXT
+#endif
+
+/* line prefix of raw record and dropped record in binary mode, see binlog_parse.py */
+#define BINLOG_RECORD_TAG       "#BL"
+#define BINLOG_DROP_TAG         "#BLD"
+
+#define _BINLOG_CAT_(a, b)      a##b
+#define _BINLOG_CAT(a, b)       _BINLOG_CAT_(a, b)
+#define _BINLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, N, ...)  N
+#define _BINLOG_NARGS(...)      _BINLOG_NARGS_(__VA_ARGS__, 7, 6, 5, 4, 3, 2, 1, 0, 0)
+
+/* format is aligned to 8 bytes, so the low 3 bits of its address hold the arguments count */
+#define _BINLOG_EMIT(fmt, n, ...)                                                       \
+    do {                                                                                \
+        static const char _binlog_fmt[] __attribute__((aligned(8))) = fmt;              \
+        const unsigned long _binlog_args[] = { __VA_ARGS__ };                           \
+        binlog_write(_binlog_fmt, n, _binlog_args);                                     \
+    } while (0)
+
+#define _BINLOG_A(x)            ((unsigned long)(x))
+#define _BINLOG_0(f)            _BINLOG_EMIT(f, 0, 0)
+#define _BINLOG_1(f, a)         _BINLOG_EMIT(f, 1, _BINLOG_A(a))
+#define _BINLOG_2(f, a, b)      _BINLOG_EMIT(f, 2, _BINLOG_A(a), _BINLOG_A(b))
+#define _BINLOG_3(f, a, b, c)   _BINLOG_EMIT(f, 3, _BINLOG_A(a), _BINLOG_A(b), _BINLOG_A(c))
+#define _BINLOG_4(f, a, b, c, d)                                                        \
+    _BINLOG_EMIT(f, 4, _BINLOG_A(a), _BINLOG_A(b), _BINLOG_A(c), _BINLOG_A(d))
+#define _BINLOG_5(f, a, b, c, d, e)                                                     \
+    _BINLOG_EMIT(f, 5, _BINLOG_A(a), _BINLOG_A(b), _BINLOG_A(c), _BINLOG_A(d), _BINLOG_A(e))
+#define _BINLOG_6(f, a, b, c, d, e, g)                                                  \
+    _BINLOG_EMIT(f, 6, _BINLOG_A(a), _BINLOG_A(b), _BINLOG_A(c), _BINLOG_A(d), _BINLOG_A(e), \
+                 _BINLOG_A(g))
+#define _BINLOG_7(f, a, b, c, d, e, g, h)                                               \
+    _BINLOG_EMIT(f, 7, _BINLOG_A(a), _BINLOG_A(b), _BINLOG_A(c), _BINLOG_A(d), _BINLOG_A(e), \
+                 _BINLOG_A(g), _BINLOG_A(h))
+
+/*
+ * Log a message in printf format, eg. BINLOG("irq %d at %lu\n", irq, now);
+ * it can be called in task or interrupt on any hart
+ */
+#define BINLOG(...)             _BINLOG_CAT(_BINLOG_, _BINLOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+
+/* statistics of the ring buffer of one hart */
+typedef struct binlog_stats {
+    unsigned long written;      /* records written */
+    unsigned long dropped;      /* records dropped since ring is full */
+    unsigned long max_used;     /* max used words of ring */
+} binlog_stats_t;
+
+/* Write a record into ring buffer of current hart, called by BINLOG macro */
+void binlog_write(const char *fmt, unsigned long nargs, const unsigned long *args);
+
+/*
+ * Output all records in ring buffers of all harts in timestamp order,
+ * it can be called on any hart, but only one hart drains at the same time,
+ * return the number of records output, or -1 if another hart is draining
+ */
+int binlog_drain(void);
+
+/* Set output mode of binlog_drain, BINLOG_MODE_TEXT or BINLOG_MODE_BINARY */
+void binlog_set_mode(uint32_t mode);
+
+/* Get ring buffer statistics of hart, return 0 if successful, otherwise -1 */
+int binlog_get_stats(uint32_t hart, binlog_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_BINLOG_API_H_ */
@@ -0,0 +1,171 @@
+#!/bin/env python3
+
+import os
+import re
+import struct
+import sys
+
+# see BINLOG_RECORD_TAG, BINLOG_DROP_TAG and BINLOG_NARGS_MASK in binlog_api.h and binlog.c
+RECORD_TAG = "#BL"
+DROP_TAG = "#BLD"
+NARGS_MASK = 0x7
+
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+# C printf conversion specification, float is not supported since arguments are stored as unsigned long
+CFMT_RE = re.compile(r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?"
+                     r"(?P<len>hh|h|ll|l|j|z|t|L)?(?P<conv>[diouxXcspfFeEgGaA%])")
+
+
+class ElfImage:
+    """
+    Minimal ELF reader which maps allocated section addresses to file content,
+    used to read format strings and constant %s arguments.
+    """
+
+    def __init__(self, elffile):
+        with open(elffile, "rb") as ef:
+            self.data = ef.read()
+        if self.data[0:4] != b"\x7fELF":
+            raise ValueError(f"{elffile} is not an elf file")
+        self.xlen = 64 if self.data[4] == 2 else 32
+        self.endian = "<" if self.data[5] == 1 else ">"
+        self.sections = []
+        if self.xlen == 64:
+            shoff, = struct.unpack_from(self.endian + "Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(self.endian + "HH", self.data, 0x3A)
+            shfmt = "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(self.endian + "I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(self.endian + "HH", self.data, 0x2E)
+            shfmt = "IIIIIIIIII"
+        for i in range(shnum):
+            _name, shtype, flags, addr, offset, size, _link, _info, _align, _entsize = \
+                struct.unpack_from(self.endian + shfmt, self.data, shoff + i * shentsize)
+            if (flags & SHF_ALLOC) and shtype != SHT_NOBITS and size > 0:
+                self.sections.append((addr, offset, size))
+
+    def read_string(self, addr):
+        """
+        Reads the null terminated string at addr, returns None if addr is not in the elf file.
+        """
+        for secaddr, offset, size in self.sections:
+            if secaddr <= addr < secaddr + size:
+                start = offset + addr - secaddr
+                end = self.data.find(b"\x00", start, offset + size)
+                if end < 0:
+                    end = offset + size
+                return self.data[start:end].decode("utf-8", errors="replace")
+        return None
+
+
+def format_record(elf, fmt, args):
+    """
+    Formats the arguments of a record like printf on target.
+
+    Args:
+        elf (ElfImage): elf image used to resolve %s arguments.
+        fmt (str): C printf format string.
+        args (list): raw argument words.
+
+    Returns:
+        str: formatted message.
+    """
+    xlen = elf.xlen
+    args = list(args)
+
+    def next_arg():
+        return args.pop(0) if args else 0
+
+    def convert(match):
+        flags, width, prec, length, conv = match.group("flags", "width", "prec", "len", "conv")
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(to_signed(next_arg(), 32))
+        if prec == "*":
+            prec = str(to_signed(next_arg(), 32))
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+        value = next_arg()
+        if conv in "fFeEgGaA":
+            return "<float>"
+        if conv == "s":
+            text = elf.read_string(value)
+            return (spec + "s") % (text if text is not None else f"<0x{value:x}>")
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "p":
+            return (spec + "s") % f"0x{value:x}"
+        bits = {"hh": 8, "h": 16, None: 32, "L": 64, "ll": 64}.get(length, xlen)
+        value &= (1 << bits) - 1
+        if conv in "di":
+            return (spec + "d") % to_signed(value, bits)
+        return (spec + conv.replace("u", "d")) % value
+
+    return CFMT_RE.sub(convert, fmt)
+
+
+def to_signed(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+
+def parse_binlog(elffile, logfile, timer_freq=0):
+    """
+    Decodes the raw records printed by binlog_drain in BINLOG_MODE_BINARY,
+    other lines in log file are printed as they are.
+
+    Args:
+        elffile (str): Path to the elf file of the application which generated the log.
+        logfile (str): Path to the console log file.
+        timer_freq (int): Frequency of timestamp in Hz, if not 0, timestamp is printed in us.
+
+    Returns:
+        bool: True if processing was successful, False otherwise.
+    """
+    for fn in (elffile, logfile):
+        if not os.path.isfile(fn):
+            print(f"{fn} does not exist. Please check!")
+            return False
+    try:
+        elf = ElfImage(elffile)
+    except (ValueError, struct.error) as exc:
+        print(f"Error: {exc}")
+        return False
+
+    with open(logfile, "r", errors="replace") as lf:
+        for line in lf:
+            line = line.rstrip("\r\n")
+            parts = line.split()
+            if len(parts) >= 3 and parts[0] == DROP_TAG:
+                print(f"# hart {parts[1]} dropped {parts[2]} records")
+                continue
+            if len(parts) < 4 or parts[0] != RECORD_TAG:
+                print(line)
+                continue
+            try:
+                core = int(parts[1])
+                ts = int(parts[2], 16)
+                hdr = int(parts[3], 16)
+                args = [int(x, 16) for x in parts[4:]]
+            except ValueError:
+                print(line)
+                continue
+            fmt = elf.read_string(hdr & ~NARGS_MASK)
+            if fmt is None:
+                msg = f"<unknown format 0x{hdr & ~NARGS_MASK:x}> " + " ".join(f"0x{x:x}" for x in args)
+            else:
+                msg = format_record(elf, fmt, args[:hdr & NARGS_MASK]).rstrip("\n")
+            stamp = f"{ts * 1000000 // timer_freq}us" if timer_freq else f"{ts}"
+            print(f"[{stamp} hart{core}] {msg}")
+    return True
+
+# NOTE: the log contains lines like "#BL 0 1a2b 80001238 1 2" printed by binlog_drain() in BINLOG_MODE_BINARY
+# the elf must be the exact one running on target, timer frequency is optional, such as 32768 for system timer
+# python nuclei_sdk/Components/profiling/binlog_parse.py demo_binlog.elf binlog.log 32768
+if __name__ == "__main__":
+    if len(sys.argv) > 2:
+        parse_binlog(sys.argv[1], sys.argv[2], int(sys.argv[3]) if len(sys.argv) > 3 else 0)
+    else:
+        print(f"Help: {sys.argv[0]} app.elf logfile [timer_freq]")
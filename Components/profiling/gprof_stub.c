@@ -9,6 +9,13 @@
 // or you can add gprof_sample(pc) in your own period timer interrupt function
 #define SAMPLE_USING_SYSTIMER
 
+// system timer interrupt is already used as tick by RTOS or owned by hrtimer component,
+// so eclic_mtip_handler is not defined here, and gprof_on/gprof_off do nothing
+#if defined(RTOS_FREERTOS) || defined(RTOS_UCOSII) || defined(RTOS_THREADX) || defined(RTOS_RTTHREAD) \
+    || defined(WITH_COMPONENT_HRTIMER)
+#undef SAMPLE_USING_SYSTIMER
+#endif
+
 extern void gprof_sample(unsigned long pc);
 
 #ifdef USING_RTOS
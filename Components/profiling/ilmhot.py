@@ -0,0 +1,249 @@
+#!/bin/env python3
+
+import os
+import re
+import sys
+import bisect
+import struct
+import argparse
+import subprocess
+
+GMONVERSION = 0x00051879
+# see struct gmonhdr and struct rawarc in gprof.c, size_t and long follow xlen
+GMON_FMTS = {
+    4: ("<IIiiiiii", "<IIi"),
+    8: ("<QQiiiiii", "<QQq"),
+}
+HISTCOUNTER_FMT = "<H"
+
+# prefixes of input sections generated by -ffunction-sections for a function
+TEXT_PREFIXES = [".text.", ".text.hot."]
+RODATA_PREFIXES = [".rodata.", ".srodata."]
+
+
+def parse_gmon(gmonfile):
+    """
+    Parses gmon.out written by gprof_collect of gprof.c.
+
+    Returns:
+        tuple: (lowpc, highpc, profrate, histogram counts, list of (frompc, selfpc, count)), None if invalid.
+    """
+    if not os.path.isfile(gmonfile):
+        print(f"{gmonfile} does not exist. Please check!", file=sys.stderr)
+        return None
+    with open(gmonfile, "rb") as gf:
+        data = gf.read()
+
+    for xlen_bytes, (hdrfmt, arcfmt) in GMON_FMTS.items():
+        hdrsize = struct.calcsize(hdrfmt)
+        if len(data) < hdrsize:
+            continue
+        lowpc, highpc, ncnt, version, profrate = struct.unpack_from(hdrfmt, data, 0)[:5]
+        if version == GMONVERSION and hdrsize <= ncnt <= len(data):
+            break
+    else:
+        print(f"Error: {gmonfile} is not a valid gmon.out file", file=sys.stderr)
+        return None
+
+    nbins = (ncnt - hdrsize) // struct.calcsize(HISTCOUNTER_FMT)
+    hist = list(struct.unpack_from(f"<{nbins}H", data, hdrsize))
+    arcs = []
+    arcsize = struct.calcsize(arcfmt)
+    for offset in range(ncnt, len(data) - arcsize + 1, arcsize):
+        arcs.append(struct.unpack_from(arcfmt, data, offset))
+    return lowpc, highpc, profrate, hist, arcs
+
+
+class Functions(object):
+    """
+    Function symbols with sizes of elf file read by nm, sorted by address,
+    names are not demangled since they are part of the section names.
+    """
+    def __init__(self, elffile, nm):
+        self.addrs = []
+        self.sizes = []
+        self.names = []
+        self.ranges = []
+        symbols = dict()
+        output = subprocess.check_output([nm, "-n", "-S", "--defined-only", elffile], universal_newlines=True)
+        for line in output.splitlines():
+            fields = line.split()
+            if len(fields) == 3:
+                symbols[fields[2]] = int(fields[0], 16)
+            if len(fields) != 4 or fields[2] not in "tTwW":
+                continue
+            self.addrs.append(int(fields[0], 16))
+            self.sizes.append(int(fields[1], 16))
+            self.names.append(fields[3])
+        # only functions in movable code ranges are candidates, .init and vector table are excluded
+        for start, end in (("_text", "_etext"), ("_ilm_text", "_eilm_text")):
+            if start in symbols and end in symbols and symbols[start] < symbols[end]:
+                self.ranges.append((symbols[start], symbols[end]))
+
+    def lookup(self, addr):
+        idx = bisect.bisect_right(self.addrs, addr) - 1
+        if idx < 0 or addr >= self.addrs[idx] + self.sizes[idx]:
+            return None
+        return idx
+
+    def movable(self, idx):
+        if not self.ranges:
+            return True
+        return any(start <= self.addrs[idx] < end for start, end in self.ranges)
+
+
+def parse_map_sections(mapfile):
+    """
+    Sizes of input sections in the memory map part of linker map file, summed by section name.
+    """
+    sizes = dict()
+    pending = None
+    started = False
+    with open(mapfile, "r", errors="replace") as mf:
+        for line in mf:
+            if not started:
+                started = line.startswith("Linker script and memory map")
+                continue
+            # long section names are followed by address and size on next line
+            match = re.match(r"^ (\.\S+)\s*$", line)
+            if match:
+                pending = match.group(1)
+                continue
+            match = re.match(r"^ (\.\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+\S", line)
+            name = pending
+            pending = None
+            if match is None:
+                continue
+            if match.group(1):
+                name = match.group(1)
+            if name is None:
+                continue
+            sizes[name] = sizes.get(name, 0) + int(match.group(3), 16)
+    return sizes
+
+
+def rank_functions(gmon, funcs):
+    """
+    Self samples and call counts of each function.
+
+    Returns:
+        dict: function index -> [samples, calls]
+    """
+    lowpc, highpc, _profrate, hist, arcs = gmon
+    stats = dict()
+    if hist:
+        scale = (highpc - lowpc) / len(hist)
+        for idx, count in enumerate(hist):
+            if count == 0:
+                continue
+            func = funcs.lookup(lowpc + int(idx * scale))
+            if func is not None:
+                stats.setdefault(func, [0, 0])[0] += count
+    for _frompc, selfpc, count in arcs:
+        func = funcs.lookup(selfpc)
+        if func is not None:
+            stats.setdefault(func, [0, 0])[1] += count
+    return stats
+
+
+def select_hot(stats, funcs, sections, budget, min_percent):
+    """
+    Greedy selection by samples per byte, then by calls per byte for functions
+    which are called but too short to be hit by samples, until budget is used.
+
+    Returns:
+        tuple: (list of (name, size, samples, calls, section names), used bytes)
+    """
+    total = sum(stat[0] for stat in stats.values())
+    candidates = []
+    for idx, (samples, calls) in stats.items():
+        name = funcs.names[idx]
+        if not funcs.movable(idx):
+            continue
+        if total and samples * 100.0 / total < min_percent and samples > 0:
+            continue
+        if sections is not None:
+            names = [prefix + name for prefix in TEXT_PREFIXES + RODATA_PREFIXES if prefix + name in sections]
+            if not any(sec.startswith(".text") for sec in names):
+                # not compiled with -ffunction-sections, or in a section of its own like .text.startup
+                continue
+            # 8 bytes for alignment of each input section
+            size = sum(sections[sec] + 8 for sec in names)
+        else:
+            names = [prefix + name for prefix in TEXT_PREFIXES + RODATA_PREFIXES]
+            size = funcs.sizes[idx] + 8
+        candidates.append((name, size, samples, calls, names))
+
+    candidates.sort(key=lambda cand: (-(cand[2] / cand[1]), -(cand[3] / cand[1])))
+    selected = []
+    used = 0
+    for cand in candidates:
+        if cand[2] == 0 and cand[3] == 0:
+            continue
+        if used + cand[1] > budget:
+            continue
+        selected.append(cand)
+        used += cand[1]
+    return selected, used
+
+
+def write_fragment(outfile, selected, used, budget, total):
+    hot = sum(cand[2] for cand in selected)
+    with open(outfile, "w") as of:
+        of.write("/*\n")
+        of.write(f" * Generated by ilmhot.py, {len(selected)} functions, {used} of {budget} bytes,\n")
+        of.write(f" * {hot} of {total} samples, included by .ilm_text of evalsoc linker script\n")
+        of.write(" */\n")
+        for name, _size, samples, calls, names in selected:
+            of.write(f"/* {name}: {samples} samples, {calls} calls */\n")
+            of.write("*(" + " ".join(names) + ")\n")
+
+
+def parse_size(value):
+    match = re.match(r"^(0x[0-9a-fA-F]+|\d+)([kKmM]?)$", value)
+    if match is None:
+        raise argparse.ArgumentTypeError(f"invalid size {value}")
+    size = int(match.group(1), 0)
+    unit = match.group(2).upper()
+    return size * (1024 if unit == "K" else 1024 * 1024 if unit == "M" else 1)
+
+
+# NOTE: gmon.out is collected by gprof_collect of an application built with -pg
+# python nuclei_sdk/Components/profiling/ilmhot.py gmon.out app.elf app.map -b 16K -o ilm_hot.ld
+# then put ilm_hot.ld into application directory and rebuild it in flashxip or ddr download mode,
+# the application code built without -pg uses the same function section names
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Generate linker fragment placing hot functions into ILM from gmon.out")
+    parser.add_argument("gmonfile", help="gmon.out collected by gprof_collect")
+    parser.add_argument("elffile", help="elf file of the profiled application")
+    parser.add_argument("mapfile", nargs="?", help="linker map file of the profiled application, used to get "
+                        "exact input section sizes including rodata, function sizes are used if not given")
+    parser.add_argument("-b", "--budget", type=parse_size, default=parse_size("16K"),
+                        help="ILM bytes used for hot code, such as 32K, default 16K")
+    parser.add_argument("--min-percent", type=float, default=0.0,
+                        help="skip sampled functions below this percent of total samples, default 0")
+    parser.add_argument("--nm", default="riscv64-unknown-elf-nm", help="nm tool to read symbols, default %(default)s")
+    parser.add_argument("-o", "--output", default="ilm_hot.ld", help="output linker fragment, default %(default)s")
+    args = parser.parse_args()
+
+    gmon = parse_gmon(args.gmonfile)
+    if gmon is None:
+        sys.exit(1)
+    try:
+        funcs = Functions(args.elffile, args.nm)
+    except (OSError, subprocess.CalledProcessError) as exc:
+        print(f"Error: unable to read symbols of {args.elffile} by {args.nm}: {exc}", file=sys.stderr)
+        sys.exit(1)
+    sections = parse_map_sections(args.mapfile) if args.mapfile else None
+    stats = rank_functions(gmon, funcs)
+    selected, used = select_hot(stats, funcs, sections, args.budget, args.min_percent)
+    total = sum(gmon[3])
+    write_fragment(args.output, selected, used, args.budget, total)
+
+    print("# function size samples calls", file=sys.stderr)
+    for name, size, samples, calls, _names in selected:
+        print(f"{name} {size} {samples} {calls}", file=sys.stderr)
+    hot = sum(cand[2] for cand in selected)
+    percent = hot * 100.0 / total if total else 0.0
+    print(f"# {len(selected)} functions, {used} of {args.budget} bytes, {percent:.1f}% of {total} samples, "
+          f"write {args.output} done", file=sys.stderr)
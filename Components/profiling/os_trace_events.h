@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _OS_TRACE_EVENTS_H_
+#define _OS_TRACE_EVENTS_H_
+
+/*
+ * uC/OS-II glue of rtostrace, it is included by os_trace.h of uC/OS-II
+ * when OS_TRACE_EN is set to 1 in os_cfg.h.
+ * Pend and post calls are recorded at entry, the error code of pend is
+ * recorded when it returns, and the error code of post only if it failed.
+ */
+#include "rtostrace_api.h"
+
+#define RTOSTRACE_UCOSII_TASK(ev, p_tcb, prio)  \
+    rtostrace_record((ev), (uint16_t)(prio), RTOSTRACE_ID(p_tcb))
+#define RTOSTRACE_UCOSII_OBJ(ev, p_obj, kind)   \
+    rtostrace_record((ev), (uint16_t)(kind), RTOSTRACE_ID(p_obj))
+#define RTOSTRACE_UCOSII_PEND_EXIT(err, kind)   \
+    rtostrace_record(RTOSTRACE_EV_OBJ_RESULT, (uint16_t)(kind), (uint32_t)(err))
+#define RTOSTRACE_UCOSII_POST_EXIT(err, kind)                                       \
+    do {                                                                            \
+        if ((err) != OS_ERR_NONE) {                                                 \
+            rtostrace_record(RTOSTRACE_EV_OBJ_RESULT, (uint16_t)(kind), (uint32_t)(err)); \
+        }                                                                           \
+    } while (0)
+
+/* interrupts, OSIntEnter and OSIntExit */
+#define OS_TRACE_ISR_ENTER()                    rtostrace_isr_enter()
+#define OS_TRACE_ISR_EXIT()                     rtostrace_isr_exit()
+#define OS_TRACE_ISR_EXIT_TO_SCHEDULER()        rtostrace_isr_exit()
+
+/* tasks, OS_TRACE_TASK_SWITCHED_IN is called in OSTaskSwHook */
+#define OS_TRACE_TASK_CREATE(p_tcb)             RTOSTRACE_UCOSII_TASK(RTOSTRACE_EV_TASK_CREATE, p_tcb, (p_tcb)->OSTCBPrio)
+#define OS_TRACE_TASK_DEL(p_tcb)                RTOSTRACE_UCOSII_TASK(RTOSTRACE_EV_TASK_DELETE, p_tcb, 0)
+#define OS_TRACE_TASK_READY(p_tcb)              RTOSTRACE_UCOSII_TASK(RTOSTRACE_EV_TASK_READY, p_tcb, (p_tcb)->OSTCBPrio)
+#define OS_TRACE_TASK_SWITCHED_IN(p_tcb)        RTOSTRACE_UCOSII_TASK(RTOSTRACE_EV_TASK_SWITCH, p_tcb, (p_tcb)->OSTCBPrio)
+#define OS_TRACE_TASK_DLY(dly_ticks)            RTOSTRACE_UCOSII_TASK(RTOSTRACE_EV_TASK_SUSPEND, OSTCBCur, 0)
+#define OS_TRACE_TASK_SUSPEND(p_tcb)            RTOSTRACE_UCOSII_TASK(RTOSTRACE_EV_TASK_SUSPEND, p_tcb, 0)
+#if OS_TASK_NAME_EN > 0u
+#define OS_TRACE_TASK_NAME_SET(p_tcb)           \
+    rtostrace_set_name(RTOSTRACE_ID(p_tcb), RTOSTRACE_OBJ_TASK, (const char *)(p_tcb)->OSTCBTaskName)
+#endif
+
+/* names of events, flag groups and memory partitions */
+#define OS_TRACE_EVENT_NAME_SET(p_event, p_name)    \
+    rtostrace_set_name(RTOSTRACE_ID(p_event), RTOSTRACE_OBJ_OTHER, (const char *)(p_name))
+
+/* priority inheritance of mutex */
+#define OS_TRACE_MUTEX_TASK_PRIO_INHERIT(p_tcb, prio)       RTOSTRACE_UCOSII_TASK(RTOSTRACE_EV_PRIO_INHERIT, p_tcb, prio)
+#define OS_TRACE_MUTEX_TASK_PRIO_DISINHERIT(p_tcb, prio)    RTOSTRACE_UCOSII_TASK(RTOSTRACE_EV_PRIO_DISINHERIT, p_tcb, prio)
+
+/* semaphore */
+#define OS_TRACE_SEM_POST_ENTER(p_sem)              RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_POST, p_sem, RTOSTRACE_OBJ_SEM)
+#define OS_TRACE_SEM_POST_EXIT(RetVal)              RTOSTRACE_UCOSII_POST_EXIT(RetVal, RTOSTRACE_OBJ_SEM)
+#define OS_TRACE_SEM_PEND_ENTER(p_sem, timeout)     RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_PEND, p_sem, RTOSTRACE_OBJ_SEM)
+#define OS_TRACE_SEM_PEND_EXIT(RetVal)              RTOSTRACE_UCOSII_PEND_EXIT(RetVal, RTOSTRACE_OBJ_SEM)
+
+/* mutex */
+#define OS_TRACE_MUTEX_POST_ENTER(p_mutex)          RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_POST, p_mutex, RTOSTRACE_OBJ_MUTEX)
+#define OS_TRACE_MUTEX_POST_EXIT(RetVal)            RTOSTRACE_UCOSII_POST_EXIT(RetVal, RTOSTRACE_OBJ_MUTEX)
+#define OS_TRACE_MUTEX_PEND_ENTER(p_mutex, timeout) RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_PEND, p_mutex, RTOSTRACE_OBJ_MUTEX)
+#define OS_TRACE_MUTEX_PEND_EXIT(RetVal)            RTOSTRACE_UCOSII_PEND_EXIT(RetVal, RTOSTRACE_OBJ_MUTEX)
+
+/* message queue */
+#define OS_TRACE_Q_POST_ENTER(p_q)                  RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_POST, p_q, RTOSTRACE_OBJ_QUEUE)
+#define OS_TRACE_Q_POST_EXIT(RetVal)                RTOSTRACE_UCOSII_POST_EXIT(RetVal, RTOSTRACE_OBJ_QUEUE)
+#define OS_TRACE_Q_POST_FRONT_ENTER(p_q)            RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_POST, p_q, RTOSTRACE_OBJ_QUEUE)
+#define OS_TRACE_Q_POST_FRONT_EXIT(RetVal)          RTOSTRACE_UCOSII_POST_EXIT(RetVal, RTOSTRACE_OBJ_QUEUE)
+#define OS_TRACE_Q_POST_OPT_ENTER(p_q, opt)         RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_POST, p_q, RTOSTRACE_OBJ_QUEUE)
+#define OS_TRACE_Q_POST_OPT_EXIT(RetVal)            RTOSTRACE_UCOSII_POST_EXIT(RetVal, RTOSTRACE_OBJ_QUEUE)
+#define OS_TRACE_Q_PEND_ENTER(p_q, timeout)         RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_PEND, p_q, RTOSTRACE_OBJ_QUEUE)
+#define OS_TRACE_Q_PEND_EXIT(RetVal)                RTOSTRACE_UCOSII_PEND_EXIT(RetVal, RTOSTRACE_OBJ_QUEUE)
+
+/* mailbox */
+#define OS_TRACE_MBOX_POST_ENTER(p_mbox)            RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_POST, p_mbox, RTOSTRACE_OBJ_MAILBOX)
+#define OS_TRACE_MBOX_POST_EXIT(RetVal)             RTOSTRACE_UCOSII_POST_EXIT(RetVal, RTOSTRACE_OBJ_MAILBOX)
+#define OS_TRACE_MBOX_POST_OPT_ENTER(p_mbox, opt)   RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_POST, p_mbox, RTOSTRACE_OBJ_MAILBOX)
+#define OS_TRACE_MBOX_POST_OPT_EXIT(RetVal)         RTOSTRACE_UCOSII_POST_EXIT(RetVal, RTOSTRACE_OBJ_MAILBOX)
+#define OS_TRACE_MBOX_PEND_ENTER(p_mbox, timeout)   RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_PEND, p_mbox, RTOSTRACE_OBJ_MAILBOX)
+#define OS_TRACE_MBOX_PEND_EXIT(RetVal)             RTOSTRACE_UCOSII_PEND_EXIT(RetVal, RTOSTRACE_OBJ_MAILBOX)
+
+/* event flag group */
+#define OS_TRACE_FLAG_POST_ENTER(p_grp, flags, opt)             RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_POST, p_grp, RTOSTRACE_OBJ_EVENT)
+#define OS_TRACE_FLAG_POST_EXIT(RetVal)                         RTOSTRACE_UCOSII_POST_EXIT(RetVal, RTOSTRACE_OBJ_EVENT)
+#define OS_TRACE_FLAG_PEND_ENTER(p_grp, flags, timeout, opt)    RTOSTRACE_UCOSII_OBJ(RTOSTRACE_EV_OBJ_PEND, p_grp, RTOSTRACE_OBJ_EVENT)
+#define OS_TRACE_FLAG_PEND_EXIT(RetVal)                         RTOSTRACE_UCOSII_PEND_EXIT(RetVal, RTOSTRACE_OBJ_EVENT)
+
+#endif /* !_OS_TRACE_EVENTS_H_ */
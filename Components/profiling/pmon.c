@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "pmon_api.h"
+
+#if defined(__SMPCC_PRESENT) && (__SMPCC_PRESENT == 1)
+
+#define PMON_STATE_OFF          0
+#define PMON_STATE_ON           1
+
+/* Sample in period interrupt, defined in PMON_SAMPLE_HZ */
+#define PMON_TIMER_TICKS        (SOC_TIMER_FREQ / PMON_SAMPLE_HZ)
+
+#define PMON_RECORD_MASK        (PMON_RECORD_NUM - 1)
+
+#if (PMON_RECORD_NUM & PMON_RECORD_MASK) != 0
+#error "PMON_RECORD_NUM must be power of 2"
+#endif
+
+static const uint16_t pmon_default_events[] = {
+    SMPCC_PMON_EVENT_DATA_READ_HIT_COUNT,
+    SMPCC_PMON_EVENT_DATA_READ_MISS_COUNT,
+    SMPCC_PMON_EVENT_DATA_WRITE_COUNT,
+    SMPCC_PMON_EVENT_DATA_READ_REPLACE_COUNT,
+};
+
+static struct {
+    volatile uint8_t state;
+    uint8_t pmon_num;                       /* PMONs used in each window */
+    uint8_t pair_num;                       /* (client, event) pairs to sample */
+    uint8_t group;                          /* first pair measured in current window */
+    uint8_t clients[PMON_MAX_PAIRS];
+    uint16_t events[PMON_MAX_PAIRS];
+    uint64_t window_start;
+    uint32_t written;                       /* records written in total */
+} pmon_ctx;
+
+static pmon_record_t pmon_records[PMON_RECORD_NUM];
+static volatile uint32_t pmon_tags[PMON_MAX_CLIENTS];
+
+/* Where the pmon data stored after execute pmon_collect(0) */
+struct pmondata pmon_data = {NULL, 0};
+
+/* program PMONs with the pairs starting from group and restart counting */
+static void pmon_program_group(void)
+{
+    uint8_t i, pair;
+
+    for (i = 0; i < pmon_ctx.pmon_num; i++) {
+        pair = (pmon_ctx.group + i) % pmon_ctx.pair_num;
+        SMPCC_SetPMONEventSelect(i, pmon_ctx.clients[pair], pmon_ctx.events[pair]);
+        SMPCC_ClearPMONCount(i);
+    }
+}
+
+int pmon_setup(uint32_t client_mask, const uint16_t *events, uint32_t event_num)
+{
+    uint32_t client, ev;
+    uint8_t pmons, pairs = 0;
+
+    pmon_off();
+    pmons = SMPCC_GetPMONNum();
+    if (pmons == 0) {
+        return -1;
+    }
+    if (events == NULL) {
+        events = pmon_default_events;
+        event_num = sizeof(pmon_default_events) / sizeof(pmon_default_events[0]);
+    }
+    for (client = 0; client < PMON_MAX_CLIENTS; client++) {
+        if ((client_mask & (1UL << client)) == 0) {
+            continue;
+        }
+        for (ev = 0; ev < event_num && pairs < PMON_MAX_PAIRS; ev++) {
+            pmon_ctx.clients[pairs] = client;
+            pmon_ctx.events[pairs] = events[ev];
+            pairs++;
+        }
+    }
+    if (pairs == 0) {
+        return -1;
+    }
+    pmon_ctx.pair_num = pairs;
+    pmon_ctx.pmon_num = (pmons < pairs) ? pmons : pairs;
+    pmon_ctx.group = 0;
+    pmon_ctx.written = 0;
+    return pairs;
+}
+
+void pmon_sample(void)
+{
+    uint64_t now, count;
+    uint32_t duration;
+    pmon_record_t *rec;
+    uint8_t i, pair;
+
+    if (pmon_ctx.state != PMON_STATE_ON) {
+        return;
+    }
+    now = SysTimer_GetLoadValue();
+    duration = (uint32_t)(now - pmon_ctx.window_start);
+    for (i = 0; i < pmon_ctx.pmon_num; i++) {
+        pair = (pmon_ctx.group + i) % pmon_ctx.pair_num;
+        count = SMPCC_GetPMONCount(i);
+        rec = &pmon_records[pmon_ctx.written & PMON_RECORD_MASK];
+        rec->timestamp = now;
+        rec->duration = duration;
+        rec->count = (count > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)count;
+        rec->tag = pmon_tags[pmon_ctx.clients[pair]];
+        rec->event = pmon_ctx.events[pair];
+        rec->client = pmon_ctx.clients[pair];
+        rec->pmon = i;
+        pmon_ctx.written++;
+    }
+    /* rotate to next group of pairs if there are more pairs than PMONs */
+    if (pmon_ctx.pair_num > pmon_ctx.pmon_num) {
+        pmon_ctx.group = (pmon_ctx.group + pmon_ctx.pmon_num) % pmon_ctx.pair_num;
+    }
+    pmon_program_group();
+    pmon_ctx.window_start = SysTimer_GetLoadValue();
+}
+
+void pmon_set_tag(uint32_t tag)
+{
+    unsigned long client = __get_hart_index();
+
+    if (client < PMON_MAX_CLIENTS) {
+        pmon_tags[client] = tag;
+    }
+}
+
+#ifndef PMON_SAMPLE_EXTERNAL
+// timer interrupt handler
+// vector mode interrupt
+__INTERRUPT static void pmon_timer_handler(void)
+{
+    // Reload Timer Interrupt
+    SysTick_Reload(PMON_TIMER_TICKS);
+
+    pmon_sample();
+}
+#endif
+
+/* Start sampling */
+void pmon_on(void)
+{
+    if (pmon_ctx.pair_num == 0) {
+        return;
+    }
+    pmon_program_group();
+    pmon_ctx.window_start = SysTimer_GetLoadValue();
+    pmon_ctx.state = PMON_STATE_ON;
+#ifndef PMON_SAMPLE_EXTERNAL
+    SysTick_Config(PMON_TIMER_TICKS);
+
+    // initialize timer interrupt as vector interrupt
+    ECLIC_Register_IRQ(SysTimer_IRQn, ECLIC_VECTOR_INTERRUPT,
+            ECLIC_LEVEL_TRIGGER, 1, 0, pmon_timer_handler);
+    // Enable IRQ
+    __enable_irq();
+#endif
+}
+
+/* Stop sampling */
+void pmon_off(void)
+{
+    if (pmon_ctx.state == PMON_STATE_OFF) {
+        return;
+    }
+#ifndef PMON_SAMPLE_EXTERNAL
+    ECLIC_DisableIRQ(SysTimer_IRQn);
+#endif
+    pmon_ctx.state = PMON_STATE_OFF;
+    __RWMB();
+}
+
+#define NUM_OCTETS_PER_LINE 20
+#define FLUSH_OUTPUT()      fflush(stdout)
+static void pmon_hexdump(const void *data, unsigned long sz)
+{
+    const uint8_t *buf = (const uint8_t *)data;
+    unsigned long rem, cur = 0, i = 0;
+
+    FLUSH_OUTPUT();
+
+    while (cur < sz) {
+        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
+        for (i = 0; i < rem; i++) {
+            printf("%02x", buf[cur + i]);
+        }
+        printf("\n");
+        FLUSH_OUTPUT();
+        cur += rem;
+    }
+}
+
+long pmon_collect(unsigned long interface)
+{
+    static const char pmon_out[] = "pmon.bin";
+    FILE *fp = NULL;
+    pmon_header_t hdr;
+    uint32_t first, num, i;
+    pmon_record_t *rec;
+    char *bufptr = NULL;
+
+    pmon_off();
+
+    num = (pmon_ctx.written > PMON_RECORD_NUM) ? PMON_RECORD_NUM : pmon_ctx.written;
+    first = pmon_ctx.written - num;
+
+    hdr.magic = PMON_MAGIC;
+    hdr.version = PMON_VERSION;
+    hdr.record_size = sizeof(pmon_record_t);
+    hdr.record_num = num;
+    hdr.lost = first;
+    hdr.timer_freq = SOC_TIMER_FREQ;
+    hdr.sample_hz = PMON_SAMPLE_HZ;
+
+    if (interface == 0) {
+        free(pmon_data.buf);
+        pmon_data.size = 0;
+        pmon_data.buf = malloc(sizeof(hdr) + num * sizeof(pmon_record_t));
+        if (pmon_data.buf == NULL) {
+            printf("pmon_collect: unable to malloc enough memory to store pmon data\n");
+            return -1;
+        }
+        bufptr = pmon_data.buf;
+        memcpy(bufptr, &hdr, sizeof(hdr));
+        bufptr += sizeof(hdr);
+    } else if (interface == 1) {
+        fp = fopen(pmon_out, "wb");
+        if (fp == NULL) {
+            printf("Unable to open %s\n", pmon_out);
+            return -1;
+        }
+        fwrite(&hdr, 1, sizeof(hdr), fp);
+    } else {
+        printf("\nDump pmon timeline data start\n");
+        pmon_hexdump(&hdr, sizeof(hdr));
+    }
+
+    /* records are stored from oldest to newest */
+    for (i = 0; i < num; i++) {
+        rec = &pmon_records[(first + i) & PMON_RECORD_MASK];
+        if (interface == 0) {
+            memcpy(bufptr, rec, sizeof(*rec));
+            bufptr += sizeof(*rec);
+        } else if (interface == 1) {
+            fwrite(rec, 1, sizeof(*rec), fp);
+        } else {
+            pmon_hexdump(rec, sizeof(*rec));
+        }
+    }
+
+    if (interface == 0) {
+        pmon_data.size = bufptr - pmon_data.buf;
+        printf("Collected pmon data @0x%lx, size %u bytes\n", (unsigned long)(pmon_data.buf), pmon_data.size);
+    } else if (interface == 1) {
+        fclose(fp);
+        printf("Write %s done!\n", pmon_out);
+    } else {
+        printf("\nCREATE: %s\n", pmon_out);
+        printf("\nDump pmon timeline data finished\n");
+    }
+    return 0;
+}
+
+#endif /* #if defined(__SMPCC_PRESENT) && (__SMPCC_PRESENT == 1) */
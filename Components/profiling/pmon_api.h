@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _PMON_API_H_
+#define _PMON_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * SMPCC PMON timeline sampler
+ *
+ * The cluster cache performance monitors(PMON) are sampled in a period
+ * interrupt, each sample window records the event count of every PMON
+ * together with the tag set by the client hart, so cluster cache behavior
+ * can be lined up with what each hart was doing.
+ *
+ * When there are more (client, event) pairs than PMONs, the pairs are
+ * rotated over the PMONs window by window, so each pair is measured
+ * in 1 of every (pairs / PMONs) windows.
+ */
+
+/* sampling frequency, eg. 1000 means 1ms, 10000 means 100us */
+#ifndef PMON_SAMPLE_HZ
+#define PMON_SAMPLE_HZ          1000
+#endif
+
+/* number of records kept in ring buffer, must be power of 2,
+ * when full, the oldest records are overwritten */
+#ifndef PMON_RECORD_NUM
+#define PMON_RECORD_NUM         1024
+#endif
+
+/* max (client, event) pairs which can be sampled */
+#define PMON_MAX_PAIRS          32
+/* max clients, see client_sel field of SMP_PMON_SEL register */
+#define PMON_MAX_CLIENTS        32
+
+// TODO define PMON_SAMPLE_EXTERNAL if the system timer interrupt is already used
+// by RTOS or other program, then you need to call pmon_sample() in your own
+// PMON_SAMPLE_HZ period interrupt, and pmon_on/pmon_off will not touch any timer
+//#define PMON_SAMPLE_EXTERNAL
+
+#define PMON_MAGIC              0x4E4F4D50 /* "PMON" */
+#define PMON_VERSION            1
+
+/* header of collected pmon data, followed by record_num records in time order */
+typedef struct pmon_header {
+    uint32_t magic;             /* PMON_MAGIC */
+    uint16_t version;           /* PMON_VERSION */
+    uint16_t record_size;       /* sizeof(pmon_record_t) */
+    uint32_t record_num;        /* number of records followed */
+    uint32_t lost;              /* number of older records overwritten */
+    uint32_t timer_freq;        /* frequency of timestamp in Hz */
+    uint32_t sample_hz;         /* PMON_SAMPLE_HZ */
+} pmon_header_t;
+
+/* one record for one PMON in one sample window */
+typedef struct pmon_record {
+    uint64_t timestamp;         /* system timer value at the end of window */
+    uint32_t duration;          /* window length in system timer ticks */
+    uint32_t count;             /* event count in window, saturated to 0xFFFFFFFF */
+    uint32_t tag;               /* tag set by client hart when window ends */
+    uint16_t event;             /* SMPCC_PMON_EVENT_* */
+    uint8_t client;             /* client hart index */
+    uint8_t pmon;               /* PMON index used */
+} pmon_record_t;
+
+/* Where the pmon data stored after execute pmon_collect(0) */
+struct pmondata {
+    char *buf;
+    unsigned int size;
+};
+extern struct pmondata pmon_data;
+
+/*
+ * Setup sampled clients and events, it must be called before pmon_on.
+ * - client_mask: bit n set means client hart index n will be sampled
+ * - events: SMPCC_PMON_EVENT_* list sampled for each client, if NULL,
+ *   data read hit, data read miss, data write and data read replace are used
+ * return the number of (client, event) pairs, or negative value if no
+ * PMON present or no pair selected
+ */
+int pmon_setup(uint32_t client_mask, const uint16_t *events, uint32_t event_num);
+
+/* Do pmon sample, you can place it in a PMON_SAMPLE_HZ period timer interrupt */
+void pmon_sample(void);
+
+/* Set tag of current hart, such as task id, it is recorded with the samples of this hart */
+void pmon_set_tag(uint32_t tag);
+
+/* Start sampling, setup system timer interrupt on current hart if not PMON_SAMPLE_EXTERNAL */
+void pmon_on(void);
+/* Stop sampling */
+void pmon_off(void);
+
+/* - if interface == 0, it will dump pmon data in buffer called pmon_data
+ * - if interface == 1, it will write pmon.bin file using open/write api
+ * - otherwise it will dump pmon data in console, which can be parsed by parse.py
+ */
+long pmon_collect(unsigned long interface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_PMON_API_H_ */
@@ -0,0 +1,75 @@
+#!/bin/env python3
+
+import os
+import struct
+import sys
+
+# SMPCC_PMON_EVENT_* defined in NMSIS/Core/Include/core_feature_smpcc.h
+PMON_EVENTS = {
+    1: "data_read",
+    2: "data_write",
+    3: "instr_read",
+    4: "data_read_hit",
+    5: "data_write_replace",
+    6: "data_read_replace",
+    7: "data_read_miss",
+    8: "instr_read_hit",
+    9: "instr_read_miss",
+    10: "instr_read_replace",
+}
+
+PMON_MAGIC = 0x4E4F4D50
+# see pmon_header_t and pmon_record_t in pmon_api.h
+HEADER_FMT = "<IHHIIII"
+RECORD_FMT = "<QIIIHBB"
+
+
+def parse_pmon_bin(binfile):
+    """
+    Parses a pmon.bin file generated by parse.py from pmon_collect dump log,
+    and prints the timeline in csv format.
+
+    Args:
+        binfile (str): Path to the pmon binary file.
+
+    Returns:
+        bool: True if processing was successful, False otherwise.
+    """
+    if not os.path.isfile(binfile):
+        print(f"{binfile} does not exist. Please check!")
+        return False
+
+    with open(binfile, "rb") as bf:
+        data = bf.read()
+
+    hdrsize = struct.calcsize(HEADER_FMT)
+    if len(data) < hdrsize:
+        print(f"Error: {binfile} is too small")
+        return False
+    magic, version, recsize, recnum, lost, timer_freq, sample_hz = struct.unpack_from(HEADER_FMT, data, 0)
+    if magic != PMON_MAGIC or recsize != struct.calcsize(RECORD_FMT):
+        print(f"Error: {binfile} is not a valid pmon data file")
+        return False
+
+    print(f"# version {version}, {recnum} records, {lost} lost, timer {timer_freq} Hz, sample {sample_hz} Hz")
+    print("time_us,duration_us,client,event,count,tag")
+    offset = hdrsize
+    for _ in range(recnum):
+        if offset + recsize > len(data):
+            print("Error: truncated record")
+            return False
+        timestamp, duration, count, tag, event, client, _pmon = struct.unpack_from(RECORD_FMT, data, offset)
+        offset += recsize
+        evname = PMON_EVENTS.get(event, f"event{event}")
+        print(f"{timestamp * 1000000 // timer_freq},{duration * 1000000 // timer_freq},{client},{evname},{count},{tag}")
+
+    return True
+
+# NOTE: pmon.bin is generated by parse.py from the console log which contains
+# Dump pmon timeline data start ... Dump pmon timeline data finished
+# python nuclei_sdk/Components/profiling/pmon_parse.py pmon.bin > pmon.csv
+if __name__ == "__main__":
+    if len(sys.argv) > 1:
+        parse_pmon_bin(sys.argv[1])
+    else:
+        print(f"Help: {sys.argv[0]} pmon.bin")
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "rtostrace_api.h"
+
+#define RTOSTRACE_STATE_OFF     0
+#define RTOSTRACE_STATE_ON      1
+
+#define RTOSTRACE_EVENT_MASK    (RTOSTRACE_EVENT_NUM - 1)
+#define RTOSTRACE_CACHE_LINE    64
+
+#if (RTOSTRACE_EVENT_NUM & RTOSTRACE_EVENT_MASK) != 0
+#error "RTOSTRACE_EVENT_NUM must be power of 2"
+#endif
+
+/*
+ * Buffer of one hart, only written by the hart itself with interrupt disabled,
+ * head is a free running counter of events recorded, busy is set while an
+ * event is written, so rtostrace_collect can wait for it on other harts.
+ */
+typedef struct rtostrace_buf {
+    volatile uint32_t head;
+    volatile uint32_t busy;
+    uint32_t lost;                          /* events dropped in stop mode */
+    uint8_t pad[RTOSTRACE_CACHE_LINE - 3 * sizeof(uint32_t)];
+    rtostrace_event_t events[RTOSTRACE_EVENT_NUM];
+} rtostrace_buf_t;
+
+/* must be placed in memory shared by all harts */
+static rtostrace_buf_t rtostrace_bufs[RTOSTRACE_MAX_CORES] __ALIGNED(RTOSTRACE_CACHE_LINE);
+static rtostrace_name_t rtostrace_names[RTOSTRACE_MAX_NAMES];
+
+static struct {
+    volatile uint8_t state;
+    uint8_t mode;
+    volatile uint32_t name_lock;
+    uint32_t name_num;                      /* used entries of rtostrace_names */
+} rtostrace_ctx;
+
+/* Where the rtostrace data stored after execute rtostrace_collect(0) */
+struct rtostracedata rtostrace_data = {NULL, 0};
+
+void rtostrace_record(uint8_t type, uint16_t arg16, uint32_t arg)
+{
+    rtostrace_buf_t *buf;
+    rtostrace_event_t *ev;
+    uint32_t head;
+    unsigned long idx = 0;
+    rv_csr_t mstatus;
+
+    if (rtostrace_ctx.state != RTOSTRACE_STATE_ON) {
+        return;
+    }
+    /* interrupt disabled, so the event is not interleaved and the hart is not changed */
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+#if RTOSTRACE_MAX_CORES > 1
+    idx = __get_hart_index();
+    if (idx >= RTOSTRACE_MAX_CORES) {
+        __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+        return;
+    }
+#endif
+    buf = &rtostrace_bufs[idx];
+    buf->busy = 1;
+    __SMP_RWMB();
+    /* state may be changed by rtostrace_stop on other hart before busy is set */
+    if (rtostrace_ctx.state != RTOSTRACE_STATE_ON) {
+        goto out;
+    }
+    head = buf->head;
+    if ((rtostrace_ctx.mode == RTOSTRACE_MODE_STOP) && (head >= RTOSTRACE_EVENT_NUM)) {
+        buf->lost++;
+        goto out;
+    }
+    ev = &buf->events[head & RTOSTRACE_EVENT_MASK];
+    ev->ts = RTOSTRACE_TIMESTAMP();
+    ev->arg = arg;
+    ev->arg16 = arg16;
+    ev->type = type;
+    buf->head = head + 1;
+out:
+    __SMP_RWMB();
+    buf->busy = 0;
+    __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+}
+
+static inline uint16_t rtostrace_isr_id(void)
+{
+#ifdef SMODE_RTOS
+    return (uint16_t)(__RV_CSR_READ(CSR_SCAUSE) & SCAUSE_CAUSE);
+#else
+    return (uint16_t)(__RV_CSR_READ(CSR_MCAUSE) & MCAUSE_CAUSE);
+#endif
+}
+
+void rtostrace_isr_enter(void)
+{
+    rtostrace_record(RTOSTRACE_EV_ISR_ENTER, rtostrace_isr_id(), 0);
+}
+
+void rtostrace_isr_exit(void)
+{
+    rtostrace_record(RTOSTRACE_EV_ISR_EXIT, rtostrace_isr_id(), 0);
+}
+
+/* names may be set by kernel glue on any hart, so the table is protected by a spin lock */
+static rv_csr_t rtostrace_name_lock(void)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+#if defined(__riscv_atomic)
+    while (__AMOSWAP_W(&rtostrace_ctx.name_lock, 1) != 0);
+    __SMP_RWMB();
+#endif
+    return mstatus;
+}
+
+static void rtostrace_name_unlock(rv_csr_t mstatus)
+{
+#if defined(__riscv_atomic)
+    __SMP_RWMB();
+    rtostrace_ctx.name_lock = 0;
+#endif
+    __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+}
+
+int rtostrace_set_name(uint32_t id, uint8_t kind, const char *name)
+{
+    rtostrace_name_t *entry = NULL;
+    uint32_t i;
+    rv_csr_t mstatus;
+
+    if (name == NULL) {
+        return -1;
+    }
+    mstatus = rtostrace_name_lock();
+    for (i = 0; i < rtostrace_ctx.name_num; i++) {
+        if (rtostrace_names[i].id == id) {
+            entry = &rtostrace_names[i];
+            break;
+        }
+    }
+    if ((entry == NULL) && (rtostrace_ctx.name_num < RTOSTRACE_MAX_NAMES)) {
+        entry = &rtostrace_names[rtostrace_ctx.name_num++];
+    }
+    if (entry != NULL) {
+        entry->id = id;
+        entry->kind = kind;
+        strncpy(entry->name, name, RTOSTRACE_NAME_LEN - 1);
+        entry->name[RTOSTRACE_NAME_LEN - 1] = '\0';
+    }
+    rtostrace_name_unlock(mstatus);
+    return (entry != NULL) ? 0 : -1;
+}
+
+void rtostrace_start(uint32_t mode)
+{
+    uint32_t core;
+
+    rtostrace_stop();
+    for (core = 0; core < RTOSTRACE_MAX_CORES; core++) {
+        rtostrace_bufs[core].head = 0;
+        rtostrace_bufs[core].lost = 0;
+    }
+    rtostrace_ctx.mode = (mode == RTOSTRACE_MODE_RING) ? RTOSTRACE_MODE_RING : RTOSTRACE_MODE_STOP;
+    __SMP_RWMB();
+    rtostrace_ctx.state = RTOSTRACE_STATE_ON;
+    __SMP_RWMB();
+}
+
+void rtostrace_stop(void)
+{
+    uint32_t core;
+
+    rtostrace_ctx.state = RTOSTRACE_STATE_OFF;
+    __SMP_RWMB();
+    /* wait for events being written on other harts */
+    for (core = 0; core < RTOSTRACE_MAX_CORES; core++) {
+        while (rtostrace_bufs[core].busy != 0);
+    }
+    __SMP_RWMB();
+}
+
+#define NUM_OCTETS_PER_LINE 20
+#define FLUSH_OUTPUT()      fflush(stdout)
+static void rtostrace_hexdump(const void *data, unsigned long sz)
+{
+    const uint8_t *buf = (const uint8_t *)data;
+    unsigned long rem, cur = 0, i = 0;
+
+    FLUSH_OUTPUT();
+
+    while (cur < sz) {
+        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
+        for (i = 0; i < rem; i++) {
+            printf("%02x", buf[cur + i]);
+        }
+        printf("\n");
+        FLUSH_OUTPUT();
+        cur += rem;
+    }
+}
+
+/* write one block of collected data to buffer, file or console */
+static void rtostrace_output(unsigned long interface, FILE *fp, char **bufptr, const void *data, unsigned long sz)
+{
+    if (sz == 0) {
+        return;
+    }
+    if (interface == 0) {
+        memcpy(*bufptr, data, sz);
+        *bufptr += sz;
+    } else if (interface == 1) {
+        fwrite(data, 1, sz, fp);
+    } else {
+        rtostrace_hexdump(data, sz);
+    }
+}
+
+/* valid events of one hart, the oldest one is at start */
+static void rtostrace_core_info(uint32_t core, rtostrace_core_t *info, uint32_t *start)
+{
+    rtostrace_buf_t *buf = &rtostrace_bufs[core];
+    uint32_t head = buf->head;
+
+    info->hart = core;
+    info->reserved = 0;
+    if (head > RTOSTRACE_EVENT_NUM) {
+        /* only happens in ring mode, older events are overwritten */
+        info->event_num = RTOSTRACE_EVENT_NUM;
+        info->lost = head - RTOSTRACE_EVENT_NUM;
+        *start = head & RTOSTRACE_EVENT_MASK;
+    } else {
+        info->event_num = head;
+        info->lost = buf->lost;
+        *start = 0;
+    }
+}
+
+long rtostrace_collect(unsigned long interface)
+{
+    static const char rtostrace_out[] = "rtostrace.bin";
+    FILE *fp = NULL;
+    rtostrace_header_t hdr;
+    rtostrace_core_t info;
+    rtostrace_event_t *events;
+    uint32_t core, start, first;
+    char *bufptr = NULL;
+    unsigned long size;
+
+    rtostrace_stop();
+
+    hdr.magic = RTOSTRACE_MAGIC;
+    hdr.version = RTOSTRACE_VERSION;
+    hdr.cores = RTOSTRACE_MAX_CORES;
+    hdr.mode = rtostrace_ctx.mode;
+    hdr.event_num = RTOSTRACE_EVENT_NUM;
+    hdr.name_num = rtostrace_ctx.name_num;
+    hdr.freq = RTOSTRACE_TIMESTAMP_FREQ;
+    hdr.reserved = 0;
+
+    if (interface == 0) {
+        size = sizeof(hdr) + hdr.name_num * sizeof(rtostrace_name_t);
+        for (core = 0; core < RTOSTRACE_MAX_CORES; core++) {
+            rtostrace_core_info(core, &info, &start);
+            size += sizeof(info) + info.event_num * sizeof(rtostrace_event_t);
+        }
+        free(rtostrace_data.buf);
+        rtostrace_data.size = 0;
+        rtostrace_data.buf = malloc(size);
+        if (rtostrace_data.buf == NULL) {
+            printf("rtostrace_collect: unable to malloc enough memory to store rtostrace data\n");
+            return -1;
+        }
+        bufptr = rtostrace_data.buf;
+    } else if (interface == 1) {
+        fp = fopen(rtostrace_out, "wb");
+        if (fp == NULL) {
+            printf("Unable to open %s\n", rtostrace_out);
+            return -1;
+        }
+    } else {
+        printf("\nDump rtostrace data start\n");
+    }
+
+    rtostrace_output(interface, fp, &bufptr, &hdr, sizeof(hdr));
+    rtostrace_output(interface, fp, &bufptr, rtostrace_names, hdr.name_num * sizeof(rtostrace_name_t));
+    for (core = 0; core < RTOSTRACE_MAX_CORES; core++) {
+        rtostrace_core_info(core, &info, &start);
+        events = rtostrace_bufs[core].events;
+        rtostrace_output(interface, fp, &bufptr, &info, sizeof(info));
+        /* buffer wraps in ring mode, oldest part first */
+        first = RTOSTRACE_EVENT_NUM - start;
+        if (first > info.event_num) {
+            first = info.event_num;
+        }
+        rtostrace_output(interface, fp, &bufptr, &events[start], first * sizeof(rtostrace_event_t));
+        rtostrace_output(interface, fp, &bufptr, events, (info.event_num - first) * sizeof(rtostrace_event_t));
+    }
+
+    if (interface == 0) {
+        rtostrace_data.size = bufptr - rtostrace_data.buf;
+        printf("Collected rtostrace data @0x%lx, size %u bytes\n", (unsigned long)(rtostrace_data.buf), rtostrace_data.size);
+    } else if (interface == 1) {
+        fclose(fp);
+        printf("Write %s done!\n", rtostrace_out);
+    } else {
+        printf("\nCREATE: %s\n", rtostrace_out);
+        printf("\nDump rtostrace data finished\n");
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _RTOSTRACE_API_H_
+#define _RTOSTRACE_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Binary RTOS event trace
+ *
+ * Kernel events such as context switch, interrupt enter/exit and queue,
+ * semaphore and mutex operations are recorded as fixed 16 bytes records
+ * with a cycle timestamp into the buffer of current hart. Each hart only
+ * writes its own buffer with interrupt disabled, so no lock is taken.
+ *
+ * The kernel glue which maps kernel trace points to rtostrace_record:
+ * - FreeRTOS: include rtostrace_freertos.h at the end of FreeRTOSConfig.h
+ * - ThreadX: include rtostrace_threadx.h in tx_user.h
+ * - uC/OS-II: set OS_TRACE_EN to 1 in os_cfg.h, os_trace_events.h is used
+ * - RT-Thread: define RT_USING_HOOK in rtconfig.h and call rtostrace_rtthread_init()
+ *
+ * rtostrace_collect() dumps the buffers, which are converted by parse.py
+ * and rtostrace_convert.py into Perfetto json or CTF trace.
+ */
+
+/* events kept in buffer of each hart, must be power of 2 */
+#ifndef RTOSTRACE_EVENT_NUM
+#define RTOSTRACE_EVENT_NUM     1024
+#endif
+
+/* max number of harts, hart index must be less than it */
+#ifndef RTOSTRACE_MAX_CORES
+#ifdef SMP_CPU_CNT
+#define RTOSTRACE_MAX_CORES     SMP_CPU_CNT
+#else
+#define RTOSTRACE_MAX_CORES     1
+#endif
+#endif
+
+/* max task and object names set by rtostrace_set_name */
+#ifndef RTOSTRACE_MAX_NAMES
+#define RTOSTRACE_MAX_NAMES     32
+#endif
+#define RTOSTRACE_NAME_LEN      16
+
+/*
+ * Timestamp of events, mcycle by default, mcycle of different harts may be
+ * not synchronized, define them as SysTimer_GetLoadValue() and SOC_TIMER_FREQ
+ * to get a timestamp shared by all harts
+ */
+#ifndef RTOSTRACE_TIMESTAMP
+#define RTOSTRACE_TIMESTAMP()   __get_rv_cycle()
+#endif
+#ifndef RTOSTRACE_TIMESTAMP_FREQ
+#define RTOSTRACE_TIMESTAMP_FREQ    SystemCoreClock
+#endif
+
+#define RTOSTRACE_MAGIC         0x52545452 /* "RTTR" */
+#define RTOSTRACE_VERSION       1
+
+/* recording mode of rtostrace_start */
+#define RTOSTRACE_MODE_STOP     0   /* stop recording when buffer is full, keep the first events */
+#define RTOSTRACE_MODE_RING     1   /* overwrite the oldest event when buffer is full, keep the last events */
+
+/* event types, see rtostrace_convert.py */
+#define RTOSTRACE_EV_TASK_SWITCH        1   /* arg: task switched in, arg16: priority */
+#define RTOSTRACE_EV_ISR_ENTER          2   /* arg16: interrupt id */
+#define RTOSTRACE_EV_ISR_EXIT           3   /* arg16: interrupt id */
+#define RTOSTRACE_EV_TASK_CREATE        4   /* arg: task, arg16: priority */
+#define RTOSTRACE_EV_TASK_DELETE        5   /* arg: task */
+#define RTOSTRACE_EV_TASK_READY         6   /* arg: task made ready */
+#define RTOSTRACE_EV_TASK_SUSPEND       7   /* arg: task delayed or suspended */
+#define RTOSTRACE_EV_PRIO_INHERIT       8   /* arg: mutex holder, arg16: inherited priority */
+#define RTOSTRACE_EV_PRIO_DISINHERIT    9   /* arg: mutex holder, arg16: restored priority */
+#define RTOSTRACE_EV_OBJ_POST           10  /* arg: object given, sent or unlocked, arg16: kind and flags */
+#define RTOSTRACE_EV_OBJ_PEND           11  /* arg: object to take, receive or lock, arg16: kind and flags */
+#define RTOSTRACE_EV_OBJ_BLOCK          12  /* arg: object which running task blocks on, arg16: kind */
+#define RTOSTRACE_EV_OBJ_GET            13  /* arg: object taken, received or locked, arg16: kind and flags */
+#define RTOSTRACE_EV_OBJ_RESULT         14  /* arg: kernel error code of last object operation, arg16: kind */
+#define RTOSTRACE_EV_USER               15  /* arg: user value, arg16: user event id */
+
+/* kinds of object in arg16 of object events and in names */
+#define RTOSTRACE_OBJ_TASK      0
+#define RTOSTRACE_OBJ_QUEUE     1
+#define RTOSTRACE_OBJ_SEM       2
+#define RTOSTRACE_OBJ_MUTEX     3
+#define RTOSTRACE_OBJ_EVENT     4
+#define RTOSTRACE_OBJ_MAILBOX   5
+#define RTOSTRACE_OBJ_OTHER     6
+#define RTOSTRACE_OBJ_IRQ       7
+#define RTOSTRACE_OBJ_KIND_MASK 0xFF
+
+/* flags of object events in arg16 */
+#define RTOSTRACE_FLAG_FAILED   0x100   /* operation failed without blocking */
+#define RTOSTRACE_FLAG_FROM_ISR 0x200   /* operation done in interrupt */
+
+/* id of task or object in events and names */
+#define RTOSTRACE_ID(ptr)       ((uint32_t)(uintptr_t)(ptr))
+
+/* one event */
+typedef struct rtostrace_event {
+    uint64_t ts;                /* RTOSTRACE_TIMESTAMP() */
+    uint32_t arg;
+    uint16_t arg16;
+    uint8_t type;               /* RTOSTRACE_EV_* */
+    uint8_t reserved;
+} rtostrace_event_t;
+
+/* header of collected data, followed by name_num names and cores blocks of events */
+typedef struct rtostrace_header {
+    uint32_t magic;             /* RTOSTRACE_MAGIC */
+    uint16_t version;           /* RTOSTRACE_VERSION */
+    uint8_t cores;              /* RTOSTRACE_MAX_CORES */
+    uint8_t mode;               /* RTOSTRACE_MODE_* */
+    uint32_t event_num;         /* RTOSTRACE_EVENT_NUM */
+    uint32_t name_num;          /* number of names followed */
+    uint32_t freq;              /* RTOSTRACE_TIMESTAMP_FREQ */
+    uint32_t reserved;
+} rtostrace_header_t;
+
+/* one task or object name */
+typedef struct rtostrace_name {
+    uint32_t id;
+    uint8_t kind;               /* RTOSTRACE_OBJ_* */
+    uint8_t reserved[3];
+    char name[RTOSTRACE_NAME_LEN];
+} rtostrace_name_t;
+
+/* events block of one hart, followed by event_num events from oldest to newest */
+typedef struct rtostrace_core {
+    uint32_t hart;
+    uint32_t event_num;         /* events followed */
+    uint32_t lost;              /* events dropped in stop mode or overwritten in ring mode */
+    uint32_t reserved;
+} rtostrace_core_t;
+
+/* Where the rtostrace data stored after execute rtostrace_collect(0) */
+struct rtostracedata {
+    char *buf;
+    unsigned int size;
+};
+extern struct rtostracedata rtostrace_data;
+
+/* Record one event into buffer of current hart, it can be called in task or interrupt */
+void rtostrace_record(uint8_t type, uint16_t arg16, uint32_t arg);
+
+/* Record interrupt enter and exit, interrupt id is read from mcause */
+void rtostrace_isr_enter(void);
+void rtostrace_isr_exit(void);
+
+#define RTOSTRACE_ISR_ENTER()   rtostrace_isr_enter()
+#define RTOSTRACE_ISR_EXIT()    rtostrace_isr_exit()
+#define RTOSTRACE_USER(id, value)   rtostrace_record(RTOSTRACE_EV_USER, (uint16_t)(id), (uint32_t)(value))
+
+/* Set name of task or object shown in converted trace, return 0 if successful */
+int rtostrace_set_name(uint32_t id, uint8_t kind, const char *name);
+
+/* Clear buffers and start recording in RTOSTRACE_MODE_STOP or RTOSTRACE_MODE_RING, names are kept */
+void rtostrace_start(uint32_t mode);
+/* Stop recording */
+void rtostrace_stop(void);
+
+/* - if interface == 0, it will dump rtostrace data in buffer called rtostrace_data
+ * - if interface == 1, it will write rtostrace.bin file using open/write api
+ * - otherwise it will dump rtostrace data in console, which can be parsed by parse.py
+ * recording is stopped before dump
+ */
+long rtostrace_collect(unsigned long interface);
+
+#ifdef RTOS_RTTHREAD
+/* Install RT-Thread hooks, RT_USING_HOOK must be defined */
+void rtostrace_rtthread_init(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_RTOSTRACE_API_H_ */
@@ -0,0 +1,462 @@
+#!/bin/env python3
+
+import os
+import sys
+import json
+import struct
+import argparse
+
+RTOSTRACE_MAGIC = 0x52545452
+# see rtostrace_header_t, rtostrace_name_t, rtostrace_core_t and rtostrace_event_t in rtostrace_api.h
+HEADER_FMT = "<IHBBIIII"
+NAME_FMT = "<IB3x16s"
+CORE_FMT = "<IIII"
+EVENT_FMT = "<QIHBx"
+
+EV_TASK_SWITCH = 1
+EV_ISR_ENTER = 2
+EV_ISR_EXIT = 3
+EV_TASK_CREATE = 4
+EV_TASK_DELETE = 5
+EV_TASK_READY = 6
+EV_TASK_SUSPEND = 7
+EV_PRIO_INHERIT = 8
+EV_PRIO_DISINHERIT = 9
+EV_OBJ_POST = 10
+EV_OBJ_PEND = 11
+EV_OBJ_BLOCK = 12
+EV_OBJ_GET = 13
+EV_OBJ_RESULT = 14
+EV_USER = 15
+
+# event name, name of arg field, name of arg16 field, used in CTF metadata
+EVENT_TYPES = {
+    EV_TASK_SWITCH: ("sched_switch", "next_tid", "next_prio"),
+    EV_ISR_ENTER: ("irq_handler_entry", "unused", "irq"),
+    EV_ISR_EXIT: ("irq_handler_exit", "unused", "irq"),
+    EV_TASK_CREATE: ("task_create", "tid", "prio"),
+    EV_TASK_DELETE: ("task_delete", "tid", "unused"),
+    EV_TASK_READY: ("task_ready", "tid", "prio"),
+    EV_TASK_SUSPEND: ("task_suspend", "tid", "unused"),
+    EV_PRIO_INHERIT: ("prio_inherit", "tid", "prio"),
+    EV_PRIO_DISINHERIT: ("prio_disinherit", "tid", "prio"),
+    EV_OBJ_POST: ("obj_post", "obj", "kind_flags"),
+    EV_OBJ_PEND: ("obj_pend", "obj", "kind_flags"),
+    EV_OBJ_BLOCK: ("obj_block", "obj", "kind_flags"),
+    EV_OBJ_GET: ("obj_get", "obj", "kind_flags"),
+    EV_OBJ_RESULT: ("obj_result", "code", "kind"),
+    EV_USER: ("user", "value", "id"),
+}
+
+OBJ_KINDS = ["task", "queue", "sem", "mutex", "event", "mailbox", "object", "irq"]
+FLAG_FAILED = 0x100
+FLAG_FROM_ISR = 0x200
+
+CTF_MAGIC = 0xC1FC1FC1
+
+
+def parse_rtostrace_bin(binfile):
+    """
+    Parses a rtostrace.bin file generated by parse.py from rtostrace_collect dump log.
+
+    Returns:
+        tuple: (header dict, names dict of id -> (kind, name), list of (hart, lost, events)),
+        each event is a tuple of (ts, type, arg16, arg), None if invalid.
+    """
+    if not os.path.isfile(binfile):
+        print(f"{binfile} does not exist. Please check!", file=sys.stderr)
+        return None
+    with open(binfile, "rb") as bf:
+        data = bf.read()
+
+    hdrsize = struct.calcsize(HEADER_FMT)
+    if len(data) < hdrsize:
+        print(f"Error: {binfile} is too small", file=sys.stderr)
+        return None
+    fields = struct.unpack_from(HEADER_FMT, data, 0)
+    keys = ["magic", "version", "cores", "mode", "event_num", "name_num", "freq", "reserved"]
+    hdr = dict(zip(keys, fields))
+    if hdr["magic"] != RTOSTRACE_MAGIC or hdr["freq"] == 0:
+        print(f"Error: {binfile} is not a valid rtostrace data file", file=sys.stderr)
+        return None
+
+    offset = hdrsize
+    names = dict()
+    for _ in range(hdr["name_num"]):
+        objid, kind, name = struct.unpack_from(NAME_FMT, data, offset)
+        offset += struct.calcsize(NAME_FMT)
+        names[objid] = (kind, name.split(b"\0")[0].decode("utf-8", "replace"))
+
+    cores = []
+    evsize = struct.calcsize(EVENT_FMT)
+    for _ in range(hdr["cores"]):
+        if offset + struct.calcsize(CORE_FMT) > len(data):
+            print("Error: truncated rtostrace data", file=sys.stderr)
+            return None
+        hart, event_num, lost, _reserved = struct.unpack_from(CORE_FMT, data, offset)
+        offset += struct.calcsize(CORE_FMT)
+        if offset + event_num * evsize > len(data):
+            print("Error: truncated rtostrace data", file=sys.stderr)
+            return None
+        events = []
+        for i in range(event_num):
+            ts, arg, arg16, evtype = struct.unpack_from(EVENT_FMT, data, offset + i * evsize)
+            events.append((ts, evtype, arg16, arg))
+        offset += event_num * evsize
+        cores.append((hart, lost, events))
+    return hdr, names, cores
+
+
+def name_of(names, objid, default_kind="task"):
+    if objid == 0:
+        return "idle"
+    if objid in names:
+        return names[objid][1]
+    return f"{default_kind}_{objid:x}"
+
+
+def kind_of(arg16):
+    kind = arg16 & 0xFF
+    return OBJ_KINDS[kind] if kind < len(OBJ_KINDS) else "object"
+
+
+def merged_events(cores):
+    """
+    Events of all harts sorted by timestamp, each one is (ts, hart, type, arg16, arg).
+    """
+    merged = []
+    for hart, _lost, events in cores:
+        merged.extend((ts, hart, evtype, arg16, arg) for ts, evtype, arg16, arg in events)
+    merged.sort(key=lambda ev: (ev[0], ev[1]))
+    return merged
+
+
+class Timeline(object):
+    """
+    Replays events into task states and interrupt slices, which are shared by
+    Perfetto output and latency statistics.
+
+    Task state is one of running, ready and blocked, a task becomes ready by
+    READY event, running by SWITCH event, and blocked when it is switched out
+    after SUSPEND or BLOCK event, or ready when it is preempted.
+    """
+    def __init__(self, hdr, names, cores):
+        self.hdr = hdr
+        self.names = names
+        self.events = merged_events(cores)
+        self.t0 = self.events[0][0] if self.events else 0
+        self.tend = self.events[-1][0] if self.events else 0
+        # (ts, dur, track, name, args), track is ("hart", hart, "cpu"|"irq") or ("task", tid)
+        self.slices = []
+        # (ts, track, name, args)
+        self.instants = []
+        # (ts, tid, prio)
+        self.prios = []
+        # tid -> list of ready to running latency in cycles
+        self.latency = dict()
+        self.inherits = 0
+        self._run()
+
+    def _begin(self, opened, track, ts, name, args=None):
+        opened[track] = (ts, name, args or {})
+
+    def _end(self, opened, track, ts):
+        if track in opened:
+            start, name, args = opened.pop(track)
+            self.slices.append((start, ts - start, track, name, args))
+
+    def _run(self):
+        opened = dict()
+        current = dict()        # hart -> running tid
+        state = dict()          # tid -> (state, ts, woken)
+        pending = dict()        # tid -> blocked reason set while running
+        irqs = dict()           # hart -> stack of (irq, ts)
+
+        for ts, hart, evtype, arg16, arg in self.events:
+            running = current.get(hart)
+            if evtype == EV_TASK_SWITCH:
+                if running == arg:
+                    continue
+                if running is not None:
+                    self._end(opened, ("hart", hart, "cpu"), ts)
+                    self._end(opened, ("task", running), ts)
+                    reason = pending.pop(running, None)
+                    if running == 0:
+                        state.pop(running, None)
+                    elif reason is not None:
+                        state[running] = ("blocked", ts, False)
+                        self._begin(opened, ("task", running), ts, reason)
+                    else:
+                        state[running] = ("ready", ts, False)
+                        self._begin(opened, ("task", running), ts, "ready (preempted)")
+                prev = state.get(arg)
+                if prev is not None and prev[0] == "ready" and prev[2]:
+                    self.latency.setdefault(arg, []).append(ts - prev[1])
+                self._end(opened, ("task", arg), ts)
+                current[hart] = arg
+                state[arg] = ("running", ts, False)
+                self._begin(opened, ("hart", hart, "cpu"), ts, name_of(self.names, arg))
+                if arg != 0:
+                    self._begin(opened, ("task", arg), ts, f"running on hart{hart}")
+                    self.prios.append((ts, arg, arg16))
+            elif evtype == EV_ISR_ENTER:
+                irqs.setdefault(hart, []).append((arg16, ts))
+            elif evtype == EV_ISR_EXIT:
+                stack = irqs.get(hart, [])
+                if stack:
+                    irq, start = stack.pop()
+                    self.slices.append((start, ts - start, ("hart", hart, "irq"), f"irq {irq}",
+                                        {"depth": len(stack)}))
+            elif evtype == EV_TASK_READY:
+                prev = state.get(arg)
+                if prev is None or prev[0] == "blocked":
+                    self._end(opened, ("task", arg), ts)
+                    state[arg] = ("ready", ts, True)
+                    self._begin(opened, ("task", arg), ts, "ready")
+            elif evtype == EV_TASK_SUSPEND or evtype == EV_OBJ_BLOCK:
+                if evtype == EV_OBJ_BLOCK:
+                    tid = running
+                    reason = f"blocked on {name_of(self.names, arg, kind_of(arg16))}"
+                else:
+                    tid = arg
+                    reason = "suspended"
+                if tid is None:
+                    continue
+                if tid in current.values():
+                    # running task blocks when it is switched out, keep object reason
+                    if evtype == EV_OBJ_BLOCK or tid not in pending:
+                        pending[tid] = reason
+                elif state.get(tid, ("",))[0] != "blocked":
+                    self._end(opened, ("task", tid), ts)
+                    state[tid] = ("blocked", ts, False)
+                    self._begin(opened, ("task", tid), ts, reason)
+            elif evtype == EV_OBJ_PEND:
+                if running is not None and running != 0:
+                    pending.setdefault(running, f"blocked on {name_of(self.names, arg, kind_of(arg16))}")
+                    self._instant(ts, hart, running, evtype, arg16, arg)
+            elif evtype == EV_OBJ_GET or evtype == EV_OBJ_RESULT:
+                if running is not None:
+                    pending.pop(running, None)
+                self._instant(ts, hart, running, evtype, arg16, arg)
+            elif evtype in (EV_PRIO_INHERIT, EV_PRIO_DISINHERIT):
+                if evtype == EV_PRIO_INHERIT:
+                    self.inherits += 1
+                self.prios.append((ts, arg, arg16))
+                self._instant(ts, hart, running, evtype, arg16, arg)
+            elif evtype == EV_TASK_CREATE:
+                self.prios.append((ts, arg, arg16))
+                self._instant(ts, hart, running, evtype, arg16, arg)
+            elif evtype == EV_TASK_DELETE:
+                self._end(opened, ("task", arg), ts)
+                state.pop(arg, None)
+                self._instant(ts, hart, running, evtype, arg16, arg)
+            else:
+                self._instant(ts, hart, running, evtype, arg16, arg)
+
+        for track in list(opened.keys()):
+            self._end(opened, track, self.tend)
+
+    def _instant(self, ts, hart, running, evtype, arg16, arg):
+        evname = EVENT_TYPES.get(evtype, (f"event{evtype}",))[0]
+        args = {"hart": hart}
+        if EV_OBJ_POST <= evtype <= EV_OBJ_GET:
+            label = f"{evname} {name_of(self.names, arg, kind_of(arg16))}"
+            args.update({"kind": kind_of(arg16), "failed": bool(arg16 & FLAG_FAILED),
+                         "from_isr": bool(arg16 & FLAG_FROM_ISR)})
+        elif evtype == EV_OBJ_RESULT:
+            label = f"{evname} {arg:d}"
+            args["kind"] = kind_of(arg16)
+        elif evtype == EV_USER:
+            label = f"user {arg16}"
+            args["value"] = arg
+        else:
+            label = f"{evname} {name_of(self.names, arg)}"
+            args["prio"] = arg16
+        track = ("task", running) if running else ("hart", hart, "cpu")
+        self.instants.append((ts, track, label, args))
+
+
+def to_perfetto(timeline, outfile):
+    """
+    Writes Chrome json trace format which is opened by https://ui.perfetto.dev,
+    process of each hart has cpu and irq tracks, and process of tasks has one track for each task.
+    """
+    freq = timeline.hdr["freq"]
+    t0 = timeline.t0
+    tasks_pid = 1000
+    tids = dict()
+    trace = []
+
+    def us(ts):
+        return (ts - t0) * 1000000.0 / freq
+
+    def track_ids(track):
+        if track[0] == "hart":
+            return track[1], 0 if track[2] == "cpu" else 1
+        if track[1] not in tids:
+            tids[track[1]] = len(tids) + 1
+        return tasks_pid, tids[track[1]]
+
+    for start, dur, track, name, args in timeline.slices:
+        pid, tid = track_ids(track)
+        trace.append({"name": name, "ph": "X", "ts": us(start), "dur": dur * 1000000.0 / freq,
+                      "pid": pid, "tid": tid, "args": args})
+    for ts, track, name, args in timeline.instants:
+        pid, tid = track_ids(track)
+        trace.append({"name": name, "ph": "i", "s": "t", "ts": us(ts), "pid": pid, "tid": tid, "args": args})
+    for ts, taskid, prio in timeline.prios:
+        trace.append({"name": f"prio {name_of(timeline.names, taskid)}", "ph": "C", "ts": us(ts),
+                      "pid": tasks_pid, "args": {"prio": prio}})
+
+    harts = sorted(set(ev[1] for ev in timeline.events))
+    for hart in harts:
+        trace.append({"name": "process_name", "ph": "M", "pid": hart, "args": {"name": f"hart{hart}"}})
+        trace.append({"name": "thread_name", "ph": "M", "pid": hart, "tid": 0, "args": {"name": "cpu"}})
+        trace.append({"name": "thread_name", "ph": "M", "pid": hart, "tid": 1, "args": {"name": "irq"}})
+    trace.append({"name": "process_name", "ph": "M", "pid": tasks_pid, "args": {"name": "tasks"}})
+    for taskid, tid in tids.items():
+        trace.append({"name": "thread_name", "ph": "M", "pid": tasks_pid, "tid": tid,
+                      "args": {"name": name_of(timeline.names, taskid)}})
+
+    with open(outfile, "w") as of:
+        json.dump({"traceEvents": trace, "displayTimeUnit": "ns"}, of)
+
+
+CTF_METADATA_HEAD = """/* CTF 1.8 */
+
+typealias integer { size = 8; align = 8; signed = false; } := uint8_t;
+typealias integer { size = 16; align = 8; signed = false; } := uint16_t;
+typealias integer { size = 32; align = 8; signed = false; } := uint32_t;
+typealias integer { size = 64; align = 8; signed = false; } := uint64_t;
+
+trace {
+    major = 1;
+    minor = 8;
+    byte_order = le;
+    packet.header := struct {
+        uint32_t magic;
+        uint32_t stream_id;
+    };
+};
+
+env {
+    domain = "rtostrace";
+    tracer_name = "nuclei_sdk_rtostrace";
+};
+
+clock {
+    name = cycle_counter;
+    freq = %d;
+    offset = 0;
+};
+
+typealias integer { size = 64; align = 8; signed = false; map = clock.cycle_counter.value; } := uint64_clock_t;
+
+stream {
+    id = 0;
+    packet.context := struct {
+        uint64_clock_t timestamp_begin;
+        uint64_clock_t timestamp_end;
+        uint64_t content_size;
+        uint64_t packet_size;
+        uint32_t cpu_id;
+    };
+    event.header := struct {
+        uint8_t id;
+        uint64_clock_t timestamp;
+    };
+};
+"""
+
+CTF_EVENT = """
+event {
+    name = "%s";
+    id = %d;
+    stream_id = 0;
+    fields := struct {
+        uint32_t %s;
+        uint16_t %s;
+        string label;
+    };
+};
+"""
+
+
+def to_ctf(hdr, names, cores, outdir):
+    """
+    Writes a CTF 1.8 trace directory with metadata and one stream file of one packet
+    for each hart, which can be read by babeltrace2 and Trace Compass.
+    """
+    os.makedirs(outdir, exist_ok=True)
+    with open(os.path.join(outdir, "metadata"), "w") as mf:
+        mf.write(CTF_METADATA_HEAD % hdr["freq"])
+        for evtype in sorted(EVENT_TYPES.keys()):
+            mf.write(CTF_EVENT % ((EVENT_TYPES[evtype][0], evtype) + EVENT_TYPES[evtype][1:]))
+
+    ctxsize = struct.calcsize("<IIQQQQI")
+    for hart, _lost, events in cores:
+        body = bytearray()
+        for ts, evtype, arg16, arg in events:
+            if evtype not in EVENT_TYPES:
+                continue
+            if evtype in (EV_ISR_ENTER, EV_ISR_EXIT, EV_OBJ_RESULT, EV_USER):
+                label = ""
+            elif EV_OBJ_POST <= evtype <= EV_OBJ_GET:
+                label = name_of(names, arg, kind_of(arg16))
+            else:
+                label = name_of(names, arg)
+            body += struct.pack("<BQIH", evtype, ts, arg, arg16)
+            body += label.encode("utf-8") + b"\0"
+        tsbegin = events[0][0] if events else 0
+        tsend = events[-1][0] if events else 0
+        size = (ctxsize + len(body)) * 8
+        packet = struct.pack("<IIQQQQI", CTF_MAGIC, 0, tsbegin, tsend, size, size, hart) + body
+        with open(os.path.join(outdir, f"stream_{hart}"), "wb") as sf:
+            sf.write(packet)
+
+
+def print_stats(timeline, cores, outfile=sys.stderr):
+    freq = timeline.hdr["freq"]
+    duration = (timeline.tend - timeline.t0) * 1000000.0 / freq
+    print(f"# {len(timeline.events)} events in {duration:.1f} us, timestamp freq {freq} Hz, "
+          f"{timeline.inherits} priority inheritances", file=outfile)
+    for hart, lost, events in cores:
+        if lost:
+            print(f"# hart{hart}: {lost} events lost, buffer is too small", file=outfile)
+    if timeline.latency:
+        print("# wakeup to running latency in us: task count min avg max", file=outfile)
+        for taskid, lats in sorted(timeline.latency.items(), key=lambda item: -max(item[1])):
+            lats = [lat * 1000000.0 / freq for lat in lats]
+            print(f"{name_of(timeline.names, taskid)} {len(lats)} {min(lats):.2f} "
+                  f"{sum(lats) / len(lats):.2f} {max(lats):.2f}", file=outfile)
+
+
+# NOTE: rtostrace.bin is generated by parse.py from the console log which contains
+# Dump rtostrace data start ... Dump rtostrace data finished
+# python nuclei_sdk/Components/profiling/rtostrace_convert.py rtostrace.bin -o trace.json
+# then open trace.json in https://ui.perfetto.dev
+# python nuclei_sdk/Components/profiling/rtostrace_convert.py rtostrace.bin -f ctf -o trace_ctf
+# then babeltrace2 trace_ctf or open it in Trace Compass
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert rtostrace.bin into Perfetto json or CTF trace")
+    parser.add_argument("binfile", help="rtostrace.bin generated by parse.py")
+    parser.add_argument("-f", "--format", choices=["perfetto", "ctf", "stats"], default="perfetto",
+                        help="output format, default %(default)s, stats only prints latency statistics")
+    parser.add_argument("-o", "--output", help="output json file of perfetto or directory of ctf, "
+                        "default rtostrace.json or rtostrace_ctf")
+    args = parser.parse_args()
+
+    result = parse_rtostrace_bin(args.binfile)
+    if result is None:
+        sys.exit(1)
+    hdr, names, cores = result
+    timeline = Timeline(hdr, names, cores)
+    if args.format == "perfetto":
+        output = args.output or "rtostrace.json"
+        to_perfetto(timeline, output)
+        print(f"Write perfetto trace {output} done, open it in https://ui.perfetto.dev", file=sys.stderr)
+    elif args.format == "ctf":
+        output = args.output or "rtostrace_ctf"
+        to_ctf(hdr, names, cores, output)
+        print(f"Write CTF trace {output} done", file=sys.stderr)
+    print_stats(timeline, cores, sys.stderr if args.format != "stats" else sys.stdout)
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _RTOSTRACE_FREERTOS_H_
+#define _RTOSTRACE_FREERTOS_H_
+
+/*
+ * FreeRTOS glue of rtostrace, include it at the end of FreeRTOSConfig.h,
+ * trace macros already defined in FreeRTOSConfig.h are kept.
+ * Queues registered by vQueueAddToRegistry get their names in the trace.
+ */
+#include "rtostrace_api.h"
+
+#if !defined(configUSE_TRACE_FACILITY) || (configUSE_TRACE_FACILITY == 0)
+#error "rtostrace requires configUSE_TRACE_FACILITY to be 1, queue type is used to tell queue, semaphore and mutex"
+#endif
+
+/* kind of queue object, only used in queue.c where Queue_t is complete */
+#define RTOSTRACE_FREERTOS_KIND(q)                                                                  \
+    ((((q)->ucQueueType == queueQUEUE_TYPE_MUTEX) ||                                                \
+      ((q)->ucQueueType == queueQUEUE_TYPE_RECURSIVE_MUTEX)) ? RTOSTRACE_OBJ_MUTEX :                \
+     (((q)->ucQueueType == queueQUEUE_TYPE_COUNTING_SEMAPHORE) ||                                   \
+      ((q)->ucQueueType == queueQUEUE_TYPE_BINARY_SEMAPHORE)) ? RTOSTRACE_OBJ_SEM : RTOSTRACE_OBJ_QUEUE)
+
+#define RTOSTRACE_FREERTOS_OBJ(ev, q, flags)    \
+    rtostrace_record((ev), (uint16_t)(RTOSTRACE_FREERTOS_KIND(q) | (flags)), RTOSTRACE_ID(q))
+
+#define RTOSTRACE_FREERTOS_TASK(ev, tcb, prio)  \
+    rtostrace_record((ev), (uint16_t)(prio), RTOSTRACE_ID(tcb))
+
+/* tasks.c */
+#ifndef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN()     RTOSTRACE_FREERTOS_TASK(RTOSTRACE_EV_TASK_SWITCH, pxCurrentTCB, pxCurrentTCB->uxPriority)
+#endif
+
+#ifndef traceTASK_CREATE
+#define traceTASK_CREATE(pxNewTCB)                                                  \
+    do {                                                                            \
+        rtostrace_set_name(RTOSTRACE_ID(pxNewTCB), RTOSTRACE_OBJ_TASK, (pxNewTCB)->pcTaskName); \
+        RTOSTRACE_FREERTOS_TASK(RTOSTRACE_EV_TASK_CREATE, pxNewTCB, (pxNewTCB)->uxPriority); \
+    } while (0)
+#endif
+
+#ifndef traceTASK_DELETE
+#define traceTASK_DELETE(pxTaskToDelete)    RTOSTRACE_FREERTOS_TASK(RTOSTRACE_EV_TASK_DELETE, pxTaskToDelete, 0)
+#endif
+
+#ifndef traceMOVED_TASK_TO_READY_STATE
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)   RTOSTRACE_FREERTOS_TASK(RTOSTRACE_EV_TASK_READY, pxTCB, (pxTCB)->uxPriority)
+#endif
+
+#ifndef traceTASK_DELAY
+#define traceTASK_DELAY()           RTOSTRACE_FREERTOS_TASK(RTOSTRACE_EV_TASK_SUSPEND, pxCurrentTCB, 0)
+#endif
+
+#ifndef traceTASK_DELAY_UNTIL
+#define traceTASK_DELAY_UNTIL(xTimeToWake)  RTOSTRACE_FREERTOS_TASK(RTOSTRACE_EV_TASK_SUSPEND, pxCurrentTCB, 0)
+#endif
+
+#ifndef traceTASK_SUSPEND
+#define traceTASK_SUSPEND(pxTaskToSuspend)  RTOSTRACE_FREERTOS_TASK(RTOSTRACE_EV_TASK_SUSPEND, pxTaskToSuspend, 0)
+#endif
+
+#ifndef traceTASK_PRIORITY_INHERIT
+#define traceTASK_PRIORITY_INHERIT(pxTCBOfMutexHolder, uxInheritedPriority) \
+    RTOSTRACE_FREERTOS_TASK(RTOSTRACE_EV_PRIO_INHERIT, pxTCBOfMutexHolder, uxInheritedPriority)
+#endif
+
+#ifndef traceTASK_PRIORITY_DISINHERIT
+#define traceTASK_PRIORITY_DISINHERIT(pxTCBOfMutexHolder, uxOriginalPriority) \
+    RTOSTRACE_FREERTOS_TASK(RTOSTRACE_EV_PRIO_DISINHERIT, pxTCBOfMutexHolder, uxOriginalPriority)
+#endif
+
+/* queue.c, semaphores and mutexes are queues */
+#ifndef traceQUEUE_REGISTRY_ADD
+#define traceQUEUE_REGISTRY_ADD(xQueue, pcQueueName)    \
+    rtostrace_set_name(RTOSTRACE_ID(xQueue), RTOSTRACE_FREERTOS_KIND(xQueue), pcQueueName)
+#endif
+
+#ifndef traceQUEUE_SEND
+#define traceQUEUE_SEND(pxQueue)    RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_POST, pxQueue, 0)
+#endif
+
+#ifndef traceQUEUE_SEND_FAILED
+#define traceQUEUE_SEND_FAILED(pxQueue)     RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_POST, pxQueue, RTOSTRACE_FLAG_FAILED)
+#endif
+
+#ifndef traceQUEUE_SEND_FROM_ISR
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)   RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_POST, pxQueue, RTOSTRACE_FLAG_FROM_ISR)
+#endif
+
+#ifndef traceQUEUE_SEND_FROM_ISR_FAILED
+#define traceQUEUE_SEND_FROM_ISR_FAILED(pxQueue)    \
+    RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_POST, pxQueue, RTOSTRACE_FLAG_FROM_ISR | RTOSTRACE_FLAG_FAILED)
+#endif
+
+#ifndef traceQUEUE_RECEIVE
+#define traceQUEUE_RECEIVE(pxQueue) RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_GET, pxQueue, 0)
+#endif
+
+#ifndef traceQUEUE_RECEIVE_FAILED
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)  RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_GET, pxQueue, RTOSTRACE_FLAG_FAILED)
+#endif
+
+#ifndef traceQUEUE_RECEIVE_FROM_ISR
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)    RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_GET, pxQueue, RTOSTRACE_FLAG_FROM_ISR)
+#endif
+
+#ifndef traceQUEUE_RECEIVE_FROM_ISR_FAILED
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED(pxQueue) \
+    RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_GET, pxQueue, RTOSTRACE_FLAG_FROM_ISR | RTOSTRACE_FLAG_FAILED)
+#endif
+
+#ifndef traceBLOCKING_ON_QUEUE_SEND
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)    RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_BLOCK, pxQueue, 0)
+#endif
+
+#ifndef traceBLOCKING_ON_QUEUE_RECEIVE
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_BLOCK, pxQueue, 0)
+#endif
+
+#ifndef traceBLOCKING_ON_QUEUE_PEEK
+#define traceBLOCKING_ON_QUEUE_PEEK(pxQueue)    RTOSTRACE_FREERTOS_OBJ(RTOSTRACE_EV_OBJ_BLOCK, pxQueue, 0)
+#endif
+
+/* called by xPortSysTickHandler, and user interrupt handlers if wanted */
+#ifndef traceISR_ENTER
+#define traceISR_ENTER()            rtostrace_isr_enter()
+#endif
+
+#ifndef traceISR_EXIT
+#define traceISR_EXIT()             rtostrace_isr_exit()
+#endif
+
+#ifndef traceISR_EXIT_TO_SCHEDULER
+#define traceISR_EXIT_TO_SCHEDULER()    rtostrace_isr_exit()
+#endif
+
+#endif /* !_RTOSTRACE_FREERTOS_H_ */
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * Kernel glue of rtostrace which needs functions, FreeRTOS and uC/OS-II
+ * only need macros, see rtostrace_freertos.h and os_trace_events.h
+ */
+#include <stdint.h>
+#include <string.h>
+#include "rtostrace_api.h"
+
+#if defined(RTOS_THREADX)
+#include "tx_api.h"
+#include "tx_trace.h"
+
+/* only when rtostrace_threadx.h is included by tx_user.h, other tools may use the same hooks */
+#ifdef _RTOSTRACE_THREADX_H_
+VOID _tx_execution_thread_enter(VOID)
+{
+    TX_THREAD *thread = tx_thread_identify();
+
+    if (thread != TX_NULL) {
+        rtostrace_record(RTOSTRACE_EV_TASK_SWITCH, (uint16_t)thread->tx_thread_priority, RTOSTRACE_ID(thread));
+    }
+}
+
+/* ThreadX has no idle thread, switch to id 0 until next thread is found */
+VOID _tx_execution_thread_exit(VOID)
+{
+    rtostrace_record(RTOSTRACE_EV_TASK_SWITCH, 0, 0);
+}
+
+VOID _tx_execution_isr_enter(VOID)
+{
+    rtostrace_isr_enter();
+}
+
+VOID _tx_execution_isr_exit(VOID)
+{
+    rtostrace_isr_exit();
+}
+
+/* Called by TX_TRACE_IN_LINE_INSERT defined in rtostrace_threadx.h, object calls are recorded at entry */
+void rtostrace_threadx_event(unsigned long id, unsigned long info1, unsigned long info2)
+{
+    switch (id) {
+        case TX_TRACE_THREAD_CREATE:
+            rtostrace_set_name(RTOSTRACE_ID(info1), RTOSTRACE_OBJ_TASK, ((TX_THREAD *)info1)->tx_thread_name);
+            rtostrace_record(RTOSTRACE_EV_TASK_CREATE, (uint16_t)info2, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_THREAD_DELETE:
+            rtostrace_record(RTOSTRACE_EV_TASK_DELETE, 0, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_THREAD_RESUME:
+            rtostrace_record(RTOSTRACE_EV_TASK_READY, 0, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_THREAD_SUSPEND:
+            rtostrace_record(RTOSTRACE_EV_TASK_SUSPEND, 0, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_QUEUE_CREATE:
+            rtostrace_set_name(RTOSTRACE_ID(info1), RTOSTRACE_OBJ_QUEUE, ((TX_QUEUE *)info1)->tx_queue_name);
+            break;
+        case TX_TRACE_QUEUE_SEND:
+        case TX_TRACE_QUEUE_FRONT_SEND:
+            rtostrace_record(RTOSTRACE_EV_OBJ_POST, RTOSTRACE_OBJ_QUEUE, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_QUEUE_RECEIVE:
+            rtostrace_record(RTOSTRACE_EV_OBJ_PEND, RTOSTRACE_OBJ_QUEUE, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_SEMAPHORE_CREATE:
+            rtostrace_set_name(RTOSTRACE_ID(info1), RTOSTRACE_OBJ_SEM, ((TX_SEMAPHORE *)info1)->tx_semaphore_name);
+            break;
+        case TX_TRACE_SEMAPHORE_PUT:
+        case TX_TRACE_SEMAPHORE_CEILING_PUT:
+            rtostrace_record(RTOSTRACE_EV_OBJ_POST, RTOSTRACE_OBJ_SEM, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_SEMAPHORE_GET:
+            rtostrace_record(RTOSTRACE_EV_OBJ_PEND, RTOSTRACE_OBJ_SEM, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_MUTEX_CREATE:
+            rtostrace_set_name(RTOSTRACE_ID(info1), RTOSTRACE_OBJ_MUTEX, ((TX_MUTEX *)info1)->tx_mutex_name);
+            break;
+        case TX_TRACE_MUTEX_PUT:
+            rtostrace_record(RTOSTRACE_EV_OBJ_POST, RTOSTRACE_OBJ_MUTEX, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_MUTEX_GET:
+            rtostrace_record(RTOSTRACE_EV_OBJ_PEND, RTOSTRACE_OBJ_MUTEX, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_EVENT_FLAGS_CREATE:
+            rtostrace_set_name(RTOSTRACE_ID(info1), RTOSTRACE_OBJ_EVENT,
+                               ((TX_EVENT_FLAGS_GROUP *)info1)->tx_event_flags_group_name);
+            break;
+        case TX_TRACE_EVENT_FLAGS_SET:
+            rtostrace_record(RTOSTRACE_EV_OBJ_POST, RTOSTRACE_OBJ_EVENT, RTOSTRACE_ID(info1));
+            break;
+        case TX_TRACE_EVENT_FLAGS_GET:
+            rtostrace_record(RTOSTRACE_EV_OBJ_PEND, RTOSTRACE_OBJ_EVENT, RTOSTRACE_ID(info1));
+            break;
+        default:
+            break;
+    }
+}
+#endif /* _RTOSTRACE_THREADX_H_ */
+
+#elif defined(RTOS_RTTHREAD)
+#include <rtthread.h>
+
+#ifdef RT_USING_HOOK
+static uint16_t rtostrace_rtthread_kind(struct rt_object *object)
+{
+    switch (rt_object_get_type(object)) {
+        case RT_Object_Class_Thread:
+            return RTOSTRACE_OBJ_TASK;
+        case RT_Object_Class_Semaphore:
+            return RTOSTRACE_OBJ_SEM;
+        case RT_Object_Class_Mutex:
+            return RTOSTRACE_OBJ_MUTEX;
+        case RT_Object_Class_Event:
+            return RTOSTRACE_OBJ_EVENT;
+        case RT_Object_Class_MailBox:
+            return RTOSTRACE_OBJ_MAILBOX;
+        case RT_Object_Class_MessageQueue:
+            return RTOSTRACE_OBJ_QUEUE;
+        default:
+            return RTOSTRACE_OBJ_OTHER;
+    }
+}
+
+/* object name may fill RT_NAME_MAX without terminator */
+static void rtostrace_rtthread_name(struct rt_object *object)
+{
+    char name[RT_NAME_MAX + 1];
+
+    memcpy(name, object->name, RT_NAME_MAX);
+    name[RT_NAME_MAX] = '\0';
+    rtostrace_set_name(RTOSTRACE_ID(object), (uint8_t)rtostrace_rtthread_kind(object), name);
+}
+
+static void rtostrace_rtthread_switch(struct rt_thread *from, struct rt_thread *to)
+{
+    rtostrace_record(RTOSTRACE_EV_TASK_SWITCH, to->current_priority, RTOSTRACE_ID(to));
+}
+
+static void rtostrace_rtthread_inited(rt_thread_t thread)
+{
+    rtostrace_rtthread_name((struct rt_object *)thread);
+    rtostrace_record(RTOSTRACE_EV_TASK_CREATE, thread->init_priority, RTOSTRACE_ID(thread));
+}
+
+static void rtostrace_rtthread_suspend(rt_thread_t thread)
+{
+    rtostrace_record(RTOSTRACE_EV_TASK_SUSPEND, 0, RTOSTRACE_ID(thread));
+}
+
+static void rtostrace_rtthread_resume(rt_thread_t thread)
+{
+    rtostrace_record(RTOSTRACE_EV_TASK_READY, thread->current_priority, RTOSTRACE_ID(thread));
+}
+
+/* names of ipc objects are set when they are created */
+static void rtostrace_rtthread_attach(struct rt_object *object)
+{
+    if (rt_object_get_type(object) != RT_Object_Class_Thread) {
+        rtostrace_rtthread_name(object);
+    }
+}
+
+static void rtostrace_rtthread_put(struct rt_object *object)
+{
+    rtostrace_record(RTOSTRACE_EV_OBJ_POST, rtostrace_rtthread_kind(object), RTOSTRACE_ID(object));
+}
+
+static void rtostrace_rtthread_trytake(struct rt_object *object)
+{
+    rtostrace_record(RTOSTRACE_EV_OBJ_PEND, rtostrace_rtthread_kind(object), RTOSTRACE_ID(object));
+}
+
+static void rtostrace_rtthread_take(struct rt_object *object)
+{
+    rtostrace_record(RTOSTRACE_EV_OBJ_GET, rtostrace_rtthread_kind(object), RTOSTRACE_ID(object));
+}
+
+void rtostrace_rtthread_init(void)
+{
+    rt_scheduler_sethook(rtostrace_rtthread_switch);
+    rt_interrupt_enter_sethook(rtostrace_isr_enter);
+    rt_interrupt_leave_sethook(rtostrace_isr_exit);
+    rt_thread_inited_sethook(rtostrace_rtthread_inited);
+    rt_thread_suspend_sethook(rtostrace_rtthread_suspend);
+    rt_thread_resume_sethook(rtostrace_rtthread_resume);
+    rt_object_attach_sethook(rtostrace_rtthread_attach);
+    rt_object_put_sethook(rtostrace_rtthread_put);
+    rt_object_trytake_sethook(rtostrace_rtthread_trytake);
+    rt_object_take_sethook(rtostrace_rtthread_take);
+}
+#endif /* RT_USING_HOOK */
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _RTOSTRACE_THREADX_H_
+#define _RTOSTRACE_THREADX_H_
+
+/*
+ * ThreadX glue of rtostrace, include it in tx_user.h.
+ *
+ * Kernel trace points of ThreadX event trace are redirected to rtostrace,
+ * so TraceX buffer set by tx_trace_enable is not filled any more.
+ * Thread switches and timer interrupts are reported by the execution
+ * change notification of the port, see PortThreadSwitch and SysTick_Handler.
+ */
+#ifndef TX_ENABLE_EVENT_TRACE
+#define TX_ENABLE_EVENT_TRACE
+#endif
+
+#ifndef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+#define TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+#endif
+
+/* tx_user.h is included before ULONG is defined, ULONG is unsigned long in tx_port.h */
+void rtostrace_threadx_event(unsigned long id, unsigned long info1, unsigned long info2);
+
+#define TX_TRACE_IN_LINE_INSERT(i, a, b, c, d, e)   \
+        { \
+            rtostrace_threadx_event((unsigned long)(i), (unsigned long)(a), (unsigned long)(b)); \
+        }
+
+#endif /* !_RTOSTRACE_THREADX_H_ */
@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "stackprof_api.h"
+
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+
+// system timer interrupt is already used as tick by RTOS or owned by hrtimer component,
+// so it is never taken over here, stackprof_sample must be called by the owner of it
+#if defined(RTOS_FREERTOS) || defined(RTOS_UCOSII) || defined(RTOS_THREADX) || defined(RTOS_RTTHREAD) \
+    || defined(WITH_COMPONENT_HRTIMER)
+#ifndef STACKPROF_SAMPLE_EXTERNAL
+#define STACKPROF_SAMPLE_EXTERNAL
+#endif
+#endif
+
+#define STACKPROF_STATE_OFF     0
+#define STACKPROF_STATE_ON      1
+
+/* Sample in period interrupt, defined in STACKPROF_SAMPLE_HZ */
+#define STACKPROF_TIMER_TICKS   (SOC_TIMER_FREQ / STACKPROF_SAMPLE_HZ)
+
+#define STACKPROF_RING_MASK     (STACKPROF_RING_NUM - 1)
+#define STACKPROF_STACK_MASK    (STACKPROF_STACK_NUM - 1)
+#define STACKPROF_CACHE_LINE    64
+#define XLEN_BYTES              (sizeof(unsigned long))
+/* mepc is saved at this word of the context pushed by irq_entry, see SAVE_CSR_CONTEXT */
+#define STACKPROF_MEPC_WORD     12
+
+#if (STACKPROF_RING_NUM & STACKPROF_RING_MASK) != 0
+#error "STACKPROF_RING_NUM must be power of 2"
+#endif
+
+#if (STACKPROF_STACK_NUM & STACKPROF_STACK_MASK) != 0
+#error "STACKPROF_STACK_NUM must be power of 2"
+#endif
+
+/*
+ * Ring of one hart, head and the producer fields are only written by the
+ * hart itself in sampling interrupt, tail is only written by the aggregating
+ * hart, head and tail are free running counters, empty when head == tail.
+ */
+typedef struct stackprof_ring {
+    volatile uint32_t head;
+    uint32_t tag;                           /* tag of running task */
+    unsigned long stack_lo;                 /* stack bounds of running task */
+    unsigned long stack_hi;
+    uint32_t dropped;                       /* samples dropped when ring is full */
+    uint32_t truncated;                     /* samples longer than STACKPROF_MAX_DEPTH */
+    uint8_t pad0[STACKPROF_CACHE_LINE - 4 * sizeof(uint32_t) - 2 * sizeof(unsigned long)];
+    volatile uint32_t tail;
+    uint8_t pad1[STACKPROF_CACHE_LINE - sizeof(uint32_t)];
+    stackprof_stack_t buf[STACKPROF_RING_NUM];
+} stackprof_ring_t;
+
+/* must be placed in memory shared by all harts */
+static stackprof_ring_t stackprof_rings[STACKPROF_MAX_CORES] __ALIGNED(STACKPROF_CACHE_LINE);
+static stackprof_stack_t stackprof_stacks[STACKPROF_STACK_NUM];
+static stackprof_name_t stackprof_names[STACKPROF_MAX_NAMES];
+
+static struct {
+    volatile uint8_t state;
+    volatile uint32_t aggregating;
+    uint32_t stack_num;                     /* used entries of stackprof_stacks */
+    uint32_t name_num;                      /* used entries of stackprof_names */
+    uint32_t samples;                       /* samples aggregated */
+    uint32_t dropped;                       /* samples dropped when table is full */
+} stackprof_ctx;
+
+/* Where the stackprof data stored after execute stackprof_collect(0) */
+struct stackprofdata stackprof_data = {NULL, 0};
+
+/* entry of non-vector interrupts, provided by SoC or RTOS port */
+extern void irq_entry(void);
+/* stack of baremetal and interrupts, defined by linker */
+extern char __StackLimit[];
+extern char __StackTop[];
+
+/* frame record of fp is at fp - 2 * XLEN_BYTES, it must be in task stack or interrupt stack */
+static inline int stackprof_valid_fp(unsigned long fp, const stackprof_ring_t *ring)
+{
+    if ((fp & (XLEN_BYTES - 1)) != 0) {
+        return 0;
+    }
+    if ((fp >= ring->stack_lo + 2 * XLEN_BYTES) && (fp <= ring->stack_hi)) {
+        return 1;
+    }
+    if ((fp >= (unsigned long)__StackLimit + 2 * XLEN_BYTES) && (fp <= (unsigned long)__StackTop)) {
+        return 1;
+    }
+    return 0;
+}
+
+__attribute__((noinline)) void stackprof_sample(void)
+{
+    stackprof_ring_t *ring;
+    stackprof_stack_t *smp;
+    unsigned long fp, prev, ra, pc;
+    uint32_t head, depth, i, idx = 0;
+    rv_csr_t mstatus;
+
+    if (stackprof_ctx.state != STACKPROF_STATE_ON) {
+        return;
+    }
+    /* interrupt disabled, so the sample is not interleaved and the hart is not changed */
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+#if STACKPROF_MAX_CORES > 1
+    idx = __get_hart_index();
+    if (idx >= STACKPROF_MAX_CORES) {
+        __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+        return;
+    }
+#endif
+    ring = &stackprof_rings[idx];
+    head = ring->head;
+    if (head - ring->tail >= STACKPROF_RING_NUM) {
+        ring->dropped++;
+        __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+        return;
+    }
+
+    /* walk interrupt handler frames up to the one which returns into irq_entry */
+    fp = (unsigned long)__builtin_frame_address(0);
+    for (i = 0; i < STACKPROF_MAX_DEPTH; i++) {
+        if (stackprof_valid_fp(fp, ring) == 0) {
+            break;
+        }
+        ra = *(unsigned long *)(fp - XLEN_BYTES);
+        if (ra - (unsigned long)irq_entry < STACKPROF_IRQ_ENTRY_SIZE) {
+            break;
+        }
+        fp = *(unsigned long *)(fp - 2 * XLEN_BYTES);
+    }
+    if ((i < STACKPROF_MAX_DEPTH) && (stackprof_valid_fp(fp, ring) != 0)) {
+        /* fp of handler is its sp at entry, which points to context saved by irq_entry */
+#if defined(ECLIC_HW_CTX_AUTO) && defined(CFG_HAS_ECLICV2)
+        pc = __RV_CSR_READ(CSR_MEPC);
+#else
+        pc = *(unsigned long *)(fp + STACKPROF_MEPC_WORD * XLEN_BYTES);
+#endif
+        /* s0 is callee saved, so handler frame record holds fp of interrupted code */
+        fp = *(unsigned long *)(fp - 2 * XLEN_BYTES);
+    } else {
+        /* handler not built with frame pointer, only pc is recorded */
+        pc = __RV_CSR_READ(CSR_MEPC);
+        fp = 0;
+    }
+
+    smp = &ring->buf[head & STACKPROF_RING_MASK];
+    smp->pcs[0] = pc;
+    depth = 1;
+    prev = 0;
+    /* frames of interrupted code, frame pointer must move to caller */
+    while ((fp > prev) && (stackprof_valid_fp(fp, ring) != 0)) {
+        ra = *(unsigned long *)(fp - XLEN_BYTES);
+        if (ra == 0) {
+            break;
+        }
+        if (depth >= STACKPROF_MAX_DEPTH) {
+            ring->truncated++;
+            break;
+        }
+        smp->pcs[depth++] = ra;
+        prev = fp;
+        fp = *(unsigned long *)(fp - 2 * XLEN_BYTES);
+    }
+    smp->depth = depth;
+    smp->hart = idx;
+    smp->tag = ring->tag;
+    /* sample must be visible before head moves */
+    __SMP_RWMB();
+    ring->head = head + 1;
+    __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+}
+
+void stackprof_set_task(uint32_t tag, unsigned long stack_lo, unsigned long stack_hi)
+{
+    stackprof_ring_t *ring;
+    unsigned long idx = 0;
+    rv_csr_t mstatus;
+
+#if STACKPROF_MAX_CORES > 1
+    idx = __get_hart_index();
+    if (idx >= STACKPROF_MAX_CORES) {
+        return;
+    }
+#endif
+    ring = &stackprof_rings[idx];
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    ring->tag = tag;
+    ring->stack_lo = stack_lo;
+    ring->stack_hi = stack_hi;
+    __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+}
+
+static int stackprof_trylock(void)
+{
+#if defined(__riscv_atomic)
+    if (__AMOSWAP_W(&stackprof_ctx.aggregating, 1) != 0) {
+        return -1;
+    }
+    __SMP_RWMB();
+    return 0;
+#else
+    int ret = -1;
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    if (stackprof_ctx.aggregating == 0) {
+        stackprof_ctx.aggregating = 1;
+        ret = 0;
+    }
+    __RV_CSR_WRITE(CSR_MSTATUS, mstatus);
+    return ret;
+#endif
+}
+
+static void stackprof_unlock(void)
+{
+    __SMP_RWMB();
+    stackprof_ctx.aggregating = 0;
+}
+
+int stackprof_set_tag_name(uint32_t tag, const char *name)
+{
+    stackprof_name_t *entry = NULL;
+    uint32_t i;
+
+    if ((name == NULL) || (stackprof_trylock() != 0)) {
+        return -1;
+    }
+    for (i = 0; i < stackprof_ctx.name_num; i++) {
+        if (stackprof_names[i].tag == tag) {
+            entry = &stackprof_names[i];
+            break;
+        }
+    }
+    if ((entry == NULL) && (stackprof_ctx.name_num < STACKPROF_MAX_NAMES)) {
+        entry = &stackprof_names[stackprof_ctx.name_num++];
+    }
+    if (entry != NULL) {
+        entry->tag = tag;
+        strncpy(entry->name, name, STACKPROF_NAME_LEN - 1);
+        entry->name[STACKPROF_NAME_LEN - 1] = '\0';
+    }
+    stackprof_unlock();
+    return (entry != NULL) ? 0 : -1;
+}
+
+/* FNV-1a hash of stack key */
+static uint32_t stackprof_hash(const stackprof_stack_t *smp)
+{
+    uint32_t hash = 2166136261UL;
+    unsigned long word;
+    uint32_t i, j;
+
+    for (i = 0; i < (uint32_t)smp->depth + 1; i++) {
+        word = (i == 0) ? (((unsigned long)smp->tag << 8) ^ smp->hart) : smp->pcs[i - 1];
+        for (j = 0; j < XLEN_BYTES; j++) {
+            hash = (hash ^ (uint8_t)(word >> (j * 8))) * 16777619UL;
+        }
+    }
+    return hash;
+}
+
+static int stackprof_same(const stackprof_stack_t *a, const stackprof_stack_t *b)
+{
+    return (a->hash == b->hash) && (a->tag == b->tag) && (a->hart == b->hart) && (a->depth == b->depth) &&
+           (memcmp(a->pcs, b->pcs, a->depth * XLEN_BYTES) == 0);
+}
+
+/* add one sample into table, open addressing with linear probing */
+static void stackprof_insert(stackprof_stack_t *smp)
+{
+    stackprof_stack_t *entry;
+    uint32_t i, slot;
+
+    smp->hash = stackprof_hash(smp);
+    slot = smp->hash & STACKPROF_STACK_MASK;
+    for (i = 0; i < STACKPROF_STACK_NUM; i++) {
+        entry = &stackprof_stacks[(slot + i) & STACKPROF_STACK_MASK];
+        if (entry->count == 0) {
+            memcpy(entry, smp, sizeof(*entry) - (STACKPROF_MAX_DEPTH - smp->depth) * XLEN_BYTES);
+            entry->count = 1;
+            stackprof_ctx.stack_num++;
+            stackprof_ctx.samples++;
+            return;
+        }
+        if (stackprof_same(entry, smp)) {
+            entry->count++;
+            stackprof_ctx.samples++;
+            return;
+        }
+    }
+    stackprof_ctx.dropped++;
+}
+
+uint32_t stackprof_aggregate(void)
+{
+    stackprof_ring_t *ring;
+    stackprof_stack_t smp;
+    uint32_t core, tail, moved = 0;
+
+    if (stackprof_trylock() != 0) {
+        return 0;
+    }
+    for (core = 0; core < STACKPROF_MAX_CORES; core++) {
+        ring = &stackprof_rings[core];
+        for (tail = ring->tail; tail != ring->head; tail++) {
+            /* read sample after head */
+            __SMP_RWMB();
+            memcpy(&smp, &ring->buf[tail & STACKPROF_RING_MASK], sizeof(smp));
+            /* sample must be consumed before the slot is given back */
+            __SMP_RWMB();
+            ring->tail = tail + 1;
+            stackprof_insert(&smp);
+            moved++;
+        }
+    }
+    stackprof_unlock();
+    return moved;
+}
+
+void stackprof_reset(void)
+{
+    uint32_t core;
+
+    while (stackprof_trylock() != 0);
+    for (core = 0; core < STACKPROF_MAX_CORES; core++) {
+        stackprof_rings[core].tail = stackprof_rings[core].head;
+        stackprof_rings[core].dropped = 0;
+        stackprof_rings[core].truncated = 0;
+    }
+    memset(stackprof_stacks, 0, sizeof(stackprof_stacks));
+    stackprof_ctx.stack_num = 0;
+    stackprof_ctx.samples = 0;
+    stackprof_ctx.dropped = 0;
+    stackprof_unlock();
+}
+
+#ifndef STACKPROF_SAMPLE_EXTERNAL
+// timer interrupt handler
+// non-vector mode interrupt, so stackprof_sample can find the context saved by irq_entry
+static void stackprof_timer_handler(void)
+{
+    // Reload Timer Interrupt
+    SysTick_Reload(STACKPROF_TIMER_TICKS);
+
+    stackprof_sample();
+}
+#endif
+
+/* Start sampling */
+void stackprof_on(void)
+{
+    stackprof_ctx.state = STACKPROF_STATE_ON;
+#ifndef STACKPROF_SAMPLE_EXTERNAL
+    SysTick_Config(STACKPROF_TIMER_TICKS);
+
+    // initialize timer interrupt as non-vector interrupt
+    ECLIC_Register_IRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT,
+            ECLIC_LEVEL_TRIGGER, 1, 0, stackprof_timer_handler);
+    // Enable IRQ
+    __enable_irq();
+#endif
+}
+
+/* Stop sampling */
+void stackprof_off(void)
+{
+    if (stackprof_ctx.state == STACKPROF_STATE_OFF) {
+        return;
+    }
+#ifndef STACKPROF_SAMPLE_EXTERNAL
+    ECLIC_DisableIRQ(SysTimer_IRQn);
+#endif
+    stackprof_ctx.state = STACKPROF_STATE_OFF;
+    __RWMB();
+}
+
+#define NUM_OCTETS_PER_LINE 20
+#define FLUSH_OUTPUT()      fflush(stdout)
+static void stackprof_hexdump(const void *data, unsigned long sz)
+{
+    const uint8_t *buf = (const uint8_t *)data;
+    unsigned long rem, cur = 0, i = 0;
+
+    FLUSH_OUTPUT();
+
+    while (cur < sz) {
+        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
+        for (i = 0; i < rem; i++) {
+            printf("%02x", buf[cur + i]);
+        }
+        printf("\n");
+        FLUSH_OUTPUT();
+        cur += rem;
+    }
+}
+
+/* write one block of collected data to buffer, file or console */
+static void stackprof_output(unsigned long interface, FILE *fp, char **bufptr, const void *data, unsigned long sz)
+{
+    if (interface == 0) {
+        memcpy(*bufptr, data, sz);
+        *bufptr += sz;
+    } else if (interface == 1) {
+        fwrite(data, 1, sz, fp);
+    } else {
+        stackprof_hexdump(data, sz);
+    }
+}
+
+long stackprof_collect(unsigned long interface)
+{
+    static const char stackprof_out[] = "stackprof.bin";
+    /* only valid pcs of each stack are written */
+    const unsigned long stack_hdr_size = offsetof(stackprof_stack_t, pcs);
+    FILE *fp = NULL;
+    stackprof_header_t hdr;
+    stackprof_stack_t *entry;
+    uint32_t core, i;
+    char *bufptr = NULL;
+    unsigned long size;
+
+    stackprof_off();
+    stackprof_aggregate();
+
+    hdr.magic = STACKPROF_MAGIC;
+    hdr.version = STACKPROF_VERSION;
+    hdr.xlen_bytes = XLEN_BYTES;
+    hdr.max_depth = STACKPROF_MAX_DEPTH;
+    hdr.stack_num = stackprof_ctx.stack_num;
+    hdr.name_num = stackprof_ctx.name_num;
+    hdr.samples = stackprof_ctx.samples;
+    hdr.dropped = stackprof_ctx.dropped;
+    hdr.truncated = 0;
+    for (core = 0; core < STACKPROF_MAX_CORES; core++) {
+        hdr.dropped += stackprof_rings[core].dropped;
+        hdr.truncated += stackprof_rings[core].truncated;
+    }
+    hdr.sample_hz = STACKPROF_SAMPLE_HZ;
+
+    if (interface == 0) {
+        size = sizeof(hdr) + hdr.name_num * sizeof(stackprof_name_t);
+        for (i = 0; i < STACKPROF_STACK_NUM; i++) {
+            if (stackprof_stacks[i].count != 0) {
+                size += stack_hdr_size + stackprof_stacks[i].depth * XLEN_BYTES;
+            }
+        }
+        free(stackprof_data.buf);
+        stackprof_data.size = 0;
+        stackprof_data.buf = malloc(size);
+        if (stackprof_data.buf == NULL) {
+            printf("stackprof_collect: unable to malloc enough memory to store stackprof data\n");
+            return -1;
+        }
+        bufptr = stackprof_data.buf;
+    } else if (interface == 1) {
+        fp = fopen(stackprof_out, "wb");
+        if (fp == NULL) {
+            printf("Unable to open %s\n", stackprof_out);
+            return -1;
+        }
+    } else {
+        printf("\nDump stackprof data start\n");
+    }
+
+    stackprof_output(interface, fp, &bufptr, &hdr, sizeof(hdr));
+    stackprof_output(interface, fp, &bufptr, stackprof_names, hdr.name_num * sizeof(stackprof_name_t));
+    for (i = 0; i < STACKPROF_STACK_NUM; i++) {
+        entry = &stackprof_stacks[i];
+        if (entry->count != 0) {
+            stackprof_output(interface, fp, &bufptr, entry, stack_hdr_size + entry->depth * XLEN_BYTES);
+        }
+    }
+
+    if (interface == 0) {
+        stackprof_data.size = bufptr - stackprof_data.buf;
+        printf("Collected stackprof data @0x%lx, size %u bytes\n", (unsigned long)(stackprof_data.buf), stackprof_data.size);
+    } else if (interface == 1) {
+        fclose(fp);
+        printf("Write %s done!\n", stackprof_out);
+    } else {
+        printf("\nCREATE: %s\n", stackprof_out);
+        printf("\nDump stackprof data finished\n");
+    }
+    return 0;
+}
+
+#endif /* #if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1) */
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _STACKPROF_API_H_
+#define _STACKPROF_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Sampling profiler with call stack capture
+ *
+ * A period interrupt captures the interrupted pc and the return addresses
+ * found by walking the frame pointer chain of the interrupted code, and
+ * pushes them into the ring buffer of current hart together with the tag
+ * of the running task. stackprof_aggregate() moves the samples into a
+ * table of unique stacks with hit counts, and stackprof_collect() dumps
+ * the table, which is converted into folded stacks for flame graphs by
+ * parse.py and stackprof_parse.py.
+ *
+ * Requirements:
+ * - all code, including the interrupt handler which calls stackprof_sample,
+ *   must be compiled with -fno-omit-frame-pointer
+ * - the period interrupt must be a non-vector interrupt entered through
+ *   irq_entry, whose saved context gives the interrupted pc
+ */
+
+/* sampling frequency, eg. 1000 means 1ms, 10000 means 100us */
+#ifndef STACKPROF_SAMPLE_HZ
+#define STACKPROF_SAMPLE_HZ     1000
+#endif
+
+/* max pcs of one stack, including the interrupted pc */
+#ifndef STACKPROF_MAX_DEPTH
+#define STACKPROF_MAX_DEPTH     16
+#endif
+
+/* samples kept in ring buffer of each hart before aggregated, must be power of 2,
+ * when full, new samples are dropped and counted */
+#ifndef STACKPROF_RING_NUM
+#define STACKPROF_RING_NUM      32
+#endif
+
+/* unique stacks kept in aggregated table, must be power of 2,
+ * when full, samples of new stacks are dropped and counted */
+#ifndef STACKPROF_STACK_NUM
+#define STACKPROF_STACK_NUM     128
+#endif
+
+/* max number of harts, hart index must be less than it */
+#ifndef STACKPROF_MAX_CORES
+#ifdef SMP_CPU_CNT
+#define STACKPROF_MAX_CORES     SMP_CPU_CNT
+#else
+#define STACKPROF_MAX_CORES     1
+#endif
+#endif
+
+/* max tag names set by stackprof_set_tag_name */
+#ifndef STACKPROF_MAX_NAMES
+#define STACKPROF_MAX_NAMES     16
+#endif
+#define STACKPROF_NAME_LEN      16
+
+/* a return address within this size from irq_entry marks the end of interrupt frames */
+#ifndef STACKPROF_IRQ_ENTRY_SIZE
+#define STACKPROF_IRQ_ENTRY_SIZE    512
+#endif
+
+// TODO define STACKPROF_SAMPLE_EXTERNAL if the system timer interrupt is already used
+// by RTOS or other program, then you need to call stackprof_sample() in your own
+// STACKPROF_SAMPLE_HZ period interrupt, such as RTOS tick hook, and stackprof_on/stackprof_off
+// will not touch any timer, it is always defined by stackprof.c when built with RTOS
+// or hrtimer component
+//#define STACKPROF_SAMPLE_EXTERNAL
+
+#define STACKPROF_MAGIC         0x46525053 /* "SPRF" */
+#define STACKPROF_VERSION       1
+
+/* header of collected data, followed by name_num names and stack_num stacks */
+typedef struct stackprof_header {
+    uint32_t magic;             /* STACKPROF_MAGIC */
+    uint16_t version;           /* STACKPROF_VERSION */
+    uint8_t xlen_bytes;         /* size of one pc */
+    uint8_t max_depth;          /* STACKPROF_MAX_DEPTH */
+    uint32_t stack_num;         /* number of stacks followed */
+    uint32_t name_num;          /* number of names followed */
+    uint32_t samples;           /* samples aggregated in total */
+    uint32_t dropped;           /* samples dropped when ring or table is full */
+    uint32_t truncated;         /* samples whose stack is longer than STACKPROF_MAX_DEPTH */
+    uint32_t sample_hz;         /* STACKPROF_SAMPLE_HZ */
+} stackprof_header_t;
+
+/* one tag name */
+typedef struct stackprof_name {
+    uint32_t tag;
+    char name[STACKPROF_NAME_LEN];
+} stackprof_name_t;
+
+/* one unique stack, pcs[0] is the interrupted pc, followed by return addresses from callee to caller */
+typedef struct stackprof_stack {
+    uint32_t count;             /* samples of this stack */
+    uint32_t tag;               /* tag of task running when sampled */
+    uint16_t depth;             /* valid pcs */
+    uint16_t hart;              /* hart index sampled */
+    uint32_t hash;
+    unsigned long pcs[STACKPROF_MAX_DEPTH];
+} stackprof_stack_t;
+
+/* Where the stackprof data stored after execute stackprof_collect(0) */
+struct stackprofdata {
+    char *buf;
+    unsigned int size;
+};
+extern struct stackprofdata stackprof_data;
+
+/* Do stack sample, call it in a STACKPROF_SAMPLE_HZ period non-vector interrupt handler */
+void stackprof_sample(void);
+
+/*
+ * Set tag and stack bounds of running task on current hart, such as in task switch hook,
+ * frame pointers out of [stack_lo, stack_hi) and the interrupt stack are not followed,
+ * if stack_hi is 0, only the interrupt stack is followed, which is the stack of baremetal
+ */
+void stackprof_set_task(uint32_t tag, unsigned long stack_lo, unsigned long stack_hi);
+
+/* Set name of tag shown in folded stacks, return 0 if successful */
+int stackprof_set_tag_name(uint32_t tag, const char *name);
+
+/* Move samples from ring buffers into aggregated table, return samples moved,
+ * call it in idle hook or low priority task, it is also called by stackprof_collect */
+uint32_t stackprof_aggregate(void);
+
+/* Clear all samples */
+void stackprof_reset(void);
+
+/* Start sampling, setup system timer interrupt on current hart if not STACKPROF_SAMPLE_EXTERNAL */
+void stackprof_on(void);
+/* Stop sampling */
+void stackprof_off(void);
+
+/* - if interface == 0, it will dump stackprof data in buffer called stackprof_data
+ * - if interface == 1, it will write stackprof.bin file using open/write api
+ * - otherwise it will dump stackprof data in console, which can be parsed by parse.py
+ */
+long stackprof_collect(unsigned long interface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_STACKPROF_API_H_ */
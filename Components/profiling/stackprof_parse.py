@@ -0,0 +1,135 @@
+#!/bin/env python3
+
+import os
+import sys
+import bisect
+import struct
+import argparse
+import subprocess
+
+STACKPROF_MAGIC = 0x46525053
+# see stackprof_header_t, stackprof_name_t and stackprof_stack_t in stackprof_api.h
+HEADER_FMT = "<IHBBIIIIII"
+NAME_FMT = "<I16s"
+STACK_FMT = "<IIHHI"
+PC_FMTS = {4: "<I", 8: "<Q"}
+
+
+class Symbols(object):
+    """
+    Function symbols of elf file read by nm, sorted by address.
+    """
+    def __init__(self, elffile, nm):
+        self.addrs = []
+        self.names = []
+        if elffile is None:
+            return
+        try:
+            output = subprocess.check_output([nm, "-n", "-C", "--defined-only", elffile],
+                                             universal_newlines=True)
+        except (OSError, subprocess.CalledProcessError) as exc:
+            print(f"Warning: unable to read symbols of {elffile} by {nm}: {exc}", file=sys.stderr)
+            return
+        for line in output.splitlines():
+            fields = line.split(None, 2)
+            if len(fields) < 3 or fields[1] not in "tTwW":
+                continue
+            self.addrs.append(int(fields[0], 16))
+            self.names.append(fields[2].replace(";", ":").replace(" ", "_"))
+
+    def lookup(self, addr):
+        idx = bisect.bisect_right(self.addrs, addr) - 1
+        if idx < 0:
+            return None
+        return self.names[idx]
+
+
+def parse_stackprof_bin(binfile):
+    """
+    Parses a stackprof.bin file generated by parse.py from stackprof_collect dump log.
+
+    Returns:
+        tuple: (header dict, tag names dict, list of (count, tag, hart, pcs)), None if invalid.
+    """
+    if not os.path.isfile(binfile):
+        print(f"{binfile} does not exist. Please check!", file=sys.stderr)
+        return None
+    with open(binfile, "rb") as bf:
+        data = bf.read()
+
+    hdrsize = struct.calcsize(HEADER_FMT)
+    if len(data) < hdrsize:
+        print(f"Error: {binfile} is too small", file=sys.stderr)
+        return None
+    fields = struct.unpack_from(HEADER_FMT, data, 0)
+    keys = ["magic", "version", "xlen_bytes", "max_depth", "stack_num", "name_num",
+            "samples", "dropped", "truncated", "sample_hz"]
+    hdr = dict(zip(keys, fields))
+    if hdr["magic"] != STACKPROF_MAGIC or hdr["xlen_bytes"] not in PC_FMTS:
+        print(f"Error: {binfile} is not a valid stackprof data file", file=sys.stderr)
+        return None
+
+    offset = hdrsize
+    names = dict()
+    for _ in range(hdr["name_num"]):
+        tag, name = struct.unpack_from(NAME_FMT, data, offset)
+        offset += struct.calcsize(NAME_FMT)
+        names[tag] = name.split(b"\0")[0].decode("utf-8", "replace").replace(";", ":").replace(" ", "_")
+
+    stacks = []
+    pcfmt = PC_FMTS[hdr["xlen_bytes"]]
+    for _ in range(hdr["stack_num"]):
+        count, tag, depth, hart, _hash = struct.unpack_from(STACK_FMT, data, offset)
+        offset += struct.calcsize(STACK_FMT)
+        if offset + depth * hdr["xlen_bytes"] > len(data):
+            print("Error: truncated stack", file=sys.stderr)
+            return None
+        pcs = [struct.unpack_from(pcfmt, data, offset + i * hdr["xlen_bytes"])[0] for i in range(depth)]
+        offset += depth * hdr["xlen_bytes"]
+        stacks.append((count, tag, hart, pcs))
+    return hdr, names, stacks
+
+
+def fold_stacks(stacks, names, symbols, show_hart=False):
+    """
+    Converts stacks into folded format used by flamegraph.pl and speedscope,
+    one line of ``root;...;leaf count`` for each unique stack.
+    """
+    folded = dict()
+    for count, tag, hart, pcs in stacks:
+        frames = []
+        for idx, pc in enumerate(pcs):
+            # return address points after the call instruction
+            name = symbols.lookup(pc if idx == 0 else pc - 1)
+            frames.append(name if name is not None else f"0x{pc:x}")
+        frames.reverse()
+        if tag != 0 or tag in names:
+            frames.insert(0, names.get(tag, f"tag{tag}"))
+        if show_hart:
+            frames.insert(0, f"hart{hart}")
+        line = ";".join(frames)
+        folded[line] = folded.get(line, 0) + count
+    return folded
+
+
+# NOTE: stackprof.bin is generated by parse.py from the console log which contains
+# Dump stackprof data start ... Dump stackprof data finished
+# python nuclei_sdk/Components/profiling/stackprof_parse.py stackprof.bin app.elf > app.folded
+# flamegraph.pl app.folded > app.svg
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert stackprof.bin into folded stacks for flame graphs")
+    parser.add_argument("binfile", help="stackprof.bin generated by parse.py")
+    parser.add_argument("elffile", nargs="?", help="elf file of application, addresses are printed if not given")
+    parser.add_argument("--nm", default="riscv64-unknown-elf-nm", help="nm tool to read symbols, default %(default)s")
+    parser.add_argument("--hart", action="store_true", help="If specified, stacks of each hart are separated")
+    args = parser.parse_args()
+
+    result = parse_stackprof_bin(args.binfile)
+    if result is None:
+        sys.exit(1)
+    hdr, names, stacks = result
+    print(f"# {hdr['samples']} samples in {hdr['stack_num']} stacks at {hdr['sample_hz']} Hz, "
+          f"{hdr['dropped']} dropped, {hdr['truncated']} truncated", file=sys.stderr)
+    folded = fold_stacks(stacks, names, Symbols(args.elffile, args.nm), args.hart)
+    for line, count in sorted(folded.items(), key=lambda item: -item[1]):
+        print(f"{line} {count}")
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# stft middleware provides streaming STFT/ISTFT over NMSIS-DSP real FFT,
+# NMSIS_LIB must contain nmsis_dsp, see README.md in this directory
+MIDDLEWARE_STFT := $(NUCLEI_SDK_MIDDLEWARE)/stft
+
+C_SRCDIRS += $(MIDDLEWARE_STFT)
+
+INCDIRS += $(MIDDLEWARE_STFT)
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _STFT_API_H_
+#define _STFT_API_H_
+
+#include "riscv_math.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+ * Streaming STFT/ISTFT over NMSIS-DSP real FFT
+ *
+ * Input is fed one hop at a time into an input ring of fftLen samples,
+ * each hop can be written directly into the ring, such as by DMA, see
+ * stft_input_f32, then stft_run_f32 does:
+ * 1. multiply the last fftLen input samples by the analysis window
+ * 2. real FFT, then call the spectrum callback to modify the spectrum in place
+ * 3. real IFFT, multiply by the synthesis window and overlap-add into
+ *    the output ring, and return the hop of output samples completed
+ *
+ * The same window is used for analysis and synthesis, and the synthesis
+ * window is normalized at init, so any window and hop (fftLen must be a
+ * multiple of hop) are reconstructed exactly when the spectrum is not
+ * modified, the output is delayed by (fftLen - hop) samples.
+ *
+ * All buffers are in the work buffer provided by caller, nothing is
+ * allocated, window and FFT tables are prepared once at init.
+ */
+
+/* size of work buffer in float32_t for stft_init_f32 */
+#if defined(RISCV_MATH_VECTOR_ZVE32F)
+#define STFT_WORK_LEN_F32(fftLen)       (8 * (fftLen))
+#else
+#define STFT_WORK_LEN_F32(fftLen)       (6 * (fftLen))
+#endif
+
+/* size of work buffer in q15_t for stft_init_q15, it must be 4 bytes aligned */
+#if defined(RISCV_MATH_VECTOR_ZVE32X)
+#define STFT_WORK_LEN_Q15(fftLen)       (9 * (fftLen))
+#else
+#define STFT_WORK_LEN_Q15(fftLen)       (7 * (fftLen))
+#endif
+
+/*
+ * Spectrum callback, called in stft_run_* to modify the spectrum in place,
+ * the layout is the one of NMSIS-DSP real FFT:
+ * - f32: {re[0], re[fftLen/2], re[1], im[1], ..., re[fftLen/2-1], im[fftLen/2-1]}
+ * - q15: {re[0], im[0], re[1], im[1], ..., re[fftLen/2], im[fftLen/2]}, scaled down by fftLen
+ */
+typedef void (*stft_spectrum_f32)(void *ctx, float32_t *spec, uint16_t fftLen);
+typedef void (*stft_spectrum_q15)(void *ctx, q15_t *spec, uint16_t fftLen);
+
+typedef struct {
+    uint16_t fftLen;                /* frame length, power of 2 supported by real FFT */
+    uint16_t hopLen;                /* samples per hop, fftLen must be multiple of it */
+    uint16_t pos;                   /* ring index of current frame start */
+    uint16_t done;                  /* ring index of output hop returned last time, fftLen if none */
+    float32_t *win;                 /* analysis window */
+    float32_t *syn;                 /* normalized synthesis window */
+    float32_t *in;                  /* input ring */
+    float32_t *acc;                 /* overlap-add output ring */
+    float32_t *time;                /* windowed frame */
+    float32_t *spec;                /* spectrum */
+#if defined(RISCV_MATH_VECTOR_ZVE32F)
+    float32_t *tmp;                 /* FFT temp buffer */
+#endif
+    riscv_rfft_fast_instance_f32 rfft;
+    stft_spectrum_f32 callback;
+    void *ctx;
+} stft_instance_f32;
+
+typedef struct {
+    uint16_t fftLen;                /* frame length, power of 2 supported by real FFT */
+    uint16_t hopLen;                /* samples per hop, fftLen must be multiple of it */
+    uint16_t pos;                   /* ring index of current frame start */
+    uint16_t done;                  /* ring index of output hop returned last time, fftLen if none */
+    int8_t shift;                   /* left shift after synthesis to restore FFT and window scaling */
+    q15_t *win;                     /* analysis window */
+    q15_t *syn;                     /* normalized synthesis window, scaled down to fit q15 */
+    q15_t *in;                      /* input ring */
+    q15_t *acc;                     /* overlap-add output ring */
+    q15_t *time;                    /* windowed frame */
+    q15_t *spec;                    /* spectrum, 2 * fftLen */
+#if defined(RISCV_MATH_VECTOR_ZVE32X)
+    q15_t *tmp;                     /* FFT temp buffer */
+    riscv_rfft_instance_q15 rfft;
+#else
+    riscv_rfft_instance_q15 rfft;
+    riscv_rfft_instance_q15 rifft;
+#endif
+    stft_spectrum_q15 callback;
+    void *ctx;
+} stft_instance_q15;
+
+/*
+ * Initialize STFT instance, window can be NULL to use hanning window,
+ * callback can be NULL to keep spectrum unchanged, work must have
+ * STFT_WORK_LEN_F32(fftLen) elements, return RISCV_MATH_SUCCESS if successful,
+ * otherwise RISCV_MATH_ARGUMENT_ERROR
+ */
+riscv_status stft_init_f32(stft_instance_f32 *S, uint16_t fftLen, uint16_t hopLen, const float32_t *window,
+                           float32_t *work, stft_spectrum_f32 callback, void *ctx);
+
+/* Get buffer of hopLen samples to be filled with next input hop, valid until next stft_run_f32 */
+float32_t *stft_input_f32(const stft_instance_f32 *S);
+
+/* Process the frame ended with the input hop, return hopLen output samples valid until next call */
+const float32_t *stft_run_f32(stft_instance_f32 *S);
+
+/* Analysis only, process the frame ended with the input hop, return the spectrum valid until next call */
+float32_t *stft_analyze_f32(stft_instance_f32 *S);
+
+/* Copy hopLen samples from pSrc as next input hop, then stft_run_f32 and copy output hop to pDst */
+void stft_process_f32(stft_instance_f32 *S, const float32_t *pSrc, float32_t *pDst);
+
+/* Same as f32 version, work must have STFT_WORK_LEN_Q15(fftLen) elements */
+riscv_status stft_init_q15(stft_instance_q15 *S, uint16_t fftLen, uint16_t hopLen, const float32_t *window,
+                           q15_t *work, stft_spectrum_q15 callback, void *ctx);
+q15_t *stft_input_q15(const stft_instance_q15 *S);
+const q15_t *stft_run_q15(stft_instance_q15 *S);
+q15_t *stft_analyze_q15(stft_instance_q15 *S);
+void stft_process_q15(stft_instance_q15 *S, const q15_t *pSrc, q15_t *pDst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_STFT_API_H_ */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stft_api.h"
+
+#if defined(RISCV_MATH_VECTOR_ZVE32F)
+#define STFT_RFFT_F32(S, src, dst, inv)     riscv_rfft_fast_f32(&(S)->rfft, (src), (dst), (S)->tmp, (inv))
+#else
+#define STFT_RFFT_F32(S, src, dst, inv)     riscv_rfft_fast_f32(&(S)->rfft, (src), (dst), (inv))
+#endif
+
+riscv_status stft_init_f32(stft_instance_f32 *S, uint16_t fftLen, uint16_t hopLen, const float32_t *window,
+                           float32_t *work, stft_spectrum_f32 callback, void *ctx)
+{
+    float32_t *sum;
+    uint32_t i;
+
+    if (S == NULL || work == NULL || hopLen == 0 || hopLen > fftLen || (fftLen % hopLen) != 0) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    if (riscv_rfft_fast_init_f32(&S->rfft, fftLen) != RISCV_MATH_SUCCESS) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLen = fftLen;
+    S->hopLen = hopLen;
+    S->pos = 0;
+    S->done = fftLen;
+    S->win = work;
+    S->syn = work + fftLen;
+    S->in = work + 2 * fftLen;
+    S->acc = work + 3 * fftLen;
+    S->time = work + 4 * fftLen;
+    S->spec = work + 5 * fftLen;
+#if defined(RISCV_MATH_VECTOR_ZVE32F)
+    S->tmp = work + 6 * fftLen;
+#endif
+    S->callback = callback;
+    S->ctx = ctx;
+
+    if (window != NULL) {
+        riscv_copy_f32(window, S->win, fftLen);
+    } else {
+        riscv_hanning_f32(S->win, fftLen);
+    }
+    /*
+     * Normalize synthesis window by the sum of squared windows overlapped
+     * at each position of hop, then the overlap-add of unmodified frames
+     * gives back the input exactly
+     */
+    sum = S->time;
+    riscv_fill_f32(0.0f, sum, hopLen);
+    for (i = 0; i < fftLen; i++) {
+        sum[i % hopLen] += S->win[i] * S->win[i];
+    }
+    for (i = 0; i < hopLen; i++) {
+        if (sum[i] <= 0.0f) {
+            return RISCV_MATH_ARGUMENT_ERROR;
+        }
+    }
+    for (i = 0; i < fftLen; i++) {
+        S->syn[i] = S->win[i] / sum[i % hopLen];
+    }
+    riscv_fill_f32(0.0f, S->in, fftLen);
+    riscv_fill_f32(0.0f, S->acc, fftLen);
+    return RISCV_MATH_SUCCESS;
+}
+
+float32_t *stft_input_f32(const stft_instance_f32 *S)
+{
+    return S->in + (S->pos + S->fftLen - S->hopLen) % S->fftLen;
+}
+
+/* window the frame starting at pos of input ring, and transform it into spectrum */
+static void stft_frame_f32(stft_instance_f32 *S)
+{
+    uint32_t n = S->fftLen, p = S->pos;
+
+    riscv_mult_f32(S->in + p, S->win, S->time, n - p);
+    if (p != 0) {
+        riscv_mult_f32(S->in, S->win + n - p, S->time + n - p, p);
+    }
+    STFT_RFFT_F32(S, S->time, S->spec, 0);
+}
+
+const float32_t *stft_run_f32(stft_instance_f32 *S)
+{
+    uint32_t n = S->fftLen, p = S->pos;
+
+    /* output hop returned last time is consumed, it is the last hop of this frame */
+    if (S->done != n) {
+        riscv_fill_f32(0.0f, S->acc + S->done, S->hopLen);
+    }
+    stft_frame_f32(S);
+    if (S->callback != NULL) {
+        S->callback(S->ctx, S->spec, S->fftLen);
+    }
+    STFT_RFFT_F32(S, S->spec, S->time, 1);
+    riscv_mult_f32(S->time, S->syn, S->time, n);
+    riscv_add_f32(S->acc + p, S->time, S->acc + p, n - p);
+    if (p != 0) {
+        riscv_add_f32(S->acc, S->time + n - p, S->acc, p);
+    }
+    S->done = p;
+    S->pos = (p + S->hopLen) % n;
+    return S->acc + p;
+}
+
+float32_t *stft_analyze_f32(stft_instance_f32 *S)
+{
+    stft_frame_f32(S);
+    S->pos = (S->pos + S->hopLen) % S->fftLen;
+    return S->spec;
+}
+
+void stft_process_f32(stft_instance_f32 *S, const float32_t *pSrc, float32_t *pDst)
+{
+    riscv_copy_f32(pSrc, stft_input_f32(S), S->hopLen);
+    riscv_copy_f32(stft_run_f32(S), pDst, S->hopLen);
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stft_api.h"
+
+#if defined(RISCV_MATH_VECTOR_ZVE32X)
+#define STFT_RFFT_Q15(S, src, dst)      riscv_rfft_q15(&(S)->rfft, (src), (dst), (S)->tmp, 0)
+#define STFT_RIFFT_Q15(S, src, dst)     riscv_rfft_q15(&(S)->rfft, (src), (dst), (S)->tmp, 1)
+#else
+#define STFT_RFFT_Q15(S, src, dst)      riscv_rfft_q15(&(S)->rfft, (src), (dst))
+#define STFT_RIFFT_Q15(S, src, dst)     riscv_rfft_q15(&(S)->rifft, (src), (dst))
+#endif
+
+static riscv_status stft_rfft_init_q15(stft_instance_q15 *S, uint16_t fftLen)
+{
+#if defined(RISCV_MATH_VECTOR_ZVE32X)
+    return riscv_rfft_init_q15(&S->rfft, fftLen);
+#else
+    if (riscv_rfft_init_q15(&S->rfft, fftLen, 0, 1) != RISCV_MATH_SUCCESS) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    return riscv_rfft_init_q15(&S->rifft, fftLen, 1, 1);
+#endif
+}
+
+riscv_status stft_init_q15(stft_instance_q15 *S, uint16_t fftLen, uint16_t hopLen, const float32_t *window,
+                           q15_t *work, stft_spectrum_q15 callback, void *ctx)
+{
+    float32_t *fwin, *sum, max = 0.0f, scale = 32768.0f;
+    uint32_t i;
+    int8_t shift = 0;
+
+    if (S == NULL || work == NULL || hopLen == 0 || hopLen > fftLen || (fftLen % hopLen) != 0) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    if (stft_rfft_init_q15(S, fftLen) != RISCV_MATH_SUCCESS) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLen = fftLen;
+    S->hopLen = hopLen;
+    S->pos = 0;
+    S->done = fftLen;
+    /* spectrum first, so the float scratch below is aligned */
+    S->spec = work;
+    S->acc = work + 2 * fftLen;
+    S->time = work + 3 * fftLen;
+    S->in = work + 4 * fftLen;
+    S->win = work + 5 * fftLen;
+    S->syn = work + 6 * fftLen;
+#if defined(RISCV_MATH_VECTOR_ZVE32X)
+    S->tmp = work + 7 * fftLen;
+#endif
+    S->callback = callback;
+    S->ctx = ctx;
+
+    /* float window in spectrum buffer and sums in acc and time buffers, only used here */
+    fwin = (float32_t *)S->spec;
+    sum = (float32_t *)S->acc;
+    if (window != NULL) {
+        riscv_copy_f32(window, fwin, fftLen);
+    } else {
+        riscv_hanning_f32(fwin, fftLen);
+    }
+    riscv_float_to_q15(fwin, S->win, fftLen);
+    /* see stft_init_f32, the sums are taken from float window for accuracy */
+    riscv_fill_f32(0.0f, sum, hopLen);
+    for (i = 0; i < fftLen; i++) {
+        sum[i % hopLen] += fwin[i] * fwin[i];
+    }
+    for (i = 0; i < hopLen; i++) {
+        if (sum[i] <= 0.0f) {
+            return RISCV_MATH_ARGUMENT_ERROR;
+        }
+    }
+    for (i = 0; i < fftLen; i++) {
+        fwin[i] = fwin[i] / sum[i % hopLen];
+        if (fwin[i] > max) {
+            max = fwin[i];
+        }
+    }
+    /* normalized synthesis window can be larger than 1, scale it down by power of 2 */
+    while (max >= 1.0f) {
+        max *= 0.5f;
+        scale *= 0.5f;
+        shift++;
+    }
+    for (i = 0; i < fftLen; i++) {
+        S->syn[i] = (q15_t)__SSAT((q31_t)(fwin[i] * scale), 16);
+    }
+    /* q15 real FFT and IFFT scale the frame down by fftLen in total */
+    for (i = 1; i < fftLen; i <<= 1) {
+        shift++;
+    }
+    S->shift = shift;
+    riscv_fill_q15(0, S->in, fftLen);
+    riscv_fill_q15(0, S->acc, fftLen);
+    riscv_fill_q15(0, S->time, fftLen);
+    return RISCV_MATH_SUCCESS;
+}
+
+q15_t *stft_input_q15(const stft_instance_q15 *S)
+{
+    return S->in + (S->pos + S->fftLen - S->hopLen) % S->fftLen;
+}
+
+static void stft_frame_q15(stft_instance_q15 *S)
+{
+    uint32_t n = S->fftLen, p = S->pos;
+
+    riscv_mult_q15(S->in + p, S->win, S->time, n - p);
+    if (p != 0) {
+        riscv_mult_q15(S->in, S->win + n - p, S->time + n - p, p);
+    }
+    STFT_RFFT_Q15(S, S->time, S->spec);
+}
+
+const q15_t *stft_run_q15(stft_instance_q15 *S)
+{
+    uint32_t n = S->fftLen, p = S->pos;
+
+    if (S->done != n) {
+        riscv_fill_q15(0, S->acc + S->done, S->hopLen);
+    }
+    stft_frame_q15(S);
+    if (S->callback != NULL) {
+        S->callback(S->ctx, S->spec, S->fftLen);
+    }
+    STFT_RIFFT_Q15(S, S->spec, S->time);
+    riscv_mult_q15(S->time, S->syn, S->time, n);
+    riscv_shift_q15(S->time, S->shift, S->time, n);
+    riscv_add_q15(S->acc + p, S->time, S->acc + p, n - p);
+    if (p != 0) {
+        riscv_add_q15(S->acc, S->time + n - p, S->acc, p);
+    }
+    S->done = p;
+    S->pos = (p + S->hopLen) % n;
+    return S->acc + p;
+}
+
+q15_t *stft_analyze_q15(stft_instance_q15 *S)
+{
+    stft_frame_q15(S);
+    S->pos = (S->pos + S->hopLen) % S->fftLen;
+    return S->spec;
+}
+
+void stft_process_q15(stft_instance_q15 *S, const q15_t *pSrc, q15_t *pDst)
+{
+    riscv_copy_q15(pSrc, stft_input_q15(S), S->hopLen);
+    riscv_copy_q15(stft_run_q15(S), pDst, S->hopLen);
+}
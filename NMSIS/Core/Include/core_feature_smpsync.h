@@ -0,0 +1,670 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __CORE_FEATURE_SMPSYNC_H__
+#define __CORE_FEATURE_SMPSYNC_H__
+/*!
+ * @file     core_feature_smpsync.h
+ * @brief    SMP synchronization primitives header file for Nuclei N/NX Core
+ */
+/*
+ * SMP Synchronization Configuration Macro:
+ *
+ * 1. __SMPSYNC_CACHELINE_SIZE:  Size in bytes which sync objects are aligned and padded to,
+ *   so words written by different harts are not in the same cache line, default 64.
+ * 2. __SMPSYNC_STATS:  Define whether contention statistics are counted in sync objects
+ *   * 0: Not counted, default
+ *   * 1: Counted, which costs some AMO operations in each acquire
+ * 3. __SMPSYNC_RELAX():  Called in each spin loop, default \ref __NOP
+ *
+ * These primitives only use memory and AMO instructions, so they work without
+ * CLINT, CIDU or other SoC units, and require the A(atomic) extension.
+ */
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "core_feature_base.h"
+
+#if defined(__riscv_atomic)
+/**
+ * \defgroup NMSIS_Core_SMPSync        SMP Synchronization Functions
+ * \ingroup  NMSIS_Core
+ * \brief    Barriers and locks shared by harts, built on AMO and LR/SC instructions.
+ * \details
+ *
+ * Nuclei N/NX SMP cores share memory of one cluster, these functions synchronize harts
+ * through memory only:
+ *
+ * * Sense-reversing barrier, \ref SMP_Barrier_Wait
+ * * Ticket spinlock, FIFO fair, \ref SMP_TicketLock_Acquire
+ * * MCS spinlock, each hart spins on its own node, \ref SMP_MCSLock_Acquire
+ * * Seqlock, readers never block writers, \ref SMP_SeqLock_ReadBegin
+ * * Reader-writer spinlock with writer preference, \ref SMP_RWLock_ReadAcquire
+ *
+ * Each object is aligned to \ref __SMPSYNC_CACHELINE_SIZE, acquire functions end with
+ * and release functions begin with a `fence rw, rw`, so accesses in the critical
+ * section are not reordered out of it.
+ *
+ * These functions don't disable interrupts, if a lock is also taken in interrupt
+ * handler, disable interrupt before acquiring it.
+ *
+ * When \ref __SMPSYNC_STATS is 1, each object counts its acquires, contended acquires
+ * and spin loops in \ref SMP_SyncStat_Type member `stat`.
+ *   @{
+ */
+#ifndef __SMPSYNC_CACHELINE_SIZE
+/** Size in bytes which sync objects are aligned and padded to */
+#define __SMPSYNC_CACHELINE_SIZE        64
+#endif
+
+#ifndef __SMPSYNC_STATS
+/** Whether contention statistics are counted, 0 or 1 */
+#define __SMPSYNC_STATS                 0
+#endif
+
+#ifndef __SMPSYNC_RELAX
+/** Called in each spin loop */
+#define __SMPSYNC_RELAX()               __NOP()
+#endif
+
+/** Align sync object to cache line */
+#define __SMPSYNC_ALIGNED               __ALIGNED(__SMPSYNC_CACHELINE_SIZE)
+
+/**
+ * \brief  Contention statistics of a sync object
+ * \details
+ * Counted only when \ref __SMPSYNC_STATS is 1, the counters wrap around.
+ */
+typedef struct {
+    volatile uint32_t acquires;     /*!< Number of acquires, or waits of barrier */
+    volatile uint32_t contended;    /*!< Number of acquires which had to spin */
+    volatile uint32_t spins;        /*!< Total spin loops */
+    volatile uint32_t max_spins;    /*!< Max spin loops of one acquire */
+} SMP_SyncStat_Type;
+
+#if __SMPSYNC_STATS
+#define __SMPSYNC_SPIN_DECL()           uint32_t __spins = 0
+#define __SMPSYNC_SPIN()                do { __spins++; __SMPSYNC_RELAX(); } while (0)
+#define __SMPSYNC_STAT(obj)             __SMP_SyncStatUpdate(&((obj)->stat), __spins)
+#define __SMPSYNC_STAT_MEMBER           SMP_SyncStat_Type stat;   /*!< Contention statistics */
+
+/**
+ * \brief  Update contention statistics after an acquire
+ * \param [in]    stat      statistics of sync object
+ * \param [in]    spins     spin loops of this acquire
+ */
+__STATIC_FORCEINLINE void __SMP_SyncStatUpdate(SMP_SyncStat_Type *stat, uint32_t spins)
+{
+    __AMOADD_W((volatile int32_t *)&stat->acquires, 1);
+    if (spins != 0) {
+        __AMOADD_W((volatile int32_t *)&stat->contended, 1);
+        __AMOADD_W((volatile int32_t *)&stat->spins, (int32_t)spins);
+        __AMOMAXU_W(&stat->max_spins, spins);
+    }
+}
+#else
+#define __SMPSYNC_SPIN_DECL()
+#define __SMPSYNC_SPIN()                __SMPSYNC_RELAX()
+#define __SMPSYNC_STAT(obj)
+#define __SMPSYNC_STAT_MEMBER
+#endif
+
+/**
+ * \brief  Clear contention statistics
+ * \details
+ * Call it when no hart is using the sync object, such as `SMP_SyncStat_Clear(&lock.stat)`.
+ * \param [in]    stat      statistics of sync object
+ */
+__STATIC_INLINE void SMP_SyncStat_Clear(SMP_SyncStat_Type *stat)
+{
+    stat->acquires = 0;
+    stat->contended = 0;
+    stat->spins = 0;
+    stat->max_spins = 0;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Atomic swap pointer into memory
+ * \param [in]    addr      Address of pointer
+ * \param [in]    val       New pointer
+ * \return  the original pointer in memory
+ */
+__STATIC_FORCEINLINE void *__SMP_SwapPtr(void * volatile *addr, void *val)
+{
+#if __RISCV_XLEN == 32
+    return (void *)(unsigned long)__AMOSWAP_W((volatile uint32_t *)addr, (uint32_t)(unsigned long)val);
+#else
+    return (void *)(unsigned long)__AMOSWAP_D((volatile uint64_t *)addr, (uint64_t)(unsigned long)val);
+#endif
+}
+
+/**
+ * \brief  Compare and swap pointer in memory
+ * \param [in]    addr      Address of pointer
+ * \param [in]    oldval    Expected pointer in memory
+ * \param [in]    newval    New pointer to store if memory equals oldval
+ * \return  the original pointer in memory
+ */
+__STATIC_FORCEINLINE void *__SMP_CASPtr(void * volatile *addr, void *oldval, void *newval)
+{
+#if __RISCV_XLEN == 32
+    return (void *)(unsigned long)__CAS_W((volatile uint32_t *)addr, (uint32_t)(unsigned long)oldval,
+                                          (uint32_t)(unsigned long)newval);
+#else
+    return (void *)(unsigned long)__CAS_D((volatile uint64_t *)addr, (uint64_t)(unsigned long)oldval,
+                                          (uint64_t)(unsigned long)newval);
+#endif
+}
+
+/* ##########################  Barrier  #################################### */
+/**
+ * \brief  Sense-reversing barrier
+ * \details
+ * Arrival counter and sense are in different cache lines, so the waiting harts
+ * spin on a line which is only written once per barrier round.
+ * Initialize it by \ref SMP_BARRIER_INITIALIZER or \ref SMP_Barrier_Init.
+ */
+typedef struct {
+    volatile uint32_t count __SMPSYNC_ALIGNED;  /*!< Number of harts arrived in this round */
+    volatile uint32_t sense __SMPSYNC_ALIGNED;  /*!< Global sense, flipped by last arrived hart */
+    uint32_t total;                             /*!< Number of harts to wait for */
+    __SMPSYNC_STAT_MEMBER
+} SMP_Barrier_Type;
+
+/** Static initializer of barrier for n harts */
+#define SMP_BARRIER_INITIALIZER(n)      { .count = 0, .sense = 0, .total = (n) }
+
+/**
+ * \brief  Initialize barrier
+ * \details
+ * Call it before any hart waits on the barrier, the local sense of each hart
+ * must be initialized to 0 too.
+ * \param [in]    bar       barrier
+ * \param [in]    total     number of harts to wait for
+ */
+__STATIC_INLINE void SMP_Barrier_Init(SMP_Barrier_Type *bar, uint32_t total)
+{
+    bar->count = 0;
+    bar->sense = 0;
+    bar->total = total;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Wait until all harts arrived at barrier
+ * \details
+ * Each hart keeps its own local sense which is 0 at the beginning, and passes it to each wait,
+ * such as a local variable of hart entry function. Memory accesses before the barrier are
+ * visible to all harts after the barrier.
+ * \param [in]      bar           barrier
+ * \param [in,out]  local_sense   local sense of calling hart, flipped in each wait
+ * \return  1 for the last arrived hart, which can do serial work, 0 for others
+ */
+__STATIC_INLINE int32_t SMP_Barrier_Wait(SMP_Barrier_Type *bar, uint32_t *local_sense)
+{
+    uint32_t sense = !(*local_sense);
+    __SMPSYNC_SPIN_DECL();
+
+    *local_sense = sense;
+    __SMP_RWMB();
+    if ((uint32_t)__AMOADD_W((volatile int32_t *)&bar->count, 1) == bar->total - 1) {
+        /* last one, reset count before releasing others */
+        bar->count = 0;
+        __SMP_RWMB();
+        bar->sense = sense;
+        __SMPSYNC_STAT(bar);
+        return 1;
+    }
+    while (bar->sense != sense) {
+        __SMPSYNC_SPIN();
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(bar);
+    return 0;
+}
+
+/* ##########################  Ticket Lock  #################################### */
+/**
+ * \brief  Ticket spinlock
+ * \details
+ * Harts get the lock in the order of their tickets. The next ticket and current owner
+ * are in different cache lines, so taking a ticket doesn't disturb the spinning harts.
+ * Zero initialized lock is unlocked.
+ */
+typedef struct {
+    volatile uint32_t next __SMPSYNC_ALIGNED;   /*!< Next ticket to take */
+    volatile uint32_t owner __SMPSYNC_ALIGNED;  /*!< Ticket holding the lock */
+    __SMPSYNC_STAT_MEMBER
+} SMP_TicketLock_Type;
+
+/**
+ * \brief  Initialize ticket lock to unlocked
+ * \param [in]    lock      ticket lock
+ */
+__STATIC_INLINE void SMP_TicketLock_Init(SMP_TicketLock_Type *lock)
+{
+    lock->next = 0;
+    lock->owner = 0;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Acquire ticket lock
+ * \details
+ * Take a ticket and spin until it is served, each spin loop relaxes once per hart waiting before it.
+ * \param [in]    lock      ticket lock
+ */
+__STATIC_INLINE void SMP_TicketLock_Acquire(SMP_TicketLock_Type *lock)
+{
+    uint32_t ticket, owner;
+    __SMPSYNC_SPIN_DECL();
+
+    ticket = (uint32_t)__AMOADD_W((volatile int32_t *)&lock->next, 1);
+    while ((owner = lock->owner) != ticket) {
+        /* proportional back off, harts before us will hold the lock first */
+        for (uint32_t i = ticket - owner; i > 1; i--) {
+            __SMPSYNC_RELAX();
+        }
+        __SMPSYNC_SPIN();
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(lock);
+}
+
+/**
+ * \brief  Try to acquire ticket lock without spinning
+ * \param [in]    lock      ticket lock
+ * \return  1 if lock is acquired, 0 if lock is held or being waited by other harts
+ */
+__STATIC_INLINE int32_t SMP_TicketLock_TryAcquire(SMP_TicketLock_Type *lock)
+{
+    uint32_t owner = lock->owner;
+    __SMPSYNC_SPIN_DECL();
+
+    if (__CAS_W(&lock->next, owner, owner + 1) != owner) {
+        return 0;
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(lock);
+    return 1;
+}
+
+/**
+ * \brief  Release ticket lock
+ * \param [in]    lock      ticket lock held by calling hart
+ */
+__STATIC_INLINE void SMP_TicketLock_Release(SMP_TicketLock_Type *lock)
+{
+    __SMP_RWMB();
+    /* only lock holder writes owner */
+    lock->owner = lock->owner + 1;
+}
+
+/**
+ * \brief  Check whether ticket lock is held
+ * \param [in]    lock      ticket lock
+ * \return  1 if lock is held, 0 if not
+ */
+__STATIC_FORCEINLINE int32_t SMP_TicketLock_IsLocked(SMP_TicketLock_Type *lock)
+{
+    return lock->next != lock->owner;
+}
+
+/* ##########################  MCS Lock  #################################### */
+/**
+ * \brief  Queue node of MCS lock
+ * \details
+ * Each acquiring hart passes its own node, which must stay valid until the lock is released,
+ * such as a per hart global or a local variable of the function holding the lock.
+ */
+typedef struct SMP_MCSNode {
+    struct SMP_MCSNode * volatile next;         /*!< Next waiting hart */
+    volatile uint32_t locked;                   /*!< 1 while waiting, cleared by previous holder */
+} __SMPSYNC_ALIGNED SMP_MCSNode_Type;
+
+/**
+ * \brief  MCS queue spinlock
+ * \details
+ * Waiting harts form a queue, and each hart spins on the `locked` of its own node,
+ * so releasing the lock only writes the cache line of the next hart.
+ * Zero initialized lock is unlocked.
+ */
+typedef struct {
+    SMP_MCSNode_Type * volatile tail;           /*!< Last node in queue, NULL when unlocked */
+    __SMPSYNC_STAT_MEMBER
+} __SMPSYNC_ALIGNED SMP_MCSLock_Type;
+
+/**
+ * \brief  Initialize MCS lock to unlocked
+ * \param [in]    lock      MCS lock
+ */
+__STATIC_INLINE void SMP_MCSLock_Init(SMP_MCSLock_Type *lock)
+{
+    lock->tail = NULL;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Acquire MCS lock
+ * \param [in]    lock      MCS lock
+ * \param [in]    node      queue node of calling hart
+ */
+__STATIC_INLINE void SMP_MCSLock_Acquire(SMP_MCSLock_Type *lock, SMP_MCSNode_Type *node)
+{
+    SMP_MCSNode_Type *pred;
+    __SMPSYNC_SPIN_DECL();
+
+    node->next = NULL;
+    node->locked = 1;
+    __SMP_RWMB();
+    pred = (SMP_MCSNode_Type *)__SMP_SwapPtr((void * volatile *)&lock->tail, node);
+    if (pred != NULL) {
+        pred->next = node;
+        while (node->locked) {
+            __SMPSYNC_SPIN();
+        }
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(lock);
+}
+
+/**
+ * \brief  Try to acquire MCS lock without spinning
+ * \param [in]    lock      MCS lock
+ * \param [in]    node      queue node of calling hart
+ * \return  1 if lock is acquired, 0 if lock is held
+ */
+__STATIC_INLINE int32_t SMP_MCSLock_TryAcquire(SMP_MCSLock_Type *lock, SMP_MCSNode_Type *node)
+{
+    __SMPSYNC_SPIN_DECL();
+
+    node->next = NULL;
+    node->locked = 0;
+    __SMP_RWMB();
+    if (__SMP_CASPtr((void * volatile *)&lock->tail, NULL, node) != NULL) {
+        return 0;
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(lock);
+    return 1;
+}
+
+/**
+ * \brief  Release MCS lock
+ * \details
+ * Hand the lock over to the next hart in queue, if a hart is being queued,
+ * wait until it links its node.
+ * \param [in]    lock      MCS lock held by calling hart
+ * \param [in]    node      queue node passed to acquire
+ */
+__STATIC_INLINE void SMP_MCSLock_Release(SMP_MCSLock_Type *lock, SMP_MCSNode_Type *node)
+{
+    SMP_MCSNode_Type *next;
+
+    __SMP_RWMB();
+    next = node->next;
+    if (next == NULL) {
+        if (__SMP_CASPtr((void * volatile *)&lock->tail, node, NULL) == node) {
+            return;
+        }
+        while ((next = node->next) == NULL) {
+            __SMPSYNC_RELAX();
+        }
+    }
+    next->locked = 0;
+}
+
+/* ##########################  Seqlock  #################################### */
+/**
+ * \brief  Sequence lock
+ * \details
+ * Writers are serialized by the sequence itself, which is odd while a write is in progress.
+ * Readers never write the lock, they retry if the sequence changed during the read,
+ * so data protected by seqlock must be safe to read while it is being written,
+ * such as words without pointers to follow.
+ * Zero initialized lock is unlocked.
+ */
+typedef struct {
+    volatile uint32_t seq;                      /*!< Sequence, odd while writing */
+    __SMPSYNC_STAT_MEMBER
+} __SMPSYNC_ALIGNED SMP_SeqLock_Type;
+
+/**
+ * \brief  Initialize seqlock
+ * \param [in]    lock      seqlock
+ */
+__STATIC_INLINE void SMP_SeqLock_Init(SMP_SeqLock_Type *lock)
+{
+    lock->seq = 0;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Begin write of seqlock
+ * \details
+ * Spin until no other writer, and make the sequence odd. Statistics count writes only.
+ * \param [in]    lock      seqlock
+ */
+__STATIC_INLINE void SMP_SeqLock_WriteBegin(SMP_SeqLock_Type *lock)
+{
+    uint32_t seq;
+    __SMPSYNC_SPIN_DECL();
+
+    while (1) {
+        seq = lock->seq;
+        if (((seq & 0x1) == 0) && (__CAS_W(&lock->seq, seq, seq + 1) == seq)) {
+            break;
+        }
+        __SMPSYNC_SPIN();
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(lock);
+}
+
+/**
+ * \brief  End write of seqlock, make the sequence even again
+ * \param [in]    lock      seqlock in write
+ */
+__STATIC_INLINE void SMP_SeqLock_WriteEnd(SMP_SeqLock_Type *lock)
+{
+    __SMP_RWMB();
+    lock->seq = lock->seq + 1;
+}
+
+/**
+ * \brief  Begin read of seqlock
+ * \details
+ * Spin while a write is in progress, then return the sequence for \ref SMP_SeqLock_ReadRetry.
+ * \code
+ * do {
+ *     seq = SMP_SeqLock_ReadBegin(&lock);
+ *     copy = shared;
+ * } while (SMP_SeqLock_ReadRetry(&lock, seq));
+ * \endcode
+ * \param [in]    lock      seqlock
+ * \return  sequence at begin of read
+ */
+__STATIC_INLINE uint32_t SMP_SeqLock_ReadBegin(SMP_SeqLock_Type *lock)
+{
+    uint32_t seq;
+
+    while ((seq = lock->seq) & 0x1) {
+        __SMPSYNC_RELAX();
+    }
+    __SMP_RMB();
+    return seq;
+}
+
+/**
+ * \brief  Check whether the read must be retried
+ * \param [in]    lock      seqlock
+ * \param [in]    seq       sequence returned by \ref SMP_SeqLock_ReadBegin
+ * \return  1 if data was written during the read and it must be retried, 0 if read is consistent
+ */
+__STATIC_INLINE int32_t SMP_SeqLock_ReadRetry(SMP_SeqLock_Type *lock, uint32_t seq)
+{
+    __SMP_RMB();
+    return lock->seq != seq;
+}
+
+/* ##########################  RW Spinlock  #################################### */
+/** Reader-writer lock state bit, set when a writer holds the lock */
+#define SMP_RWLOCK_WRITER               0x80000000U
+/** Reader-writer lock state bit, set when a writer is waiting, which blocks new readers */
+#define SMP_RWLOCK_PENDING              0x40000000U
+/** Reader-writer lock state mask, count of readers holding the lock */
+#define SMP_RWLOCK_READERS              0x3FFFFFFFU
+
+/**
+ * \brief  Reader-writer spinlock
+ * \details
+ * Many readers or one writer hold the lock. A waiting writer sets a pending bit
+ * which blocks new readers, so writers are not starved by readers.
+ * Zero initialized lock is unlocked.
+ */
+typedef struct {
+    volatile uint32_t state;                    /*!< Writer, pending bits and readers count */
+    __SMPSYNC_STAT_MEMBER
+} __SMPSYNC_ALIGNED SMP_RWLock_Type;
+
+/**
+ * \brief  Initialize reader-writer lock to unlocked
+ * \param [in]    lock      reader-writer lock
+ */
+__STATIC_INLINE void SMP_RWLock_Init(SMP_RWLock_Type *lock)
+{
+    lock->state = 0;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Acquire reader-writer lock for read
+ * \param [in]    lock      reader-writer lock
+ */
+__STATIC_INLINE void SMP_RWLock_ReadAcquire(SMP_RWLock_Type *lock)
+{
+    uint32_t state;
+    __SMPSYNC_SPIN_DECL();
+
+    while (1) {
+        state = lock->state;
+        if (((state & (SMP_RWLOCK_WRITER | SMP_RWLOCK_PENDING)) == 0) &&
+            (__CAS_W(&lock->state, state, state + 1) == state)) {
+            break;
+        }
+        __SMPSYNC_SPIN();
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(lock);
+}
+
+/**
+ * \brief  Try to acquire reader-writer lock for read without spinning
+ * \param [in]    lock      reader-writer lock
+ * \return  1 if lock is acquired, 0 if a writer holds or waits for the lock
+ */
+__STATIC_INLINE int32_t SMP_RWLock_TryReadAcquire(SMP_RWLock_Type *lock)
+{
+    uint32_t state = lock->state;
+    __SMPSYNC_SPIN_DECL();
+
+    if (((state & (SMP_RWLOCK_WRITER | SMP_RWLOCK_PENDING)) != 0) ||
+        (__CAS_W(&lock->state, state, state + 1) != state)) {
+        return 0;
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(lock);
+    return 1;
+}
+
+/**
+ * \brief  Release reader-writer lock held for read
+ * \param [in]    lock      reader-writer lock
+ */
+__STATIC_INLINE void SMP_RWLock_ReadRelease(SMP_RWLock_Type *lock)
+{
+    __SMP_RWMB();
+    __AMOADD_W((volatile int32_t *)&lock->state, -1);
+}
+
+/**
+ * \brief  Acquire reader-writer lock for write
+ * \details
+ * Set pending bit to block new readers, and spin until readers and other writer left.
+ * \param [in]    lock      reader-writer lock
+ */
+__STATIC_INLINE void SMP_RWLock_WriteAcquire(SMP_RWLock_Type *lock)
+{
+    uint32_t state;
+    __SMPSYNC_SPIN_DECL();
+
+    while (1) {
+        state = lock->state;
+        if ((state & ~SMP_RWLOCK_PENDING) == 0) {
+            /* pending bit is cleared, other waiting writers will set it again */
+            if (__CAS_W(&lock->state, state, SMP_RWLOCK_WRITER) == state) {
+                break;
+            }
+        } else if ((state & SMP_RWLOCK_PENDING) == 0) {
+            __AMOOR_W((volatile int32_t *)&lock->state, (int32_t)SMP_RWLOCK_PENDING);
+        }
+        __SMPSYNC_SPIN();
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(lock);
+}
+
+/**
+ * \brief  Try to acquire reader-writer lock for write without spinning
+ * \param [in]    lock      reader-writer lock
+ * \return  1 if lock is acquired, 0 if lock is held
+ */
+__STATIC_INLINE int32_t SMP_RWLock_TryWriteAcquire(SMP_RWLock_Type *lock)
+{
+    uint32_t state = lock->state;
+    __SMPSYNC_SPIN_DECL();
+
+    if (((state & ~SMP_RWLOCK_PENDING) != 0) ||
+        (__CAS_W(&lock->state, state, SMP_RWLOCK_WRITER) != state)) {
+        return 0;
+    }
+    __SMP_RWMB();
+    __SMPSYNC_STAT(lock);
+    return 1;
+}
+
+/**
+ * \brief  Release reader-writer lock held for write
+ * \details
+ * Pending bit set by waiting writers is kept.
+ * \param [in]    lock      reader-writer lock
+ */
+__STATIC_INLINE void SMP_RWLock_WriteRelease(SMP_RWLock_Type *lock)
+{
+    __SMP_RWMB();
+    __AMOAND_W((volatile int32_t *)&lock->state, (int32_t)~SMP_RWLOCK_WRITER);
+}
+
+/** @} */ /* End of Doxygen Group NMSIS_Core_SMPSync */
+#endif /* defined(__riscv_atomic) */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __CORE_FEATURE_SMPSYNC_H__ */
@@ -508,6 +508,14 @@
     #endif
 #endif
 
+#ifndef configUSE_PER_CORE_READY_LISTS
+    #define configUSE_PER_CORE_READY_LISTS    0
+#endif /* configUSE_PER_CORE_READY_LISTS */
+
+#ifndef configUSE_HW_STACK_TRACK
+    #define configUSE_HW_STACK_TRACK    0
+#endif /* configUSE_HW_STACK_TRACK */
+
 #ifndef configUSE_PASSIVE_IDLE_HOOK
     #define configUSE_PASSIVE_IDLE_HOOK    0
 #endif /* configUSE_PASSIVE_IDLE_HOOK */
@@ -2892,6 +2900,19 @@
     #error configUSE_CORE_AFFINITY is not supported in single core FreeRTOS
 #endif
 
+#if ( ( configNUMBER_OF_CORES == 1 ) && ( configUSE_PER_CORE_READY_LISTS != 0 ) )
+    #error configUSE_PER_CORE_READY_LISTS is not supported in single core FreeRTOS
+#endif
+
+#if ( configUSE_HW_STACK_TRACK == 1 )
+    #if ( portSTACK_GROWTH > 0 )
+        #error configUSE_HW_STACK_TRACK only supports stack growing downwards
+    #endif
+    #if !defined( portHW_STACK_TRACK_GET ) || !defined( portHW_STACK_TRACK_SET )
+        #error configUSE_HW_STACK_TRACK requires portHW_STACK_TRACK_GET and portHW_STACK_TRACK_SET to be defined by the port
+    #endif
+#endif
+
 #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION != 0 ) )
     #error configUSE_PORT_OPTIMISED_TASK_SELECTION is not supported in SMP FreeRTOS
 #endif
@@ -3177,6 +3198,12 @@ typedef struct xSTATIC_TCB
         BaseType_t xDummy23;
         UBaseType_t uxDummy24;
     #endif
+    #if ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configNUMBER_OF_CORES > 1 )
+        BaseType_t xDummy27;
+    #endif
+    #if ( configUSE_HW_STACK_TRACK == 1 )
+        void * pxDummy28;
+    #endif
     uint8_t ucDummy7[ configMAX_TASK_NAME_LEN ];
     #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
         BaseType_t xDummy25;
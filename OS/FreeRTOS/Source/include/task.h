@@ -180,6 +180,15 @@ typedef struct xTASK_STATUS
     #endif
 } TaskStatus_t;
 
+/* Used with the vTaskGetCoreScheduleStats() function to return the scheduling
+ * counters of one core. */
+typedef struct xTASK_CORE_SCHEDULE_STATS
+{
+    uint32_t ulLocalSwitches;  /* Number of times a task was taken from the ready lists of this core and switched in on it. */
+    uint32_t ulStolenSwitches; /* Number of times a task was stolen from the ready lists of another core and switched in on this core. */
+    uint32_t ulYieldRequests;  /* Number of yield requests sent to this core by other cores through portYIELD_CORE(). */
+} TaskCoreScheduleStats_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -1483,6 +1492,32 @@ BaseType_t xTaskResumeFromISR( TaskHandle_t xTaskToResume ) PRIVILEGED_FUNCTION;
     void vTaskPreemptionEnable( const TaskHandle_t xTask );
 #endif
 
+#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_PER_CORE_READY_LISTS == 1 ) )
+
+/**
+ * @brief Gets the scheduling counters of a core.
+ *
+ * When configUSE_PER_CORE_READY_LISTS is set to 1, each core has its own
+ * ready lists, which hold the ready tasks that last ran on it. A core takes
+ * the highest priority ready task from its own lists first, and steals a task
+ * of the same priority from the lists of another core when its own lists have
+ * no task it can run, the stolen task is moved to the lists of this core.
+ * These counters show how often tasks are taken from the core's own lists and
+ * how often they are stolen from another core. Switching in of the idle tasks
+ * is not counted.
+ *
+ * @param xCoreID The core to get the counters for.
+ * @param pxStats Pointer to the structure to be filled with the counters.
+ */
+    void vTaskGetCoreScheduleStats( BaseType_t xCoreID,
+                                    TaskCoreScheduleStats_t * pxStats );
+
+/**
+ * @brief Clears the scheduling counters of all cores.
+ */
+    void vTaskResetCoreScheduleStats( void );
+#endif
+
 /*-----------------------------------------------------------
 * SCHEDULER CONTROL
 *----------------------------------------------------------*/
@@ -31,6 +31,7 @@
 
 /* Scheduler includes. */
 #include <stdio.h>
+#include <string.h>
 #include "FreeRTOS.h"
 #include "task.h"
 
@@ -101,7 +102,15 @@ extern void prvPortStartFirstTask(void) __attribute__((naked));
  */
 static void prvTaskExitError(void);
 
+#ifdef WITH_COMPONENT_HRTIMER
+/* SysTimer interrupt is owned by hrtimer component, and the tick is one of its periodic timers */
+#include "hrtimer_api.h"
+#if( configUSE_TICKLESS_IDLE == 1 )
+#error "configUSE_TICKLESS_IDLE is not supported with hrtimer component"
+#endif
+#else
 #define xPortSysTickHandler     eclic_mtip_handler
+#endif
 
 /*-----------------------------------------------------------*/
 
@@ -113,6 +122,26 @@ UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
 UBaseType_t uxCriticalNestings[ configNUMBER_OF_CORES ] = { 0 };
 #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
 
+#if ( configUSE_HW_STACK_TRACK == 1 )
+/* Stack bound of the task to be switched in on each core, set by kernel in
+vTaskSwitchContext and written to CSR_MSTACK_BOUND by portasm.S */
+StackType_t * volatile pxPortHwStackBound[ configNUMBER_OF_CORES ];
+
+/* CSR_MSTACK_BOUND follows the lowest sp, including the sp of interrupts
+running on the interrupt stack, so the interrupt stacks of all harts must be
+above every task stack, otherwise a task bound is lowered into the interrupt
+stack, it is checked for each task in pxPortInitialiseStack */
+#ifndef __ICCRISCV__
+/* __StackBottom is the bottom of hart stacks defined in linker script such as gcc_evalsoc_ilm.ld */
+extern char __StackBottom[];
+#define portISR_STACK_BOTTOM        ( ( StackType_t * ) __StackBottom )
+#else
+/* CSTACK$$Base is defined in iar linker script such as iar_evalsoc_ilm.icf */
+extern char CSTACK$$Base[];
+#define portISR_STACK_BOTTOM        ( ( StackType_t * ) CSTACK$$Base )
+#endif
+#endif
+
 #if configMAX_SYSCALL_INTERRUPT_PRIORITY < 255
 /*
  * Record the real MTH calculated by the configMAX_SYSCALL_INTERRUPT_PRIORITY
@@ -169,6 +198,23 @@ static uint8_t ucMaxSysCallPriority = 0;
 
 spin_lock_t hw_sync_locks[portRTOS_SPINLOCK_COUNT] = {0, 0};
 
+#if ( configUSE_PORT_LOCK_STATS == 1 )
+static PortLockStats_t xPortLockStats[portRTOS_SPINLOCK_COUNT][configNUMBER_OF_CORES];
+
+void vPortGetLockStats(unsigned long ulLockNum, BaseType_t xCoreID, PortLockStats_t *pxStats)
+{
+    configASSERT(ulLockNum < portRTOS_SPINLOCK_COUNT);
+    configASSERT(xCoreID < configNUMBER_OF_CORES);
+    *pxStats = xPortLockStats[ulLockNum][xCoreID];
+}
+
+void vPortResetLockStats(void)
+{
+    memset(xPortLockStats, 0, sizeof(xPortLockStats));
+    __RWMB();
+}
+#endif
+
 /* Note this is a single method with uxAcquire parameter since we have
 * static vars, the method is always called with a compile time constant for
 * uxAcquire, and the compiler should do the right thing! */
@@ -183,6 +229,10 @@ void vPortRecursiveLock(BaseType_t xCoreID, unsigned long ulLockNum, spin_lock_t
     unsigned long ulCoreNum = xCoreID;   /* ID of current hart  */
     unsigned long ulLockBit = 1u << ulLockNum;      /* Bit mask for lock   */
     configASSERT(ulLockBit < 256u);
+#if ( configUSE_PORT_LOCK_STATS == 1 )
+    uint64_t ullSpinStart = 0;
+    BaseType_t xContended = pdFALSE;
+#endif
 
     if (uxAcquire) {    /* ACQUIRE PATH */
         /* Case 1: lock already held by THIS core -> pure recursion.  */
@@ -198,6 +248,12 @@ void vPortRecursiveLock(BaseType_t xCoreID, unsigned long ulLockNum, spin_lock_t
         do {
             /* Spin-wait until the lock appears free.                 */
             while ((!*pxSpinLock == 0)) {
+#if ( configUSE_PORT_LOCK_STATS == 1 )
+                if (xContended == pdFALSE) {
+                    xContended = pdTRUE;
+                    ullSpinStart = __get_rv_cycle();
+                }
+#endif
                 __NOP();
             }
             /* Atomically attempt to take the lock.                   */
@@ -211,6 +267,13 @@ void vPortRecursiveLock(BaseType_t xCoreID, unsigned long ulLockNum, spin_lock_t
         configASSERT(ucRecursionCountByLock[ulLockNum] == 0);
         ucRecursionCountByLock[ulLockNum] = 1;
         ucOwnedByCore[ulCoreNum] |= ulLockBit;      /* mark ownership */
+#if ( configUSE_PORT_LOCK_STATS == 1 )
+        xPortLockStats[ulLockNum][ulCoreNum].ulAcquires++;
+        if (xContended) {
+            xPortLockStats[ulLockNum][ulCoreNum].ulContended++;
+            xPortLockStats[ulLockNum][ulCoreNum].ullSpinCycles += __get_rv_cycle() - ullSpinStart;
+        }
+#endif
     } else {    /* RELEASE PATH */
         configASSERT((ucOwnedByCore[ulCoreNum] & ulLockBit) != 0);
         configASSERT(ucRecursionCountByLock[ulLockNum] != 0);
@@ -292,6 +355,11 @@ static volatile unsigned long ulSchedulerReady = 0;
  */
 StackType_t* pxPortInitialiseStack(StackType_t* pxTopOfStack, TaskFunction_t pxCode, void* pvParameters)
 {
+#if ( configUSE_HW_STACK_TRACK == 1 )
+    /* Task stack must be below the interrupt stacks, see portISR_STACK_BOTTOM */
+    configASSERT( pxTopOfStack < portISR_STACK_BOTTOM );
+#endif
+
     /* Simulate the stack frame as it would be created by a context switch
     interrupt. */
 
@@ -428,6 +496,14 @@ BaseType_t xPortStartScheduler(void)
     }
 #endif
 
+#if ( configUSE_HW_STACK_TRACK == 1 )
+    /* Stack check unit in track mode, CSR_MSTACK_BOUND follows the lowest sp,
+    the bound is loaded per task in prvPortStartFirstTask and eclic_msip_handler */
+    __RV_CSR_CLEAR(CSR_MSTACK_CTRL, MSTACK_CTRL_OVF_TRACK_EN);
+    __RV_CSR_SET(CSR_MSTACK_CTRL, MSTACK_CTRL_MODE);
+    __RV_CSR_SET(CSR_MSTACK_CTRL, MSTACK_CTRL_OVF_TRACK_EN);
+#endif
+
     /* Initialise the critical nesting count ready for the first task. */
     portSET_CRITICAL_NESTING_COUNT( xCoreID, 0 );
 
@@ -540,10 +616,13 @@ void xPortSysTickHandler(void)
     executes all interrupts must be unmasked.  There is therefore no need to
     save and then restore the interrupt mask value as its value is already
     known. */
+    traceISR_ENTER();
 #if ( configNUMBER_OF_CORES == 1 )
     portDISABLE_INTERRUPTS();
     {
+#ifndef WITH_COMPONENT_HRTIMER
         SysTick_Reload(SYSTICK_TICK_CONST);
+#endif
         /* Increment the RTOS tick. */
         if (xTaskIncrementTick() != pdFALSE) {
             /* A context switch is required.  Context switching is performed in
@@ -559,7 +638,9 @@ void xPortSysTickHandler(void)
      * critical section. */
     ulPreviousMask = taskENTER_CRITICAL_FROM_ISR();
     {
+#ifndef WITH_COMPONENT_HRTIMER
         SysTick_Reload(SYSTICK_TICK_CONST);
+#endif
         /* Increment the RTOS tick. */
         if (xTaskIncrementTick() != pdFALSE) {
             /* A context switch is required.  Context switching is performed in
@@ -569,6 +650,7 @@ void xPortSysTickHandler(void)
     }
     taskEXIT_CRITICAL_FROM_ISR( ulPreviousMask );
 #endif
+    traceISR_EXIT();
 }
 /*-----------------------------------------------------------*/
 
@@ -748,7 +830,11 @@ __attribute__((weak)) void vPortSetupTimerInterrupt(void)
 #else
     if (1) {
 #endif
+#ifdef WITH_COMPONENT_HRTIMER
+        hrtimer_tick_config(ticks, xPortSysTickHandler);
+#else
         SysTick_Config(ticks);
+#endif
         ECLIC_DisableIRQ(SysTimer_IRQn);
         ECLIC_SetLevelIRQ(SysTimer_IRQn, configKERNEL_INTERRUPT_PRIORITY);
         ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
@@ -257,6 +257,27 @@ portFORCE_INLINE static void vPortSetBASEPRI(uint8_t ulNewMaskValue)
     extern spin_lock_t hw_sync_locks[portRTOS_SPINLOCK_COUNT];
     extern void vPortRecursiveLock(BaseType_t xCoreID, unsigned long ulLockNum, spin_lock_t *pxSpinLock, BaseType_t uxAcquire);
 
+    /* Set configUSE_PORT_LOCK_STATS to 1 in FreeRTOSConfig.h to count, per lock
+     * and per core, how often the ISR lock(0) and TASK lock(1) are taken and how
+     * long the core spins when the lock is held by another core. */
+    #ifndef configUSE_PORT_LOCK_STATS
+    #define configUSE_PORT_LOCK_STATS                   0
+    #endif
+
+    #if ( configUSE_PORT_LOCK_STATS == 1 )
+    typedef struct {
+        uint32_t ulAcquires;        /* Number of acquisitions, recursive ones are not counted */
+        uint32_t ulContended;       /* Number of acquisitions which found the lock held by another core */
+        uint64_t ullSpinCycles;     /* Cycles spent waiting for the lock held by another core */
+    } PortLockStats_t;
+
+    /* Each core only updates its own counters, so reading counters of other
+     * cores is not atomic, and reset should be done when the counters are not
+     * being updated by other cores. */
+    extern void vPortGetLockStats(unsigned long ulLockNum, BaseType_t xCoreID, PortLockStats_t *pxStats);
+    extern void vPortResetLockStats(void);
+    #endif
+
     /* Acquire the TASK lock. TASK lock is a recursive lock.
      * It should be able to be locked by the same core multiple times. */
     #define portGET_TASK_LOCK( xCoreID )                vPortRecursiveLock(xCoreID, 1, &hw_sync_locks[1], pdTRUE )
@@ -291,6 +312,21 @@ portFORCE_INLINE static void vPortSetBASEPRI(uint8_t ulNewMaskValue)
 
 #endif /* if ( configNUMBER_OF_CORES > 1 ) */
 
+/* Set configUSE_HW_STACK_TRACK to 1 (STACKTRACK=1 in make) to track the stack
+ * high water mark of each task by the stack check unit in track mode, the
+ * stack bound of the task switched in is written to CSR_MSTACK_BOUND by
+ * portasm.S right after sp is switched, so it must also be passed to assembler */
+#if defined( configUSE_HW_STACK_TRACK ) && ( configUSE_HW_STACK_TRACK == 1 )
+    #if !defined(CFG_HAS_STACK_CHECK)
+    #error "configUSE_HW_STACK_TRACK requires stack check unit, CFG_HAS_STACK_CHECK is not defined"
+    #endif
+    extern StackType_t * volatile pxPortHwStackBound[ configNUMBER_OF_CORES ];
+    /* Lowest sp reached by the task running on this core since switched in */
+    #define portHW_STACK_TRACK_GET()                    ( ( StackType_t * ) __RV_CSR_READ( CSR_MSTACK_BOUND ) )
+    /* Stack bound loaded when the task is switched in on core xCoreID */
+    #define portHW_STACK_TRACK_SET( xCoreID, pxBound )  ( pxPortHwStackBound[ ( xCoreID ) ] = ( pxBound ) )
+#endif
+
 #ifdef __cplusplus
 }
 #endif
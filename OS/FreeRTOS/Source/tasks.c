@@ -127,7 +127,15 @@
 /* If any of the following are set then task stacks are filled with a known
  * value so the high water mark can be determined.  If none of the following are
  * set then don't fill the stack so there is no unnecessary dependency on memset. */
-#if ( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+#if ( configUSE_HW_STACK_TRACK == 1 )
+    /* The high water mark is tracked by hardware, the known value is only
+     * needed by the stack overflow check method 2. */
+    #if ( configCHECK_FOR_STACK_OVERFLOW > 1 )
+        #define tskSET_NEW_STACKS_TO_KNOWN_VALUE    1
+    #else
+        #define tskSET_NEW_STACKS_TO_KNOWN_VALUE    0
+    #endif
+#elif ( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
     #define tskSET_NEW_STACKS_TO_KNOWN_VALUE    1
 #else
     #define tskSET_NEW_STACKS_TO_KNOWN_VALUE    0
@@ -277,16 +285,37 @@
 
 /*-----------------------------------------------------------*/
 
+/*
+ * With configUSE_PER_CORE_READY_LISTS, each core has its own set of ready
+ * lists, stored one after another in pxReadyTasksLists, and a ready task is
+ * referenced from the lists of its home core xReadyCore.  taskREADY_LIST()
+ * returns the ready list of a core and priority, taskTCB_READY_LIST() returns
+ * the ready list of priority uxPriority that pxTCB is referenced from, or is
+ * added to, and taskREADY_TASKS_AT_PRIORITY() counts the ready tasks of a
+ * priority on all cores.
+ */
+#if ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configNUMBER_OF_CORES > 1 )
+    #define taskREADY_LISTS_NUM    ( ( UBaseType_t ) configMAX_PRIORITIES * ( UBaseType_t ) configNUMBER_OF_CORES )
+    #define taskREADY_LIST( xCoreID, uxPriority ) \
+    ( &( pxReadyTasksLists[ ( ( UBaseType_t ) ( xCoreID ) * ( UBaseType_t ) configMAX_PRIORITIES ) + ( uxPriority ) ] ) )
+    #define taskTCB_READY_LIST( pxTCB, uxPriority )      taskREADY_LIST( ( pxTCB )->xReadyCore, ( uxPriority ) )
+    #define taskREADY_TASKS_AT_PRIORITY( uxPriority )    prvReadyTasksAtPriority( uxPriority )
+#else
+    #define taskREADY_LISTS_NUM                          ( ( UBaseType_t ) configMAX_PRIORITIES )
+    #define taskTCB_READY_LIST( pxTCB, uxPriority )      ( &( pxReadyTasksLists[ ( uxPriority ) ] ) )
+    #define taskREADY_TASKS_AT_PRIORITY( uxPriority )    listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( uxPriority ) ] ) )
+#endif
+
 /*
  * Place the task represented by pxTCB into the appropriate ready list for
  * the task.  It is inserted at the end of the list.
  */
-#define prvAddTaskToReadyList( pxTCB )                                                                     \
-    do {                                                                                                   \
-        traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                           \
-        taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                \
-        listINSERT_END( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
-        tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB );                                                      \
+#define prvAddTaskToReadyList( pxTCB )                                                                        \
+    do {                                                                                                      \
+        traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                              \
+        taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                   \
+        listINSERT_END( taskTCB_READY_LIST( ( pxTCB ), ( pxTCB )->uxPriority ), &( ( pxTCB )->xStateListItem ) ); \
+        tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB );                                                         \
     } while( 0 )
 /*-----------------------------------------------------------*/
 
@@ -359,10 +388,17 @@
             if( pxCurrentTCBs[ ( xCoreID ) ]->xTaskRunState != taskTASK_SCHEDULED_TO_YIELD ) \
             {                                                                                \
                 portYIELD_CORE( xCoreID );                                                   \
+                taskRECORD_YIELD_REQUEST( xCoreID );                                         \
                 pxCurrentTCBs[ ( xCoreID ) ]->xTaskRunState = taskTASK_SCHEDULED_TO_YIELD;   \
             }                                                                                \
         }                                                                                    \
     } while( 0 )
+
+    #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+        #define taskRECORD_YIELD_REQUEST( xCoreID )    ( xCoreScheduleStats[ ( xCoreID ) ].ulYieldRequests++ )
+    #else
+        #define taskRECORD_YIELD_REQUEST( xCoreID )
+    #endif
 #endif /* #if ( configNUMBER_OF_CORES > 1 ) */
 /*-----------------------------------------------------------*/
 
@@ -391,6 +427,12 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         volatile BaseType_t xTaskRunState;      /**< Used to identify the core the task is running on, if the task is running. Otherwise, identifies the task's state - not running or yielding. */
         UBaseType_t uxTaskAttributes;           /**< Task's attributes - currently used to identify the idle tasks. */
     #endif
+    #if ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configNUMBER_OF_CORES > 1 )
+        BaseType_t xReadyCore; /**< The home core of the task, whose ready lists reference the task when it is ready.  It is the core the task last ran on. */
+    #endif
+    #if ( configUSE_HW_STACK_TRACK == 1 )
+        StackType_t * pxHwStackLowest; /**< The lowest stack address the task has used, tracked by the stack check hardware. */
+    #endif
     char pcTaskName[ configMAX_TASK_NAME_LEN ]; /**< Descriptive name given to the task when created.  Facilitates debugging only. */
 
     #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
@@ -472,7 +514,7 @@ typedef tskTCB TCB_t;
  * xDelayedTaskList1 and xDelayedTaskList2 could be moved to function scope but
  * doing so breaks some kernel aware debuggers and debuggers that rely on removing
  * the static qualifier. */
-PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /**< Prioritised ready tasks. */
+PRIVILEGED_DATA static List_t pxReadyTasksLists[ taskREADY_LISTS_NUM ];  /**< Prioritised ready tasks, of each core with configUSE_PER_CORE_READY_LISTS. */
 PRIVILEGED_DATA static List_t xDelayedTaskList1;                         /**< Delayed tasks. */
 PRIVILEGED_DATA static List_t xDelayedTaskList2;                         /**< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /**< Points to the delayed task list currently being used. */
@@ -510,10 +552,16 @@ PRIVILEGED_DATA static UBaseType_t uxTaskNumber = ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime = ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
 PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandles[ configNUMBER_OF_CORES ];       /**< Holds the handles of the idle tasks.  The idle tasks are created automatically when the scheduler is started. */
 
+#if ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configNUMBER_OF_CORES > 1 )
+    /* Only updated with the task lock and the ISR lock both held. */
+    PRIVILEGED_DATA static TaskCoreScheduleStats_t xCoreScheduleStats[ configNUMBER_OF_CORES ];
+#endif
+
 /* Improve support for OpenOCD. The kernel tracks Ready tasks via priority lists.
  * For tracking the state of remote threads, OpenOCD uses uxTopUsedPriority
- * to determine the number of priority lists to read back from the remote target. */
-static const volatile UBaseType_t uxTopUsedPriority = configMAX_PRIORITIES - 1U;
+ * to determine the number of priority lists to read back from the remote target,
+ * the ready lists of all cores are read with configUSE_PER_CORE_READY_LISTS. */
+static const volatile UBaseType_t uxTopUsedPriority = taskREADY_LISTS_NUM - 1U;
 
 /* Context switches are held pending while the scheduler is suspended.  Also,
  * interrupts must not manipulate the xStateListItem of a TCB, or any of the
@@ -573,6 +621,21 @@ static BaseType_t prvCreateIdleTasks( void );
     static void prvSelectHighestPriorityTask( BaseType_t xCoreID );
 #endif /* #if ( configNUMBER_OF_CORES > 1 ) */
 
+#if ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configNUMBER_OF_CORES > 1 )
+
+/*
+ * Returns the number of ready tasks of priority uxPriority on all cores.
+ */
+    static UBaseType_t prvReadyTasksAtPriority( UBaseType_t uxPriority );
+
+/*
+ * Moves the ready task pxTCB to the end of the ready list of its priority on
+ * xCoreID, and makes xCoreID its home core.
+ */
+    static void prvMoveTaskToCoreReadyList( TCB_t * pxTCB,
+                                            BaseType_t xCoreID );
+#endif
+
 /**
  * Utility task that simply returns pdTRUE if the task referenced by xTask is
  * currently in the Suspended state, or pdFALSE if the task referenced by xTask
@@ -670,12 +733,28 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  * This function determines the 'high water mark' of the task stack by
  * determining how much of the stack remains at the original preset value.
  */
-#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) ) && ( configUSE_HW_STACK_TRACK == 0 )
 
     static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte ) PRIVILEGED_FUNCTION;
 
 #endif
 
+/*
+ * When configUSE_HW_STACK_TRACK is 1, the stack bound register follows the
+ * lowest stack pointer while a task runs.  prvHwStackTrackRecord() saves it
+ * into the TCB of the task running on this core, and
+ * prvTaskCheckFreeStackSpaceHw() returns the high water mark from the TCB.
+ */
+#if ( configUSE_HW_STACK_TRACK == 1 )
+
+    static void prvHwStackTrackRecord( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+    #if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+        static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpaceHw( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+    #endif
+
+#endif
+
 /*
  * Return the amount of time, in ticks, that will pass before the kernel will
  * next move a task from the Blocked state to the Running state or before the
@@ -943,6 +1022,13 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                                 #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
                                     if( pxCurrentTCBs[ xCoreID ]->xPreemptionDisable == pdFALSE )
                                 #endif
+                                #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+                                    /* Among cores running tasks of the same lowest priority, keep
+                                     * the home core of pxTCB so that it is not stolen. */
+                                    if( ( xLowestPriorityCore < 0 ) ||
+                                        ( xLowestPriorityCore != pxTCB->xReadyCore ) ||
+                                        ( xCurrentCoreTaskPriority < xLowestPriorityToPreempt ) )
+                                #endif
                                 {
                                     xLowestPriorityToPreempt = xCurrentCoreTaskPriority;
                                     xLowestPriorityCore = xCoreID;
@@ -1015,6 +1101,9 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
         #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
             BaseType_t xPriorityDropped = pdFALSE;
         #endif
+        #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+            BaseType_t xListIndex;
+        #endif
 
         /* This function should be called when scheduler is running. */
         configASSERT( xSchedulerRunning == pdTRUE );
@@ -1029,11 +1118,11 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
          *
          * To fix these problems, the running task should be put to the end of the
          * ready list before searching for the ready task in the ready list. */
-        if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ),
+        if( listIS_CONTAINED_WITHIN( taskTCB_READY_LIST( pxCurrentTCBs[ xCoreID ], pxCurrentTCBs[ xCoreID ]->uxPriority ),
                                      &pxCurrentTCBs[ xCoreID ]->xStateListItem ) == pdTRUE )
         {
             ( void ) uxListRemove( &pxCurrentTCBs[ xCoreID ]->xStateListItem );
-            vListInsertEnd( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ),
+            vListInsertEnd( taskTCB_READY_LIST( pxCurrentTCBs[ xCoreID ], pxCurrentTCBs[ xCoreID ]->uxPriority ),
                             &pxCurrentTCBs[ xCoreID ]->xStateListItem );
         }
 
@@ -1051,77 +1140,118 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             }
             #endif
 
-            if( listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxCurrentPriority ] ) ) == pdFALSE )
+            if( taskREADY_TASKS_AT_PRIORITY( uxCurrentPriority ) > ( UBaseType_t ) 0U )
             {
-                const List_t * const pxReadyList = &( pxReadyTasksLists[ uxCurrentPriority ] );
-                const ListItem_t * pxEndMarker = listGET_END_MARKER( pxReadyList );
+                const List_t * pxReadyList;
+                const ListItem_t * pxEndMarker;
                 ListItem_t * pxIterator;
 
                 /* The ready task list for uxCurrentPriority is not empty, so uxTopReadyPriority
                  * must not be decremented any further. */
                 xDecrementTopPriority = pdFALSE;
 
-                for( pxIterator = listGET_HEAD_ENTRY( pxReadyList ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+                /* With per-core ready lists, the ready list of this core is searched
+                 * first, then the ready lists of the other cores, in core order from
+                 * this core, to steal a task of the same priority. */
+                #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+                    for( xListIndex = ( BaseType_t ) 0; ( xListIndex < ( BaseType_t ) configNUMBER_OF_CORES ) && ( xTaskScheduled == pdFALSE ); xListIndex++ )
+                #endif
                 {
-                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
-                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-                    /* coverity[misra_c_2012_rule_11_5_violation] */
-                    pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+                    #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+                    {
+                        pxReadyList = taskREADY_LIST( ( xCoreID + xListIndex ) % ( BaseType_t ) configNUMBER_OF_CORES, uxCurrentPriority );
+                    }
+                    #else
+                    {
+                        pxReadyList = &( pxReadyTasksLists[ uxCurrentPriority ] );
+                    }
+                    #endif
+                    pxEndMarker = listGET_END_MARKER( pxReadyList );
 
-                    #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
+                    for( pxIterator = listGET_HEAD_ENTRY( pxReadyList ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
                     {
-                        /* When falling back to the idle priority because only one priority
-                         * level is allowed to run at a time, we should ONLY schedule the true
-                         * idle tasks, not user tasks at the idle priority. */
-                        if( uxCurrentPriority < uxTopReadyPriority )
+                        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                        /* coverity[misra_c_2012_rule_11_5_violation] */
+                        pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+                        #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
                         {
-                            if( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U )
+                            /* When falling back to the idle priority because only one priority
+                             * level is allowed to run at a time, we should ONLY schedule the true
+                             * idle tasks, not user tasks at the idle priority. */
+                            if( uxCurrentPriority < uxTopReadyPriority )
                             {
-                                continue;
+                                if( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U )
+                                {
+                                    continue;
+                                }
                             }
                         }
-                    }
-                    #endif /* #if ( configRUN_MULTIPLE_PRIORITIES == 0 ) */
+                        #endif /* #if ( configRUN_MULTIPLE_PRIORITIES == 0 ) */
 
-                    if( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING )
-                    {
-                        #if ( configUSE_CORE_AFFINITY == 1 )
-                            if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
-                        #endif
+                        if( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING )
                         {
-                            /* If the task is not being executed by any core swap it in. */
-                            pxCurrentTCBs[ xCoreID ]->xTaskRunState = taskTASK_NOT_RUNNING;
                             #if ( configUSE_CORE_AFFINITY == 1 )
-                                pxPreviousTCB = pxCurrentTCBs[ xCoreID ];
+                                if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
                             #endif
-                            pxTCB->xTaskRunState = xCoreID;
-                            pxCurrentTCBs[ xCoreID ] = pxTCB;
-                            xTaskScheduled = pdTRUE;
+                            {
+                                /* If the task is not being executed by any core swap it in. */
+                                pxCurrentTCBs[ xCoreID ]->xTaskRunState = taskTASK_NOT_RUNNING;
+                                #if ( configUSE_CORE_AFFINITY == 1 )
+                                    pxPreviousTCB = pxCurrentTCBs[ xCoreID ];
+                                #endif
+                                #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+                                {
+                                    if( pxTCB->xReadyCore != xCoreID )
+                                    {
+                                        /* Steal the task, this core becomes its home core. */
+                                        prvMoveTaskToCoreReadyList( pxTCB, xCoreID );
+
+                                        if( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U )
+                                        {
+                                            xCoreScheduleStats[ xCoreID ].ulStolenSwitches++;
+                                        }
+                                    }
+                                    else if( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U )
+                                    {
+                                        xCoreScheduleStats[ xCoreID ].ulLocalSwitches++;
+                                    }
+                                    else
+                                    {
+                                        mtCOVERAGE_TEST_MARKER();
+                                    }
+                                }
+                                #endif
+                                pxTCB->xTaskRunState = xCoreID;
+                                pxCurrentTCBs[ xCoreID ] = pxTCB;
+                                xTaskScheduled = pdTRUE;
+                            }
                         }
-                    }
-                    else if( pxTCB == pxCurrentTCBs[ xCoreID ] )
-                    {
-                        configASSERT( ( pxTCB->xTaskRunState == xCoreID ) || ( pxTCB->xTaskRunState == taskTASK_SCHEDULED_TO_YIELD ) );
+                        else if( pxTCB == pxCurrentTCBs[ xCoreID ] )
+                        {
+                            configASSERT( ( pxTCB->xTaskRunState == xCoreID ) || ( pxTCB->xTaskRunState == taskTASK_SCHEDULED_TO_YIELD ) );
 
-                        #if ( configUSE_CORE_AFFINITY == 1 )
-                            if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
-                        #endif
+                            #if ( configUSE_CORE_AFFINITY == 1 )
+                                if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
+                            #endif
+                            {
+                                /* The task is already running on this core, mark it as scheduled. */
+                                pxTCB->xTaskRunState = xCoreID;
+                                xTaskScheduled = pdTRUE;
+                            }
+                        }
+                        else
                         {
-                            /* The task is already running on this core, mark it as scheduled. */
-                            pxTCB->xTaskRunState = xCoreID;
-                            xTaskScheduled = pdTRUE;
+                            /* This task is running on the core other than xCoreID. */
+                            mtCOVERAGE_TEST_MARKER();
                         }
-                    }
-                    else
-                    {
-                        /* This task is running on the core other than xCoreID. */
-                        mtCOVERAGE_TEST_MARKER();
-                    }
 
-                    if( xTaskScheduled != pdFALSE )
-                    {
-                        /* A task has been selected to run on this core. */
-                        break;
+                        if( xTaskScheduled != pdFALSE )
+                        {
+                            /* A task has been selected to run on this core. */
+                            break;
+                        }
                     }
                 }
             }
@@ -1181,7 +1311,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
         {
             if( xTaskScheduled == pdTRUE )
             {
-                if( ( pxPreviousTCB != NULL ) && ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxPreviousTCB->uxPriority ] ), &( pxPreviousTCB->xStateListItem ) ) != pdFALSE ) )
+                if( ( pxPreviousTCB != NULL ) && ( listIS_CONTAINED_WITHIN( taskTCB_READY_LIST( pxPreviousTCB, pxPreviousTCB->uxPriority ), &( pxPreviousTCB->xStateListItem ) ) != pdFALSE ) )
                 {
                     /* A ready task was just evicted from this core. See if it can be
                      * scheduled on any other core. */
@@ -1271,6 +1401,35 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configNUMBER_OF_CORES > 1 )
+
+    static UBaseType_t prvReadyTasksAtPriority( UBaseType_t uxPriority )
+    {
+        UBaseType_t uxReadyTasks = 0U;
+        BaseType_t xCoreID;
+
+        for( xCoreID = ( BaseType_t ) 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+        {
+            uxReadyTasks += listCURRENT_LIST_LENGTH( taskREADY_LIST( xCoreID, uxPriority ) );
+        }
+
+        return uxReadyTasks;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void prvMoveTaskToCoreReadyList( TCB_t * pxTCB,
+                                            BaseType_t xCoreID )
+    {
+        ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+        pxTCB->xReadyCore = xCoreID;
+        listINSERT_END( taskTCB_READY_LIST( pxTCB, pxTCB->uxPriority ), &( pxTCB->xStateListItem ) );
+    }
+
+#endif /* #if ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configNUMBER_OF_CORES > 1 ) */
+
+/*-----------------------------------------------------------*/
+
 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
 
     static TCB_t * prvCreateStaticTask( TaskFunction_t pxTaskCode,
@@ -2010,11 +2169,25 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     }
     #endif /* portUSING_MPU_WRAPPERS */
 
+    #if ( configUSE_HW_STACK_TRACK == 1 )
+    {
+        /* Only the initial context is on the stack so far. */
+        pxNewTCB->pxHwStackLowest = ( StackType_t * ) pxNewTCB->pxTopOfStack;
+    }
+    #endif
+
     /* Initialize task state and task attributes. */
     #if ( configNUMBER_OF_CORES > 1 )
     {
         pxNewTCB->xTaskRunState = taskTASK_NOT_RUNNING;
 
+        #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+        {
+            /* A new task is made ready on the core creating it. */
+            pxNewTCB->xReadyCore = ( BaseType_t ) portGET_CORE_ID();
+        }
+        #endif
+
         /* Is this an idle task? */
         if( ( ( TaskFunction_t ) pxTaskCode == ( TaskFunction_t ) ( &prvIdleTask ) ) || ( ( TaskFunction_t ) pxTaskCode == ( TaskFunction_t ) ( &prvPassiveIdleTask ) ) )
         {
@@ -2936,7 +3109,7 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                  * nothing more than change its priority variable. However, if
                  * the task is in a ready list it needs to be removed and placed
                  * in the list appropriate to its new priority. */
-                if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+                if( listIS_CONTAINED_WITHIN( taskTCB_READY_LIST( pxTCB, uxPriorityUsedOnEntry ), &( pxTCB->xStateListItem ) ) != pdFALSE )
                 {
                     /* The task is currently in its ready list - remove before
                      * adding it to its new ready list.  As we are in a critical
@@ -3144,6 +3317,41 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
 #endif /* #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 ) */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configNUMBER_OF_CORES > 1 )
+
+    void vTaskGetCoreScheduleStats( BaseType_t xCoreID,
+                                    TaskCoreScheduleStats_t * pxStats )
+    {
+        configASSERT( taskVALID_CORE_ID( xCoreID ) == pdTRUE );
+        configASSERT( pxStats != NULL );
+
+        taskENTER_CRITICAL();
+        {
+            *pxStats = xCoreScheduleStats[ xCoreID ];
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskResetCoreScheduleStats( void )
+    {
+        BaseType_t xCoreID;
+
+        taskENTER_CRITICAL();
+        {
+            for( xCoreID = ( BaseType_t ) 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                xCoreScheduleStats[ xCoreID ].ulLocalSwitches = 0U;
+                xCoreScheduleStats[ xCoreID ].ulStolenSwitches = 0U;
+                xCoreScheduleStats[ xCoreID ].ulYieldRequests = 0U;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* #if ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configNUMBER_OF_CORES > 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskSuspend == 1 )
 
     void vTaskSuspend( TaskHandle_t xTaskToSuspend )
@@ -3676,6 +3884,12 @@ static BaseType_t prvCreateIdleTasks( void )
                 /* Assign idle task to each core before SMP scheduler is running. */
                 xIdleTaskHandles[ xCoreID ]->xTaskRunState = xCoreID;
                 pxCurrentTCBs[ xCoreID ] = xIdleTaskHandles[ xCoreID ];
+
+                #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+                {
+                    prvMoveTaskToCoreReadyList( xIdleTaskHandles[ xCoreID ], xCoreID );
+                }
+                #endif
             }
             #endif
         }
@@ -3753,6 +3967,26 @@ void vTaskStartScheduler( void )
          * FreeRTOSConfig.h file. */
         portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
 
+        #if ( configUSE_HW_STACK_TRACK == 1 )
+        {
+            /* Stack bound to be loaded when the first task starts on each core. */
+            #if ( configNUMBER_OF_CORES == 1 )
+            {
+                portHW_STACK_TRACK_SET( 0, pxCurrentTCB->pxHwStackLowest );
+            }
+            #else
+            {
+                BaseType_t xCoreID;
+
+                for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+                {
+                    portHW_STACK_TRACK_SET( xCoreID, pxCurrentTCBs[ xCoreID ]->pxHwStackLowest );
+                }
+            }
+            #endif
+        }
+        #endif
+
         traceTASK_SWITCHED_IN();
 
         traceSTARTING_SCHEDULER( xIdleTaskHandles );
@@ -3982,7 +4216,7 @@ void vTaskSuspendAll( void )
         {
             xReturn = 0;
         }
-        else if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > 1U )
+        else if( taskREADY_TASKS_AT_PRIORITY( tskIDLE_PRIORITY ) > 1U )
         {
             /* There are other idle priority tasks in the ready state.  If
              * time slicing is used then the very next tick interrupt must be
@@ -4316,7 +4550,7 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
 
     TaskHandle_t xTaskGetHandle( const char * pcNameToQuery )
     {
-        UBaseType_t uxQueue = configMAX_PRIORITIES;
+        UBaseType_t uxQueue = taskREADY_LISTS_NUM;
         TCB_t * pxTCB;
 
         traceENTER_xTaskGetHandle( pcNameToQuery );
@@ -4441,7 +4675,7 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
                                       const UBaseType_t uxArraySize,
                                       configRUN_TIME_COUNTER_TYPE * const pulTotalRunTime )
     {
-        UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
+        UBaseType_t uxTask = 0, uxQueue = taskREADY_LISTS_NUM;
 
         traceENTER_uxTaskGetSystemState( pxTaskStatusArray, uxArraySize, pulTotalRunTime );
 
@@ -4862,7 +5096,7 @@ BaseType_t xTaskIncrementTick( void )
         {
             #if ( configNUMBER_OF_CORES == 1 )
             {
-                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > 1U )
+                if( taskREADY_TASKS_AT_PRIORITY( pxCurrentTCB->uxPriority ) > 1U )
                 {
                     xSwitchRequired = pdTRUE;
                 }
@@ -4877,7 +5111,7 @@ BaseType_t xTaskIncrementTick( void )
 
                 for( xCoreID = 0; xCoreID < ( ( BaseType_t ) configNUMBER_OF_CORES ); xCoreID++ )
                 {
-                    if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ) ) > 1U )
+                    if( taskREADY_TASKS_AT_PRIORITY( pxCurrentTCBs[ xCoreID ]->uxPriority ) > 1U )
                     {
                         xYieldPendings[ xCoreID ] = pdTRUE;
                     }
@@ -5152,6 +5386,13 @@ BaseType_t xTaskIncrementTick( void )
             /* Check for stack overflow, if configured. */
             taskCHECK_FOR_STACK_OVERFLOW();
 
+            /* Save the stack high water mark tracked by hardware. */
+            #if ( configUSE_HW_STACK_TRACK == 1 )
+            {
+                prvHwStackTrackRecord( pxCurrentTCB );
+            }
+            #endif
+
             /* Before the currently running task is switched out, save its errno. */
             #if ( configUSE_POSIX_ERRNO == 1 )
             {
@@ -5172,6 +5413,14 @@ BaseType_t xTaskIncrementTick( void )
              * or reconfiguring the MPU. */
             portTASK_SWITCH_HOOK( pxCurrentTCB );
 
+            /* The port loads the stack bound of the new task after its stack
+             * pointer is restored. */
+            #if ( configUSE_HW_STACK_TRACK == 1 )
+            {
+                portHW_STACK_TRACK_SET( 0, pxCurrentTCB->pxHwStackLowest );
+            }
+            #endif
+
             /* After the new task is switched in, update the global errno. */
             #if ( configUSE_POSIX_ERRNO == 1 )
             {
@@ -5253,6 +5502,13 @@ BaseType_t xTaskIncrementTick( void )
                 /* Check for stack overflow, if configured. */
                 taskCHECK_FOR_STACK_OVERFLOW();
 
+                /* Save the stack high water mark tracked by hardware. */
+                #if ( configUSE_HW_STACK_TRACK == 1 )
+                {
+                    prvHwStackTrackRecord( pxCurrentTCBs[ xCoreID ] );
+                }
+                #endif
+
                 /* Before the currently running task is switched out, save its errno. */
                 #if ( configUSE_POSIX_ERRNO == 1 )
                 {
@@ -5269,6 +5525,14 @@ BaseType_t xTaskIncrementTick( void )
                  * or reconfiguring the MPU. */
                 portTASK_SWITCH_HOOK( pxCurrentTCBs[ portGET_CORE_ID() ] );
 
+                /* The port loads the stack bound of the new task after its stack
+                 * pointer is restored. */
+                #if ( configUSE_HW_STACK_TRACK == 1 )
+                {
+                    portHW_STACK_TRACK_SET( xCoreID, pxCurrentTCBs[ xCoreID ]->pxHwStackLowest );
+                }
+                #endif
+
                 /* After the new task is switched in, update the global errno. */
                 #if ( configUSE_POSIX_ERRNO == 1 )
                 {
@@ -5758,7 +6022,7 @@ void vTaskMissedYield( void )
                  * the ready list at the idle priority contains one more task than the
                  * number of idle tasks, which is equal to the configured numbers of cores
                  * then a task other than the idle task is ready to execute. */
-                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUMBER_OF_CORES )
+                if( taskREADY_TASKS_AT_PRIORITY( tskIDLE_PRIORITY ) > ( UBaseType_t ) configNUMBER_OF_CORES )
                 {
                     taskYIELD();
                 }
@@ -5847,7 +6111,7 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
              * the ready list at the idle priority contains one more task than the
              * number of idle tasks, which is equal to the configured numbers of cores
              * then a task other than the idle task is ready to execute. */
-            if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUMBER_OF_CORES )
+            if( taskREADY_TASKS_AT_PRIORITY( tskIDLE_PRIORITY ) > ( UBaseType_t ) configNUMBER_OF_CORES )
             {
                 taskYIELD();
             }
@@ -6066,11 +6330,11 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 
 static void prvInitialiseTaskLists( void )
 {
-    UBaseType_t uxPriority;
+    UBaseType_t uxList;
 
-    for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+    for( uxList = ( UBaseType_t ) 0U; uxList < taskREADY_LISTS_NUM; uxList++ )
     {
-        vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
+        vListInitialise( &( pxReadyTasksLists[ uxList ] ) );
     }
 
     vListInitialise( &xDelayedTaskList1 );
@@ -6299,7 +6563,11 @@ static void prvCheckTasksWaitingTermination( void )
          * parameter is provided to allow it to be skipped. */
         if( xGetFreeStackSpace != pdFALSE )
         {
-            #if ( portSTACK_GROWTH > 0 )
+            #if ( configUSE_HW_STACK_TRACK == 1 )
+            {
+                pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpaceHw( pxTCB );
+            }
+            #elif ( portSTACK_GROWTH > 0 )
             {
                 pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxEndOfStack );
             }
@@ -6359,7 +6627,7 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) ) && ( configUSE_HW_STACK_TRACK == 0 )
 
     static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte )
     {
@@ -6376,7 +6644,55 @@ static void prvCheckTasksWaitingTermination( void )
         return uxCount;
     }
 
-#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) ) */
+#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) ) && ( configUSE_HW_STACK_TRACK == 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_HW_STACK_TRACK == 1 )
+
+    static void prvHwStackTrackRecord( TCB_t * pxTCB )
+    {
+        StackType_t * pxBound = portHW_STACK_TRACK_GET();
+
+        /* A bound below the start of the stack means the stack overflowed. */
+        if( pxBound < pxTCB->pxStack )
+        {
+            pxBound = pxTCB->pxStack;
+        }
+
+        if( pxBound < pxTCB->pxHwStackLowest )
+        {
+            pxTCB->pxHwStackLowest = pxBound;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+
+        static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpaceHw( TCB_t * pxTCB )
+        {
+            /* The bound of a task is saved to its TCB when it is switched out,
+             * so take the live bound if it is running on this core.  For a
+             * task running on another core, the value saved when it was last
+             * switched out is returned. */
+            taskENTER_CRITICAL();
+            {
+                #if ( configNUMBER_OF_CORES == 1 )
+                    if( pxTCB == pxCurrentTCB )
+                #else
+                    if( pxTCB == pxCurrentTCBs[ portGET_CORE_ID() ] )
+                #endif
+                {
+                    prvHwStackTrackRecord( pxTCB );
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            return ( configSTACK_DEPTH_TYPE ) ( pxTCB->pxHwStackLowest - pxTCB->pxStack );
+        }
+
+    #endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) ) */
+
+#endif /* configUSE_HW_STACK_TRACK */
 /*-----------------------------------------------------------*/
 
 #if ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 )
@@ -6389,7 +6705,9 @@ static void prvCheckTasksWaitingTermination( void )
     configSTACK_DEPTH_TYPE uxTaskGetStackHighWaterMark2( TaskHandle_t xTask )
     {
         TCB_t * pxTCB;
-        uint8_t * pucEndOfStack;
+        #if ( configUSE_HW_STACK_TRACK == 0 )
+            uint8_t * pucEndOfStack;
+        #endif
         configSTACK_DEPTH_TYPE uxReturn;
 
         traceENTER_uxTaskGetStackHighWaterMark2( xTask );
@@ -6404,18 +6722,26 @@ static void prvCheckTasksWaitingTermination( void )
         pxTCB = prvGetTCBFromHandle( xTask );
         configASSERT( pxTCB != NULL );
 
-        #if portSTACK_GROWTH < 0
+        #if ( configUSE_HW_STACK_TRACK == 1 )
         {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+            uxReturn = prvTaskCheckFreeStackSpaceHw( pxTCB );
         }
         #else
         {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+            #if portSTACK_GROWTH < 0
+            {
+                pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+            }
+            #else
+            {
+                pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+            }
+            #endif
+
+            uxReturn = prvTaskCheckFreeStackSpace( pucEndOfStack );
         }
         #endif
 
-        uxReturn = prvTaskCheckFreeStackSpace( pucEndOfStack );
-
         traceRETURN_uxTaskGetStackHighWaterMark2( uxReturn );
 
         return uxReturn;
@@ -6429,7 +6755,9 @@ static void prvCheckTasksWaitingTermination( void )
     UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
     {
         TCB_t * pxTCB;
-        uint8_t * pucEndOfStack;
+        #if ( configUSE_HW_STACK_TRACK == 0 )
+            uint8_t * pucEndOfStack;
+        #endif
         UBaseType_t uxReturn;
 
         traceENTER_uxTaskGetStackHighWaterMark( xTask );
@@ -6437,18 +6765,26 @@ static void prvCheckTasksWaitingTermination( void )
         pxTCB = prvGetTCBFromHandle( xTask );
         configASSERT( pxTCB != NULL );
 
-        #if portSTACK_GROWTH < 0
+        #if ( configUSE_HW_STACK_TRACK == 1 )
         {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+            uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpaceHw( pxTCB );
         }
         #else
         {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+            #if portSTACK_GROWTH < 0
+            {
+                pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+            }
+            #else
+            {
+                pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+            }
+            #endif
+
+            uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
         }
         #endif
 
-        uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
-
         traceRETURN_uxTaskGetStackHighWaterMark( uxReturn );
 
         return uxReturn;
@@ -6666,7 +7002,7 @@ static void prvResetNextTaskUnblockTime( void )
 
                 /* If the task being modified is in the ready state it will need
                  * to be moved into a new list. */
-                if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxMutexHolderTCB->uxPriority ] ), &( pxMutexHolderTCB->xStateListItem ) ) != pdFALSE )
+                if( listIS_CONTAINED_WITHIN( taskTCB_READY_LIST( pxMutexHolderTCB, pxMutexHolderTCB->uxPriority ), &( pxMutexHolderTCB->xStateListItem ) ) != pdFALSE )
                 {
                     if( uxListRemove( &( pxMutexHolderTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
                     {
@@ -6899,7 +7235,7 @@ static void prvResetNextTaskUnblockTime( void )
                      * from its current state list if it is in the Ready state as
                      * the task's priority is going to change and there is one
                      * Ready list per priority. */
-                    if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+                    if( listIS_CONTAINED_WITHIN( taskTCB_READY_LIST( pxTCB, uxPriorityUsedOnEntry ), &( pxTCB->xStateListItem ) ) != pdFALSE )
                     {
                         if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
                         {
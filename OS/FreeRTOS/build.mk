@@ -12,3 +12,8 @@ INCDIRS += $(NUCLEI_SDK_RTOS)/Source/include \
 ifneq ($(SMP),)
 COMMON_FLAGS += -DconfigNUMBER_OF_CORES=$(SMP)
 endif
+
+# Track task stack high water mark by stack check unit when STACKTRACK=1
+ifeq ($(STACKTRACK),1)
+COMMON_FLAGS += -DconfigUSE_HW_STACK_TRACK=1
+endif
@@ -9,3 +9,13 @@ INCDIRS += $(NUCLEI_SDK_RTOS)/include
 ifeq ($(RTTHREAD_MSH), 1)
 	INCDIRS += $(NUCLEI_SDK_RTOS)/components/finsh
 endif
+
+# Enable SMP RT-Thread support when SMP is greater than 1
+ifeq ($(call gt,$(SMP),1),$(true))
+COMMON_FLAGS += -DRT_USING_SMP -DRT_CPUS_NR=$(SMP)
+endif
+
+# Track thread stack high water mark by stack check unit when STACKTRACK=1
+ifeq ($(STACKTRACK),1)
+COMMON_FLAGS += -DRT_USING_HW_STACK_TRACK
+endif
@@ -225,9 +225,13 @@ long list_thread(void)
                             ((rt_ubase_t)ptr - (rt_ubase_t)thread->stack_addr) * 100 / thread->stack_size,
                             thread->remaining_tick,
                             thread->error);
+#else
+#ifdef RT_USING_HW_STACK_TRACK
+                    ptr = (rt_uint8_t *)rt_hw_stack_lowest(thread);
 #else
                     ptr = (rt_uint8_t *)thread->stack_addr;
                     while (*ptr == '#')ptr ++;
+#endif
 
                     rt_kprintf(" 0x%08x 0x%08x    %02d%%   0x%08x %03d\n",
                             thread->stack_size + ((rt_ubase_t)thread->stack_addr - (rt_ubase_t)thread->sp),
@@ -591,6 +595,63 @@ FINSH_FUNCTION_EXPORT(list_msgqueue, list message queue in system);
 MSH_CMD_EXPORT(list_msgqueue, list message queue in system);
 #endif
 
+#ifdef RT_USING_SPSC
+long list_spsc(void)
+{
+    rt_ubase_t level;
+    list_get_next_t find_arg;
+    rt_list_t *obj_list[LIST_FIND_OBJ_NR];
+    rt_list_t *next = (rt_list_t*)RT_NULL;
+
+    int maxlen;
+    const char *item_title = "spsc";
+
+    list_find_init(&find_arg, RT_Object_Class_SPSC, obj_list, sizeof(obj_list)/sizeof(obj_list[0]));
+
+    maxlen = RT_NAME_MAX;
+
+    rt_kprintf("%-*.s entry size  dropped    reader\n", maxlen, item_title); object_split(maxlen);
+    rt_kprintf(     " ----- ----- ---------- --------\n");
+    do
+    {
+        next = list_get_next(next, &find_arg);
+        {
+            int i;
+            for (i = 0; i < find_arg.nr_out; i++)
+            {
+                struct rt_object *obj;
+                struct rt_spsc *c;
+
+                obj = rt_list_entry(obj_list[i], struct rt_object, list);
+                level = rt_hw_interrupt_disable();
+                if ((obj->type & ~RT_Object_Class_Static) != find_arg.type)
+                {
+                    rt_hw_interrupt_enable(level);
+                    continue;
+                }
+
+                rt_hw_interrupt_enable(level);
+
+                c = (struct rt_spsc *)obj;
+                rt_kprintf("%-*.*s %05d %05d %010d %-*.*s\n",
+                        maxlen, RT_NAME_MAX,
+                        c->parent.name,
+                        rt_spsc_count(c),
+                        c->max_msgs,
+                        c->dropped,
+                        RT_NAME_MAX, RT_NAME_MAX,
+                        (c->waiting && c->reader) ? c->reader->name : "");
+            }
+        }
+    }
+    while (next != (rt_list_t*)RT_NULL);
+
+    return 0;
+}
+FINSH_FUNCTION_EXPORT(list_spsc, list spsc channel in system);
+MSH_CMD_EXPORT(list_spsc, list spsc channel in system);
+#endif
+
 #ifdef RT_USING_MEMHEAP
 long list_memheap(void)
 {
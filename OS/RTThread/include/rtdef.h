@@ -359,6 +359,7 @@ typedef struct rt_object *rt_object_t;                  /**< Type for kernel obj
  *  - MemPool
  *  - Device
  *  - Timer
+ *  - SPSC Channel
  *  - Unknown
  *  - Static
  */
@@ -375,6 +376,7 @@ enum rt_object_class_type
     RT_Object_Class_MemPool       = 0x08,      /**< The object is a memory pool. */
     RT_Object_Class_Device        = 0x09,      /**< The object is a device. */
     RT_Object_Class_Timer         = 0x0a,      /**< The object is a timer. */
+    RT_Object_Class_SPSC          = 0x0b,      /**< The object is a single-producer/single-consumer channel. */
     RT_Object_Class_Unknown       = 0x0c,      /**< The object is unknown. */
     RT_Object_Class_Static        = 0x80       /**< The object is a static object. */
 };
@@ -471,7 +473,15 @@ typedef struct rt_timer *rt_timer_t;
 #define RT_THREAD_RUNNING               0x03                /**< Running status */
 #define RT_THREAD_BLOCK                 RT_THREAD_SUSPEND   /**< Blocked status */
 #define RT_THREAD_CLOSE                 0x04                /**< Closed status */
+#ifdef RT_USING_SMP
+/* SMP scheduler keeps the yield flag in bit 3, so the state only uses the low 3 bits */
+#define RT_THREAD_STAT_MASK             0x07
+
+#define RT_THREAD_STAT_YIELD            0x08                /**< indicate whether remaining_tick has been reloaded since last schedule */
+#define RT_THREAD_STAT_YIELD_MASK       RT_THREAD_STAT_YIELD
+#else
 #define RT_THREAD_STAT_MASK             0x0f
+#endif /* RT_USING_SMP */
 
 /**
  * thread control command definitions
@@ -480,6 +490,45 @@ typedef struct rt_timer *rt_timer_t;
 #define RT_THREAD_CTRL_CLOSE            0x01                /**< Close thread. */
 #define RT_THREAD_CTRL_CHANGE_PRIORITY  0x02                /**< Change thread priority. */
 #define RT_THREAD_CTRL_INFO             0x03                /**< Get thread information. */
+#define RT_THREAD_CTRL_BIND_CPU         0x04                /**< Set thread bind cpu. */
+
+#ifdef RT_USING_SMP
+
+#ifndef RT_CPUS_NR
+#define RT_CPUS_NR                      1
+#endif
+
+#define RT_CPU_DETACHED                 RT_CPUS_NR          /**< The thread not running on cpu. */
+#define RT_CPU_MASK                     ((1 << RT_CPUS_NR) - 1) /**< All CPUs mask bit. */
+
+#ifndef RT_SCHEDULE_IPI
+#define RT_SCHEDULE_IPI                 0
+#endif
+
+/**
+ * CPUs definitions
+ *
+ */
+struct rt_cpu
+{
+    struct rt_thread *current_thread;
+
+    rt_uint16_t irq_nest;
+    rt_uint8_t  irq_switch_flag;
+
+    rt_uint8_t current_priority;
+    rt_list_t priority_table[RT_THREAD_PRIORITY_MAX];
+#if RT_THREAD_PRIORITY_MAX > 32
+    rt_uint32_t priority_group;
+    rt_uint8_t ready_table[32];
+#else
+    rt_uint32_t priority_group;
+#endif
+
+    rt_tick_t tick;
+};
+
+#endif
 
 /**
  * Thread structure
@@ -500,12 +549,24 @@ struct rt_thread
     void       *parameter;                              /**< parameter */
     void       *stack_addr;                             /**< stack address */
     rt_uint32_t stack_size;                             /**< stack size */
+#ifdef RT_USING_HW_STACK_TRACK
+    void       *hw_stack_lowest;                        /**< lowest stack address used, tracked by hardware */
+#endif
 
     /* error code */
     rt_err_t    error;                                  /**< error code */
 
     rt_uint8_t  stat;                                   /**< thread status */
 
+#ifdef RT_USING_SMP
+    rt_uint8_t  bind_cpu;                               /**< thread is bind to cpu */
+    rt_uint8_t  oncpu;                                  /**< process on cpu */
+
+    rt_uint16_t scheduler_lock_nest;                    /**< scheduler lock count */
+    rt_uint16_t cpus_lock_nest;                         /**< cpus lock count */
+    rt_uint16_t critical_lock_nest;                     /**< critical lock count */
+#endif /*RT_USING_SMP*/
+
     /* priority */
     rt_uint8_t  current_priority;                       /**< current priority */
     rt_uint8_t  init_priority;                          /**< initialized priority */
@@ -659,6 +720,33 @@ struct rt_messagequeue
 typedef struct rt_messagequeue *rt_mq_t;
 #endif
 
+#ifdef RT_USING_SPSC
+/**
+ * single-producer/single-consumer channel structure
+ *
+ * The producer (usually an ISR) and the consumer (a thread) never share a
+ * lock, the ring indexes are free running counters published with fences.
+ */
+struct rt_spsc
+{
+    struct rt_object     parent;                        /**< inherit from rt_object */
+
+    void                *msg_pool;                      /**< start address of message buffer */
+
+    rt_uint16_t          msg_size;                      /**< message size of each message */
+    rt_uint16_t          max_msgs;                      /**< max number of messages, power of 2 */
+
+    volatile rt_uint32_t in_offset;                     /**< free running write index, owned by producer */
+    volatile rt_uint32_t out_offset;                    /**< free running read index, owned by consumer */
+
+    volatile rt_uint32_t waiting;                       /**< consumer is suspended on this channel */
+    struct rt_thread    *reader;                        /**< consumer thread */
+
+    rt_uint32_t          dropped;                       /**< messages dropped because channel is full */
+};
+typedef struct rt_spsc *rt_spsc_t;
+#endif
+
 /**@}*/
 
 /**
@@ -181,6 +181,22 @@ rt_uint16_t rt_critical_level(void);
 void rt_scheduler_sethook(void (*hook)(rt_thread_t from, rt_thread_t to));
 #endif
 
+#ifdef RT_USING_SMP
+void rt_scheduler_do_irq_switch(void *context);
+#endif /*RT_USING_SMP*/
+
+/*
+ * cpu object
+ */
+#ifdef RT_USING_SMP
+struct rt_cpu *rt_cpu_self(void);
+struct rt_cpu *rt_cpu_index(int index);
+
+rt_base_t rt_cpus_lock(void);
+void rt_cpus_unlock(rt_base_t level);
+void rt_cpus_lock_status_restore(struct rt_thread *thread);
+#endif /*RT_USING_SMP*/
+
 /**@}*/
 
 /**
@@ -369,6 +385,29 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
 rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg);
 #endif
 
+#ifdef RT_USING_SPSC
+/*
+ * single-producer/single-consumer channel interface
+ */
+rt_err_t rt_spsc_init(rt_spsc_t   spsc,
+                      const char *name,
+                      void       *msgpool,
+                      rt_size_t   msg_size,
+                      rt_size_t   pool_size);
+rt_err_t rt_spsc_detach(rt_spsc_t spsc);
+rt_spsc_t rt_spsc_create(const char *name,
+                         rt_size_t   msg_size,
+                         rt_size_t   max_msgs);
+rt_err_t rt_spsc_delete(rt_spsc_t spsc);
+
+rt_err_t rt_spsc_send(rt_spsc_t spsc, const void *buffer, rt_size_t size);
+rt_err_t rt_spsc_recv(rt_spsc_t  spsc,
+                      void      *buffer,
+                      rt_size_t  size,
+                      rt_int32_t timeout);
+rt_size_t rt_spsc_count(rt_spsc_t spsc);
+#endif
+
 /**@}*/
 
 #ifdef RT_USING_DEVICE
@@ -497,6 +536,7 @@ char *rt_strncpy(char *dest, const char *src, rt_ubase_t n);
 void *rt_memmove(void *dest, const void *src, rt_ubase_t n);
 rt_int32_t rt_memcmp(const void *cs, const void *ct, rt_ubase_t count);
 rt_int32_t rt_strcasecmp(const char *a, const char *b);
+rt_uint32_t rt_crc32(rt_uint32_t crc, const void *buf, rt_size_t len);
 
 void rt_show_version(void);
 
@@ -7,6 +7,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2020/03/26     Huaqi        Nuclei RISC-V Core porting code.
+ * 2026/10/19     Nuclei       Add SMP support
  */
 
 #include <rthw.h>
@@ -33,6 +34,14 @@
 #define configMAX_SYSCALL_INTERRUPT_PRIORITY    255
 #endif
 
+#if defined(RT_USING_SMP) && (defined(SMODE_RTOS) || defined(__ICCRISCV__))
+#error "RT-Thread SMP is only supported when RT-Thread run in machine mode with gcc toolchain"
+#endif
+
+#if defined(RT_USING_HW_STACK_TRACK) && (defined(SMODE_RTOS) || defined(__ICCRISCV__) || !defined(CFG_HAS_STACK_CHECK))
+#error "RT_USING_HW_STACK_TRACK requires stack check unit, RT-Thread run in machine mode with gcc toolchain"
+#endif
+
 #ifdef SMODE_RTOS
 #define SysTick_Handler     eclic_stip_handler
 extern void eclic_ssip_handler(void);
@@ -54,16 +63,34 @@ extern void eclic_ssip_handler(void);
 #define SMODE_TICK_RELOAD()     SysTick_HartReload(SYSTICK_TICK_CONST, EXECUTE_HARTID)
 #endif
 
+#elif defined(WITH_COMPONENT_HRTIMER)
+/* SysTimer interrupt is owned by hrtimer component, and the tick is one of its periodic timers */
+#include "hrtimer_api.h"
+#define portINITIAL_XSTATUS ( MSTATUS_MPP | MSTATUS_MPIE | MSTATUS_FS_INITIAL | MSTATUS_VS_INITIAL)
 #else
 #define SysTick_Handler     eclic_mtip_handler
 #define portINITIAL_XSTATUS ( MSTATUS_MPP | MSTATUS_MPIE | MSTATUS_FS_INITIAL | MSTATUS_VS_INITIAL)
 #endif
 
+#ifndef RT_USING_SMP
 volatile rt_ubase_t  rt_interrupt_from_thread = 0;
 volatile rt_ubase_t  rt_interrupt_to_thread   = 0;
 volatile rt_ubase_t rt_thread_switch_interrupt_flag = 0;
+#endif
 void SysTick_Handler(void);
 
+#ifdef RT_USING_HW_STACK_TRACK
+static void rt_hw_stack_track_record(struct rt_thread *thread);
+/*
+ * CSR_MSTACK_BOUND follows the lowest sp, including the sp of interrupts
+ * running on the interrupt stack, so the hart stacks which are used as
+ * interrupt stacks must be above every thread stack, otherwise the bound
+ * of a thread is lowered into the interrupt stack, see rt_hw_stack_init.
+ * __StackBottom is defined in linker script such as gcc_evalsoc_ilm.ld
+ */
+extern char __StackBottom[];
+#endif
+
 /* Stack frame size 32 REGBYTES(4/8) for most cases, but for ilp32e mode, it's 14 REGBYTES(4) */
 struct rt_hw_stack_frame {
     rt_ubase_t epc;        /* epc - epc    - program counter                     */
@@ -128,6 +155,13 @@ rt_uint8_t* rt_hw_stack_init(void*       tentry,
     stk  = (rt_uint8_t*)RT_ALIGN_DOWN((rt_ubase_t)stk, 16);
 #else
     stk  = (rt_uint8_t*)RT_ALIGN_DOWN((rt_ubase_t)stk, 4);
+#endif
+#ifdef RT_USING_HW_STACK_TRACK
+    // thread stack above interrupt stack can't be tracked, stop here
+    if (stk > (rt_uint8_t *)__StackBottom) {
+        rt_kprintf("thread stack 0x%p is above interrupt stack 0x%p\n", stk, __StackBottom);
+        rt_hw_cpu_shutdown();
+    }
 #endif
     stk -= sizeof(struct rt_hw_stack_frame);
 
@@ -146,6 +180,7 @@ rt_uint8_t* rt_hw_stack_init(void*       tentry,
     return stk;
 }
 
+#ifndef RT_USING_SMP
 /*
  * void rt_hw_context_switch_interrupt(rt_ubase_t from, rt_ubase_t to);
  */
@@ -172,6 +207,7 @@ void rt_hw_context_switch(rt_ubase_t from, rt_ubase_t to)
 {
     rt_hw_context_switch_interrupt(from, to);
 }
+#endif
 
 /** shutdown CPU */
 void rt_hw_cpu_shutdown()
@@ -185,6 +221,26 @@ void rt_hw_cpu_shutdown()
     }
 }
 
+#ifdef RT_USING_SMP
+/*
+ * Schedule IPI handler, called by eclic_xsip_handler with the context saved
+ * on current thread stack, it will not return if a thread switch happens.
+ * Every switch in SMP happens here, rt_schedule just sends this IPI to its
+ * own cpu, so the kernel lock is always handed over in the same way.
+ */
+void xPortTaskSwitch(void *context)
+{
+    /* Clear Software IRQ of this hart, A MUST */
+    SysTimer_ClearSWIRQ();
+    __RWMB();
+
+#ifdef RT_USING_HW_STACK_TRACK
+    /* context is saved on current thread stack, which may be switched out now */
+    rt_hw_stack_track_record(rt_thread_self());
+#endif
+    rt_scheduler_do_irq_switch(context);
+}
+#else
 void xPortTaskSwitch(void)
 {
     /* Clear Software IRQ, A MUST */
@@ -194,12 +250,19 @@ void xPortTaskSwitch(void)
     SysTimer_ClearSWIRQ();
 #endif
     rt_thread_switch_interrupt_flag = 0;
+#ifdef RT_USING_HW_STACK_TRACK
+    // context of from thread is saved on its stack now
+    if (rt_interrupt_from_thread) {
+        rt_hw_stack_track_record(rt_container_of((void *)rt_interrupt_from_thread, struct rt_thread, sp));
+    }
+#endif
     // make from thread to be to thread
     // If there is another swi interrupt triggered by other harts
     // not through rt_hw_context_switch or rt_hw_context_switch_interrupt
     // the task switch should just do a same task save and restore
     rt_interrupt_from_thread = rt_interrupt_to_thread;
 }
+#endif
 
 void vPortSetupTimerInterrupt(void)
 {
@@ -225,7 +288,11 @@ void vPortSetupTimerInterrupt(void)
 #else
     /* Make SWI and SysTick the lowest priority interrupts. */
     /* Stop and clear the SysTimer. SysTimer as Non-Vector Interrupt */
+#ifdef WITH_COMPONENT_HRTIMER
+    hrtimer_tick_config(SYSTICK_TICK_CONST, SysTick_Handler);
+#else
     SysTick_Config(SYSTICK_TICK_CONST);
+#endif
     ECLIC_DisableIRQ(SysTimer_IRQn);
     ECLIC_SetLevelIRQ(SysTimer_IRQn, configKERNEL_INTERRUPT_PRIORITY);
     ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
@@ -267,6 +334,74 @@ extern char _sp[];
 extern char CSTACK$$Limit[];
 #define __RTT_INT_STACK  (CSTACK$$Limit)
 #endif
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+// __STACK_SIZE is defined in linker script, each hart has its own stack below _sp
+extern char __STACK_SIZE[];
+#define __RTT_HART_INT_STACK    ((unsigned long)__RTT_INT_STACK - \
+                                 (__RV_CSR_READ(CSR_MHARTID) & 0xFF) * (unsigned long)__STACK_SIZE)
+#else
+#define __RTT_HART_INT_STACK    ((unsigned long)__RTT_INT_STACK)
+#endif
+
+// Enable interrupt and task sp swap, it must be done on each hart
+static void rt_hw_interrupt_stack_init(void)
+{
+#if defined(ECLIC_HW_CTX_AUTO) && defined(CFG_HAS_ECLICV2)
+    // NOTE: setup interrupt stack pointer for CSR_MTSP or CSR_STSP depends on which mode RTT run on
+    __RV_CSR_WRITE(CSR_XTSP, __RTT_HART_INT_STACK);
+    // NOTE: enable trap sp auto swap
+    __RV_CSR_SET(CSR_XECLIC_CTL, XECLIC_CTL_TSP_EN);
+#endif
+}
+
+#ifdef RT_USING_HW_STACK_TRACK
+// Enable stack check unit in track mode, it must be done on each hart
+static void rt_hw_stack_track_init(void)
+{
+    __RV_CSR_CLEAR(CSR_MSTACK_CTRL, MSTACK_CTRL_OVF_TRACK_EN);
+    __RV_CSR_SET(CSR_MSTACK_CTRL, MSTACK_CTRL_MODE);
+    __RV_CSR_SET(CSR_MSTACK_CTRL, MSTACK_CTRL_OVF_TRACK_EN);
+}
+
+/* Save lowest sp reached by thread, it must be the thread running on this hart */
+static void rt_hw_stack_track_record(struct rt_thread *thread)
+{
+    rt_uint8_t *bound = (rt_uint8_t *)__RV_CSR_READ(CSR_MSTACK_BOUND);
+
+    // bound below stack start means the stack overflowed
+    if (bound < (rt_uint8_t *)thread->stack_addr) {
+        bound = (rt_uint8_t *)thread->stack_addr;
+    }
+    if (bound < (rt_uint8_t *)thread->hw_stack_lowest) {
+        thread->hw_stack_lowest = bound;
+    }
+}
+
+/*
+ * Load stack bound of current thread, called by context_gcc.S
+ * after sp is switched to the stack of current thread
+ */
+void rt_hw_stack_track_load(void)
+{
+    __RV_CSR_WRITE(CSR_MSTACK_BOUND, (rv_csr_t)rt_thread_self()->hw_stack_lowest);
+}
+
+/*
+ * Get lowest stack address used by thread, for a thread running on
+ * other hart, it is the value saved when it was last switched out
+ */
+void *rt_hw_stack_lowest(struct rt_thread *thread)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+
+    if (thread == rt_thread_self()) {
+        rt_hw_stack_track_record(thread);
+    }
+    rt_hw_interrupt_enable(level);
+    return thread->hw_stack_lowest;
+}
+#endif
+
 /**
  * This function will initial your board.
  */
@@ -287,11 +422,9 @@ void rt_hw_board_init()
     rt_hw_interrupt_disable();
 
     // Enable interrupt and task sp swap
-#if defined(ECLIC_HW_CTX_AUTO) && defined(CFG_HAS_ECLICV2)
-    // NOTE: setup interrupt stack pointer for CSR_MTSP or CSR_STSP depends on which mode RTT run on
-    __RV_CSR_WRITE(CSR_XTSP, (unsigned long)__RTT_INT_STACK);
-    // NOTE: enable trap sp auto swap
-    __RV_CSR_SET(CSR_XECLIC_CTL, XECLIC_CTL_TSP_EN);
+    rt_hw_interrupt_stack_init();
+#ifdef RT_USING_HW_STACK_TRACK
+    rt_hw_stack_track_init();
 #endif
 }
 
@@ -301,7 +434,7 @@ void SysTick_Handler(void)
     // Reload timer
 #ifdef SMODE_RTOS
     SMODE_TICK_RELOAD();
-#else
+#elif !defined(WITH_COMPONENT_HRTIMER)
     SysTick_Reload(SYSTICK_TICK_CONST);
 #endif
 
@@ -333,15 +466,173 @@ char rt_hw_console_getchar(void)
     return ch;
 }
 
+#ifdef RT_USING_SMP
+// RT-Thread takes cpu 0 as the boot cpu, which initializes the kernel and runs the
+// system tick, so cpu id is the hart index counted from the boot hart, the same
+// mapping is used for cpu id, ipi target and boot hart selection
+#define RT_HW_BOOT_HART_INDEX       (EXECUTE_HARTID - __HARTID_OFFSET)
+#define RT_HW_HART_TO_CPU(hart)     (((hart) + RT_CPUS_NR - RT_HW_BOOT_HART_INDEX) % RT_CPUS_NR)
+#define RT_HW_CPU_TO_HART(cpu)      (((cpu) + RT_HW_BOOT_HART_INDEX) % RT_CPUS_NR)
+
+// in SMP, rt_hw_interrupt_disable/enable are the kernel big lock, they are
+// built on top of the local ones below, so the irq-off window is per hart
+#define RT_HW_IRQ_CPUS              RT_CPUS_NR
+#define RT_HW_IRQ_CPU_ID()          RT_HW_HART_TO_CPU(__get_hart_index())
+#undef rt_hw_interrupt_disable
+#undef rt_hw_interrupt_enable
+#define rt_hw_interrupt_disable     rt_hw_local_irq_disable
+#define rt_hw_interrupt_enable      rt_hw_local_irq_enable
+#else
+#define RT_HW_IRQ_CPUS              1
+#define RT_HW_IRQ_CPU_ID()          0
+#endif
+
+#ifdef RT_USING_IRQOFF_STAT
+static rt_ubase_t rt_hw_irqoff_start[RT_HW_IRQ_CPUS];
+static rt_ubase_t rt_hw_irqoff_max[RT_HW_IRQ_CPUS];
+
+rt_ubase_t rt_hw_irqoff_max_get(void)
+{
+    rt_ubase_t max = 0;
+
+    for (int i = 0; i < RT_HW_IRQ_CPUS; i ++) {
+        if (rt_hw_irqoff_max[i] > max) {
+            max = rt_hw_irqoff_max[i];
+        }
+    }
+    return max;
+}
+
+void rt_hw_irqoff_max_reset(void)
+{
+    for (int i = 0; i < RT_HW_IRQ_CPUS; i ++) {
+        rt_hw_irqoff_max[i] = 0;
+    }
+}
+#endif
+
 rt_base_t rt_hw_interrupt_disable(void)
 {
     rt_base_t level = __RV_CSR_READ_CLEAR(CSR_XSTATUS, XSTATUS_XIE);
     __RWMB();
+#ifdef RT_USING_IRQOFF_STAT
+    // only the outermost disable opens a new irq-off window
+    if (level & XSTATUS_XIE) {
+        rt_hw_irqoff_start[RT_HW_IRQ_CPU_ID()] = __read_cycle_csr();
+    }
+#endif
     return level;
 }
 
 void rt_hw_interrupt_enable(rt_base_t level)
 {
+#ifdef RT_USING_IRQOFF_STAT
+    if (level & XSTATUS_XIE) {
+        unsigned long cpu = RT_HW_IRQ_CPU_ID();
+        rt_ubase_t cost = __read_cycle_csr() - rt_hw_irqoff_start[cpu];
+        if (cost > rt_hw_irqoff_max[cpu]) {
+            rt_hw_irqoff_max[cpu] = cost;
+        }
+    }
+#endif
     __RV_CSR_WRITE(CSR_XSTATUS, level);
     __RWMB();
 }
+
+#ifdef RT_USING_SMP
+#undef rt_hw_interrupt_disable
+#undef rt_hw_interrupt_enable
+#define rt_hw_interrupt_disable     rt_cpus_lock
+#define rt_hw_interrupt_enable      rt_cpus_unlock
+
+int rt_hw_cpu_id(void)
+{
+    return (int)RT_HW_HART_TO_CPU(__get_hart_index());
+}
+
+void rt_hw_spin_lock_init(rt_hw_spinlock_t *lock)
+{
+    lock->lock = 0;
+}
+
+void rt_hw_spin_lock(rt_hw_spinlock_t *lock)
+{
+    // test and test-and-set, spin on plain loads to keep the line shared
+    while (__AMOSWAP_W((volatile uint32_t *)&lock->lock, 1) != 0) {
+        while (lock->lock != 0);
+    }
+    // acquire: critical section accesses stay after the lock is taken
+    __SMP_RWMB();
+}
+
+void rt_hw_spin_unlock(rt_hw_spinlock_t *lock)
+{
+    // release: critical section accesses complete before the lock is freed
+    __SMP_RWMB();
+    lock->lock = 0;
+}
+
+void rt_hw_ipi_send(int ipi_vector, unsigned int cpu_mask)
+{
+    // only schedule ipi is used, it is the software interrupt of the target hart
+    (void)ipi_vector;
+    // interrupt pending request must be issued after the scheduler data updates
+    __RWMB();
+    for (int cpu = 0; cpu < RT_CPUS_NR; cpu ++) {
+        if (cpu_mask & (1U << cpu)) {
+            SysTimer_SetHartSWIRQ(RT_HW_CPU_TO_HART(cpu));
+        }
+    }
+}
+
+static volatile uint32_t rt_hw_secondary_cpu_started = 0;
+
+void rt_hw_secondary_cpu_up(void)
+{
+    __SMP_RWMB();
+    rt_hw_secondary_cpu_started = 1;
+    __SMP_RWMB();
+}
+
+void rt_hw_secondary_cpu_idle_exec(void)
+{
+    // woken up by tick or schedule ipi
+    __WFI();
+}
+
+/*
+ * Secondary hart entry, wait until the kernel is initialized by boot hart
+ * and main thread starts, then join the scheduler.
+ */
+static void rt_hw_secondary_cpu_start(void)
+{
+    while (rt_hw_secondary_cpu_started == 0);
+    __SMP_RWMB();
+
+    rt_hw_local_irq_disable();
+
+    /* OS Tick and SWI of this hart */
+    vPortSetupTimerInterrupt();
+    rt_hw_interrupt_stack_init();
+#ifdef RT_USING_HW_STACK_TRACK
+    rt_hw_stack_track_init();
+#endif
+
+    rt_hw_spin_lock(&_cpus_lock);
+    rt_system_scheduler_start();
+}
+
+extern int entry(void);
+/*
+ * smp_main is called by all harts from startup code,
+ * boot hart initializes RT-Thread, and others wait to join the scheduler
+ */
+void smp_main(void)
+{
+    if (rt_hw_cpu_id() == 0) {
+        entry();
+    } else {
+        rt_hw_secondary_cpu_start();
+    }
+}
+#endif
@@ -19,6 +19,12 @@
 extern "C" {
 #endif
 
+#ifdef RT_USING_SMP
+/* spinlock taken with amoswap.w, 0 means unlocked */
+typedef struct {
+    volatile uint32_t lock;
+} rt_hw_spinlock_t;
+#endif
 
 #ifdef __cplusplus
 }
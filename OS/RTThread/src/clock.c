@@ -13,6 +13,7 @@
  * 2010-07-13     Bernard      fix rt_tick_from_millisecond issue found by kuronca
  * 2011-06-26     Bernard      add rt_tick_set function.
  * 2018-11-22     Jesven       add per cpu tick
+ * 2026-10-19     Nuclei       only cpu 0 drives global tick and timer in smp
  */
 
 #include <rthw.h>
@@ -68,8 +69,21 @@ void rt_tick_increase(void)
 {
     struct rt_thread *thread;
 
+#ifdef RT_USING_SMP
+    struct rt_cpu *pcpu = rt_cpu_self();
+
+    /* increase the tick of this cpu */
+    ++ pcpu->tick;
+
+    /* the global tick and timers are only driven by cpu 0 */
+    if (pcpu == rt_cpu_index(0))
+    {
+        ++ rt_tick;
+    }
+#else
     /* increase the global tick */
     ++ rt_tick;
+#endif /*RT_USING_SMP*/
 
     /* check time slice */
     thread = rt_thread_self();
@@ -85,6 +99,9 @@ void rt_tick_increase(void)
     }
 
     /* check timer */
+#ifdef RT_USING_SMP
+    if (pcpu == rt_cpu_index(0))
+#endif /*RT_USING_SMP*/
     rt_timer_check();
 }
 
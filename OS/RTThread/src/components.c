@@ -179,6 +179,11 @@ void main_thread_entry(void *parameter)
     /* RT-Thread components initialization */
     rt_components_init();
 #endif
+
+#ifdef RT_USING_SMP
+    /* secondary cpus join the scheduler now */
+    rt_hw_secondary_cpu_up();
+#endif /*RT_USING_SMP*/
     /* invoke system main function */
 #if defined(__CC_ARM) || defined(__CLANG_ARM)
     $Super$$main(); /* for ARMCC. */
@@ -237,6 +242,10 @@ int rtthread_startup(void)
     /* idle thread initialization */
     rt_thread_idle_init();
 
+#ifdef RT_USING_SMP
+    rt_hw_spin_lock(&_cpus_lock);
+#endif /*RT_USING_SMP*/
+
     /* start scheduler */
     rt_system_scheduler_start();
 
@@ -15,6 +15,7 @@
  * 2018-07-14     armink       add idle hook list
  * 2018-11-22     Jesven       add per cpu idle task
  *                             combine the code of primary and secondary cpu
+ * 2026-10-19     Nuclei       enable per cpu idle task for Nuclei smp port
  */
 
 #include <rthw.h>
@@ -34,11 +35,17 @@
 #endif
 #endif
 
+#ifdef RT_USING_SMP
+#define _CPUS_NR                RT_CPUS_NR
+#else
+#define _CPUS_NR                1
+#endif /*RT_USING_SMP*/
+
 extern rt_list_t rt_thread_defunct;
 
-static struct rt_thread idle;
+static struct rt_thread idle[_CPUS_NR];
 ALIGN(RT_ALIGN_SIZE)
-static rt_uint8_t rt_thread_stack[IDLE_THREAD_STACK_SIZE];
+static rt_uint8_t rt_thread_stack[_CPUS_NR][IDLE_THREAD_STACK_SIZE];
 
 #ifdef RT_USING_IDLE_HOOK
 #ifndef RT_IDLE_HOOK_LIST_SIZE
@@ -164,6 +171,14 @@ void rt_thread_idle_excute(void)
         thread = rt_list_entry(rt_thread_defunct.next,
                 struct rt_thread,
                 tlist);
+#ifdef RT_USING_SMP
+        /* the exited thread may not be switched out of its cpu yet */
+        if (thread->oncpu != RT_CPU_DETACHED)
+        {
+            rt_hw_interrupt_enable(lock);
+            break;
+        }
+#endif /*RT_USING_SMP*/
         /* remove defunct thread */
         rt_list_remove(&(thread->tlist));
         /* release thread's stack */
@@ -178,6 +193,17 @@ void rt_thread_idle_excute(void)
 extern void rt_system_power_manager(void);
 static void rt_thread_idle_entry(void *parameter)
 {
+#ifdef RT_USING_SMP
+    /* only the idle thread of cpu 0 does the system background job */
+    if (rt_hw_cpu_id() != 0)
+    {
+        while (1)
+        {
+            rt_hw_secondary_cpu_idle_exec();
+        }
+    }
+#endif /*RT_USING_SMP*/
+
     while (1)
     {
 
@@ -209,18 +235,34 @@ static void rt_thread_idle_entry(void *parameter)
  */
 void rt_thread_idle_init(void)
 {
-    /* initialize thread */
-    rt_thread_init(&idle,
-                   "tidle",
-                   rt_thread_idle_entry,
-                   RT_NULL,
-                   &rt_thread_stack[0],
-                   sizeof(rt_thread_stack),
-                   RT_THREAD_PRIORITY_MAX - 1,
-                   32);
-
-    /* startup */
-    rt_thread_startup(&idle);
+    rt_ubase_t i;
+    char tidle_name[RT_NAME_MAX];
+
+    for (i = 0; i < _CPUS_NR; i++)
+    {
+#ifdef RT_USING_SMP
+        rt_sprintf(tidle_name, "tidle%d", (int)i);
+#else
+        rt_strncpy(tidle_name, "tidle", RT_NAME_MAX);
+#endif /*RT_USING_SMP*/
+
+        /* initialize thread */
+        rt_thread_init(&idle[i],
+                       tidle_name,
+                       rt_thread_idle_entry,
+                       RT_NULL,
+                       &rt_thread_stack[i][0],
+                       sizeof(rt_thread_stack[i]),
+                       RT_THREAD_PRIORITY_MAX - 1,
+                       32);
+#ifdef RT_USING_SMP
+        /* each cpu always has its own idle thread to run */
+        rt_thread_control(&idle[i], RT_THREAD_CTRL_BIND_CPU, (void*)i);
+#endif /*RT_USING_SMP*/
+
+        /* startup */
+        rt_thread_startup(&idle[i]);
+    }
 }
 
 /**
@@ -231,5 +273,11 @@ void rt_thread_idle_init(void)
  */
 rt_thread_t rt_thread_idle_gethandler(void)
 {
-    return (rt_thread_t)(&idle);
+#ifdef RT_USING_SMP
+    register int id = rt_hw_cpu_id();
+#else
+    register int id = 0;
+#endif /*RT_USING_SMP*/
+
+    return (rt_thread_t)(&idle[id]);
 }
@@ -9,6 +9,7 @@
  * 2006-05-03     Bernard      add IRQ_DEBUG
  * 2016-08-09     ArdaFu       add interrupt enter and leave hook.
  * 2018-11-22     Jesven       rt_interrupt_get_nest function add disable irq
+ * 2026-10-19     Nuclei       per cpu interrupt nest for smp
  */
 
 #include <rthw.h>
@@ -49,7 +50,16 @@ void rt_interrupt_leave_sethook(void (*hook)(void))
 
 /**@{*/
 
+#ifdef RT_USING_SMP
+#define rt_interrupt_nest rt_cpu_self()->irq_nest
+/* interrupt nest is per cpu data, it is enough to disable local interrupt */
+#define _irq_nest_lock()            rt_hw_local_irq_disable()
+#define _irq_nest_unlock(level)     rt_hw_local_irq_enable(level)
+#else
 volatile rt_uint8_t rt_interrupt_nest;
+#define _irq_nest_lock()            rt_hw_interrupt_disable()
+#define _irq_nest_unlock(level)     rt_hw_interrupt_enable(level)
+#endif /*RT_USING_SMP*/
 
 /**
  * This function will be invoked by BSP, when enter interrupt service routine
@@ -65,10 +75,10 @@ void rt_interrupt_enter(void)
     RT_DEBUG_LOG(RT_DEBUG_IRQ, ("irq coming..., irq nest:%d\n",
                                 rt_interrupt_nest));
 
-    level = rt_hw_interrupt_disable();
+    level = _irq_nest_lock();
     rt_interrupt_nest ++;
     RT_OBJECT_HOOK_CALL(rt_interrupt_enter_hook,());
-    rt_hw_interrupt_enable(level);
+    _irq_nest_unlock(level);
 }
 
 /**
@@ -85,10 +95,21 @@ void rt_interrupt_leave(void)
     RT_DEBUG_LOG(RT_DEBUG_IRQ, ("irq leave, irq nest:%d\n",
                                 rt_interrupt_nest));
 
-    level = rt_hw_interrupt_disable();
+    level = _irq_nest_lock();
     rt_interrupt_nest --;
+#ifdef RT_USING_SMP
+    /*
+     * a schedule ipi taken in a nested interrupt has cleared the software
+     * interrupt but left the switch pending, post it again at the outermost
+     * exit, it is taken once this interrupt returns to the thread
+     */
+    if (rt_interrupt_nest == 0 && rt_cpu_self()->irq_switch_flag)
+    {
+        rt_hw_ipi_send(RT_SCHEDULE_IPI, 1U << rt_hw_cpu_id());
+    }
+#endif /*RT_USING_SMP*/
     RT_OBJECT_HOOK_CALL(rt_interrupt_leave_hook,());
-    rt_hw_interrupt_enable(level);
+    _irq_nest_unlock(level);
 }
 
 /**
@@ -104,9 +125,9 @@ RT_WEAK rt_uint8_t rt_interrupt_get_nest(void)
     rt_uint8_t ret;
     rt_base_t level;
 
-    level = rt_hw_interrupt_disable();
+    level = _irq_nest_lock();
     ret = rt_interrupt_nest;
-    rt_hw_interrupt_enable(level);
+    _irq_nest_unlock(level);
     return ret;
 }
 
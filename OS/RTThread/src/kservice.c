@@ -17,6 +17,7 @@
  * 2013-06-24     Bernard      remove rt_kprintf if RT_USING_CONSOLE is not defined.
  * 2013-09-24     aozima       make sure the device is in STREAM mode when used by rt_kprintf.
  * 2015-07-06     Bernard      Add rt_assert_handler routine.
+ * 2026-10-19     Nuclei       word at a time string functions, add rt_crc32.
  */
 
 #include <rtthread.h>
@@ -302,6 +303,43 @@ void *rt_memmove(void *dest, const void *src, rt_ubase_t n)
     return dest;
 }
 
+#define RT_WORD_SIZE            (sizeof(rt_ubase_t))
+#define RT_WORD_UNALIGNED(X)    ((rt_ubase_t)(X) & (RT_WORD_SIZE - 1))
+
+#ifndef RT_USING_TINY_SIZE
+/*
+ * The string and memory compare functions below go word by word when both
+ * pointers have the same alignment, an aligned word never crosses the end of
+ * memory region where the null terminator is, so reading whole words is safe.
+ */
+#define RT_WORD_LOW7            (~(rt_ubase_t)0 / 0xff * 0x7f)
+
+/* each byte of result is 0xff if the same byte of w is not zero, otherwise 0x00 */
+rt_inline rt_ubase_t _rt_word_orc(rt_ubase_t w)
+{
+#ifdef __riscv_zbb
+    rt_ubase_t r;
+
+    __asm__ ("orc.b %0, %1" : "=r"(r) : "r"(w));
+    return r;
+#else
+    rt_ubase_t t = (((w & RT_WORD_LOW7) + RT_WORD_LOW7) | w) & ~RT_WORD_LOW7;
+
+    return (t >> 7) * 0xff;
+#endif
+}
+
+#ifdef __riscv_zbb
+/* difference of the first byte set in mask of words w1 and w2, mask must not be zero */
+rt_inline int _rt_word_diff(rt_ubase_t w1, rt_ubase_t w2, rt_ubase_t mask)
+{
+    int shift = __builtin_ctzl(mask) & ~7;
+
+    return (int)((w1 >> shift) & 0xff) - (int)((w2 >> shift) & 0xff);
+}
+#endif
+#endif /* RT_USING_TINY_SIZE */
+
 /**
  * This function will compare two areas of memory
  *
@@ -313,10 +351,38 @@ void *rt_memmove(void *dest, const void *src, rt_ubase_t n)
  */
 rt_int32_t rt_memcmp(const void *cs, const void *ct, rt_ubase_t count)
 {
-    const unsigned char *su1, *su2;
+    const unsigned char *su1 = (const unsigned char *)cs, *su2 = (const unsigned char *)ct;
     int res = 0;
 
-    for (su1 = (const unsigned char *)cs, su2 = (const unsigned char *)ct; 0 < count; ++su1, ++su2, count--)
+#ifndef RT_USING_TINY_SIZE
+    if (count >= RT_WORD_SIZE && RT_WORD_UNALIGNED(su1) == RT_WORD_UNALIGNED(su2))
+    {
+        const rt_ubase_t *w1, *w2;
+
+        for (; RT_WORD_UNALIGNED(su1); ++su1, ++su2, count--)
+            if ((res = *su1 - *su2) != 0)
+                return res;
+
+        for (w1 = (const rt_ubase_t *)su1, w2 = (const rt_ubase_t *)su2; count >= RT_WORD_SIZE;
+             w1++, w2++, count -= RT_WORD_SIZE)
+        {
+            if (*w1 != *w2)
+            {
+#ifdef __riscv_zbb
+                return _rt_word_diff(*w1, *w2, *w1 ^ *w2);
+#else
+                /* the difference is in this word */
+                count = RT_WORD_SIZE;
+                break;
+#endif
+            }
+        }
+        su1 = (const unsigned char *)w1;
+        su2 = (const unsigned char *)w2;
+    }
+#endif
+
+    for (; 0 < count; ++su1, ++su2, count--)
         if ((res = *su1 - *su2) != 0)
             break;
 
@@ -387,11 +453,32 @@ rt_int32_t rt_strcasecmp(const char *a, const char *b)
  */
 char *rt_strncpy(char *dst, const char *src, rt_ubase_t n)
 {
-    if (n != 0)
+    char *d = dst;
+    const char *s = src;
+
+#ifndef RT_USING_TINY_SIZE
+    if (RT_WORD_UNALIGNED(d) == RT_WORD_UNALIGNED(s))
     {
-        char *d = dst;
-        const char *s = src;
+        rt_ubase_t *wd;
+        const rt_ubase_t *ws;
+
+        for (; n != 0 && RT_WORD_UNALIGNED(s) && *s != '\0'; n--)
+            *d++ = *s++;
 
+        /* copy whole words without null byte, the rest is done below */
+        if (!RT_WORD_UNALIGNED(s))
+        {
+            for (wd = (rt_ubase_t *)d, ws = (const rt_ubase_t *)s;
+                 n >= RT_WORD_SIZE && _rt_word_orc(*ws) == ~(rt_ubase_t)0; n -= RT_WORD_SIZE)
+                *wd++ = *ws++;
+            d = (char *)wd;
+            s = (const char *)ws;
+        }
+    }
+#endif
+
+    if (n != 0)
+    {
         do
         {
             if ((*d++ = *s++) == 0)
@@ -420,6 +507,35 @@ rt_int32_t rt_strncmp(const char *cs, const char *ct, rt_ubase_t count)
 {
     register signed char __res = 0;
 
+#ifndef RT_USING_TINY_SIZE
+    if (count >= RT_WORD_SIZE && RT_WORD_UNALIGNED(cs) == RT_WORD_UNALIGNED(ct))
+    {
+        const rt_ubase_t *w1, *w2;
+        rt_ubase_t stop;
+
+        for (; RT_WORD_UNALIGNED(cs); count--)
+            if ((__res = *cs - *ct++) != 0 || !*cs++)
+                return __res;
+
+        /* stop at the word with a null byte or a difference */
+        for (w1 = (const rt_ubase_t *)cs, w2 = (const rt_ubase_t *)ct; count >= RT_WORD_SIZE;
+             w1++, w2++, count -= RT_WORD_SIZE)
+        {
+            if ((stop = (*w1 ^ *w2) | ~_rt_word_orc(*w1)) != 0)
+            {
+#ifdef __riscv_zbb
+                return (signed char)_rt_word_diff(*w1, *w2, stop);
+#else
+                count = RT_WORD_SIZE;
+                break;
+#endif
+            }
+        }
+        cs = (const char *)w1;
+        ct = (const char *)w2;
+    }
+#endif
+
     while (count)
     {
         if ((__res = *cs - *ct++) != 0 || !*cs++)
@@ -440,6 +556,33 @@ rt_int32_t rt_strncmp(const char *cs, const char *ct, rt_ubase_t count)
  */
 rt_int32_t rt_strcmp(const char *cs, const char *ct)
 {
+#ifndef RT_USING_TINY_SIZE
+    if (RT_WORD_UNALIGNED(cs) == RT_WORD_UNALIGNED(ct))
+    {
+        const rt_ubase_t *w1, *w2;
+        rt_ubase_t stop;
+
+        for (; RT_WORD_UNALIGNED(cs); cs++, ct++)
+            if (*cs == '\0' || *cs != *ct)
+                return (*cs - *ct);
+
+        /* stop at the word with a null byte or a difference */
+        w1 = (const rt_ubase_t *)cs;
+        w2 = (const rt_ubase_t *)ct;
+        while ((stop = (*w1 ^ *w2) | ~_rt_word_orc(*w1)) == 0)
+        {
+            w1++;
+            w2++;
+        }
+#ifdef __riscv_zbb
+        return _rt_word_diff(*w1, *w2, stop);
+#else
+        cs = (const char *)w1;
+        ct = (const char *)w2;
+#endif
+    }
+#endif
+
     while (*cs && *cs == *ct)
     {
         cs++;
@@ -480,14 +623,99 @@ rt_size_t rt_strnlen(const char *s, rt_ubase_t maxlen)
  */
 rt_size_t rt_strlen(const char *s)
 {
-    const char *sc;
+    const char *sc = s;
 
-    for (sc = s; *sc != '\0'; ++sc) /* nothing */
+#ifndef RT_USING_TINY_SIZE
+    const rt_ubase_t *ws;
+    rt_ubase_t zero;
+
+    for (; RT_WORD_UNALIGNED(sc); ++sc)
+        if (*sc == '\0')
+            return sc - s;
+
+    for (ws = (const rt_ubase_t *)sc; (zero = ~_rt_word_orc(*ws)) == 0; ++ws) /* nothing */
+        ;
+
+    sc = (const char *)ws;
+#ifdef __riscv_zbb
+    return sc - s + (__builtin_ctzl(zero) >> 3);
+#endif
+#endif
+
+    for (; *sc != '\0'; ++sc) /* nothing */
         ;
 
     return sc - s;
 }
 
+static const rt_uint32_t _rt_crc32_table[16] =
+{
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+};
+
+rt_inline rt_uint32_t _rt_crc32_byte(rt_uint32_t crc, rt_uint8_t c)
+{
+    crc ^= c;
+    crc = (crc >> 4) ^ _rt_crc32_table[crc & 0xf];
+
+    return (crc >> 4) ^ _rt_crc32_table[crc & 0xf];
+}
+
+#ifdef __riscv_zbc
+/*
+ * Barrett reduction of a whole word with carry-less multiply, the quotient of
+ * 2^(XLEN + 32) / P in bit reflected order with the bit of 2^XLEN implicit, see
+ * https://www.corsix.org/content/barrett-reduction-polynomials
+ */
+#define RT_CRC32_POLY           0xedb88320UL
+#if __riscv_xlen == 64
+#define RT_CRC32_POLY_QT        0x5a72d812fb808b20UL
+#else
+#define RT_CRC32_POLY_QT        0xfb808b20UL
+#endif
+
+rt_inline rt_uint32_t _rt_crc32_word(rt_ubase_t s)
+{
+    rt_ubase_t t;
+
+    __asm__ ("clmul %0, %1, %2" : "=r"(t) : "r"(s), "r"(RT_CRC32_POLY_QT));
+    t = (t << 1) ^ s;
+    __asm__ ("clmulr %0, %1, %2" : "=r"(t) : "r"(t), "r"(RT_CRC32_POLY << (__riscv_xlen - 32)));
+
+    return (rt_uint32_t)(t >> (__riscv_xlen - 32));
+}
+#endif
+
+/**
+ * This function will calculate the CRC-32 (IEEE 802.3, same as zlib crc32) of a buffer,
+ * whole words are processed by carry-less multiply when Zbc extension is present.
+ *
+ * @param crc the CRC-32 of previous data, 0 for the first buffer
+ * @param buf the buffer
+ * @param len the length of buffer
+ *
+ * @return the CRC-32 of previous data and the buffer
+ */
+rt_uint32_t rt_crc32(rt_uint32_t crc, const void *buf, rt_size_t len)
+{
+    const rt_uint8_t *p = (const rt_uint8_t *)buf;
+
+    crc = ~crc;
+#ifdef __riscv_zbc
+    for (; len != 0 && RT_WORD_UNALIGNED(p); len--)
+        crc = _rt_crc32_byte(crc, *p++);
+
+    for (; len >= RT_WORD_SIZE; len -= RT_WORD_SIZE, p += RT_WORD_SIZE)
+        crc = _rt_crc32_word(crc ^ *(const rt_ubase_t *)p);
+#endif
+
+    for (; len != 0; len--)
+        crc = _rt_crc32_byte(crc, *p++);
+
+    return ~crc;
+}
+
 #ifdef RT_USING_HEAP
 /**
  * This function will duplicate a string.
@@ -49,6 +49,9 @@ enum rt_object_info_type
     RT_Object_Info_Device,                             /**< The object is a device */
 #endif
     RT_Object_Info_Timer,                              /**< The object is a timer. */
+#ifdef RT_USING_SPSC
+    RT_Object_Info_SPSC,                               /**< The object is a spsc channel. */
+#endif
     RT_Object_Info_Unknown,                            /**< The object is unknown. */
 };
 
@@ -92,6 +95,10 @@ static struct rt_object_information rt_object_container[RT_Object_Info_Unknown]
 #endif
     /* initialize object container - timer */
     {RT_Object_Class_Timer, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Timer), sizeof(struct rt_timer)},
+#ifdef RT_USING_SPSC
+    /* initialize object container - spsc channel */
+    {RT_Object_Class_SPSC, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_SPSC), sizeof(struct rt_spsc)},
+#endif
 };
 
 #ifdef RT_USING_HOOK
@@ -27,6 +27,8 @@
  *                             rt_schedule_insert_thread won't insert current task to ready queue
  *                             in smp version, rt_hw_context_switch_interrupt maybe switch to
  *                               new task directly
+ * 2026-10-19     Nuclei       implement smp version for Nuclei RISC-V port,
+ *                             only wake up the cpu which will be preempted
  *
  */
 
@@ -42,14 +44,20 @@ rt_uint8_t rt_thread_ready_table[32];
 #endif
 
 
+#ifndef RT_USING_SMP
 extern volatile rt_uint8_t rt_interrupt_nest;
 static rt_int16_t rt_scheduler_lock_nest;
 struct rt_thread *rt_current_thread = RT_NULL;
 rt_uint8_t rt_current_priority;
+#endif /*RT_USING_SMP*/
 
 
 rt_list_t rt_thread_defunct;
 
+#ifdef RT_USING_SMP
+rt_hw_spinlock_t _rt_critical_lock;
+#endif /*RT_USING_SMP*/
+
 #ifdef RT_USING_HOOK
 static void (*rt_scheduler_hook)(struct rt_thread *from, struct rt_thread *to);
 
@@ -116,15 +124,152 @@ static void _rt_scheduler_stack_check(struct rt_thread *thread)
 }
 #endif
 
+#ifdef RT_USING_SMP
+/*
+ * get the highest priority in a ready table,
+ * RT_THREAD_PRIORITY_MAX is returned when there is no ready thread.
+ */
+rt_inline rt_ubase_t _get_ready_priority(rt_uint32_t group, rt_uint8_t *ready_table)
+{
+#if RT_THREAD_PRIORITY_MAX > 32
+    register rt_ubase_t number;
+#endif
+
+    if (group == 0)
+        return RT_THREAD_PRIORITY_MAX;
+
+#if RT_THREAD_PRIORITY_MAX > 32
+    number = __rt_ffs(group) - 1;
+    return (number << 3) + __rt_ffs(ready_table[number]) - 1;
+#else
+    return __rt_ffs(group) - 1;
+#endif
+}
+
+/*
+ * get the highest priority thread in both the global ready queue and the
+ * ready queue of current cpu, the thread is not removed from its queue.
+ */
+static struct rt_thread* _get_highest_priority_thread(rt_ubase_t *highest_prio)
+{
+    register rt_ubase_t highest_ready_priority, local_highest_ready_priority;
+    struct rt_cpu* pcpu = rt_cpu_self();
+
+#if RT_THREAD_PRIORITY_MAX > 32
+    highest_ready_priority = _get_ready_priority(rt_thread_ready_priority_group, rt_thread_ready_table);
+    local_highest_ready_priority = _get_ready_priority(pcpu->priority_group, pcpu->ready_table);
+#else
+    highest_ready_priority = _get_ready_priority(rt_thread_ready_priority_group, RT_NULL);
+    local_highest_ready_priority = _get_ready_priority(pcpu->priority_group, RT_NULL);
+#endif
+
+    /* get highest ready priority thread */
+    if (highest_ready_priority < local_highest_ready_priority)
+    {
+        *highest_prio = highest_ready_priority;
+        return rt_list_entry(rt_thread_priority_table[highest_ready_priority].next,
+                             struct rt_thread, tlist);
+    }
+
+    if (local_highest_ready_priority < RT_THREAD_PRIORITY_MAX)
+    {
+        *highest_prio = local_highest_ready_priority;
+        return rt_list_entry(pcpu->priority_table[local_highest_ready_priority].next,
+                             struct rt_thread, tlist);
+    }
+
+    *highest_prio = RT_THREAD_PRIORITY_MAX;
+    return RT_NULL;
+}
+
+/*
+ * check whether the current thread of current cpu should give up the cpu
+ */
+static rt_bool_t _scheduler_need_switch(struct rt_thread *current_thread)
+{
+    rt_ubase_t highest_ready_priority;
+
+    if (_get_highest_priority_thread(&highest_ready_priority) == RT_NULL)
+        return RT_FALSE;
+
+    if ((current_thread->stat & RT_THREAD_STAT_MASK) != RT_THREAD_RUNNING)
+        return RT_TRUE;
+
+    if (current_thread->current_priority > highest_ready_priority)
+        return RT_TRUE;
+
+    if (current_thread->current_priority == highest_ready_priority &&
+        (current_thread->stat & RT_THREAD_STAT_YIELD_MASK))
+        return RT_TRUE;
+
+    return RT_FALSE;
+}
+
+/*
+ * Notify one other cpu which should run the new ready thread.
+ *
+ * Instead of broadcasting the schedule ipi, only the cpu running the lowest
+ * priority thread is woken up, and only if the new ready thread preempts it.
+ * The current cpu is never notified here, the caller will do a schedule.
+ */
+static void _scheduler_ipi_notify(struct rt_thread *thread, int cpu_id)
+{
+    int cpu, target = -1;
+    rt_uint8_t lowest_priority = thread->current_priority;
+    struct rt_cpu *pcpu;
+
+    if (thread->bind_cpu != RT_CPUS_NR)
+    {
+        pcpu = rt_cpu_index(thread->bind_cpu);
+        if (thread->bind_cpu != cpu_id && pcpu->current_thread != RT_NULL &&
+            pcpu->current_priority > lowest_priority)
+        {
+            target = thread->bind_cpu;
+        }
+    }
+    else
+    {
+        /* the current cpu will be preempted first if it is the lowest one */
+        pcpu = rt_cpu_index(cpu_id);
+        if (pcpu->current_priority > lowest_priority)
+            lowest_priority = pcpu->current_priority;
+
+        for (cpu = 0; cpu < RT_CPUS_NR; cpu ++)
+        {
+            pcpu = rt_cpu_index(cpu);
+            if (cpu == cpu_id || pcpu->current_thread == RT_NULL)
+                continue;
+
+            if (pcpu->current_priority > lowest_priority)
+            {
+                lowest_priority = pcpu->current_priority;
+                target = cpu;
+            }
+        }
+    }
+
+    if (target >= 0)
+    {
+        rt_cpu_index(target)->irq_switch_flag = 1;
+        rt_hw_ipi_send(RT_SCHEDULE_IPI, 1U << target);
+    }
+}
+#endif /*RT_USING_SMP*/
+
 /**
  * @ingroup SystemInit
  * This function will initialize the system scheduler
  */
 void rt_system_scheduler_init(void)
 {
+#ifdef RT_USING_SMP
+    int cpu;
+#endif /*RT_USING_SMP*/
     register rt_base_t offset;
 
+#ifndef RT_USING_SMP
     rt_scheduler_lock_nest = 0;
+#endif /*RT_USING_SMP*/
 
     RT_DEBUG_LOG(RT_DEBUG_SCHEDULER, ("start scheduler: max priority 0x%02x\n",
                                       RT_THREAD_PRIORITY_MAX));
@@ -134,8 +279,28 @@ void rt_system_scheduler_init(void)
         rt_list_init(&rt_thread_priority_table[offset]);
     }
 
+#ifdef RT_USING_SMP
+    for (cpu = 0; cpu < RT_CPUS_NR; cpu++)
+    {
+        struct rt_cpu *pcpu =  rt_cpu_index(cpu);
+        for (offset = 0; offset < RT_THREAD_PRIORITY_MAX; offset ++)
+        {
+            rt_list_init(&pcpu->priority_table[offset]);
+        }
+
+        pcpu->irq_switch_flag = 0;
+        pcpu->current_priority = RT_THREAD_PRIORITY_MAX - 1;
+        pcpu->current_thread = RT_NULL;
+        pcpu->priority_group = 0;
+
+#if RT_THREAD_PRIORITY_MAX > 32
+        rt_memset(pcpu->ready_table, 0, sizeof(pcpu->ready_table));
+#endif
+    }
+#else
     rt_current_priority = RT_THREAD_PRIORITY_MAX - 1;
     rt_current_thread = RT_NULL;
+#endif /*RT_USING_SMP*/
 
     /* initialize ready priority group */
     rt_thread_ready_priority_group = 0;
@@ -157,6 +322,22 @@ void rt_system_scheduler_init(void)
 void rt_system_scheduler_start(void)
 {
     register struct rt_thread *to_thread;
+#ifdef RT_USING_SMP
+    rt_ubase_t highest_ready_priority;
+
+    /* _cpus_lock is held here, it is released by the first thread */
+    to_thread = _get_highest_priority_thread(&highest_ready_priority);
+    RT_ASSERT(to_thread != RT_NULL);
+
+    to_thread->oncpu = rt_hw_cpu_id();
+    rt_cpu_self()->current_priority = (rt_uint8_t)highest_ready_priority;
+
+    rt_schedule_remove_thread(to_thread);
+    to_thread->stat = RT_THREAD_RUNNING | (to_thread->stat & ~RT_THREAD_STAT_MASK);
+
+    /* switch to new thread */
+    rt_hw_context_switch_to((rt_ubase_t)&to_thread->sp, to_thread);
+#else
     register rt_ubase_t highest_ready_priority;
 
 #if RT_THREAD_PRIORITY_MAX > 32
@@ -177,6 +358,7 @@ void rt_system_scheduler_start(void)
 
     /* switch to new thread */
     rt_hw_context_switch_to((rt_ubase_t)&to_thread->sp);
+#endif /*RT_USING_SMP*/
 
     /* never come back */
 }
@@ -187,6 +369,359 @@ void rt_system_scheduler_start(void)
 
 /**@{*/
 
+#ifdef RT_USING_SMP
+/**
+ * This function will perform one schedule. If the current thread of this
+ * cpu should give up the cpu, a schedule ipi is sent to this cpu itself.
+ * The thread switch is done in the ipi handler, which is taken as soon as
+ * the interrupt is enabled on a thread, or after the outermost interrupt
+ * service routine returns.
+ */
+void rt_schedule(void)
+{
+    rt_base_t level;
+    int cpu_id;
+    struct rt_cpu *pcpu;
+    struct rt_thread *current_thread;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    cpu_id = rt_hw_cpu_id();
+    pcpu   = rt_cpu_index(cpu_id);
+    current_thread = pcpu->current_thread;
+
+    /* check the scheduler is started and enabled or not */
+    if (current_thread != RT_NULL && current_thread->scheduler_lock_nest == 1)
+    {
+        if (_scheduler_need_switch(current_thread))
+        {
+            pcpu->irq_switch_flag = 1;
+            rt_hw_ipi_send(RT_SCHEDULE_IPI, 1U << cpu_id);
+        }
+        else
+        {
+            /* nothing to yield to */
+            current_thread->stat &= ~RT_THREAD_STAT_YIELD_MASK;
+        }
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function checks if a scheduling is needed after IRQ context. If yes,
+ * it will select one thread with the highest priority level, and then switch
+ * to it. It is called by the schedule ipi handler of the port, with the
+ * context of interrupted thread.
+ */
+void rt_scheduler_do_irq_switch(void *context)
+{
+    int cpu_id;
+    rt_base_t level;
+    struct rt_cpu* pcpu;
+    struct rt_thread *to_thread;
+    struct rt_thread *current_thread;
+
+    level = rt_hw_interrupt_disable();
+
+    cpu_id = rt_hw_cpu_id();
+    pcpu   = rt_cpu_index(cpu_id);
+    current_thread = pcpu->current_thread;
+
+    if (pcpu->irq_switch_flag == 0)
+    {
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    /*
+     * the flag is kept when the switch can't be done now, rt_exit_critical
+     * schedules again when the scheduler is unlocked, and rt_interrupt_leave
+     * posts the schedule ipi again when the outermost interrupt exits
+     */
+    if (current_thread->scheduler_lock_nest == 1 && pcpu->irq_nest == 0)
+    {
+        rt_ubase_t highest_ready_priority;
+
+        /* clear irq switch flag */
+        pcpu->irq_switch_flag = 0;
+
+        to_thread = _get_highest_priority_thread(&highest_ready_priority);
+        if (to_thread != RT_NULL)
+        {
+            current_thread->oncpu = RT_CPU_DETACHED;
+            if ((current_thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_RUNNING)
+            {
+                if (current_thread->current_priority < highest_ready_priority)
+                {
+                    to_thread = current_thread;
+                }
+                else if (current_thread->current_priority == highest_ready_priority &&
+                         (current_thread->stat & RT_THREAD_STAT_YIELD_MASK) == 0)
+                {
+                    to_thread = current_thread;
+                }
+                else
+                {
+                    rt_schedule_insert_thread(current_thread);
+                }
+                current_thread->stat &= ~RT_THREAD_STAT_YIELD_MASK;
+            }
+            to_thread->oncpu = cpu_id;
+
+            if (to_thread != current_thread)
+            {
+                /* if the destination thread is not the same as current thread */
+                pcpu->current_priority = (rt_uint8_t)highest_ready_priority;
+
+                RT_OBJECT_HOOK_CALL(rt_scheduler_hook, (current_thread, to_thread));
+
+                rt_schedule_remove_thread(to_thread);
+                to_thread->stat = RT_THREAD_RUNNING | (to_thread->stat & ~RT_THREAD_STAT_MASK);
+
+#ifdef RT_USING_OVERFLOW_CHECK
+                _rt_scheduler_stack_check(to_thread);
+#endif
+                RT_DEBUG_LOG(RT_DEBUG_SCHEDULER, ("[%d]switch to priority#%d "
+                                                  "thread:%.*s(sp:0x%p), "
+                                                  "from thread:%.*s(sp: 0x%p)\n",
+                                                  cpu_id, highest_ready_priority,
+                                                  RT_NAME_MAX, to_thread->name, to_thread->sp,
+                                                  RT_NAME_MAX, current_thread->name, current_thread->sp));
+
+                /* the lock is handed over to the destination thread */
+                current_thread->cpus_lock_nest--;
+                current_thread->scheduler_lock_nest--;
+
+                rt_hw_context_switch_interrupt(context, (rt_ubase_t)&current_thread->sp,
+                                               (rt_ubase_t)&to_thread->sp, to_thread);
+                /* never come back */
+            }
+        }
+    }
+
+    rt_hw_interrupt_enable(level);
+}
+
+/*
+ * This function will insert a thread to system ready queue. The state of
+ * thread will be set as READY and remove from suspend queue.
+ *
+ * @param thread the thread to be inserted
+ * @note Please do not invoke this function in user application.
+ */
+void rt_schedule_insert_thread(struct rt_thread *thread)
+{
+    int cpu_id;
+    int bind_cpu;
+    register rt_base_t level;
+
+    RT_ASSERT(thread != RT_NULL);
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    /* it should be RUNNING thread */
+    if (thread->oncpu != RT_CPU_DETACHED)
+    {
+        thread->stat = RT_THREAD_RUNNING | (thread->stat & ~RT_THREAD_STAT_MASK);
+        goto __exit;
+    }
+
+    /* READY thread, insert to ready queue */
+    thread->stat = RT_THREAD_READY | (thread->stat & ~RT_THREAD_STAT_MASK);
+
+    cpu_id   = rt_hw_cpu_id();
+    bind_cpu = thread->bind_cpu ;
+
+    /* insert thread to ready list */
+    if (bind_cpu == RT_CPUS_NR)
+    {
+#if RT_THREAD_PRIORITY_MAX > 32
+        rt_thread_ready_table[thread->number] |= thread->high_mask;
+#endif
+        rt_thread_ready_priority_group |= thread->number_mask;
+
+        rt_list_insert_before(&(rt_thread_priority_table[thread->current_priority]),
+                              &(thread->tlist));
+    }
+    else
+    {
+        struct rt_cpu *pcpu = rt_cpu_index(bind_cpu);
+
+#if RT_THREAD_PRIORITY_MAX > 32
+        pcpu->ready_table[thread->number] |= thread->high_mask;
+#endif
+        pcpu->priority_group |= thread->number_mask;
+
+        rt_list_insert_before(&(pcpu->priority_table[thread->current_priority]),
+                              &(thread->tlist));
+    }
+
+    RT_DEBUG_LOG(RT_DEBUG_SCHEDULER, ("insert thread[%.*s], the priority: %d\n",
+                                      RT_NAME_MAX, thread->name, thread->current_priority));
+
+    _scheduler_ipi_notify(thread, cpu_id);
+
+__exit:
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+
+/*
+ * This function will remove a thread from system ready queue.
+ *
+ * @param thread the thread to be removed
+ *
+ * @note Please do not invoke this function in user application.
+ */
+void rt_schedule_remove_thread(struct rt_thread *thread)
+{
+    register rt_base_t level;
+
+    RT_ASSERT(thread != RT_NULL);
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    RT_DEBUG_LOG(RT_DEBUG_SCHEDULER, ("remove thread[%.*s], the priority: %d\n",
+                                      RT_NAME_MAX, thread->name,
+                                      thread->current_priority));
+
+    /* remove thread from ready list */
+    rt_list_remove(&(thread->tlist));
+    if (thread->bind_cpu == RT_CPUS_NR)
+    {
+        if (rt_list_isempty(&(rt_thread_priority_table[thread->current_priority])))
+        {
+#if RT_THREAD_PRIORITY_MAX > 32
+            rt_thread_ready_table[thread->number] &= ~thread->high_mask;
+            if (rt_thread_ready_table[thread->number] == 0)
+            {
+                rt_thread_ready_priority_group &= ~thread->number_mask;
+            }
+#else
+            rt_thread_ready_priority_group &= ~thread->number_mask;
+#endif
+        }
+    }
+    else
+    {
+        struct rt_cpu *pcpu = rt_cpu_index(thread->bind_cpu);
+
+        if (rt_list_isempty(&(pcpu->priority_table[thread->current_priority])))
+        {
+#if RT_THREAD_PRIORITY_MAX > 32
+            pcpu->ready_table[thread->number] &= ~thread->high_mask;
+            if (pcpu->ready_table[thread->number] == 0)
+            {
+                pcpu->priority_group &= ~thread->number_mask;
+            }
+#else
+            pcpu->priority_group &= ~thread->number_mask;
+#endif
+        }
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will lock the thread scheduler.
+ */
+void rt_enter_critical(void)
+{
+    register rt_base_t level;
+    struct rt_thread *current_thread;
+
+    /* disable interrupt */
+    level = rt_hw_local_irq_disable();
+
+    current_thread = rt_cpu_self()->current_thread;
+    if (!current_thread)
+    {
+        rt_hw_local_irq_enable(level);
+        return;
+    }
+
+    /*
+     * the maximal number of nest is RT_UINT16_MAX, which is big
+     * enough and does not check here
+     */
+
+    /* lock scheduler for all cpus */
+    if (current_thread->critical_lock_nest == 0)
+    {
+        rt_hw_spin_lock(&_rt_critical_lock);
+    }
+
+    /* critical for local cpu */
+    current_thread->critical_lock_nest ++;
+
+    /* lock scheduler for local cpu */
+    current_thread->scheduler_lock_nest ++;
+
+    /* enable interrupt */
+    rt_hw_local_irq_enable(level);
+}
+
+/**
+ * This function will unlock the thread scheduler.
+ */
+void rt_exit_critical(void)
+{
+    register rt_base_t level;
+    struct rt_thread *current_thread;
+
+    /* disable interrupt */
+    level = rt_hw_local_irq_disable();
+
+    current_thread = rt_cpu_self()->current_thread;
+    if (!current_thread)
+    {
+        rt_hw_local_irq_enable(level);
+        return;
+    }
+
+    current_thread->scheduler_lock_nest --;
+
+    current_thread->critical_lock_nest --;
+
+    if (current_thread->critical_lock_nest == 0)
+    {
+        rt_hw_spin_unlock(&_rt_critical_lock);
+    }
+
+    if (current_thread->scheduler_lock_nest <= 0)
+    {
+        current_thread->scheduler_lock_nest = 0;
+        /* enable interrupt */
+        rt_hw_local_irq_enable(level);
+
+        rt_schedule();
+    }
+    else
+    {
+        /* enable interrupt */
+        rt_hw_local_irq_enable(level);
+    }
+}
+
+/**
+ * Get the scheduler lock level
+ *
+ * @return the level of the scheduler lock. 0 means unlocked.
+ */
+rt_uint16_t rt_critical_level(void)
+{
+    struct rt_thread *current_thread = rt_cpu_self()->current_thread;
+
+    return current_thread ? current_thread->critical_lock_nest : 0;
+}
+#else
 /**
  * This function will perform one schedule. It will select one thread
  * with the highest priority level, then switch to it.
@@ -419,5 +954,6 @@ rt_uint16_t rt_critical_level(void)
 {
     return rt_scheduler_lock_nest;
 }
+#endif /*RT_USING_SMP*/
 /**@}*/
 
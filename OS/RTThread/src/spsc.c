@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ * Copyright (c) 2019-Present Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Nuclei       single-producer/single-consumer channel
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+
+#ifdef RT_USING_SPSC
+
+#include <nuclei_sdk_soc.h>
+
+/**
+ * @addtogroup IPC
+ */
+
+/**@{*/
+
+/*
+ * The channel is a ring of max_msgs slots (power of 2) indexed by two free
+ * running 32 bit counters:
+ * - in_offset is written only by the producer, after the slot is filled
+ * - out_offset is written only by the consumer, after the slot is drained
+ *
+ * So sending and a non-blocking receive never need to disable interrupts.
+ * Only when the consumer has to block, the waiting flag is raised and the
+ * producer claims it with an atomic swap, which guarantees that exactly one
+ * side (producer wakeup or thread timeout) resumes the consumer.
+ */
+#define SPSC_SLOT(spsc, idx)    ((rt_uint8_t *)(spsc)->msg_pool + \
+                                 ((idx) & ((spsc)->max_msgs - 1)) * (spsc)->msg_size)
+
+rt_inline void _spsc_object_init(rt_spsc_t spsc, rt_size_t msg_size, rt_size_t max_msgs)
+{
+    spsc->msg_size   = (rt_uint16_t)msg_size;
+    spsc->max_msgs   = (rt_uint16_t)max_msgs;
+    spsc->in_offset  = 0;
+    spsc->out_offset = 0;
+    spsc->waiting    = 0;
+    spsc->reader     = RT_NULL;
+    spsc->dropped    = 0;
+}
+
+/* round down to power of 2, the ring index mask relies on it */
+rt_inline rt_size_t _spsc_floor_pow2(rt_size_t n)
+{
+    rt_size_t p = 1;
+
+    while ((p << 1) <= n)
+        p <<= 1;
+
+    return p;
+}
+
+/**
+ * This function will initialize a spsc channel and put it under control of
+ * resource management.
+ *
+ * @param spsc the spsc channel object
+ * @param name the name of spsc channel
+ * @param msgpool the beginning address of buffer to save messages
+ * @param msg_size the maximum size of message
+ * @param pool_size the size of buffer to save messages
+ *
+ * @return the operation status, RT_EOK on successful
+ */
+rt_err_t rt_spsc_init(rt_spsc_t   spsc,
+                      const char *name,
+                      void       *msgpool,
+                      rt_size_t   msg_size,
+                      rt_size_t   pool_size)
+{
+    rt_size_t max_msgs;
+
+    /* parameter check */
+    RT_ASSERT(spsc != RT_NULL);
+    RT_ASSERT(msgpool != RT_NULL);
+
+    /* get correct message size */
+    msg_size = RT_ALIGN(msg_size, RT_ALIGN_SIZE);
+    if (msg_size == 0 || pool_size < msg_size)
+        return -RT_ERROR;
+    max_msgs = _spsc_floor_pow2(pool_size / msg_size);
+    if (max_msgs > 0x8000)
+        return -RT_ERROR;
+
+    /* initialize object */
+    rt_object_init(&(spsc->parent), RT_Object_Class_SPSC, name);
+
+    spsc->msg_pool = msgpool;
+    _spsc_object_init(spsc, msg_size, max_msgs);
+
+    return RT_EOK;
+}
+
+/**
+ * This function will detach a spsc channel from resource management
+ *
+ * @param spsc the spsc channel object
+ *
+ * @return the operation status, RT_EOK on successful
+ */
+rt_err_t rt_spsc_detach(rt_spsc_t spsc)
+{
+    /* parameter check */
+    RT_ASSERT(spsc != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&spsc->parent) == RT_Object_Class_SPSC);
+    RT_ASSERT(rt_object_is_systemobject(&spsc->parent));
+
+    /* wake up the blocked reader with an error */
+    if (__AMOSWAP_W(&spsc->waiting, 0) != 0)
+    {
+        spsc->reader->error = -RT_ERROR;
+        rt_thread_resume(spsc->reader);
+    }
+
+    /* detach spsc object */
+    rt_object_detach(&(spsc->parent));
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_HEAP
+/**
+ * This function will create a spsc channel object from system resource
+ *
+ * @param name the name of spsc channel
+ * @param msg_size the size of message
+ * @param max_msgs the maximum number of message, rounded down to power of 2
+ *
+ * @return the created spsc channel, RT_NULL on error happen
+ */
+rt_spsc_t rt_spsc_create(const char *name,
+                         rt_size_t   msg_size,
+                         rt_size_t   max_msgs)
+{
+    rt_spsc_t spsc;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* get correct message size */
+    msg_size = RT_ALIGN(msg_size, RT_ALIGN_SIZE);
+    max_msgs = _spsc_floor_pow2(max_msgs);
+    if (msg_size == 0 || max_msgs == 0 || max_msgs > 0x8000)
+        return RT_NULL;
+
+    /* allocate object */
+    spsc = (rt_spsc_t)rt_object_allocate(RT_Object_Class_SPSC, name);
+    if (spsc == RT_NULL)
+        return spsc;
+
+    /* allocate message pool */
+    spsc->msg_pool = RT_KERNEL_MALLOC(msg_size * max_msgs);
+    if (spsc->msg_pool == RT_NULL)
+    {
+        rt_object_delete(&(spsc->parent));
+
+        return RT_NULL;
+    }
+    _spsc_object_init(spsc, msg_size, max_msgs);
+
+    return spsc;
+}
+
+/**
+ * This function will delete a spsc channel object and release the memory
+ *
+ * @param spsc the spsc channel object
+ *
+ * @return the error code
+ */
+rt_err_t rt_spsc_delete(rt_spsc_t spsc)
+{
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* parameter check */
+    RT_ASSERT(spsc != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&spsc->parent) == RT_Object_Class_SPSC);
+    RT_ASSERT(rt_object_is_systemobject(&spsc->parent) == RT_FALSE);
+
+    /* wake up the blocked reader with an error */
+    if (__AMOSWAP_W(&spsc->waiting, 0) != 0)
+    {
+        spsc->reader->error = -RT_ERROR;
+        rt_thread_resume(spsc->reader);
+    }
+
+    /* free spsc pool */
+    RT_KERNEL_FREE(spsc->msg_pool);
+
+    /* delete spsc object */
+    rt_object_delete(&(spsc->parent));
+
+    return RT_EOK;
+}
+#endif
+
+/**
+ * This function will send a message to spsc channel object. It never blocks
+ * and never disables interrupts, so it is intended to be called from the only
+ * producer, which is usually an interrupt service routine. If the consumer
+ * thread is blocked on this channel, it will be woken up.
+ *
+ * @param spsc the spsc channel object
+ * @param buffer the message
+ * @param size the size of buffer
+ *
+ * @return the error code, -RT_EFULL if channel has no free slot
+ */
+rt_err_t rt_spsc_send(rt_spsc_t spsc, const void *buffer, rt_size_t size)
+{
+    rt_uint32_t in;
+
+    /* parameter check */
+    RT_ASSERT(spsc != RT_NULL);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* greater than one message size */
+    if (size > spsc->msg_size)
+        return -RT_ERROR;
+
+    in = spsc->in_offset;
+    if ((rt_uint32_t)(in - spsc->out_offset) >= spsc->max_msgs)
+    {
+        spsc->dropped ++;
+        return -RT_EFULL;
+    }
+
+    rt_memcpy(SPSC_SLOT(spsc, in), buffer, size);
+
+    /* message must be visible before the slot is published */
+    __SMP_WMB();
+    spsc->in_offset = in + 1;
+    /* publish slot before checking whether reader is sleeping */
+    __SMP_RWMB();
+
+    if (spsc->waiting && __AMOSWAP_W(&spsc->waiting, 0) != 0)
+    {
+        /* we own the wakeup now */
+        rt_thread_resume(spsc->reader);
+        rt_schedule();
+    }
+
+    return RT_EOK;
+}
+
+/* take one message out of channel, return RT_FALSE if channel is empty */
+rt_inline rt_bool_t _spsc_pop(rt_spsc_t spsc, void *buffer, rt_size_t size)
+{
+    rt_uint32_t out = spsc->out_offset;
+
+    if (spsc->in_offset == out)
+        return RT_FALSE;
+
+    /* read slot only after the index published by producer is observed */
+    __SMP_RMB();
+    rt_memcpy(buffer, SPSC_SLOT(spsc, out), size > spsc->msg_size ? spsc->msg_size : size);
+    /* slot must be drained before it is handed back to producer */
+    __SMP_RWMB();
+    spsc->out_offset = out + 1;
+
+    return RT_TRUE;
+}
+
+/**
+ * This function will receive a message from spsc channel object, if there is
+ * no message in channel, the only consumer thread will wait for a specified
+ * time.
+ *
+ * @param spsc the spsc channel object
+ * @param buffer the received message will be saved in
+ * @param size the size of buffer
+ * @param timeout the waiting time
+ *
+ * @return the error code
+ */
+rt_err_t rt_spsc_recv(rt_spsc_t  spsc,
+                      void      *buffer,
+                      rt_size_t  size,
+                      rt_int32_t timeout)
+{
+    struct rt_thread *thread;
+    register rt_ubase_t temp;
+    rt_uint32_t tick_delta;
+
+    /* parameter check */
+    RT_ASSERT(spsc != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&spsc->parent) == RT_Object_Class_SPSC);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* fast path, no interrupt disable at all */
+    if (_spsc_pop(spsc, buffer, size))
+        return RT_EOK;
+
+    if (timeout == 0)
+        return -RT_ETIMEOUT;
+
+    RT_DEBUG_IN_THREAD_CONTEXT;
+
+    /* initialize delta tick */
+    tick_delta = 0;
+    /* get current thread */
+    thread = rt_thread_self();
+    spsc->reader = thread;
+
+    while (1)
+    {
+        /* disable interrupt */
+        temp = rt_hw_interrupt_disable();
+
+        /* reset error number in thread */
+        thread->error = RT_EOK;
+
+        /* suspend current thread, then tell producer we are sleeping */
+        rt_thread_suspend(thread);
+        spsc->waiting = 1;
+        __SMP_RWMB();
+
+        /* a message published before the flag was seen, undo the sleep */
+        if (spsc->in_offset != spsc->out_offset)
+        {
+            if (__AMOSWAP_W(&spsc->waiting, 0) != 0)
+                rt_thread_resume(thread);
+            rt_hw_interrupt_enable(temp);
+        }
+        else
+        {
+            /* has waiting time, start thread timer */
+            if (timeout > 0)
+            {
+                /* get the start tick of timer */
+                tick_delta = rt_tick_get();
+
+                /* reset the timeout of thread timer and start it */
+                rt_timer_control(&(thread->thread_timer),
+                                 RT_TIMER_CTRL_SET_TIME,
+                                 &timeout);
+                rt_timer_start(&(thread->thread_timer));
+            }
+
+            /* enable interrupt */
+            rt_hw_interrupt_enable(temp);
+
+            /* re-schedule */
+            rt_schedule();
+
+            /* timeout or channel detached, withdraw the wakeup request */
+            __AMOSWAP_W(&spsc->waiting, 0);
+        }
+
+        if (_spsc_pop(spsc, buffer, size))
+            return RT_EOK;
+
+        /* resume from suspend state */
+        if (thread->error != RT_EOK)
+        {
+            /* return error */
+            return thread->error;
+        }
+
+        /* if it's not waiting forever and then re-calculate timeout tick */
+        if (timeout > 0)
+        {
+            tick_delta = rt_tick_get() - tick_delta;
+            timeout -= tick_delta;
+            if (timeout <= 0)
+                return -RT_ETIMEOUT;
+        }
+    }
+}
+
+/**
+ * This function will return the number of messages pending in spsc channel.
+ *
+ * @param spsc the spsc channel object
+ *
+ * @return the pending message count
+ */
+rt_size_t rt_spsc_count(rt_spsc_t spsc)
+{
+    RT_ASSERT(spsc != RT_NULL);
+
+    return (rt_size_t)(rt_uint32_t)(spsc->in_offset - spsc->out_offset);
+}
+
+/**@}*/
+
+#endif /* end of RT_USING_SPSC */
@@ -26,13 +26,16 @@
                                bug when thread has not startup.
  * 2018-11-22     Jesven       yield is same to rt_schedule
  *                             add support for tasks bound to cpu
+ * 2026-10-19     Nuclei       enable smp thread management for Nuclei port
  */
 
 #include <rthw.h>
 #include <rtthread.h>
 
 extern rt_list_t rt_thread_priority_table[RT_THREAD_PRIORITY_MAX];
+#ifndef RT_USING_SMP
 extern struct rt_thread *rt_current_thread;
+#endif /*RT_USING_SMP*/
 extern rt_list_t rt_thread_defunct;
 
 #ifdef RT_USING_HOOK
@@ -100,7 +103,7 @@ void rt_thread_exit(void)
     register rt_base_t level;
 
     /* get current thread */
-    thread = rt_current_thread;
+    thread = rt_thread_self();
 
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
@@ -162,6 +165,9 @@ static rt_err_t _rt_thread_init(struct rt_thread *thread,
                                           (rt_uint8_t *)((char *)thread->stack_addr + thread->stack_size - sizeof(rt_ubase_t)),
                                           (void *)rt_thread_exit);
 #endif
+#ifdef RT_USING_HW_STACK_TRACK
+    thread->hw_stack_lowest = thread->sp;
+#endif
 
     /* priority init */
     RT_ASSERT(priority < RT_THREAD_PRIORITY_MAX);
@@ -182,6 +188,17 @@ static rt_err_t _rt_thread_init(struct rt_thread *thread,
     thread->error = RT_EOK;
     thread->stat  = RT_THREAD_INIT;
 
+#ifdef RT_USING_SMP
+    /* not bind on any cpu */
+    thread->bind_cpu = RT_CPUS_NR;
+    thread->oncpu = RT_CPU_DETACHED;
+
+    /* lock init */
+    thread->scheduler_lock_nest = 0;
+    thread->cpus_lock_nest = 0;
+    thread->critical_lock_nest = 0;
+#endif /*RT_USING_SMP*/
+
     /* initialize cleanup function and user data */
     thread->cleanup   = 0;
     thread->user_data = 0;
@@ -253,7 +270,17 @@ rt_err_t rt_thread_init(struct rt_thread *thread,
  */
 rt_thread_t rt_thread_self(void)
 {
+#ifdef RT_USING_SMP
+    rt_base_t lock;
+    rt_thread_t self;
+
+    lock = rt_hw_local_irq_disable();
+    self = rt_cpu_self()->current_thread;
+    rt_hw_local_irq_enable(lock);
+    return self;
+#else
     return rt_current_thread;
+#endif /*RT_USING_SMP*/
 }
 
 /**
@@ -461,7 +488,20 @@ rt_err_t rt_thread_yield(void)
     level = rt_hw_interrupt_disable();
 
     /* set to current thread */
-    thread = rt_current_thread;
+    thread = rt_thread_self();
+
+#ifdef RT_USING_SMP
+    /* running thread is not in ready queue, let scheduler put it to the end */
+    thread->remaining_tick = thread->init_tick;
+    thread->stat |= RT_THREAD_STAT_YIELD;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    rt_schedule();
+
+    return RT_EOK;
+#else
 
     /* if the thread stat is READY and on ready queue list */
     if ((thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_READY &&
@@ -486,6 +526,7 @@ rt_err_t rt_thread_yield(void)
     rt_hw_interrupt_enable(level);
 
     return RT_EOK;
+#endif /*RT_USING_SMP*/
 }
 
 /**
@@ -503,7 +544,7 @@ rt_err_t rt_thread_sleep(rt_tick_t tick)
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
     /* set to current thread */
-    thread = rt_current_thread;
+    thread = rt_thread_self();
     RT_ASSERT(thread != RT_NULL);
     RT_ASSERT(rt_object_get_type((rt_object_t)thread) == RT_Object_Class_Thread);
 
@@ -670,6 +711,14 @@ rt_err_t rt_thread_control(rt_thread_t thread, int cmd, void *arg)
 #else
             thread->number_mask = 1 << thread->current_priority;
 #endif
+
+#ifdef RT_USING_SMP
+            /* running thread, the cpu priority is used to choose ipi target */
+            if (thread->oncpu != RT_CPU_DETACHED)
+            {
+                rt_cpu_index(thread->oncpu)->current_priority = thread->current_priority;
+            }
+#endif /*RT_USING_SMP*/
         }
 
         /* enable interrupt */
@@ -692,6 +741,23 @@ rt_err_t rt_thread_control(rt_thread_t thread, int cmd, void *arg)
         }
 #endif
 
+#ifdef RT_USING_SMP
+    case RT_THREAD_CTRL_BIND_CPU:
+    {
+        rt_uint8_t cpu;
+
+        if ((thread->stat & RT_THREAD_STAT_MASK) != RT_THREAD_INIT)
+        {
+            /* we only support bind cpu before started phase. */
+            return -RT_ERROR;
+        }
+
+        cpu = (rt_uint8_t)(rt_ubase_t)arg;
+        thread->bind_cpu = cpu > RT_CPUS_NR ? RT_CPUS_NR : cpu;
+        break;
+    }
+#endif /*RT_USING_SMP*/
+
     default:
         break;
     }
@@ -712,6 +778,7 @@ rt_err_t rt_thread_control(rt_thread_t thread, int cmd, void *arg)
 rt_err_t rt_thread_suspend(rt_thread_t thread)
 {
     register rt_base_t temp;
+    register rt_base_t stat;
 
     /* thread check */
     RT_ASSERT(thread != RT_NULL);
@@ -719,7 +786,14 @@ rt_err_t rt_thread_suspend(rt_thread_t thread)
 
     RT_DEBUG_LOG(RT_DEBUG_THREAD, ("thread suspend:  %s\n", thread->name));
 
-    if ((thread->stat & RT_THREAD_STAT_MASK) != RT_THREAD_READY)
+    stat = thread->stat & RT_THREAD_STAT_MASK;
+#ifdef RT_USING_SMP
+    /* not suspend running status thread on other core */
+    RT_ASSERT(stat != RT_THREAD_RUNNING || thread == rt_thread_self());
+    if ((stat != RT_THREAD_READY) && (stat != RT_THREAD_RUNNING))
+#else
+    if (stat != RT_THREAD_READY)
+#endif /*RT_USING_SMP*/
     {
         RT_DEBUG_LOG(RT_DEBUG_THREAD, ("thread suspend: thread disorder, 0x%2x\n",
                                        thread->stat));
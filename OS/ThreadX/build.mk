@@ -12,3 +12,8 @@ ifeq ($(THREADX_MODULE),1)
 C_SRCDIRS += $(NUCLEI_SDK_RTOS)/common_modules/module_manager/src $(NUCLEI_SDK_RTOS)/ports/nuclei/module_manager/src
 INCDIRS += $(NUCLEI_SDK_RTOS)/common_modules/module_manager/inc $(NUCLEI_SDK_RTOS)/common_modules/inc
 endif
+
+# Track thread stack high water mark by stack check unit when STACKTRACK=1
+ifeq ($(STACKTRACK),1)
+COMMON_FLAGS += -DTX_HW_STACK_TRACK
+endif
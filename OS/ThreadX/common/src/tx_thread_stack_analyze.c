@@ -74,6 +74,23 @@ VOID  _tx_thread_stack_analyze(TX_THREAD *thread_ptr)
 
 TX_INTERRUPT_SAVE_AREA
 
+#ifdef TX_PORT_STACK_TRACK_UPDATE
+
+    /* The highest stack usage is tracked by the port with hardware, so there
+       is no need to search the stack fill pattern.  */
+
+    /* Disable interrupts.  */
+    TX_DISABLE
+
+    /* Determine if the thread pointer is valid.  */
+    if ((thread_ptr != TX_NULL) && (thread_ptr -> tx_thread_id == TX_THREAD_ID))
+    {
+
+        /* Update the highest stack usage if the thread is running.  */
+        TX_PORT_STACK_TRACK_UPDATE(thread_ptr)
+    }
+#else
+
 ULONG       *stack_ptr;
 ULONG       *stack_lowest;
 ULONG       *stack_highest;
@@ -175,6 +192,7 @@ ULONG       size;
             }
         }
     }
+#endif
 
     /* Restore interrupts.  */
     TX_RESTORE
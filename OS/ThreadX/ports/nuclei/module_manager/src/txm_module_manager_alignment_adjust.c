@@ -33,6 +33,32 @@ VOID  _txm_module_manager_alignment_adjust(TXM_MODULE_PREAMBLE *module_preamble,
 {
 #ifdef TXM_MODULE_MANAGER_PMP
 
+ULONG   size;
+
+    /* Round code and data size up to power of 2 no less than the PMP granularity, and align
+       them to their size, so each of them is covered by one NAPOT entry.  */
+    size =  ((ULONG) 1) << TXM_MODULE_MANAGER_PMP_GRANULE_ORDER;
+    while (size < *code_size)
+    {
+        size =  size << 1;
+    }
+    *code_size =  size;
+    if (*code_alignment < size)
+    {
+        *code_alignment =  size;
+    }
+
+    size =  ((ULONG) 1) << TXM_MODULE_MANAGER_PMP_GRANULE_ORDER;
+    while (size < *data_size)
+    {
+        size =  size << 1;
+    }
+    *data_size =  size;
+    if (*data_alignment < size)
+    {
+        *data_alignment =  size;
+    }
+
 #else
 
 
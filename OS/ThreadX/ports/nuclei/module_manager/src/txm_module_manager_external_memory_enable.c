@@ -35,6 +35,59 @@ UINT  _txm_module_manager_external_memory_enable(TXM_MODULE_INSTANCE *module_ins
 {
 #ifdef TXM_MODULE_MANAGER_PMP
 
+    /* Determine if the module manager has not been initialized yet.  */
+    if (_txm_module_manager_ready != TX_TRUE)
+    {
+        /* Module manager has not been initialized.  */
+        return(TX_NOT_AVAILABLE);
+    }
+
+    /* Determine if the module is valid.  */
+    if ((module_instance == TX_NULL) || (module_instance -> txm_module_instance_id != TXM_MODULE_ID))
+    {
+        /* Invalid module pointer.  */
+        return(TX_PTR_ERROR);
+    }
+
+    /* Shared memory must be granted by the module properties.  */
+    if ((module_instance -> txm_module_instance_property_flags & TXM_MODULE_SHARED_EXTERNAL_MEMORY_ACCESS) == 0)
+    {
+        return(TXM_MODULE_INVALID_PROPERTIES);
+    }
+
+    /* The shared memory takes one NAPOT entry, so it must be a naturally aligned power of 2
+       size no less than the PMP granularity.  */
+    if ((length < (((ULONG) 1) << TXM_MODULE_MANAGER_PMP_GRANULE_ORDER)) ||
+        (length & (length - 1)) ||
+        (((ALIGN_TYPE) start_address) & (length - 1)))
+    {
+        return(TXM_MODULE_ALIGNMENT_ERROR);
+    }
+
+    /* Get module manager protection mutex.  */
+    _tx_mutex_get(&_txm_module_manager_mutex, TX_WAIT_FOREVER);
+
+    /* The module must be loaded and not started yet.  */
+    if (module_instance -> txm_module_instance_state != TXM_MODULE_LOADED)
+    {
+        /* Release the protection mutex.  */
+        _tx_mutex_put(&_txm_module_manager_mutex);
+
+        return(TX_START_ERROR);
+    }
+
+    /* Save the shared memory and update the PMP entries of the module.  */
+    module_instance -> txm_module_instance_shared_memory_address =     start_address;
+    module_instance -> txm_module_instance_shared_memory_length =      length;
+    module_instance -> txm_module_instance_shared_memory_attributes =  attributes;
+    if (module_instance -> txm_module_instance_property_flags & TXM_MODULE_USER_MODE)
+    {
+        _txm_module_manager_mm_register_setup(module_instance);
+    }
+
+    /* Release the protection mutex.  */
+    _tx_mutex_put(&_txm_module_manager_mutex);
+
     /* Return success.  */
     return(TX_SUCCESS);
 
@@ -69,3 +69,62 @@ TX_THREAD               *thread_ptr;
         (_txm_module_manager_fault_notify)(thread_ptr, module_instance_ptr);
     }
 }
+
+
+#ifdef TXM_MODULE_MANAGER_PMP
+
+/* Define the handlers of access faults in machine mode, registered before the module ones.  */
+
+static unsigned long    _txm_module_manager_machine_fault_handler[StAccessFault_EXCn + 1];
+
+
+VOID  _txm_module_manager_memory_fault_register(VOID)
+{
+
+static const UINT   exccodes[] = {InsAccFault_EXCn, LdFault_EXCn, StAccessFault_EXCn};
+UINT                i;
+
+    /* Only access faults are caused by PMP.  */
+    for (i = 0; i < sizeof(exccodes) / sizeof(exccodes[0]); i++)
+    {
+        _txm_module_manager_machine_fault_handler[exccodes[i]] =  Exception_Get_EXC(exccodes[i]);
+        Exception_Register_EXC(exccodes[i], (unsigned long) _txm_module_manager_memory_fault_exception);
+    }
+}
+
+
+/* Called by exc_entry with the exception frame saved on the stack of the faulting thread, or by
+   _txm_module_manager_trap_entry with the frame saved on the kernel stack of the faulting user mode
+   thread, and the user sp kept above the frame.  */
+VOID  _txm_module_manager_memory_fault_exception(unsigned long mcause, unsigned long sp)
+{
+
+EXC_Frame_Type  *frame =  (EXC_Frame_Type *) sp;
+unsigned long   exccode =  mcause & MCAUSE_CAUSE;
+
+    /* Faults of machine mode are not caused by modules.  */
+    if ((__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_MPP) != 0)
+    {
+        if (_txm_module_manager_machine_fault_handler[exccode])
+        {
+            ((VOID (*)(unsigned long, unsigned long)) _txm_module_manager_machine_fault_handler[exccode])(mcause, sp);
+        }
+        return;
+    }
+
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_thread_ptr =     _tx_thread_current_ptr;
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_code_location =  (VOID *) frame -> epc;
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_mcause =         mcause;
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_mtval =          __RV_CSR_READ(CSR_MTVAL);
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_sp =             *((unsigned long *) (sp + sizeof(EXC_Frame_Type)));
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_ra =             frame -> ra;
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_a0 =             frame -> a0;
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_a1 =             frame -> a1;
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_a2 =             frame -> a2;
+    _txm_module_manager_memory_fault_info.txm_module_manager_memory_fault_info_a3 =             frame -> a3;
+
+    /* Terminate the thread, it is switched out as soon as the exception returns.  */
+    _txm_module_manager_memory_fault_handler();
+}
+
+#endif
@@ -25,21 +25,249 @@
 #include "txm_module.h"
 
 
+#ifdef TXM_MODULE_MANAGER_PMP
+
+#ifdef TXM_MODULE_MANAGER_SPMP
+#if !defined(__SPMP_PRESENT) || (__SPMP_PRESENT != 1)
+#error "TXM_MODULE_MANAGER_SPMP requires sPMP, __SPMP_PRESENT is not 1"
+#endif
+/* sPMP entries apply to user mode only when the U bit is set.  */
+#define TXM_MODULE_MANAGER_PMP_USER             SPMP_U
+#define TXM_MODULE_MANAGER_PMP_ADDR_SET(i, v)   __set_sPMPADDRx(i, v)
+#define TXM_MODULE_MANAGER_PMP_CFG_SET(i, v)    __set_sPMPxCFG(i, v)
+#else
+#if !defined(__PMP_PRESENT) || (__PMP_PRESENT != 1)
+#error "TXM_MODULE_MANAGER_PMP requires PMP, __PMP_PRESENT is not 1"
+#endif
+#define TXM_MODULE_MANAGER_PMP_USER             0
+#define TXM_MODULE_MANAGER_PMP_ADDR_SET(i, v)   __set_PMPADDRx(i, v)
+#define TXM_MODULE_MANAGER_PMP_CFG_SET(i, v)    __set_PMPxCFG(i, v)
+#endif
+
+#define TXM_MODULE_MANAGER_PMP_GRANULE          (((ALIGN_TYPE) 1) << TXM_MODULE_MANAGER_PMP_GRANULE_ORDER)
+
+extern VOID _txm_module_manager_trap_entry(VOID);
+
+/* Output section of _txm_module_manager_user_mode_entry, padded to whole PMP granules by
+   linker script such as gcc_evalsoc_ilm.ld, so no other kernel code is in it.  */
+extern UCHAR __txm_user_mode_entry_start[];
+extern UCHAR __txm_user_mode_entry_end[];
+
+/* Define the PMP entries currently programmed, and the module they are programmed for.
+   Kernel threads run in machine mode which is not restricted by unlocked entries, so the
+   entries are kept when kernel threads are switched in.  */
+
+static ALIGN_TYPE           _txm_module_manager_pmp_addr[TXM_MODULE_MANAGER_PMP_ENTRIES];
+static UCHAR                _txm_module_manager_pmp_cfg[TXM_MODULE_MANAGER_PMP_ENTRIES];
+static TXM_MODULE_INSTANCE  *_txm_module_manager_pmp_module;
+
+/* Define the kernel stack of the running user mode thread, the context is saved below it by
+   eclic_msip_handler and _txm_module_manager_trap_entry when trapped from user mode, and the
+   user sp is kept at it.  It is the kernel call stack of _txm_module_manager_user_mode_enter.  */
+ALIGN_TYPE                  _txm_module_manager_kernel_stack;
+
+
+/* Add a region to the PMP entries of the module, a naturally aligned power of 2 region
+   takes one NAPOT entry, others take two entries as TOR range.  Returns the next entry.  */
+static UINT  _txm_module_manager_pmp_region_add(TXM_MODULE_INSTANCE *module_instance, UINT index,
+                                                ALIGN_TYPE start, ALIGN_TYPE size, UCHAR protection)
+{
+ALIGN_TYPE  *addr = module_instance -> txm_module_instance_pmp_addr;
+UCHAR       *cfg = module_instance -> txm_module_instance_pmp_cfg;
+
+    protection = protection | TXM_MODULE_MANAGER_PMP_USER;
+    if (((size & (size - 1)) == 0) && ((start & (size - 1)) == 0) && (size >= 8))
+    {
+        if (index < TXM_MODULE_MANAGER_PMP_ENTRIES)
+        {
+            addr[index] =  (start >> PMP_SHIFT) | ((size - 1) >> (PMP_SHIFT + 1));
+            cfg[index] =   protection | PMP_A_NAPOT;
+            index++;
+        }
+    }
+    else if ((index + 1) < TXM_MODULE_MANAGER_PMP_ENTRIES)
+    {
+        /* The bottom of TOR range is the address of previous entry, which is off.  */
+        addr[index] =      start >> PMP_SHIFT;
+        cfg[index] =       0;
+        addr[index + 1] =  (start + size) >> PMP_SHIFT;
+        cfg[index + 1] =   protection | PMP_A_TOR;
+        index += 2;
+    }
+    return(index);
+}
+
+
 VOID  _txm_module_manager_mm_register_setup(TXM_MODULE_INSTANCE *module_instance)
 {
-#ifdef TXM_MODULE_MANAGER_PMP
 
+TX_INTERRUPT_SAVE_AREA
 
-#else
+ALIGN_TYPE  start;
+ALIGN_TYPE  end;
+ALIGN_TYPE  alloc_end;
+UINT        index;
 
+    /* Kernel calls and memory faults of user mode modules go through the module trap entry,
+       which is installed when the first user mode module is loaded.  */
+    if ((__RV_CSR_READ(CSR_MTVEC) & ~((rv_csr_t) 0x3F)) != (rv_csr_t) _txm_module_manager_trap_entry)
+    {
+        __RV_CSR_WRITE(CSR_MTVEC, ((rv_csr_t) _txm_module_manager_trap_entry) | (__RV_CSR_READ(CSR_MTVEC) & 0x3F));
+        _txm_module_manager_memory_fault_register();
+    }
 
-#endif
+    TX_DISABLE
+
+    TX_MEMSET(module_instance -> txm_module_instance_pmp_addr, 0, sizeof(module_instance -> txm_module_instance_pmp_addr));
+    TX_MEMSET(module_instance -> txm_module_instance_pmp_cfg, 0, sizeof(module_instance -> txm_module_instance_pmp_cfg));
+
+    /* The kernel call entry is the only kernel code executable in user mode.  */
+    index =  _txm_module_manager_pmp_region_add(module_instance, 0, (ALIGN_TYPE) __txm_user_mode_entry_start,
+                                                (ALIGN_TYPE) (__txm_user_mode_entry_end - __txm_user_mode_entry_start), PMP_R | PMP_X);
+
+    if (module_instance -> txm_module_instance_property_flags & TXM_MODULE_MEMORY_PROTECTION)
+    {
+        /* Code region is read only, so a GOT written by the module must be placed in module data.
+           It is never widened to whole granules over other memory, in place and absolute loaded
+           code must be granule aligned, see TXM_MODULE_MANAGER_CHECK_CODE_ALIGNMENT, and code
+           copied by the module manager may take the rest of its allocation.  */
+        start =  (ALIGN_TYPE) module_instance -> txm_module_instance_code_start;
+        end =    ((ALIGN_TYPE) module_instance -> txm_module_instance_code_end) + 1;
+        if ((end & (TXM_MODULE_MANAGER_PMP_GRANULE - 1)) && (module_instance -> txm_module_instance_code_allocation_ptr))
+        {
+            alloc_end =  ((ALIGN_TYPE) module_instance -> txm_module_instance_code_allocation_ptr) +
+                         module_instance -> txm_module_instance_code_allocation_size;
+            if (((end + TXM_MODULE_MANAGER_PMP_GRANULE - 1) & ~(TXM_MODULE_MANAGER_PMP_GRANULE - 1)) <= alloc_end)
+            {
+                end =  (end + TXM_MODULE_MANAGER_PMP_GRANULE - 1) & ~(TXM_MODULE_MANAGER_PMP_GRANULE - 1);
+            }
+        }
+        if (((start | end) & (TXM_MODULE_MANAGER_PMP_GRANULE - 1)) == 0)
+        {
+            index =  _txm_module_manager_pmp_region_add(module_instance, index, start, end - start, PMP_R | PMP_X);
+        }
+
+        /* Data region holds module data and stacks of all module threads.  */
+        start =  (ALIGN_TYPE) module_instance -> txm_module_instance_data_start;
+        end =    ((ALIGN_TYPE) module_instance -> txm_module_instance_data_end) + 1;
+        index =  _txm_module_manager_pmp_region_add(module_instance, index, start, end - start, PMP_R | PMP_W);
+
+        /* Shared memory enabled by _txm_module_manager_external_memory_enable.  */
+        if (module_instance -> txm_module_instance_shared_memory_length)
+        {
+            _txm_module_manager_pmp_region_add(module_instance, index,
+                                               (ALIGN_TYPE) module_instance -> txm_module_instance_shared_memory_address,
+                                               module_instance -> txm_module_instance_shared_memory_length,
+                                               (module_instance -> txm_module_instance_shared_memory_attributes & TXM_MODULE_MANAGER_SHARED_ATTRIBUTE_WRITE) ?
+                                               (PMP_R | PMP_W) : PMP_R);
+        }
+    }
+    else if (index < TXM_MODULE_MANAGER_PMP_ENTRIES)
+    {
+        /* No memory protection, the whole address space is accessible.  */
+        module_instance -> txm_module_instance_pmp_addr[index] =  ~((ALIGN_TYPE) 0);
+        module_instance -> txm_module_instance_pmp_cfg[index] =   PMP_R | PMP_W | PMP_X | PMP_A_NAPOT | TXM_MODULE_MANAGER_PMP_USER;
+    }
+
+    /* Entries are written again at next switch if the module is running.  */
+    if (_txm_module_manager_pmp_module == module_instance)
+    {
+        _txm_module_manager_pmp_module =  TX_NULL;
+    }
+
+    TX_RESTORE
 }
 
-#ifdef TXM_MODULE_MANAGER_PMP
-UINT _txm_module_manager_inside_data_check(TXM_MODULE_INSTANCE *module_instance, ALIGN_TYPE obj_ptr, UINT obj_size)
+
+VOID  _txm_module_manager_pmp_invalidate(TXM_MODULE_INSTANCE *module_instance)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    if (_txm_module_manager_pmp_module == module_instance)
+    {
+        _txm_module_manager_pmp_module =  TX_NULL;
+    }
+    TX_RESTORE
+}
+
+
+/* Called with interrupts disabled when thread_ptr is switched in.  */
+VOID  _txm_module_manager_pmp_switch(TX_THREAD *thread_ptr)
+{
+
+TXM_MODULE_INSTANCE *module_instance;
+UINT                i;
+
+    /* Machine mode threads are not restricted, keep the entries of last module.  */
+    if ((thread_ptr == TX_NULL) || (thread_ptr -> tx_thread_module_user_mode == 0))
+    {
+        return;
+    }
+
+    _txm_module_manager_kernel_stack =  (((ALIGN_TYPE) thread_ptr -> tx_thread_module_kernel_stack_end) & ~((ALIGN_TYPE) 15)) - 16;
+
+    module_instance =  (TXM_MODULE_INSTANCE *) thread_ptr -> tx_thread_module_instance_ptr;
+    if (module_instance == _txm_module_manager_pmp_module)
+    {
+        return;
+    }
+
+    /* Only write the entries different from the programmed ones, for modules loaded from the
+       same image, it is just the data region.  */
+    for (i = 0; i < TXM_MODULE_MANAGER_PMP_ENTRIES; i++)
+    {
+        if (module_instance -> txm_module_instance_pmp_addr[i] != _txm_module_manager_pmp_addr[i])
+        {
+            _txm_module_manager_pmp_addr[i] =  module_instance -> txm_module_instance_pmp_addr[i];
+            TXM_MODULE_MANAGER_PMP_ADDR_SET(TXM_MODULE_MANAGER_PMP_FIRST_ENTRY + i, _txm_module_manager_pmp_addr[i]);
+        }
+        if (module_instance -> txm_module_instance_pmp_cfg[i] != _txm_module_manager_pmp_cfg[i])
+        {
+            _txm_module_manager_pmp_cfg[i] =  module_instance -> txm_module_instance_pmp_cfg[i];
+            TXM_MODULE_MANAGER_PMP_CFG_SET(TXM_MODULE_MANAGER_PMP_FIRST_ENTRY + i, _txm_module_manager_pmp_cfg[i]);
+        }
+    }
+    _txm_module_manager_pmp_module =  module_instance;
+}
+
+
+UINT  _txm_module_manager_inside_data_check(TXM_MODULE_INSTANCE *module_instance, ALIGN_TYPE obj_ptr, UINT obj_size)
 {
 
-    return(TX_TRUE);
+ALIGN_TYPE  obj_end =  obj_ptr + obj_size;
+ALIGN_TYPE  shared_start;
+
+    /* Check for overflow.  */
+    if (obj_end < obj_ptr)
+    {
+        return(TX_FALSE);
+    }
+
+    /* Check if it's inside module data.  */
+    if ((obj_ptr >= (ALIGN_TYPE) module_instance -> txm_module_instance_data_start) &&
+        (obj_end <= ((ALIGN_TYPE) module_instance -> txm_module_instance_data_end) + 1))
+    {
+        return(TX_TRUE);
+    }
+
+    /* Check if it's inside writable shared memory.  */
+    shared_start =  (ALIGN_TYPE) module_instance -> txm_module_instance_shared_memory_address;
+    if ((module_instance -> txm_module_instance_shared_memory_attributes & TXM_MODULE_MANAGER_SHARED_ATTRIBUTE_WRITE) &&
+        (obj_ptr >= shared_start) &&
+        (obj_end <= shared_start + module_instance -> txm_module_instance_shared_memory_length))
+    {
+        return(TX_TRUE);
+    }
+
+    return(TX_FALSE);
 }
+
+#else
+
+VOID  _txm_module_manager_mm_register_setup(TXM_MODULE_INSTANCE *module_instance)
+{
+}
+
 #endif
@@ -29,6 +29,9 @@ VOID _txm_module_manager_thread_stack_build(TX_THREAD *thread_ptr, VOID (*functi
     struct thread_stack_frame *frame;
     TXM_MODULE_THREAD_ENTRY_INFO *thread_entry_info;
     uint8_t *stk;
+#ifdef TXM_MODULE_MANAGER_PMP
+    unsigned long user_sp;
+#endif
     int i;
 
     stk  = thread_ptr -> tx_thread_stack_end;
@@ -40,6 +43,15 @@ VOID _txm_module_manager_thread_stack_build(TX_THREAD *thread_ptr, VOID (*functi
     stk  = (uint8_t *)(((unsigned long)stk) & (~(unsigned long)(16 - 1)));
 #else
     stk  = (uint8_t *)(((unsigned long)stk) & (~(unsigned long)(4 - 1)));
+#endif
+#ifdef TXM_MODULE_MANAGER_PMP
+    /* Context of user mode threads is kept on the kernel stack, below the user sp,
+       the same as saved by eclic_msip_handler when interrupted in user mode.  */
+    if (thread_ptr -> tx_thread_module_user_mode) {
+        user_sp = (unsigned long)stk;
+        stk = (uint8_t *)((((unsigned long)thread_ptr -> tx_thread_module_kernel_stack_end) & (~(unsigned long)(16 - 1))) - 16);
+        *((unsigned long *)stk) = user_sp;
+    }
 #endif
     stk -= sizeof(struct thread_stack_frame);
 
@@ -54,6 +66,12 @@ VOID _txm_module_manager_thread_stack_build(TX_THREAD *thread_ptr, VOID (*functi
 
     frame->epc     = (unsigned long)function_ptr;
     frame->mstatus = THREAD_INITIAL_MSTATUS;
+#ifdef TXM_MODULE_MANAGER_PMP
+    /* Threads of user mode module start from shell entry in user mode */
+    if (thread_ptr -> tx_thread_module_user_mode) {
+        frame->mstatus &= ~MSTATUS_MPP;
+    }
+#endif
 
     thread_ptr -> tx_thread_stack_ptr = stk;
     __FENCE_I();
@@ -22,10 +22,58 @@
 #define TX_SOURCE_CODE
 
 #include "tx_api.h"
+#include "tx_thread.h"
 #include "txm_module.h"
 
-// TODO not applicable to current ThreadX Module implemented in M-Mode
+#ifdef TXM_MODULE_MANAGER_PMP
+
+/* Kernel call dispatcher of user mode modules, the module calls it as a function, and the ecall
+   is handled by _txm_module_manager_trap_entry, which calls _txm_module_manager_kernel_dispatch
+   on the kernel stack of the thread and returns to the caller of this function directly.
+   It is the only kernel code executable in user mode, so its section is placed in a dedicated
+   output section by linker script such as gcc_evalsoc_ilm.ld, which is padded to a whole PMP
+   granule, and only that output section is made executable for user mode.  */
+__attribute__((naked, used, aligned(1 << TXM_MODULE_MANAGER_PMP_GRANULE_ORDER), section(".text.txm_module_manager_user_mode_entry")))
+ALIGN_TYPE _txm_module_manager_user_mode_entry(ULONG kernel_request, ALIGN_TYPE param_1, ALIGN_TYPE param_2, ALIGN_TYPE param_3)
+{
+    __asm__ volatile("ecall\n"
+                     "ret\n");
+}
+
+/* Called by _txm_module_manager_trap_entry with interrupts disabled, save where to return in
+   user mode, and return the kernel stack of current thread.
+   The evalsoc GCC linker scripts only align the output section of the kernel call entry to
+   PMP granules when this symbol is defined.  */
+ALIGN_TYPE _txm_module_manager_user_mode_enter(ALIGN_TYPE user_sp, ALIGN_TYPE user_pc)
+{
+    TX_THREAD *thread_ptr = _tx_thread_current_ptr;
+
+    thread_ptr -> tx_thread_module_stack_ptr = (VOID *) user_sp;
+    thread_ptr -> tx_thread_module_saved_lr = user_pc;
+    thread_ptr -> tx_thread_module_current_user_mode = 0;
+    /* 16 bytes aligned for psABI, see _txm_module_manager_thread_stack_build */
+    return ((ALIGN_TYPE) thread_ptr -> tx_thread_module_kernel_stack_end) & ~((ALIGN_TYPE) 15);
+}
+
+/* Called by _txm_module_manager_kernel_call with interrupts disabled, return to user mode
+   by next mret, and return the user stack of current thread.  */
+ALIGN_TYPE _txm_module_manager_user_mode_exit(VOID)
+{
+    TX_THREAD *thread_ptr = _tx_thread_current_ptr;
+
+    thread_ptr -> tx_thread_module_current_user_mode = 1;
+    __RV_CSR_WRITE(CSR_MEPC, thread_ptr -> tx_thread_module_saved_lr);
+    __RV_CSR_CLEAR(CSR_MSTATUS, MSTATUS_MPP);
+    __RV_CSR_SET(CSR_MSTATUS, MSTATUS_MPIE);
+    return (ALIGN_TYPE) thread_ptr -> tx_thread_module_stack_ptr;
+}
+
+#else
+
+// Not applicable when modules run in M-Mode without TXM_MODULE_MANAGER_PMP
 ALIGN_TYPE _txm_module_manager_user_mode_entry(ULONG kernel_request, ALIGN_TYPE param_1, ALIGN_TYPE param_2, ALIGN_TYPE param_3)
 {
     return TX_NOT_AVAILABLE;
 }
+
+#endif
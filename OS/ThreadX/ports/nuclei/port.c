@@ -5,6 +5,10 @@
 
 #include "nuclei_sdk_soc.h"
 
+#ifdef TX_HW_STACK_TRACK
+#include <stdio.h>
+#endif
+
 #ifdef TX_REGRESSION_TEST
 /* External reference for regression test ISR dispatch. */
 extern void test_interrupt_dispatch(void);
@@ -15,14 +19,24 @@ extern void test_interrupt_dispatch(void);
 #define SYSTICK_TICK_CONST          (SOC_TIMER_FREQ / TX_TIMER_TICKS_PER_SECOND)
 #define KERNEL_INTERRUPT_PRIORITY   0
 
+#ifdef WITH_COMPONENT_HRTIMER
+// SysTimer interrupt is owned by hrtimer component, and the tick is one of its periodic timers
+#include "hrtimer_api.h"
+#else
 // MUST define SysTick_Handler as eclic_mtip_handler, which is registered in vector table
 #define SysTick_Handler     eclic_mtip_handler
+#endif
 
 /* This is the timer interrupt service routine. */
 void SysTick_Handler(void)
 {
+#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+    _tx_execution_isr_enter();
+#endif
+#ifndef WITH_COMPONENT_HRTIMER
     // Reload timer
     SysTick_Reload(SYSTICK_TICK_CONST);
+#endif
 
     /* Increment system clock. */
     _tx_timer_system_clock++;
@@ -70,8 +84,54 @@ void SysTick_Handler(void)
             _tx_thread_time_slice();
         }
     }
+#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+    _tx_execution_isr_exit();
+#endif
+}
+
+#ifdef TX_HW_STACK_TRACK
+#if !defined(CFG_HAS_STACK_CHECK)
+#error "TX_HW_STACK_TRACK requires stack check unit, CFG_HAS_STACK_CHECK is not defined"
+#endif
+/*
+ * CSR_MSTACK_BOUND follows the lowest sp, including the sp of interrupts
+ * running on the interrupt stack, so the hart stacks which are used as
+ * interrupt stacks must be above every thread stack, otherwise the bound
+ * of a thread is lowered into the interrupt stack, see _tx_thread_stack_build
+ */
+#ifndef __ICCRISCV__
+// __StackBottom is defined in linker script such as gcc_evalsoc_ilm.ld
+extern char __StackBottom[];
+#define PORT_INT_STACK_BOTTOM       ((uint8_t *)__StackBottom)
+#else
+// CSTACK$$Base is defined in iar linker script such as iar_evalsoc_ilm.icf
+extern char CSTACK$$Base[];
+#define PORT_INT_STACK_BOTTOM       ((uint8_t *)CSTACK$$Base)
+#endif
+
+/* Save lowest sp reached by thread, it must be the thread running on this core */
+static void PortStackTrackSave(TX_THREAD *thread_ptr)
+{
+    ULONG *bound = (ULONG *)__RV_CSR_READ(CSR_MSTACK_BOUND);
+
+    // bound below stack start means the stack overflowed
+    if (bound < (ULONG *)thread_ptr->tx_thread_stack_start) {
+        bound = (ULONG *)thread_ptr->tx_thread_stack_start;
+    }
+    if (bound < (ULONG *)thread_ptr->tx_thread_stack_highest_ptr) {
+        thread_ptr->tx_thread_stack_highest_ptr = bound;
+    }
 }
 
+/* Called by _tx_thread_stack_analyze with interrupt disabled */
+VOID _tx_port_stack_track_update(TX_THREAD *thread_ptr)
+{
+    if (thread_ptr == _tx_thread_current_ptr) {
+        PortStackTrackSave(thread_ptr);
+    }
+}
+#endif
+
 // Task Switch code called in eclic_msip_handler
 void PortThreadSwitch(void)
 {
@@ -94,6 +154,13 @@ void PortThreadSwitch(void)
     SysTimer_ClearSWIRQ();
     __RWMB();
 
+#ifdef TX_HW_STACK_TRACK
+    // context.S has switched to interrupt stack, bound still belongs to the switched out thread
+    if (_tx_thread_current_ptr) {
+        PortStackTrackSave(_tx_thread_current_ptr);
+    }
+#endif
+
     /*
      * Magic idle task emulation for threadx
      * ThreadX don't have idle task, so _tx_thread_execute_ptr could be NULL
@@ -133,6 +200,17 @@ void PortThreadSwitch(void)
     _tx_thread_current_ptr -> tx_thread_run_count++;
     /* Load the selected thread's current time-slice for SysTick accounting. */
     _tx_timer_time_slice =  _tx_thread_current_ptr -> tx_thread_time_slice;
+#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+    _tx_execution_thread_enter();
+#endif
+#ifdef TX_HW_STACK_TRACK
+    // Only interrupt stack is used until sp is switched to the new thread
+    __RV_CSR_WRITE(CSR_MSTACK_BOUND, (rv_csr_t)_tx_thread_current_ptr -> tx_thread_stack_highest_ptr);
+#endif
+#ifdef TXM_MODULE_MANAGER_PMP
+    // Only the PMP entries different from the running module are written
+    _txm_module_manager_pmp_switch(_tx_thread_current_ptr);
+#endif
     __RWMB();
 }
 
@@ -142,7 +220,11 @@ void SetupSysTickInterrupt(void)
 
     /* Make SWI and SysTick the lowest priority interrupts. */
     /* Stop and clear the SysTimer. SysTimer as Non-Vector Interrupt */
+#ifdef WITH_COMPONENT_HRTIMER
+    hrtimer_tick_config(ticks, SysTick_Handler);
+#else
     SysTick_Config(ticks);
+#endif
     ECLIC_DisableIRQ(SysTimer_IRQn);
     ECLIC_SetLevelIRQ(SysTimer_IRQn, KERNEL_INTERRUPT_PRIORITY);
     ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
@@ -172,6 +254,14 @@ VOID _tx_initialize_low_level(VOID)
 #if defined(ECLIC_HW_CTX_AUTO) && defined(CFG_HAS_ECLICV2)
     __RV_CSR_SET(CSR_MECLIC_CTL, MECLIC_CTL_TSP_EN);
 #endif
+#ifdef TX_HW_STACK_TRACK
+    // Stack check unit in track mode, _tx_thread_schedule starts the first thread
+    // without PortThreadSwitch, so start from the highest bound to follow its sp
+    __RV_CSR_CLEAR(CSR_MSTACK_CTRL, MSTACK_CTRL_OVF_TRACK_EN);
+    __RV_CSR_SET(CSR_MSTACK_CTRL, MSTACK_CTRL_MODE);
+    __RV_CSR_WRITE(CSR_MSTACK_BOUND, (rv_csr_t)(-1));
+    __RV_CSR_SET(CSR_MSTACK_CTRL, MSTACK_CTRL_OVF_TRACK_EN);
+#endif
 }
 
 UINT _tx_thread_interrupt_control(UINT new_posture)
@@ -232,6 +322,17 @@ VOID _tx_thread_stack_build(TX_THREAD *thread_ptr, VOID (*function_ptr)(VOID))
     int i;
 
     stk  = thread_ptr -> tx_thread_stack_end;
+#ifdef TX_HW_STACK_TRACK
+    // thread stack above interrupt stack can't be tracked, stop here
+    if ((uint8_t *)stk >= PORT_INT_STACK_BOTTOM) {
+        printf("thread %s stack %p is above interrupt stack %p\n", thread_ptr -> tx_thread_name,
+               (void *)stk, (void *)PORT_INT_STACK_BOTTOM);
+        __disable_irq();
+        while (1) {
+            __WFI();
+        }
+    }
+#endif
     /* https://github.com/riscv-non-isa/riscv-elf-psabi-doc/blob/master/riscv-cc.adoc */
     /* 32-bit boundary for ilp32e, and 128-bit boundary for others */
 #ifndef __riscv_32e
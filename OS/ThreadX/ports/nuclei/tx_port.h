@@ -143,8 +143,9 @@ typedef unsigned short                          USHORT;
 
 */
 
+/* Low 32 bits of mcycle, so the trace entries have real time stamps in cpu cycles */
 #ifndef TX_TRACE_TIME_SOURCE
-#define TX_TRACE_TIME_SOURCE                    ++_tx_trace_simulated_time
+#define TX_TRACE_TIME_SOURCE                    ((ULONG) __get_rv_cycle())
 #endif
 #ifndef TX_TRACE_TIME_MASK
 #define TX_TRACE_TIME_MASK                      0xFFFFFFFFUL
@@ -175,6 +176,28 @@ typedef unsigned short                          USHORT;
 #endif
 
 
+/* Determine whether or not hardware stack tracking is enabled. When TX_HW_STACK_TRACK is
+   defined, the stack check unit runs in track mode, the lowest stack pointer reached by a
+   thread is saved to tx_thread_stack_highest_ptr when the thread is switched out, and
+   _tx_thread_stack_analyze returns it without searching the stack fill pattern.  */
+
+#ifdef TX_HW_STACK_TRACK
+struct TX_THREAD_STRUCT;
+VOID    _tx_port_stack_track_update(struct TX_THREAD_STRUCT *thread_ptr);
+#define TX_PORT_STACK_TRACK_UPDATE(thread_ptr)      _tx_port_stack_track_update(thread_ptr);
+#endif
+
+
+/* Determine whether or not user mode modules are isolated by PMP. When TXM_MODULE_MANAGER_PMP
+   is defined, the PMP entries of the module are programmed when a thread of a user mode module
+   is switched in.  */
+
+#ifdef TXM_MODULE_MANAGER_PMP
+struct TX_THREAD_STRUCT;
+VOID    _txm_module_manager_pmp_switch(struct TX_THREAD_STRUCT *thread_ptr);
+#endif
+
+
 
 /* Define the TX_THREAD control block extensions for this port. The main reason
    for the multiple macros is so that backward compatibility can be maintained with
@@ -219,6 +242,14 @@ typedef unsigned short                          USHORT;
                                         unsigned long long  tx_thread_execution_time_last_start;
 #endif
 
+/* Execution change notification, called by port when thread is switched and timer interrupt is serviced */
+#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+VOID    _tx_execution_thread_enter(VOID);
+VOID    _tx_execution_thread_exit(VOID);
+VOID    _tx_execution_isr_enter(VOID);
+VOID    _tx_execution_isr_exit(VOID);
+#endif
+
 
 /* Define the port extensions of the remaining ThreadX objects.  */
 
@@ -155,7 +155,11 @@ The following extensions must also be defined in tx_port.h:
 
 /* Define the supported options for this module.   */
 
+#ifdef TXM_MODULE_MANAGER_PMP
+#define TXM_MODULE_MANAGER_SUPPORTED_OPTIONS    (TXM_MODULE_USER_MODE | TXM_MODULE_MEMORY_PROTECTION | TXM_MODULE_SHARED_EXTERNAL_MEMORY_ACCESS)
+#else
 #define TXM_MODULE_MANAGER_SUPPORTED_OPTIONS    (0)
+#endif
 #define TXM_MODULE_MANAGER_REQUIRED_OPTIONS     0
 
 
@@ -183,10 +187,34 @@ The following extensions must also be defined in tx_port.h:
 
 #ifdef TXM_MODULE_MANAGER_PMP
 
+/* User mode modules are isolated by PMP entries, or by sPMP entries when TXM_MODULE_MANAGER_SPMP
+   is also defined, the entries from TXM_MODULE_MANAGER_PMP_FIRST_ENTRY are reserved for modules.
+   The entries of each module are computed when it is loaded, and only the entries different from
+   the running module are written when a thread of another module is switched in.  */
+
+#ifndef TXM_MODULE_MANAGER_PMP_FIRST_ENTRY
+#define TXM_MODULE_MANAGER_PMP_FIRST_ENTRY      0
+#endif
+
+/* One entry for the kernel call entry, code and data region take one entry when they are
+   naturally aligned power of 2 size, otherwise two, and one for the shared memory.  */
+#ifndef TXM_MODULE_MANAGER_PMP_ENTRIES
+#define TXM_MODULE_MANAGER_PMP_ENTRIES          6
+#endif
+
+/* Define the PMP granularity as power of 2, it is 4KB for most Nuclei cores.  */
+#ifndef TXM_MODULE_MANAGER_PMP_GRANULE_ORDER
+#define TXM_MODULE_MANAGER_PMP_GRANULE_ORDER    12
+#endif
 
 /* Define the port-extensions to the module manager instance structure.  */
 
-#define TXM_MODULE_MANAGER_PORT_EXTENSION
+#define TXM_MODULE_MANAGER_PORT_EXTENSION                                                   \
+    ALIGN_TYPE          txm_module_instance_pmp_addr[TXM_MODULE_MANAGER_PMP_ENTRIES];       \
+    UCHAR               txm_module_instance_pmp_cfg[TXM_MODULE_MANAGER_PMP_ENTRIES];        \
+    VOID                *txm_module_instance_shared_memory_address;                         \
+    ULONG               txm_module_instance_shared_memory_length;                           \
+    UINT                txm_module_instance_shared_memory_attributes;
 
 #else   /* TXM_MODULE_MANAGER_PMP is not defined */
 
@@ -203,40 +231,37 @@ typedef struct TXM_MODULE_MANAGER_MEMORY_FAULT_INFO_STRUCT
 {
     TX_THREAD           *txm_module_manager_memory_fault_info_thread_ptr;
     VOID                *txm_module_manager_memory_fault_info_code_location;
-    ULONG               txm_module_manager_memory_fault_info_shcsr;
-    ULONG               txm_module_manager_memory_fault_info_cfsr;
-    ULONG               txm_module_manager_memory_fault_info_mmfar;
-    ULONG               txm_module_manager_memory_fault_info_bfar;
-    ULONG               txm_module_manager_memory_fault_info_control;
+    ULONG               txm_module_manager_memory_fault_info_mcause;
+    ULONG               txm_module_manager_memory_fault_info_mtval;
     ULONG               txm_module_manager_memory_fault_info_sp;
-    ULONG               txm_module_manager_memory_fault_info_r0;
-    ULONG               txm_module_manager_memory_fault_info_r1;
-    ULONG               txm_module_manager_memory_fault_info_r2;
-    ULONG               txm_module_manager_memory_fault_info_r3;
-    ULONG               txm_module_manager_memory_fault_info_r4;
-    ULONG               txm_module_manager_memory_fault_info_r5;
-    ULONG               txm_module_manager_memory_fault_info_r6;
-    ULONG               txm_module_manager_memory_fault_info_r7;
-    ULONG               txm_module_manager_memory_fault_info_r8;
-    ULONG               txm_module_manager_memory_fault_info_r9;
-    ULONG               txm_module_manager_memory_fault_info_r10;
-    ULONG               txm_module_manager_memory_fault_info_r11;
-    ULONG               txm_module_manager_memory_fault_info_r12;
-    ULONG               txm_module_manager_memory_fault_info_lr;
-    ULONG               txm_module_manager_memory_fault_info_xpsr;
+    ULONG               txm_module_manager_memory_fault_info_ra;
+    ULONG               txm_module_manager_memory_fault_info_a0;
+    ULONG               txm_module_manager_memory_fault_info_a1;
+    ULONG               txm_module_manager_memory_fault_info_a2;
+    ULONG               txm_module_manager_memory_fault_info_a3;
 } TXM_MODULE_MANAGER_MEMORY_FAULT_INFO;
 
 
 #define TXM_MODULE_MANAGER_FAULT_INFO                                               \
     TXM_MODULE_MANAGER_MEMORY_FAULT_INFO    _txm_module_manager_memory_fault_info;
 
-/* Define the macro to check the code alignment.  */
+/* Define the macro to check the code alignment.  With TXM_MODULE_MANAGER_PMP, the code size
+   must be whole PMP granules too, since the code region is not widened over other memory.  */
+
+#ifdef TXM_MODULE_MANAGER_PMP
+#define TXM_MODULE_MANAGER_CHECK_CODE_SIZE(temp)                                    \
+        temp =  temp | (module_preamble -> txm_module_preamble_code_size &          \
+                        ((((ULONG) 1) << TXM_MODULE_MANAGER_PMP_GRANULE_ORDER) - 1));
+#else
+#define TXM_MODULE_MANAGER_CHECK_CODE_SIZE(temp)
+#endif
 
 #define TXM_MODULE_MANAGER_CHECK_CODE_ALIGNMENT(module_location, code_alignment)    \
     {                                                                               \
         ULONG   temp;                                                               \
         temp =  (ULONG) module_location;                                            \
         temp =  temp & (code_alignment - 1);                                        \
+        TXM_MODULE_MANAGER_CHECK_CODE_SIZE(temp)                                    \
         if (temp)                                                                   \
         {                                                                           \
             _tx_mutex_put(&_txm_module_manager_mutex);                              \
@@ -272,7 +297,6 @@ typedef struct TXM_MODULE_MANAGER_MEMORY_FAULT_INFO_STRUCT
 /* Define the macro to populate the thread control block with module port-specific information.
    Check if the module is in user mode and set up txm_module_thread_entry_info_kernel_call_dispatcher accordingly.
 */
-// TODO only M-mode execution is supported now
 #define TXM_MODULE_MANAGER_THREAD_SETUP(thread_ptr, module_instance)                                                                    \
     thread_ptr -> tx_thread_module_current_user_mode =  module_instance -> txm_module_instance_property_flags & TXM_MODULE_USER_MODE;   \
     thread_ptr -> tx_thread_module_user_mode =          module_instance -> txm_module_instance_property_flags & TXM_MODULE_USER_MODE;   \
@@ -287,8 +311,16 @@ typedef struct TXM_MODULE_MANAGER_MEMORY_FAULT_INFO_STRUCT
 
 
 /* Define the macro to populate the module control block with module port-specific information.
-   If memory protection is enabled, set up the MPU registers.
+   If memory protection is enabled, set up the PMP entries, user mode modules without memory
+   protection get an entry for the whole address space.
 */
+#ifdef TXM_MODULE_MANAGER_PMP
+#define TXM_MODULE_MANAGER_MODULE_SETUP(module_instance)                                            \
+    if (module_instance -> txm_module_instance_property_flags & TXM_MODULE_USER_MODE)               \
+    {                                                                                               \
+        _txm_module_manager_mm_register_setup(module_instance);                                     \
+    }
+#else
 #define TXM_MODULE_MANAGER_MODULE_SETUP(module_instance)                                            \
     if (module_instance -> txm_module_instance_property_flags & TXM_MODULE_USER_MODE)               \
     {                                                                                               \
@@ -301,16 +333,21 @@ typedef struct TXM_MODULE_MANAGER_MEMORY_FAULT_INFO_STRUCT
     {                                                                                               \
         /* Do nothing.  */                                                                          \
     }
+#endif
 
 /* Define the macro to perform port-specific functions when unloading the module.  */
+#ifdef TXM_MODULE_MANAGER_PMP
+/* Forget the PMP entries of the module if they are programmed.  */
+#define TXM_MODULE_MANAGER_MODULE_UNLOAD(module_instance)       _txm_module_manager_pmp_invalidate(module_instance);
+#else
 /* Nothing needs to be done for this port.  */
 #define TXM_MODULE_MANAGER_MODULE_UNLOAD(module_instance)
+#endif
 
 
 /* Define the macros to perform port-specific checks when passing pointers to the kernel.  */
 
 /* Define macro to make sure object is inside the module's data.  */
-/* TODO: TXM_MODULE_MANAGER_PMP is not implemented */
 #ifdef TXM_MODULE_MANAGER_PMP
 #define TXM_MODULE_MANAGER_CHECK_INSIDE_DATA(module_instance, obj_ptr, obj_size) \
     _txm_module_manager_inside_data_check(module_instance, obj_ptr, obj_size)
@@ -335,7 +372,10 @@ VOID  _txm_module_manager_alignment_adjust(TXM_MODULE_PREAMBLE *module_preamble,
 VOID  _txm_module_manager_memory_fault_handler(VOID);                                                                           \
 UINT  _txm_module_manager_memory_fault_notify(VOID (*notify_function)(TX_THREAD *, TXM_MODULE_INSTANCE *));                     \
 VOID  _txm_module_manager_mm_register_setup(TXM_MODULE_INSTANCE *module_instance);                                              \
-UINT  _txm_module_manager_inside_data_check(TXM_MODULE_INSTANCE *module_instance, ALIGN_TYPE obj_ptr, UINT obj_size);
+UINT  _txm_module_manager_inside_data_check(TXM_MODULE_INSTANCE *module_instance, ALIGN_TYPE obj_ptr, UINT obj_size);   \
+VOID  _txm_module_manager_pmp_invalidate(TXM_MODULE_INSTANCE *module_instance);                                              \
+VOID  _txm_module_manager_memory_fault_register(VOID);                                                                          \
+VOID  _txm_module_manager_memory_fault_exception(unsigned long mcause, unsigned long sp);
 
 #define TXM_MODULE_MANAGER_VERSION_ID   \
 CHAR                            _txm_module_manager_version_id[] =  \
@@ -8,6 +8,10 @@
 
 #include "nuclei_sdk_soc.h"
 
+#if defined(TX_THREAD_SMP_ENABLE_PROTECT_STAT) || defined(TX_HW_STACK_TRACK)
+#include <stdio.h>
+#endif
+
 #ifdef TX_REGRESSION_TEST
 /* External reference for regression test ISR dispatch. */
 extern void test_interrupt_dispatch(void);
@@ -18,14 +22,22 @@ extern void test_interrupt_dispatch(void);
 #define SYSTICK_TICK_CONST          (SOC_TIMER_FREQ / TX_TIMER_TICKS_PER_SECOND)
 #define KERNEL_INTERRUPT_PRIORITY   0
 
+#ifdef WITH_COMPONENT_HRTIMER
+// SysTimer interrupt is owned by hrtimer component, and the tick is one of its periodic timers
+#include "hrtimer_api.h"
+#else
 // MUST define SysTick_Handler as eclic_mtip_handler, which is registered in vector table
 #define SysTick_Handler     eclic_mtip_handler
+#endif
 
 /* This is the timer interrupt service routine. */
 void SysTick_Handler(void)
 {
     UINT saved_posture;
 
+#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+    _tx_execution_isr_enter();
+#endif
     /* Get the protection.  */
     saved_posture = _tx_thread_smp_protect();
 
@@ -37,8 +49,10 @@ void SysTick_Handler(void)
     test_interrupt_dispatch();
 #endif
 
+#ifndef WITH_COMPONENT_HRTIMER
     // Reload timer
     SysTick_Reload(SYSTICK_TICK_CONST);
+#endif
 
     /* Increment system clock. */
     _tx_timer_system_clock++;
@@ -68,8 +82,55 @@ void SysTick_Handler(void)
     _tx_timer_interrupt_active --;
     /* Release the protection.  */
     _tx_thread_smp_unprotect(saved_posture);
+#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+    _tx_execution_isr_exit();
+#endif
+}
+
+#ifdef TX_HW_STACK_TRACK
+#if !defined(CFG_HAS_STACK_CHECK)
+#error "TX_HW_STACK_TRACK requires stack check unit, CFG_HAS_STACK_CHECK is not defined"
+#endif
+/*
+ * CSR_MSTACK_BOUND follows the lowest sp, including the sp of interrupts
+ * running on the interrupt stack, so the hart stacks which are used as
+ * interrupt stacks must be above every thread stack, otherwise the bound
+ * of a thread is lowered into the interrupt stack, see _tx_thread_stack_build
+ */
+#ifndef __ICCRISCV__
+// __StackBottom is defined in linker script such as gcc_evalsoc_ilm.ld
+extern char __StackBottom[];
+#define PORT_INT_STACK_BOTTOM       ((uint8_t *)__StackBottom)
+#else
+// CSTACK$$Base is defined in iar linker script such as iar_evalsoc_ilm.icf
+extern char CSTACK$$Base[];
+#define PORT_INT_STACK_BOTTOM       ((uint8_t *)CSTACK$$Base)
+#endif
+
+/* Save lowest sp reached by thread, it must be the thread running on this core */
+static void PortStackTrackSave(TX_THREAD *thread_ptr)
+{
+    ULONG *bound = (ULONG *)__RV_CSR_READ(CSR_MSTACK_BOUND);
+
+    // bound below stack start means the stack overflowed
+    if (bound < (ULONG *)thread_ptr->tx_thread_stack_start) {
+        bound = (ULONG *)thread_ptr->tx_thread_stack_start;
+    }
+    if (bound < (ULONG *)thread_ptr->tx_thread_stack_highest_ptr) {
+        thread_ptr->tx_thread_stack_highest_ptr = bound;
+    }
 }
 
+/* Called by _tx_thread_stack_analyze with interrupt disabled, threads
+ * running on other cores are updated when they are switched out */
+VOID _tx_port_stack_track_update(TX_THREAD *thread_ptr)
+{
+    if (thread_ptr == _tx_thread_current_ptr[_tx_thread_smp_core_get()]) {
+        PortStackTrackSave(thread_ptr);
+    }
+}
+#endif
+
 /* Find a runnable thread for this core and optionally publish it as current. */
 TX_THREAD* _tx_find_ready_thread(UINT set_current)
 {
@@ -95,6 +156,13 @@ TX_THREAD* _tx_find_ready_thread(UINT set_current)
     if (set_current) {
         /* First-thread restore needs to populate _tx_thread_current_ptr here. */
         _tx_thread_current_ptr[coreid] = rdy_thread;
+#ifdef TX_HW_STACK_TRACK
+        // Stack check unit of this core in track mode, start from bound of the first thread
+        __RV_CSR_CLEAR(CSR_MSTACK_CTRL, MSTACK_CTRL_OVF_TRACK_EN);
+        __RV_CSR_SET(CSR_MSTACK_CTRL, MSTACK_CTRL_MODE);
+        __RV_CSR_WRITE(CSR_MSTACK_BOUND, (rv_csr_t)rdy_thread->tx_thread_stack_highest_ptr);
+        __RV_CSR_SET(CSR_MSTACK_CTRL, MSTACK_CTRL_OVF_TRACK_EN);
+#endif
     }
     __RWMB();
     return rdy_thread;
@@ -136,6 +204,10 @@ void PortThreadSwitch(void)
         _tx_timer_time_slice[coreid] =  0;
     }
     if (_tx_thread_current_ptr[coreid]) {
+#ifdef TX_HW_STACK_TRACK
+        // context.S has switched to interrupt stack, bound still belongs to the switched out thread
+        PortStackTrackSave(_tx_thread_current_ptr[coreid]);
+#endif
         /* Current thread context is saved, ready for scheduling */
         _tx_thread_current_ptr[coreid] -> tx_thread_smp_core_control = 1;
         _tx_thread_current_ptr[coreid] =  TX_NULL;
@@ -181,6 +253,13 @@ void PortThreadSwitch(void)
     rdy_thread -> tx_thread_run_count ++;
     /* Setup time-slice, if present.  */
     _tx_timer_time_slice[coreid] =  rdy_thread -> tx_thread_time_slice;
+#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+    _tx_execution_thread_enter();
+#endif
+#ifdef TX_HW_STACK_TRACK
+    // Only interrupt stack is used until sp is switched to the new thread
+    __RV_CSR_WRITE(CSR_MSTACK_BOUND, (rv_csr_t)rdy_thread -> tx_thread_stack_highest_ptr);
+#endif
     __RWMB();
 }
 
@@ -191,7 +270,11 @@ void SetupSysTickInterrupt(void)
     if (_tx_thread_smp_core_get() == 0) {
         /* Make SWI and SysTick the lowest priority interrupts. */
         /* Stop and clear the SysTimer. SysTimer as Non-Vector Interrupt */
+#ifdef WITH_COMPONENT_HRTIMER
+        hrtimer_tick_config(ticks, SysTick_Handler);
+#else
         SysTick_Config(ticks);
+#endif
         ECLIC_DisableIRQ(SysTimer_IRQn);
         ECLIC_SetLevelIRQ(SysTimer_IRQn, KERNEL_INTERRUPT_PRIORITY);
         ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
@@ -233,6 +316,61 @@ UINT _tx_thread_interrupt_control(UINT new_posture)
     return (UINT)temp;
 }
 
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+/* Per-core SMP protection statistics, only updated by the core owning the protection. */
+static TX_THREAD_SMP_PROTECT_STAT _tx_thread_smp_protect_stat[TX_THREAD_SMP_MAX_CORES];
+/* Cycle stamp and caller PC of the ongoing hold, kept apart from the statistics
+   so that a reset done while holding the protection doesn't lose them. */
+static unsigned long _tx_thread_smp_protect_hold_start[TX_THREAD_SMP_MAX_CORES];
+static ULONG _tx_thread_smp_protect_hold_pc[TX_THREAD_SMP_MAX_CORES];
+
+static inline UINT _tx_thread_smp_protect_stat_bucket(unsigned long cycles)
+{
+    UINT bucket = 0;
+
+    while ((cycles >>= 1) != 0) {
+        if (++bucket == (TX_THREAD_SMP_PROTECT_STAT_BUCKETS - 1)) {
+            break;
+        }
+    }
+    return bucket;
+}
+
+/* Called right after the ticket is owned, spin_start is sampled before taking a ticket. */
+static inline void _tx_thread_smp_protect_stat_acquired(UINT core_id, unsigned long spin_start, UINT spun, ULONG pc)
+{
+    TX_THREAD_SMP_PROTECT_STAT *stat = &_tx_thread_smp_protect_stat[core_id];
+    unsigned long now = __read_cycle_csr();
+    unsigned long spin = now - spin_start;
+
+    stat->tx_thread_smp_protect_stat_acquires ++;
+    if (spun) {
+        stat->tx_thread_smp_protect_stat_contended ++;
+    }
+    stat->tx_thread_smp_protect_stat_spin_cycles += spin;
+    if (spin > stat->tx_thread_smp_protect_stat_max_spin) {
+        stat->tx_thread_smp_protect_stat_max_spin = spin;
+    }
+    stat->tx_thread_smp_protect_stat_spin_hist[_tx_thread_smp_protect_stat_bucket(spin)] ++;
+    _tx_thread_smp_protect_hold_pc[core_id] = pc;
+    _tx_thread_smp_protect_hold_start[core_id] = now;
+}
+
+/* Called right before the ticket is handed to the next core. */
+static inline void _tx_thread_smp_protect_stat_release(UINT core_id)
+{
+    TX_THREAD_SMP_PROTECT_STAT *stat = &_tx_thread_smp_protect_stat[core_id];
+    unsigned long hold = __read_cycle_csr() - _tx_thread_smp_protect_hold_start[core_id];
+
+    stat->tx_thread_smp_protect_stat_hold_cycles += hold;
+    if (hold > stat->tx_thread_smp_protect_stat_max_hold) {
+        stat->tx_thread_smp_protect_stat_max_hold = hold;
+        stat->tx_thread_smp_protect_stat_max_hold_pc = _tx_thread_smp_protect_hold_pc[core_id];
+    }
+    stat->tx_thread_smp_protect_stat_hold_hist[_tx_thread_smp_protect_stat_bucket(hold)] ++;
+}
+#endif
+
 /*    This function forcefully releases previously obtained protection, regardless of the protection count. */
 /*    The supplied previous interrupt posture is restored.                                                  */
 void _tx_thread_smp_force_unprotect(UINT new_interrupt_posture)
@@ -243,6 +381,9 @@ void _tx_thread_smp_force_unprotect(UINT new_interrupt_posture)
     core_id = _tx_thread_smp_core_get();
     if (_tx_thread_smp_protection.tx_thread_smp_protect_core == core_id) {
         _tx_thread_smp_protection.tx_thread_smp_protect_count = 0;
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+        _tx_thread_smp_protect_stat_release(core_id);
+#endif
         /* Publish the owner-clear state before handing the ticket to the
            next hart. Otherwise ticket_owner can become visible first, let the
            successor publish itself as owner, and then have this delayed clear
@@ -374,6 +515,10 @@ UINT _tx_thread_smp_protect(void)
     UINT old_posture;
     UINT core_id;
     UINT my_ticket;
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+    unsigned long spin_start;
+    UINT spun = 0;
+#endif
 
     old_posture = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE) & MSTATUS_MIE;
     core_id = _tx_thread_smp_core_get();
@@ -383,14 +528,23 @@ UINT _tx_thread_smp_protect(void)
         return old_posture;
     }
 
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+    spin_start = __read_cycle_csr();
+#endif
     my_ticket = (UINT)__AMOADD_W((volatile int32_t *)&(_tx_thread_smp_protection.tx_thread_smp_protect_ticket_next), 1);
 
     while (_tx_thread_smp_protection.tx_thread_smp_protect_ticket_owner != my_ticket) {
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+        spun = 1;
+#endif
         __NOP();
     }
 
     _tx_thread_smp_protection.tx_thread_smp_protect_core = core_id;
     _tx_thread_smp_protection.tx_thread_smp_protect_count = 1;
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+    _tx_thread_smp_protect_stat_acquired(core_id, spin_start, spun, (ULONG)__builtin_return_address(0));
+#endif
     __RWMB();   /* mem-barrier    */
     return old_posture;
 }
@@ -408,6 +562,9 @@ void _tx_thread_smp_unprotect(UINT new_interrupt_posture)
             _tx_thread_smp_protection.tx_thread_smp_protect_count --;
         }
         if ((_tx_thread_smp_protection.tx_thread_smp_protect_count == 0) && (_tx_thread_preempt_disable == 0)) {
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+            _tx_thread_smp_protect_stat_release(core_id);
+#endif
             /* Publish the owner-clear state before advancing the ticket.
                Otherwise another hart can observe ticket_owner first, acquire
                the lock, and then get its protect_core update overwritten by
@@ -422,6 +579,64 @@ void _tx_thread_smp_unprotect(UINT new_interrupt_posture)
     __RWMB();
 }
 
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+/*    This function copies the SMP protection statistics of one core. The  */
+/*    copy is taken while owning the protection, so it is consistent.      */
+UINT _tx_thread_smp_protect_stat_get(UINT core, TX_THREAD_SMP_PROTECT_STAT *stat)
+{
+    UINT saved_posture;
+
+    if ((core >= TX_THREAD_SMP_MAX_CORES) || (stat == TX_NULL)) {
+        return TX_PTR_ERROR;
+    }
+    saved_posture = _tx_thread_smp_protect();
+    *stat = _tx_thread_smp_protect_stat[core];
+    _tx_thread_smp_unprotect(saved_posture);
+    return TX_SUCCESS;
+}
+
+/*    This function clears the SMP protection statistics of all cores.     */
+void _tx_thread_smp_protect_stat_reset(void)
+{
+    UINT saved_posture;
+
+    saved_posture = _tx_thread_smp_protect();
+    memset(_tx_thread_smp_protect_stat, 0, sizeof(_tx_thread_smp_protect_stat));
+    _tx_thread_smp_unprotect(saved_posture);
+}
+
+/*    This function prints the SMP protection statistics of all cores.     */
+/*    Printing is done outside the protection from a snapshot.             */
+void _tx_thread_smp_protect_stat_dump(void)
+{
+    static TX_THREAD_SMP_PROTECT_STAT snapshot;
+    TX_THREAD_SMP_PROTECT_STAT *stat = &snapshot;
+    UINT core, i;
+
+    printf("ThreadX SMP protection statistics, in cycles\n");
+    for (core = 0; core < TX_THREAD_SMP_MAX_CORES; core ++) {
+        _tx_thread_smp_protect_stat_get(core, stat);
+        printf("CSV, smp_protect_core%u_acquires, %lu\n", core, stat->tx_thread_smp_protect_stat_acquires);
+        printf("CSV, smp_protect_core%u_contended, %lu\n", core, stat->tx_thread_smp_protect_stat_contended);
+        printf("CSV, smp_protect_core%u_spin_cycles, %llu\n", core, stat->tx_thread_smp_protect_stat_spin_cycles);
+        printf("CSV, smp_protect_core%u_hold_cycles, %llu\n", core, stat->tx_thread_smp_protect_stat_hold_cycles);
+        printf("CSV, smp_protect_core%u_max_spin, %lu\n", core, stat->tx_thread_smp_protect_stat_max_spin);
+        printf("CSV, smp_protect_core%u_max_hold, %lu\n", core, stat->tx_thread_smp_protect_stat_max_hold);
+        printf("smp_protect core%u max hold caller pc: 0x%lx\n", core, stat->tx_thread_smp_protect_stat_max_hold_pc);
+        /* bucket n counts [2^n, 2^(n+1)) cycles */
+        printf("smp_protect core%u spin histogram:", core);
+        for (i = 0; i < TX_THREAD_SMP_PROTECT_STAT_BUCKETS; i ++) {
+            printf(" %lu", stat->tx_thread_smp_protect_stat_spin_hist[i]);
+        }
+        printf("\nsmp_protect core%u hold histogram:", core);
+        for (i = 0; i < TX_THREAD_SMP_PROTECT_STAT_BUCKETS; i ++) {
+            printf(" %lu", stat->tx_thread_smp_protect_stat_hold_hist[i]);
+        }
+        printf("\n");
+    }
+}
+#endif
+
 /*    This function gets the global time value that is used for debug     */
 /*    information and event tracing.                                      */
 ULONG _tx_thread_smp_time_get(void)
@@ -536,6 +751,17 @@ VOID _tx_thread_stack_build(TX_THREAD *thread_ptr, VOID (*function_ptr)(VOID))
     int i;
 
     stk  = thread_ptr -> tx_thread_stack_end;
+#ifdef TX_HW_STACK_TRACK
+    // thread stack above interrupt stack can't be tracked, stop here
+    if ((uint8_t *)stk >= PORT_INT_STACK_BOTTOM) {
+        printf("thread %s stack %p is above interrupt stack %p\n", thread_ptr -> tx_thread_name,
+               (void *)stk, (void *)PORT_INT_STACK_BOTTOM);
+        __disable_irq();
+        while (1) {
+            __WFI();
+        }
+    }
+#endif
     /* https://github.com/riscv-non-isa/riscv-elf-psabi-doc/blob/master/riscv-cc.adoc */
     /* 32-bit boundary for ilp32e, and 128-bit boundary for others */
 #ifndef __riscv_32e
@@ -346,8 +346,9 @@ extern void             delete_timer_thread(void);
 
 */
 
+/* Low 32 bits of mcycle, so the trace entries have real time stamps in cpu cycles */
 #ifndef TX_TRACE_TIME_SOURCE
-#define TX_TRACE_TIME_SOURCE                    ++_tx_trace_simulated_time
+#define TX_TRACE_TIME_SOURCE                    ((ULONG) __get_rv_cycle())
 #endif
 #ifndef TX_TRACE_TIME_MASK
 #define TX_TRACE_TIME_MASK                      0xFFFFFFFFUL
@@ -378,6 +379,18 @@ extern void             delete_timer_thread(void);
 #endif
 
 
+/* Determine whether or not hardware stack tracking is enabled. When TX_HW_STACK_TRACK is
+   defined, the stack check unit runs in track mode, the lowest stack pointer reached by a
+   thread is saved to tx_thread_stack_highest_ptr when the thread is switched out, and
+   _tx_thread_stack_analyze returns it without searching the stack fill pattern.  */
+
+#ifdef TX_HW_STACK_TRACK
+struct TX_THREAD_STRUCT;
+VOID    _tx_port_stack_track_update(struct TX_THREAD_STRUCT *thread_ptr);
+#define TX_PORT_STACK_TRACK_UPDATE(thread_ptr)      _tx_port_stack_track_update(thread_ptr);
+#endif
+
+
 
 /* Define the TX_THREAD control block extensions for this port. The main reason
    for the multiple macros is so that backward compatibility can be maintained with
@@ -422,6 +435,14 @@ extern void             delete_timer_thread(void);
                                         unsigned long long  tx_thread_execution_time_last_start;
 #endif
 
+/* Execution change notification, called by port when thread is switched and timer interrupt is serviced */
+#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+VOID    _tx_execution_thread_enter(VOID);
+VOID    _tx_execution_thread_exit(VOID);
+VOID    _tx_execution_isr_enter(VOID);
+VOID    _tx_execution_isr_exit(VOID);
+#endif
+
 
 /* Define the port extensions of the remaining ThreadX objects.  */
 
@@ -500,6 +521,44 @@ typedef struct TX_THREAD_SMP_PROTECT_STRUCT
 extern void _tx_thread_smp_unprotect(UINT interrupt_save);
 extern UINT _tx_thread_smp_protect(void);
 
+
+/* Determine if the SMP protection lock statistics should be gathered. By default, this is
+   disabled and costs nothing. When TX_THREAD_SMP_ENABLE_PROTECT_STAT is defined, each core records
+   how often it takes the protection, how many cycles it spins waiting for its ticket and how
+   many cycles it holds the protection, together with log2 histograms of both and the caller
+   PC of the longest hold. All statistic updates are done while the protection is owned.  */
+
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+
+/* Define the number of log2 histogram buckets, bucket n counts cycles in [2^n, 2^(n+1)),
+   and the last bucket collects everything above.  */
+
+#ifndef TX_THREAD_SMP_PROTECT_STAT_BUCKETS
+#define TX_THREAD_SMP_PROTECT_STAT_BUCKETS      16
+#endif
+
+typedef struct TX_THREAD_SMP_PROTECT_STAT_STRUCT
+{
+    ULONG   tx_thread_smp_protect_stat_acquires;        /* Outermost protect count          */
+    ULONG   tx_thread_smp_protect_stat_contended;       /* Acquires that had to spin        */
+    ULONG64 tx_thread_smp_protect_stat_spin_cycles;     /* Total cycles spent spinning      */
+    ULONG64 tx_thread_smp_protect_stat_hold_cycles;     /* Total cycles holding protection  */
+    ULONG   tx_thread_smp_protect_stat_max_spin;        /* Longest spin in cycles           */
+    ULONG   tx_thread_smp_protect_stat_max_hold;        /* Longest hold in cycles           */
+    ULONG   tx_thread_smp_protect_stat_max_hold_pc;     /* Caller PC of the longest hold    */
+    ULONG   tx_thread_smp_protect_stat_spin_hist[TX_THREAD_SMP_PROTECT_STAT_BUCKETS];
+    ULONG   tx_thread_smp_protect_stat_hold_hist[TX_THREAD_SMP_PROTECT_STAT_BUCKETS];
+} TX_THREAD_SMP_PROTECT_STAT;
+
+/* Copy a consistent snapshot of core's statistics, return TX_SUCCESS or TX_PTR_ERROR.  */
+extern UINT _tx_thread_smp_protect_stat_get(UINT core, TX_THREAD_SMP_PROTECT_STAT *stat);
+/* Clear the statistics of all cores.  */
+extern void _tx_thread_smp_protect_stat_reset(void);
+/* Print the statistics and histograms of all cores.  */
+extern void _tx_thread_smp_protect_stat_dump(void);
+
+#endif
+
 /* Define ThreadX interrupt lockout and restore macros for protection on
    access of critical kernel information.  The restore interrupt macro must
    restore the interrupt posture of the running thread prior to the value
@@ -36,7 +36,12 @@ void vPortSetupTimerInterrupt(void);
 /*
  * Exception handlers.
  */
+#ifdef WITH_COMPONENT_HRTIMER
+/* SysTimer interrupt is owned by hrtimer component, and the tick is one of its periodic timers */
+#include "hrtimer_api.h"
+#else
 #define xPortSysTickHandler                     eclic_mtip_handler
+#endif
 
 void xPortSysTickHandler(void);
 
@@ -259,7 +264,9 @@ void xPortSysTickHandler(void)
     save and then restore the interrupt mask value as its value is already
     known. */
     OS_ENTER_CRITICAL();
+#ifndef WITH_COMPONENT_HRTIMER
     SysTick_Reload(SYSTICK_TICK_CONST);
+#endif
     OSIntEnter();                              /* Tell uC/OS-II that we are starting an ISR            */
     OS_EXIT_CRITICAL();
 
@@ -280,7 +287,11 @@ __attribute__((weak)) void vPortSetupTimerInterrupt(void)
 
     /* Make SWI and SysTick the lowest priority interrupts. */
     /* Stop and clear the SysTimer. SysTimer as Non-Vector Interrupt */
+#ifdef WITH_COMPONENT_HRTIMER
+    hrtimer_tick_config(ticks, xPortSysTickHandler);
+#else
     SysTick_Config(ticks);
+#endif
     ECLIC_DisableIRQ(SysTimer_IRQn);
     ECLIC_SetLevelIRQ(SysTimer_IRQn, configKERNEL_INTERRUPT_PRIORITY);
     ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
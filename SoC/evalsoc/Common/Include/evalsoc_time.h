@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _EVALSOC_TIME_H
+#define _EVALSOC_TIME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Time services used by the libc stubs.
+ *
+ * Counter values are converted with factors precomputed by SystemTime_Update,
+ * as out = count * integer + ((count * frac) >> 64), so reading a time never
+ * divides, which is a libgcc __udivdi3 call on RV32.
+ */
+
+/** Time source of \ref SystemTime_GetNs */
+typedef enum SystemTime_Source {
+    SYSTIME_CYCLE = 0,          /*!< mcycle of current hart, SystemCoreClock based */
+    SYSTIME_TIMER = 1,          /*!< SysTimer mtime shared by all harts, SOC_TIMER_FREQ based */
+    SYSTIME_SOURCE_NUM
+} SystemTime_Source_Type;
+
+/** Conversion factor from counter ticks to another unit */
+typedef struct SystemTime_Conv {
+    uint64_t integer;           /*!< integer part of output units per tick */
+    uint64_t frac;              /*!< fractional part of output units per tick, in 2^-64 */
+} SystemTime_Conv_Type;
+
+/** Conversion factors of all time sources */
+typedef struct SystemTime_Info {
+    uint32_t freq[SYSTIME_SOURCE_NUM];                 /*!< counter frequency factors are computed for */
+    uint32_t res_ns[SYSTIME_SOURCE_NUM];               /*!< counter resolution in ns, rounded up */
+    SystemTime_Conv_Type to_ns[SYSTIME_SOURCE_NUM];    /*!< ticks to nanoseconds */
+    SystemTime_Conv_Type to_clk[SYSTIME_SOURCE_NUM];   /*!< ticks to CLOCKS_PER_SEC units */
+} SystemTime_Info_Type;
+
+extern SystemTime_Info_Type SystemTime;
+
+/**
+ * \brief Recompute conversion factors of all time sources
+ * \details
+ * Called by \ref SystemCoreClockUpdate, it is also called on first read
+ * after \ref SystemCoreClock is changed.
+ */
+extern void SystemTime_Update(void);
+
+/**
+ * \brief Return high 64 bits of 64x64 bits unsigned product
+ */
+__STATIC_FORCEINLINE uint64_t SystemTime_MulHi64(uint64_t a, uint64_t b)
+{
+#if __riscv_xlen == 64
+    return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+    uint32_t al = (uint32_t)a, ah = (uint32_t)(a >> 32);
+    uint32_t bl = (uint32_t)b, bh = (uint32_t)(b >> 32);
+    uint64_t ll = (uint64_t)al * bl;
+    uint64_t lh = (uint64_t)al * bh;
+    uint64_t hl = (uint64_t)ah * bl;
+    uint64_t hh = (uint64_t)ah * bh;
+    uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+/**
+ * \brief Convert counter ticks with precomputed factor
+ */
+__STATIC_FORCEINLINE uint64_t SystemTime_Convert(const SystemTime_Conv_Type *conv, uint64_t ticks)
+{
+    return ticks * conv->integer + SystemTime_MulHi64(ticks, conv->frac);
+}
+
+/**
+ * \brief Read counter of time source
+ */
+__STATIC_FORCEINLINE uint64_t SystemTime_GetTicks(SystemTime_Source_Type src)
+{
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+    if (src == SYSTIME_TIMER) {
+        return (uint64_t)SysTimer_GetLoadValue();
+    }
+#endif
+    return __get_rv_cycle();
+}
+
+/**
+ * \brief Make sure conversion factors match current \ref SystemCoreClock
+ */
+__STATIC_FORCEINLINE void SystemTime_Check(void)
+{
+    if (SystemTime.freq[SYSTIME_CYCLE] != SystemCoreClock) {
+        SystemTime_Update();
+    }
+}
+
+/**
+ * \brief Get time of source in nanoseconds since its counter started
+ */
+__STATIC_FORCEINLINE uint64_t SystemTime_GetNs(SystemTime_Source_Type src)
+{
+    SystemTime_Check();
+    return SystemTime_Convert(&SystemTime.to_ns[src], SystemTime_GetTicks(src));
+}
+
+/**
+ * \brief Split nanoseconds into seconds and remaining nanoseconds without division
+ */
+__STATIC_FORCEINLINE uint64_t SystemTime_SplitNs(uint64_t ns, uint32_t *nsec)
+{
+    /* 2^64 / 1e9 rounded down, the quotient is at most 2 less than exact one */
+    uint64_t sec = SystemTime_MulHi64(ns, 18446744073ULL);
+    uint64_t rem = ns - sec * 1000000000ULL;
+
+    while (rem >= 1000000000ULL) {
+        rem -= 1000000000ULL;
+        sec++;
+    }
+    *nsec = (uint32_t)rem;
+    return sec;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -8,6 +8,7 @@ extern "C" {
 
 #include "evalsoc.h"
 #include "evalsoc_uart.h"
+#include "evalsoc_time.h"
 
 #ifdef __cplusplus
 }
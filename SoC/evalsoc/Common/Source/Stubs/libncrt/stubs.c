@@ -35,11 +35,8 @@ void exit(int fd)
 // clock() function implementation is added in 0.4.0 sdk release
 __WEAK clock_t clock(void)
 {
-    uint64_t cycles = __get_rv_cycle();
-    clock_t clktm;
-
-    clktm = (cycles * CLOCKS_PER_SEC) / SystemCoreClock;
-    return clktm;
+    SystemTime_Check();
+    return (clock_t)SystemTime_Convert(&SystemTime.to_clk[SYSTIME_CYCLE], __get_rv_cycle());
 }
 
 extern __WEAK void (*__fini_array_start[])(void);
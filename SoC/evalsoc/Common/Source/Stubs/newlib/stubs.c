@@ -95,23 +95,58 @@ __WEAK void* __dso_handle = NULL;
 char *__env[1] = { 0 };
 char **environ = __env;
 
+/* Time source of clock id, CLOCK_MONOTONIC uses SysTimer mtime shared by all harts */
+static int clock_source(clockid_t clock_id, SystemTime_Source_Type* src)
+{
+    switch (clock_id) {
+#ifdef CLOCK_MONOTONIC
+        case CLOCK_MONOTONIC:
+            *src = SYSTIME_TIMER;
+            return 0;
+#endif
+#ifdef CLOCK_MONOTONIC_RAW
+        case CLOCK_MONOTONIC_RAW:
+#endif
+#ifdef CLOCK_PROCESS_CPUTIME_ID
+        case CLOCK_PROCESS_CPUTIME_ID:
+#endif
+#ifdef CLOCK_THREAD_CPUTIME_ID
+        case CLOCK_THREAD_CPUTIME_ID:
+#endif
+        case CLOCK_REALTIME:
+            *src = SYSTIME_CYCLE;
+            return 0;
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+}
+
+/* Offset of CLOCK_REALTIME to mcycle based time in ns, set by clock_settime */
+static int64_t realtime_offset;
+
 /* Get resolution of clock. */
 __WEAK int clock_getres(clockid_t clock_id, struct timespec* res)
 {
-    res->tv_sec = 0;
-    res->tv_nsec = 1000000000 / SystemCoreClock;
+    SystemTime_Source_Type src;
 
+    if (clock_source(clock_id, &src) != 0) {
+        return -1;
+    }
+    if (res) {
+        SystemTime_Check();
+        res->tv_sec = 0;
+        res->tv_nsec = SystemTime.res_ns[src];
+    }
     return 0;
 }
 
 __WEAK int _gettimeofday(struct timeval* tp, void* tzp)
 {
-    uint64_t cycles;
+    uint32_t nsec;
 
-    cycles = __get_rv_cycle();
-
-    tp->tv_sec = cycles / SystemCoreClock;
-    tp->tv_usec = (cycles % SystemCoreClock) * 1000000 / SystemCoreClock;
+    tp->tv_sec = SystemTime_SplitNs(SystemTime_GetNs(SYSTIME_CYCLE) + realtime_offset, &nsec);
+    tp->tv_usec = nsec / 1000;
     return 0;
 }
 
@@ -223,46 +258,51 @@ __WEAK int _wait(int* status)
     return -1;
 }
 
-extern int _gettimeofday(struct timeval* tp, void* tzp);
-
 __WEAK clock_t _times(struct tms* buf)
 {
-    static struct timeval t0;
-    struct timeval t;
-    long long utime;
+    static uint64_t t0;
+    uint64_t cycles;
 
+    SystemTime_Check();
+    cycles = __get_rv_cycle();
     /* When called for the first time, initialize t0. */
-    if (t0.tv_sec == 0 && t0.tv_usec == 0) {
-        _gettimeofday(&t0, 0);
+    if (t0 == 0) {
+        t0 = cycles;
     }
 
-    _gettimeofday(&t, 0);
-
-    utime = (t.tv_sec - t0.tv_sec) * 1000000 + (t.tv_usec - t0.tv_usec);
-    buf->tms_utime = utime * CLOCKS_PER_SEC / 1000000;
+    buf->tms_utime = SystemTime_Convert(&SystemTime.to_clk[SYSTIME_CYCLE], cycles - t0);
     buf->tms_stime = buf->tms_cstime = buf->tms_cutime = 0;
 
     return buf->tms_utime;
 }
 
-/* Set CLOCK to value TP. */
+/* Set CLOCK to value TP, only CLOCK_REALTIME can be set. */
 __WEAK int clock_settime(clockid_t clock_id, const struct timespec* tp)
 {
-    return -1;
+    if (clock_id != CLOCK_REALTIME || tp->tv_nsec < 0 || tp->tv_nsec >= 1000000000L) {
+        errno = EINVAL;
+        return -1;
+    }
+    realtime_offset = (int64_t)tp->tv_sec * 1000000000LL + tp->tv_nsec - (int64_t)SystemTime_GetNs(SYSTIME_CYCLE);
+    return 0;
 }
 
 /* Get current value of CLOCK and store it in tp.  */
 __WEAK int clock_gettime(clockid_t clock_id, struct timespec* tp)
 {
-    struct timeval tv;
-    int retval = -1;
+    SystemTime_Source_Type src;
+    uint64_t ns;
+    uint32_t nsec;
 
-    retval = _gettimeofday(&tv, NULL);
-    if (retval == 0) {
-        (tp)->tv_sec = (&tv)->tv_sec;
-        (tp)->tv_nsec = (&tv)->tv_usec * 1000;
+    if (clock_source(clock_id, &src) != 0) {
+        return -1;
     }
+    ns = SystemTime_GetNs(src);
+    if (clock_id == CLOCK_REALTIME) {
+        ns += realtime_offset;
+    }
+    tp->tv_sec = SystemTime_SplitNs(ns, &nsec);
+    tp->tv_nsec = nsec;
 
-    return retval;
+    return 0;
 }
-
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <time.h>
+#include "nuclei_sdk_soc.h"
+
+SystemTime_Info_Type SystemTime;
+
+/* out / in as integer and 64 bits fraction, fraction is computed in two 32 bits steps */
+static void SystemTime_SetConv(SystemTime_Conv_Type *conv, uint32_t in, uint32_t out)
+{
+    uint64_t rem;
+    uint64_t hi;
+
+    conv->integer = out / in;
+    rem = out % in;
+    hi = (rem << 32) / in;
+    rem = (rem << 32) % in;
+    conv->frac = (hi << 32) | ((rem << 32) / in);
+}
+
+void SystemTime_Update(void)
+{
+    uint32_t freq[SYSTIME_SOURCE_NUM];
+
+    freq[SYSTIME_CYCLE] = SystemCoreClock;
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+    freq[SYSTIME_TIMER] = SOC_TIMER_FREQ;
+#else
+    freq[SYSTIME_TIMER] = SystemCoreClock;
+#endif
+    for (int i = 0; i < SYSTIME_SOURCE_NUM; i++) {
+        if (freq[i] == 0) {
+            freq[i] = 1;
+        }
+        SystemTime_SetConv(&SystemTime.to_ns[i], freq[i], 1000000000UL);
+        SystemTime_SetConv(&SystemTime.to_clk[i], freq[i], CLOCKS_PER_SEC);
+        SystemTime.res_ns[i] = (1000000000UL + freq[i] - 1) / freq[i];
+    }
+    /* written last, readers check it to know whether factors are up to date */
+    SystemTime.freq[SYSTIME_TIMER] = freq[SYSTIME_TIMER];
+    SystemTime.freq[SYSTIME_CYCLE] = SystemCoreClock;
+}
@@ -204,6 +204,8 @@ void SystemCoreClockUpdate(void)             /* Get Core Clock Frequency */
      * Note: This function can be used to retrieve the system core clock frequeny
      *    after user changed register settings.
      */
+    /* Recompute the time conversion factors of libc time functions */
+    SystemTime_Update();
 }
 
 /**
@@ -278,6 +280,23 @@ extern char CSTACK$$Limit[];
 #define __TOP_OF_STACK  (CSTACK$$Limit)
 #endif
 
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+// each hart has its own stack below top of stack, see startup code
+#ifndef __ICCRISCV__
+// __STACK_SIZE is defined in linker script such as gcc_evalsoc_ilm.ld
+extern char __STACK_SIZE[];
+#define __HART_STACK_SIZE       ((unsigned long)__STACK_SIZE)
+#else
+// CSTACK block holds SMP_CPU_CNT stacks in iar linker script such as iar_evalsoc_smp.icf
+extern char CSTACK$$Base[];
+#define __HART_STACK_SIZE       (((unsigned long)CSTACK$$Limit - (unsigned long)CSTACK$$Base) / SMP_CPU_CNT)
+#endif
+#define __HART_TOP_OF_STACK     ((unsigned long)__TOP_OF_STACK - \
+                                 (__RV_CSR_READ(CSR_MHARTID) & 0xFF) * __HART_STACK_SIZE)
+#else
+#define __HART_TOP_OF_STACK     ((unsigned long)__TOP_OF_STACK)
+#endif
+
 /**
  * \brief      Store the exception handlers for each exception ID in supervisor mode
  * \note
@@ -925,7 +944,8 @@ void ECLIC_Interrupt_Init(void)
         ECLIC_SetCfgNlbits(__ECLIC_INTCTLBITS);
 
 #if defined(ECLIC_HW_CTX_AUTO) && defined(CFG_HAS_ECLICV2)
-        __RV_CSR_WRITE(CSR_MTSP, (unsigned long)__TOP_OF_STACK);
+        /* Each hart swaps to its own stack when trap stack swap is enabled by rtos */
+        __RV_CSR_WRITE(CSR_MTSP, __HART_TOP_OF_STACK);
         /* Enable Hardware Auto Save Context */
         __RV_CSR_SET(CSR_MMISC_CTL, MMISC_CTL_HW_AUTO_CONTEXT);
 
@@ -1579,6 +1599,7 @@ void _premain_init(void)
         // TODO implement system_system_clock function to get real cpu clock freq in HZ or directly give the real cpu HZ
         // TODO you can directly give the correct cpu frequency here, if you know it without call get_cpu_freq function
         SystemCoreClock = get_system_clock();
+        SystemCoreClockUpdate();
         uart_init(SOC_DEBUG_UART, 115200);
         /* Display banner after UART initialized */
         SystemBannerPrint();
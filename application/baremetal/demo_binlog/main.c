@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include "nuclei_sdk_hal.h"
+#include "binlog_api.h"
+
+/*
+ * Log the same LOG_LINES lines by printf and by BINLOG, and compare the
+ * cycles spent on the logging call sites, the BINLOG lines are output later
+ * by binlog_drain, first as text, then as raw records for binlog_parse.py.
+ */
+#define LOG_LINES               16
+
+static const char *stage_names[] = {"init", "run", "stop"};
+
+static uint64_t log_by_printf(void)
+{
+    uint64_t start, cycles = 0;
+
+    for (uint32_t i = 0; i < LOG_LINES; i++) {
+        start = __get_rv_cycle();
+        printf("printf: stage %s, loop %lu, value 0x%lx\n", stage_names[i % 3], (unsigned long)i,
+               (unsigned long)(i * 0x1234));
+        cycles += __get_rv_cycle() - start;
+    }
+    return cycles;
+}
+
+static uint64_t log_by_binlog(void)
+{
+    uint64_t start, cycles = 0;
+
+    for (uint32_t i = 0; i < LOG_LINES; i++) {
+        start = __get_rv_cycle();
+        BINLOG("binlog: stage %s, loop %lu, value 0x%lx\n", stage_names[i % 3], (unsigned long)i,
+               (unsigned long)(i * 0x1234));
+        cycles += __get_rv_cycle() - start;
+    }
+    return cycles;
+}
+
+int main(void)
+{
+    uint64_t printf_cycles, binlog_cycles;
+    binlog_stats_t stats;
+    int lines;
+
+    printf("Deferred binary logging demo, %d lines each\n", LOG_LINES);
+    printf_cycles = log_by_printf();
+
+    binlog_cycles = log_by_binlog();
+    binlog_set_mode(BINLOG_MODE_TEXT);
+    lines = binlog_drain();
+    printf("Drained %d lines as text\n", lines);
+
+    log_by_binlog();
+    binlog_set_mode(BINLOG_MODE_BINARY);
+    lines = binlog_drain();
+    printf("Drained %d lines as raw records, decode them by binlog_parse.py\n", lines);
+
+    binlog_get_stats(0, &stats);
+    printf("binlog written %lu, dropped %lu, max used %lu words\n", stats.written, stats.dropped, stats.max_used);
+    printf("CSV, printf, %lu\n", (unsigned long)(printf_cycles / LOG_LINES));
+    printf("CSV, binlog, %lu\n", (unsigned long)(binlog_cycles / LOG_LINES));
+    if (binlog_cycles < printf_cycles) {
+        printf("BINLOG is %lu times faster than printf\n",
+               (unsigned long)(printf_cycles / (binlog_cycles ? binlog_cycles : 1)));
+    }
+    return 0;
+}
@@ -0,0 +1,263 @@
+// See LICENSE for license details.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include "nuclei_sdk_soc.h"
+#include "cxxrt_api.h"
+
+/*
+ * Allocation latency benchmark of cxxrt middleware, the same sequence of
+ * allocations and frees is run through operator new/delete served by the
+ * cxxrt pool, and through newlib malloc/free which grows the heap by _sbrk.
+ *
+ * Build with CXXRT_POOL=tlsf or CXXRT_POOL=block to compare the pools:
+ *   make CXXRT_POOL=block run_qemu
+ *
+ * Then exceptions are thrown from the pool, and from emergency buffers
+ * after the pool is exhausted, and a function local static is guarded.
+ */
+#define BENCH_OPS           2048
+#define BENCH_SLOTS         32
+#define BENCH_MAX_SIZE      120
+
+typedef struct {
+    const char *name;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t cnt;
+} bench_stat_t;
+
+static uint32_t read_cost;
+static uint32_t lcg_seed;
+static int errors = 0;
+
+static uint32_t lcg_next(void)
+{
+    lcg_seed = lcg_seed * 1103515245 + 12345;
+    return lcg_seed >> 8;
+}
+
+static void stat_init(bench_stat_t *stat, const char *name)
+{
+    stat->name = name;
+    stat->min = 0xFFFFFFFF;
+    stat->max = 0;
+    stat->sum = 0;
+    stat->cnt = 0;
+}
+
+static void stat_update(bench_stat_t *stat, uint64_t cycles)
+{
+    uint32_t val = (cycles > read_cost) ? (uint32_t)(cycles - read_cost) : 0;
+
+    stat->min = (val < stat->min) ? val : stat->min;
+    stat->max = (val > stat->max) ? val : stat->max;
+    stat->sum += val;
+    stat->cnt++;
+}
+
+static void stat_print(const bench_stat_t *stat)
+{
+    uint32_t avg = stat->cnt ? (uint32_t)(stat->sum / stat->cnt) : 0;
+
+    printf("CSV, %s, %lu, %lu, %lu, %lu\n", stat->name, (unsigned long)stat->min, (unsigned long)avg,
+           (unsigned long)stat->max, (unsigned long)(stat->max - stat->min));
+}
+
+static uint32_t measure_read_cost(void)
+{
+    uint64_t start, end;
+    uint32_t cost = 0xFFFFFFFF;
+
+    for (int i = 0; i < 8; i++) {
+        start = __get_rv_cycle();
+        end = __get_rv_cycle();
+        cost = (end - start < cost) ? (uint32_t)(end - start) : cost;
+    }
+    return cost;
+}
+
+/* allocators under test, noinline to keep the call cost of both paths alike */
+__attribute__((noinline)) static void *pool_alloc(size_t size)
+{
+    return new (std::nothrow) uint8_t[size];
+}
+
+__attribute__((noinline)) static void pool_free(void *ptr)
+{
+    delete[] static_cast<uint8_t *>(ptr);
+}
+
+__attribute__((noinline)) static void *newlib_alloc(size_t size)
+{
+    return malloc(size);
+}
+
+__attribute__((noinline)) static void newlib_free(void *ptr)
+{
+    free(ptr);
+}
+
+/*
+ * Random alloc and free of random sizes on a set of slots, the same seed
+ * gives the same sequence for both allocators, data is checked before free
+ */
+static void run_sequence(void *(*alloc)(size_t), void (*release)(void *),
+                         bench_stat_t *alloc_stat, bench_stat_t *free_stat)
+{
+    static uint8_t *slots[BENCH_SLOTS];
+    static uint32_t sizes[BENCH_SLOTS];
+    uint64_t start, end;
+    uint32_t idx;
+
+    lcg_seed = 0x5A5A;
+    for (uint32_t op = 0; op < BENCH_OPS; op++) {
+        idx = lcg_next() % BENCH_SLOTS;
+        if (slots[idx] == NULL) {
+            sizes[idx] = 1 + lcg_next() % BENCH_MAX_SIZE;
+            start = __get_rv_cycle();
+            slots[idx] = (uint8_t *)alloc(sizes[idx]);
+            end = __get_rv_cycle();
+            if (slots[idx] == NULL) {
+                printf("%s failed at op %lu\n", alloc_stat->name, (unsigned long)op);
+                errors++;
+                continue;
+            }
+            stat_update(alloc_stat, end - start);
+            memset(slots[idx], (uint8_t)idx, sizes[idx]);
+        } else {
+            if ((slots[idx][0] != (uint8_t)idx) || (slots[idx][sizes[idx] - 1] != (uint8_t)idx)) {
+                errors++;
+            }
+            start = __get_rv_cycle();
+            release(slots[idx]);
+            end = __get_rv_cycle();
+            stat_update(free_stat, end - start);
+            slots[idx] = NULL;
+        }
+    }
+    for (idx = 0; idx < BENCH_SLOTS; idx++) {
+        release(slots[idx]);
+        slots[idx] = NULL;
+    }
+}
+
+class Config {
+public:
+    Config() : value(0xC0FFEE)
+    {
+        ctor_runs++;
+    }
+    uint32_t value;
+    static uint32_t ctor_runs;
+};
+
+uint32_t Config::ctor_runs = 0;
+
+/* thrown when the pool is exhausted, so it must not allocate like std::logic_error */
+struct PoolError {
+    uint32_t code;
+};
+
+static Config &get_config(void)
+{
+    /* initialized on first use under __cxa_guard_acquire */
+    static Config config;
+    return config;
+}
+
+static void run_exceptions(void)
+{
+    bench_stat_t stat;
+    uint64_t start, end;
+    void *hog[512];
+    uint32_t cnt = 0;
+    cxxrt_stat_t pool;
+
+    stat_init(&stat, "throw_catch");
+    for (int i = 0; i < 32; i++) {
+        start = __get_rv_cycle();
+        try {
+            throw std::runtime_error("cxxrt");
+        } catch (const std::runtime_error &e) {
+            end = __get_rv_cycle();
+            errors += (strcmp(e.what(), "cxxrt") != 0);
+        }
+        stat_update(&stat, end - start);
+    }
+    stat_print(&stat);
+
+    /* exhaust the pool, bad_alloc and later exceptions use emergency buffers */
+    try {
+        while (cnt < sizeof(hog) / sizeof(hog[0])) {
+            hog[cnt] = ::operator new(64);
+            cnt++;
+        }
+        printf("pool not exhausted by %lu allocations\n", (unsigned long)cnt);
+        errors++;
+    } catch (const std::bad_alloc &) {
+        printf("bad_alloc caught after %lu allocations\n", (unsigned long)cnt);
+    }
+    try {
+        throw PoolError{0xE};
+    } catch (const PoolError &e) {
+        errors += (e.code != 0xE);
+    }
+    while (cnt > 0) {
+        ::operator delete(hog[--cnt]);
+    }
+    cxxrt_get_stat(&pool);
+    if (pool.eh_emergency < 2) {
+        printf("emergency buffers not used\n");
+        errors++;
+    }
+}
+
+int main(void)
+{
+    bench_stat_t pool_new, pool_delete, newlib_malloc, newlib_free_stat;
+    cxxrt_stat_t stat;
+
+    read_cost = measure_read_cost();
+#if defined(CXXRT_POOL_BLOCK)
+    printf("C++ runtime allocation benchmark, block pool\n");
+#else
+    printf("C++ runtime allocation benchmark, tlsf pool\n");
+#endif
+
+    stat_init(&pool_new, "cxxrt_new");
+    stat_init(&pool_delete, "cxxrt_delete");
+    stat_init(&newlib_malloc, "newlib_malloc");
+    stat_init(&newlib_free_stat, "newlib_free");
+    /* first allocation initializes the pool and the newlib heap, keep it out of the samples */
+    pool_free(pool_alloc(1));
+    newlib_free(newlib_alloc(1));
+    run_sequence(pool_alloc, pool_free, &pool_new, &pool_delete);
+    run_sequence(newlib_alloc, newlib_free, &newlib_malloc, &newlib_free_stat);
+
+    printf("%d ops, cycle read cost %lu\n", BENCH_OPS, (unsigned long)read_cost);
+    printf("CSV, Item, Min, Avg, Max, Jitter\n");
+    stat_print(&pool_new);
+    stat_print(&pool_delete);
+    stat_print(&newlib_malloc);
+    stat_print(&newlib_free_stat);
+
+    run_exceptions();
+
+    errors += (get_config().value != 0xC0FFEE);
+    errors += (get_config().value != 0xC0FFEE);
+    errors += (Config::ctor_runs != 1);
+
+    cxxrt_get_stat(&stat);
+    errors += (stat.used != 0);
+    cxxrt_dump_stat();
+    if (errors) {
+        printf("cxxrt demo failed, %d errors\n", errors);
+        return -1;
+    }
+    printf("cxxrt demo finished\n");
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include "nuclei_sdk_soc.h"
 #include "ref_conv.h"
 #include "riscv_math.h"
+#include "stft_api.h"
 
 #include "nmsis_bench.h"
 
@@ -276,6 +277,72 @@ static int test_flag_error = 0;
 
 BENCH_DECLARE_VAR();
 
+/* streaming STFT/ISTFT throughput with 75% overlapped hanning window and unchanged spectrum */
+#define STFT_FFT_LEN    128
+#define STFT_HOP_LEN    32
+#define STFT_SIG_LEN    512
+#define STFT_DELTAF32   (0.001f)
+#define STFT_DELTAQ15   (1638)
+
+static float32_t stft_work_f32[STFT_WORK_LEN_F32(STFT_FFT_LEN)];
+static q15_t stft_work_q15[STFT_WORK_LEN_Q15(STFT_FFT_LEN)] __ALIGNED(4);
+static float32_t stft_sig_f32[STFT_SIG_LEN], stft_out_f32[STFT_SIG_LEN];
+static q15_t stft_sig_q15[STFT_SIG_LEN], stft_out_q15[STFT_SIG_LEN];
+
+static void test_stft(void)
+{
+    stft_instance_f32 Sf;
+    stft_instance_q15 Sq;
+    uint32_t i, delay = STFT_FFT_LEN - STFT_HOP_LEN;
+
+    for (i = 0; i < STFT_SIG_LEN; i++) {
+        stft_sig_f32[i] = 0.3f * riscv_sin_f32(0.07f * i) + 0.2f * riscv_cos_f32(0.31f * i);
+    }
+    riscv_float_to_q15(stft_sig_f32, stft_sig_q15, STFT_SIG_LEN);
+    printf("STFT %d points, hop %d, %d samples\n", STFT_FFT_LEN, STFT_HOP_LEN, STFT_SIG_LEN);
+
+    if (stft_init_f32(&Sf, STFT_FFT_LEN, STFT_HOP_LEN, NULL, stft_work_f32, NULL, NULL) != RISCV_MATH_SUCCESS) {
+        BENCH_ERROR(stft_process_f32);
+        test_flag_error = 1;
+        return;
+    }
+    BENCH_START(stft_process_f32);
+    for (i = 0; i < STFT_SIG_LEN; i += STFT_HOP_LEN) {
+        stft_process_f32(&Sf, stft_sig_f32 + i, stft_out_f32 + i);
+    }
+    BENCH_END(stft_process_f32);
+    /* output is delayed by fftLen - hopLen, and the first frames are not fully overlapped */
+    for (i = STFT_FFT_LEN; i < STFT_SIG_LEN; i++) {
+        if (fabsf(stft_out_f32[i] - stft_sig_f32[i - delay]) > STFT_DELTAF32) {
+            BENCH_ERROR(stft_process_f32);
+            printf("index: %lu, expect: %f, actual: %f\n", (unsigned long)i, stft_sig_f32[i - delay], stft_out_f32[i]);
+            test_flag_error = 1;
+            break;
+        }
+    }
+    BENCH_STATUS(stft_process_f32);
+
+    if (stft_init_q15(&Sq, STFT_FFT_LEN, STFT_HOP_LEN, NULL, stft_work_q15, NULL, NULL) != RISCV_MATH_SUCCESS) {
+        BENCH_ERROR(stft_process_q15);
+        test_flag_error = 1;
+        return;
+    }
+    BENCH_START(stft_process_q15);
+    for (i = 0; i < STFT_SIG_LEN; i += STFT_HOP_LEN) {
+        stft_process_q15(&Sq, stft_sig_q15 + i, stft_out_q15 + i);
+    }
+    BENCH_END(stft_process_q15);
+    for (i = STFT_FFT_LEN; i < STFT_SIG_LEN; i++) {
+        if (abs(stft_out_q15[i] - stft_sig_q15[i - delay]) > STFT_DELTAQ15) {
+            BENCH_ERROR(stft_process_q15);
+            printf("index: %lu, expect: %d, actual: %d\n", (unsigned long)i, stft_sig_q15[i - delay], stft_out_q15[i]);
+            test_flag_error = 1;
+            break;
+        }
+    }
+    BENCH_STATUS(stft_process_q15);
+}
+
 int main(void)
 {
     printf("\r\nNuclei RISC-V NMSIS-DSP Library Demonstration\r\n");
@@ -440,6 +507,9 @@ int main(void)
         }
     }
     BENCH_STATUS(riscv_conv_fast_opt_q15);
+
+    test_stft();
+
     if (test_flag_error) {
         printf("test error apprears, please recheck.\n");
         NMSIS_TEST_FAIL();
@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "riscv_math.h"
+#include "gemm_api.h"
+
+/*
+ * Compare riscv_mat_mult_f32/q31/q15 of NMSIS-DSP with the cache blocked
+ * gemm_mat_mult_* for square matrices from 16 to GEMM_MAX_SIZE, the f32
+ * results are checked with relative error, q31 and q15 must be exactly the same.
+ * When SMP_CPU_CNT is defined, the rows of C are split between all harts.
+ */
+#ifndef GEMM_MAX_SIZE
+#define GEMM_MAX_SIZE           512
+#endif
+
+#ifdef SMP_CPU_CNT
+#define GEMM_PARTS              SMP_CPU_CNT
+#else
+#define GEMM_PARTS              1
+#endif
+
+#define DELTAF32                (1e-4f)
+
+static uint32_t mat_a[GEMM_MAX_SIZE * GEMM_MAX_SIZE];
+static uint32_t mat_b[GEMM_MAX_SIZE * GEMM_MAX_SIZE];
+static uint32_t mat_c[GEMM_MAX_SIZE * GEMM_MAX_SIZE];
+static uint32_t mat_ref[GEMM_MAX_SIZE * GEMM_MAX_SIZE];
+static q15_t mat_state[GEMM_MAX_SIZE * GEMM_MAX_SIZE];
+static uint8_t gemm_work[GEMM_PARTS][GEMM_DEFAULT_WORK_MAX] __attribute__((aligned(8)));
+
+static gemm_plan_t plan;
+static uint32_t job_size;
+static volatile uint32_t job_seq = 0;
+static volatile uint32_t job_done = 0;
+static uint32_t seed = 1;
+
+static uint32_t rand_u32(void)
+{
+    seed = seed * 1664525 + 1013904223;
+    return seed;
+}
+
+static void run_part(uint32_t part)
+{
+    uint16_t n = job_size;
+
+    switch (plan.type) {
+        case GEMM_F32: {
+            riscv_matrix_instance_f32 a = {n, n, (float32_t *)mat_a}, b = {n, n, (float32_t *)mat_b};
+            riscv_matrix_instance_f32 c = {n, n, (float32_t *)mat_c};
+            gemm_mat_mult_f32(&plan, &a, &b, &c, gemm_work[part], part, GEMM_PARTS);
+            break;
+        }
+        case GEMM_Q31: {
+            riscv_matrix_instance_q31 a = {n, n, (q31_t *)mat_a}, b = {n, n, (q31_t *)mat_b};
+            riscv_matrix_instance_q31 c = {n, n, (q31_t *)mat_c};
+            gemm_mat_mult_q31(&plan, &a, &b, &c, gemm_work[part], part, GEMM_PARTS);
+            break;
+        }
+        default: {
+            riscv_matrix_instance_q15 a = {n, n, (q15_t *)mat_a}, b = {n, n, (q15_t *)mat_b};
+            riscv_matrix_instance_q15 c = {n, n, (q15_t *)mat_c};
+            gemm_mat_mult_q15(&plan, &a, &b, &c, gemm_work[part], part, GEMM_PARTS);
+            break;
+        }
+    }
+}
+
+/* run all parts, each hart runs the part of its hart index */
+static uint64_t run_gemm(uint16_t type, uint32_t size)
+{
+    uint64_t start;
+
+    if (gemm_plan_tiles(&plan, type, size, size, size, GEMM_PARTS) == 0) {
+        printf("Work buffer is too small for size %lu\n", (unsigned long)size);
+        return 0;
+    }
+    job_size = size;
+    start = __get_rv_cycle();
+#if GEMM_PARTS > 1
+    job_done = 0;
+    __SMP_RWMB();
+    job_seq = job_seq + 1;
+    run_part(__get_hart_index());
+    while (job_done != GEMM_PARTS - 1);
+    __SMP_RWMB();
+#else
+    run_part(0);
+#endif
+    return __get_rv_cycle() - start;
+}
+
+static uint64_t run_ref(uint16_t type, uint32_t size)
+{
+    uint64_t start = __get_rv_cycle();
+    uint16_t n = size;
+
+    if (type == GEMM_F32) {
+        riscv_matrix_instance_f32 a = {n, n, (float32_t *)mat_a}, b = {n, n, (float32_t *)mat_b};
+        riscv_matrix_instance_f32 c = {n, n, (float32_t *)mat_ref};
+        riscv_mat_mult_f32(&a, &b, &c);
+    } else if (type == GEMM_Q31) {
+        riscv_matrix_instance_q31 a = {n, n, (q31_t *)mat_a}, b = {n, n, (q31_t *)mat_b};
+        riscv_matrix_instance_q31 c = {n, n, (q31_t *)mat_ref};
+        riscv_mat_mult_q31(&a, &b, &c);
+    } else {
+        riscv_matrix_instance_q15 a = {n, n, (q15_t *)mat_a}, b = {n, n, (q15_t *)mat_b};
+        riscv_matrix_instance_q15 c = {n, n, (q15_t *)mat_ref};
+        riscv_mat_mult_q15(&a, &b, &c, mat_state);
+    }
+    return __get_rv_cycle() - start;
+}
+
+static void fill_inputs(uint16_t type, uint32_t size)
+{
+    uint32_t i, cnt = size * size;
+
+    for (i = 0; i < cnt; i++) {
+        if (type == GEMM_F32) {
+            ((float32_t *)mat_a)[i] = (float32_t)(int32_t)(rand_u32() >> 16) / 32768.0f - 1.0f;
+            ((float32_t *)mat_b)[i] = (float32_t)(int32_t)(rand_u32() >> 16) / 32768.0f - 1.0f;
+        } else if (type == GEMM_Q31) {
+            ((q31_t *)mat_a)[i] = (q31_t)rand_u32() >> 4;
+            ((q31_t *)mat_b)[i] = (q31_t)rand_u32() >> 4;
+        } else {
+            ((q15_t *)mat_a)[i] = (q15_t)(rand_u32() >> 16) >> 4;
+            ((q15_t *)mat_b)[i] = (q15_t)(rand_u32() >> 16) >> 4;
+        }
+    }
+}
+
+static int check_result(uint16_t type, uint32_t size)
+{
+    uint32_t i, cnt = size * size;
+    float32_t diff, ref;
+
+    if (type != GEMM_F32) {
+        return memcmp(mat_c, mat_ref, cnt * ((type == GEMM_Q31) ? sizeof(q31_t) : sizeof(q15_t))) == 0 ? 0 : -1;
+    }
+    for (i = 0; i < cnt; i++) {
+        ref = ((float32_t *)mat_ref)[i];
+        diff = ((float32_t *)mat_c)[i] - ref;
+        diff = (diff < 0) ? -diff : diff;
+        ref = (ref < 0) ? -ref : ref;
+        if (diff > DELTAF32 * (ref + size)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int boot_hart_main(void)
+{
+    static const char *names[] = {"f32", "q31", "q15"};
+    uint64_t ref_cycles, gemm_cycles;
+    uint32_t size;
+    uint16_t type;
+    int errors = 0;
+
+    gemm_plan_init(&plan);
+    printf("Cache blocked matrix multiply, L1 D-Cache %lu bytes, cluster cache %lu bytes, %d parts\n",
+           (unsigned long)plan.l1_size, (unsigned long)plan.l2_size, GEMM_PARTS);
+    printf("CSV, type, size, mc, kc, nc, riscv_mat_mult cycles, gemm cycles\n");
+    for (type = GEMM_F32; type <= GEMM_Q15; type++) {
+        for (size = 16; size <= GEMM_MAX_SIZE; size *= 2) {
+            fill_inputs(type, size);
+            ref_cycles = run_ref(type, size);
+            gemm_cycles = run_gemm(type, size);
+            printf("CSV, %s, %lu, %u, %u, %u, %lu, %lu\n", names[type], (unsigned long)size,
+                   plan.mc, plan.kc, plan.nc, (unsigned long)ref_cycles, (unsigned long)gemm_cycles);
+            if (gemm_cycles == 0 || check_result(type, size) != 0) {
+                printf("ERROR, gemm_mat_mult_%s size %lu result mismatch\n", names[type], (unsigned long)size);
+                errors++;
+            }
+        }
+    }
+    if (errors) {
+        printf("GEMM demo failed\n");
+        return 1;
+    }
+    printf("GEMM demo passed\n");
+    return 0;
+}
+
+#if GEMM_PARTS > 1
+static void other_harts_main(unsigned long part)
+{
+    uint32_t seq = 0;
+
+    while (1) {
+        while (job_seq == seq);
+        __SMP_RWMB();
+        seq = job_seq;
+        run_part(part);
+        __SMP_RWMB();
+        __AMOADD_W((volatile int32_t *)&job_done, 1);
+    }
+}
+
+/* Reimplementation of smp_main for multi-harts */
+int smp_main(void)
+{
+    if (__get_hart_id() == BOOT_HARTID) {
+        return boot_hart_main();
+    }
+    other_harts_main(__get_hart_index());
+    return 0;
+}
+#endif
+
+int main(void)
+{
+#if GEMM_PARTS > 1
+    return smp_main();
+#else
+    return boot_hart_main();
+#endif
+}
@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include "nuclei_sdk_hal.h"
+#include "irqaffinity_api.h"
+
+#if !defined(__CIDU_PRESENT) || (__CIDU_PRESENT != 1)
+/* __CIDU_PRESENT shoulu be defined in <Device>.h */
+#warning "__CIDU_PRESENT is not defined or equal to 1, please check!"
+#warning "This example require CPU CIDU feature!"
+#endif
+
+#if !defined(SMP_CPU_CNT)
+#warning "This example require CPU SMP feature!"
+#error "SMP_CPU_CNT macro is not defined, please set SMP_CPU_CNT to integer value > 1"
+#endif
+
+/*
+ * UART0 receive interrupt is managed by irq affinity service, type in the
+ * serial terminal to trigger it, each received char costs HANDLER_LOOPS loops
+ * to simulate a heavy device handler.
+ * - first DEMO_PERIODS seconds: IRQAFF_SPREAD to all harts, the first coming hart claims it
+ * - next DEMO_PERIODS seconds: IRQAFF_PIN to the last hart
+ * - last DEMO_PERIODS seconds: IRQAFF_BALANCE between all harts, rebalanced every second
+ */
+#define DEMO_PERIODS            5
+#define HANDLER_LOOPS           2000
+#define INTLEVEL                1
+#define INTPRIORITY             0
+#define ALL_HARTS               ((1UL << SMP_CPU_CNT) - 1)
+
+static volatile uint32_t boothart_ready = 0;
+static volatile uint32_t chars_received = 0;
+
+#if defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1)
+static void uart0_rx_handler(void)
+{
+    int32_t status = uart_get_status(SOC_DEBUG_UART);
+
+    if (status & UART_IP_RXIP_MASK) {
+        // Clear rx pending
+        uart_clear_status(SOC_DEBUG_UART, UART_IP_RXIP_MASK);
+        (void)uart_read(SOC_DEBUG_UART);
+        __AMOADD_W((volatile int32_t *)&chars_received, 1);
+        for (volatile int i = 0; i < HANDLER_LOOPS; i++);
+    }
+}
+
+static void run_periods(const char *name)
+{
+    uint64_t last[SMP_CPU_CNT], now;
+    uint32_t hart;
+    int moved;
+
+    for (hart = 0; hart < SMP_CPU_CNT; hart++) {
+        last[hart] = irqaff_hart_load(hart);
+    }
+    for (int i = 0; i < DEMO_PERIODS; i++) {
+        delay_1ms(1000);
+        moved = irqaff_balance();
+        printf("%s: %lu chars, route 0x%lx, moved %d, cycles per hart:", name, (unsigned long)chars_received,
+               (unsigned long)irqaff_get_route(UART0_IRQn), moved);
+        for (hart = 0; hart < SMP_CPU_CNT; hart++) {
+            now = irqaff_hart_load(hart);
+            printf(" %lu", (unsigned long)(now - last[hart]));
+            last[hart] = now;
+        }
+        printf("\n");
+    }
+}
+
+static int boot_hart_main(void)
+{
+    if (irqaff_register(UART0_IRQn, uart0_rx_handler, INTLEVEL, INTPRIORITY, IRQAFF_SPREAD, ALL_HARTS) != 0) {
+        printf("Unable to register UART0 interrupt!\n");
+        return -1;
+    }
+    irqaff_hart_init();
+    __enable_irq();
+    uart_enable_rxint(SOC_DEBUG_UART);
+    boothart_ready = 1;
+    __SMP_RWMB();
+
+    printf("Type in the terminal to trigger uart receive interrupt\n");
+    run_periods("spread");
+    irqaff_set_affinity(UART0_IRQn, IRQAFF_PIN, 1UL << (SMP_CPU_CNT - 1));
+    run_periods("pin");
+    irqaff_set_affinity(UART0_IRQn, IRQAFF_BALANCE, ALL_HARTS);
+    run_periods("balance");
+
+    irqaff_dump();
+    printf("IRQ affinity demo finished\n");
+    return 0;
+}
+
+static void other_harts_main(void)
+{
+    while (boothart_ready == 0);
+    irqaff_hart_init();
+    __enable_irq();
+    while (1);
+}
+#endif
+
+/* Reimplementation of smp_main for multi-harts */
+int smp_main(void)
+{
+    int ret = 0;
+    unsigned long hartid = __get_hart_id();
+
+    if ((__RV_CSR_READ(CSR_MCFG_INFO) & MCFG_INFO_SMP) == 0) {
+        if (hartid == BOOT_HARTID) {
+            printf("[WARN] SMP & CIDU not present! Exit now!\n");
+        }
+        return 0;
+    }
+#if defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1)
+    if (hartid == BOOT_HARTID) {
+        ret = boot_hart_main();
+    } else {
+        other_harts_main();
+    }
+#else
+    if (hartid == BOOT_HARTID) {
+        printf("[ERROR]__CIDU_PRESENT must be defined as 1 in <Device>.h!\r\n");
+    }
+#endif
+    return ret;
+}
+
+int main(void)
+{
+    return smp_main();
+}
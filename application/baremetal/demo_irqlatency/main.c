@@ -0,0 +1,143 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+#else
+#error "This example require CPU ECLIC feature"
+#endif
+
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+#else
+#error "This example require CPU System Timer feature"
+#endif
+
+/*
+ * Measure interrupt latency of software interrupt in ECLIC vector and
+ * non-vector mode, each sample triggers the software interrupt and measures:
+ * - entry: cycles from triggering to the first statement of handler
+ * - exit: cycles from the last statement of handler to the interrupted code
+ * For non-vector mode, the context saving and restoring of the common
+ * interrupt entry are counted, and in vector mode, the registers saved by
+ * __INTERRUPT handler prologue are counted.
+ * The cycles read overhead is measured and subtracted from each sample.
+ */
+#define IRQ_SAMPLES             64
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} lat_stat_t;
+
+static volatile uint64_t irq_enter, irq_leave;
+static volatile uint32_t irq_hit = 0;
+static uint32_t read_cost;
+
+// non-vector mode interrupt
+void nonvec_msip_handler(void)
+{
+    irq_enter = __get_rv_cycle();
+    SysTimer_ClearSWIRQ();
+    irq_hit++;
+    irq_leave = __get_rv_cycle();
+}
+
+// vector mode interrupt, no nesting, so no CSR context saving required
+__INTERRUPT void vec_msip_handler(void)
+{
+    irq_enter = __get_rv_cycle();
+    SysTimer_ClearSWIRQ();
+    irq_hit++;
+    irq_leave = __get_rv_cycle();
+}
+
+static void lat_update(lat_stat_t *stat, uint64_t cycles)
+{
+    uint32_t lat = (cycles > read_cost) ? (uint32_t)(cycles - read_cost) : 0;
+
+    stat->min = (lat < stat->min) ? lat : stat->min;
+    stat->max = (lat > stat->max) ? lat : stat->max;
+    stat->sum += lat;
+}
+
+static void lat_print(const char *mode, const char *name, const lat_stat_t *stat)
+{
+    printf("CSV, %s_%s, %lu, %lu, %lu\n", mode, name, (unsigned long)stat->min,
+           (unsigned long)(stat->sum / IRQ_SAMPLES), (unsigned long)stat->max);
+}
+
+static uint32_t measure_read_cost(void)
+{
+    uint64_t start, end;
+    uint32_t cost = 0xFFFFFFFF;
+
+    for (int i = 0; i < 8; i++) {
+        start = __get_rv_cycle();
+        end = __get_rv_cycle();
+        cost = (end - start < cost) ? (uint32_t)(end - start) : cost;
+    }
+    return cost;
+}
+
+static int measure_irq(const char *mode, uint8_t shv, void *handler)
+{
+    lat_stat_t entry = {0xFFFFFFFF, 0, 0}, leave = {0xFFFFFFFF, 0, 0};
+    uint64_t start, end;
+    uint32_t hit;
+
+    if (ECLIC_Register_IRQ(SysTimerSW_IRQn, shv, ECLIC_LEVEL_TRIGGER, 1, 0, handler) != 0) {
+        printf("ERROR, register %s software interrupt failed\n", mode);
+        return -1;
+    }
+    for (uint32_t i = 0; i < IRQ_SAMPLES; i++) {
+        hit = irq_hit;
+        start = __get_rv_cycle();
+        SysTimer_SetSWIRQ();
+        while (irq_hit == hit);
+        end = __get_rv_cycle();
+        lat_update(&entry, irq_enter - start);
+        lat_update(&leave, end - irq_leave);
+    }
+    ECLIC_DisableIRQ(SysTimerSW_IRQn);
+    lat_print(mode, "entry", &entry);
+    lat_print(mode, "exit", &leave);
+    return 0;
+}
+
+int main(void)
+{
+    CSR_MCFGINFO_Type mcfg_info;
+    int ret = 0;
+
+#if defined(CPU_SERIES) && CPU_SERIES == 100
+    mcfg_info.b.clic = 1;
+#else
+    mcfg_info.d = __RV_CSR_READ(CSR_MCFG_INFO);
+#endif
+
+    if (0 == mcfg_info.b.clic) {
+        printf("ECLIC is not present, will not run this example!\r\n");
+        return 0;
+    }
+
+    read_cost = measure_read_cost();
+    printf("Software interrupt latency benchmark, %d samples, cycle read cost %lu\n",
+           IRQ_SAMPLES, (unsigned long)read_cost);
+#if defined(ECLIC_HW_CTX_AUTO) && defined(CFG_HAS_ECLICV2)
+    printf("Context save: ECLIC hardware auto-save\n");
+#else
+    printf("Context save: software\n");
+#endif
+    __enable_irq();
+    printf("CSV, IRQ, Min, Avg, Max\n");
+    ret |= measure_irq("nonvector", ECLIC_NON_VECTOR_INTERRUPT, (void *)nonvec_msip_handler);
+    ret |= measure_irq("vector", ECLIC_VECTOR_INTERRUPT, (void *)vec_msip_handler);
+    __disable_irq();
+    if (ret) {
+        printf("IRQ latency benchmark failed\n");
+        return 1;
+    }
+    printf("IRQ latency benchmark finished\n");
+    return 0;
+}
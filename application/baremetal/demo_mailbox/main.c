@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "mailbox_api.h"
+
+#if !defined(__riscv_atomic)
+#error "RVA(atomic) extension is required for SMP"
+#endif
+
+#if !defined(SMP_CPU_CNT)
+#warning "This example require CPU SMP feature!"
+#error "SMP_CPU_CNT macro is not defined, please set SMP_CPU_CNT to integer value > 1"
+#endif
+
+/*
+ * All harts form a pipeline ring: hart n receives messages from hart n-1,
+ * adds its hart index to the value, and forwards them to hart n+1.
+ * The boot hart feeds the pipeline in batches of 1 and MBOX_SLOT_NUM messages,
+ * and checks the results coming back, with batching, the doorbell is rung once
+ * per batch instead of once per message.
+ */
+#define MSG_COUNT               1024
+#define ROUNDS                  2
+
+typedef struct {
+    uint32_t seq;
+    uint32_t value;
+} pipe_msg_t;
+
+static const uint32_t round_batch[ROUNDS] = {1, MBOX_SLOT_NUM};
+
+static volatile uint32_t ready = 0;
+static volatile int32_t round_done = 0;
+static volatile uint32_t finished = 0;
+static uint32_t hart_doorbells[ROUNDS][SMP_CPU_CNT];
+
+static void stage_main(unsigned long me, unsigned long prev, unsigned long next)
+{
+    mbox_stats_t stats;
+    pipe_msg_t msg;
+    uint32_t r, i;
+
+    for (r = 0; r < ROUNDS; r++) {
+        for (i = 0; i < MSG_COUNT; i++) {
+            if (mbox_tryrecv(prev, &msg, sizeof(msg)) == MBOX_EMPTY) {
+                // nothing more to receive now, pass what we have to next hart
+                mbox_flush(next);
+                mbox_recv(prev, &msg, sizeof(msg));
+            }
+            msg.value += me;
+            while (mbox_post(next, &msg, sizeof(msg)) == MBOX_FULL) {
+                mbox_flush(next);
+            }
+        }
+        mbox_flush(next);
+        mbox_get_stats(next, &stats);
+        hart_doorbells[r][me] = stats.doorbells;
+        __AMOADD_W(&round_done, 1);
+    }
+}
+
+static int lead_main(unsigned long me, unsigned long prev, unsigned long next)
+{
+    mbox_stats_t stats;
+    pipe_msg_t msg;
+    uint32_t r, i, batch, sent, recvd, errors = 0;
+    uint32_t expect_add = 0, total, last;
+    uint64_t start, cost;
+
+    for (i = 0; i < SMP_CPU_CNT; i++) {
+        expect_add += (i != me) ? i : 0;
+    }
+    for (r = 0; r < ROUNDS; r++) {
+        batch = round_batch[r];
+        sent = 0;
+        recvd = 0;
+        start = __get_rv_cycle();
+        while (recvd < MSG_COUNT) {
+            // feed one batch and wait until it comes back
+            for (i = 0; i < batch && sent < MSG_COUNT; i++) {
+                msg.seq = sent;
+                msg.value = sent;
+                mbox_post(next, &msg, sizeof(msg));
+                sent++;
+            }
+            mbox_flush(next);
+            while (recvd < sent) {
+                mbox_recv(prev, &msg, sizeof(msg));
+                if (msg.seq != recvd || msg.value != recvd + expect_add) {
+                    errors++;
+                }
+                recvd++;
+            }
+        }
+        cost = __get_rv_cycle() - start;
+        mbox_get_stats(next, &stats);
+        hart_doorbells[r][me] = stats.doorbells;
+        while (round_done < (int32_t)((r + 1) * (SMP_CPU_CNT - 1)));
+        __SMP_RWMB();
+
+        total = 0;
+        for (i = 0; i < SMP_CPU_CNT; i++) {
+            last = (r == 0) ? 0 : hart_doorbells[r - 1][i];
+            total += hart_doorbells[r][i] - last;
+        }
+        printf("CSV, mailbox_batch%u_cycles_per_msg, %lu\n", batch, (unsigned long)(cost / MSG_COUNT));
+        printf("CSV, mailbox_batch%u_doorbells, %u\n", batch, total);
+    }
+    if (errors) {
+        printf("%u messages mismatch!\n", errors);
+    }
+    return errors;
+}
+
+/* Reimplementation of smp_main for multi-harts */
+int smp_main(void)
+{
+    unsigned long hartid = __get_hart_id();
+    unsigned long me = __get_hart_index();
+    unsigned long prev = (me + SMP_CPU_CNT - 1) % SMP_CPU_CNT;
+    unsigned long next = (me + 1) % SMP_CPU_CNT;
+    int doorbell, ret = 0;
+
+    if (hartid == BOOT_HARTID) {
+        doorbell = mbox_init(MBOX_DOORBELL_AUTO);
+        __enable_irq();
+        printf("Mailbox demo, %d harts, doorbell %s\n", SMP_CPU_CNT,
+               (doorbell == MBOX_DOORBELL_CIDU) ? "CIDU" : "CLINT");
+        ready = 1;
+        __SMP_RWMB();
+        ret = lead_main(me, prev, next);
+        printf("Mailbox demo finished\n");
+        finished = 1;
+        __SMP_RWMB();
+    } else {
+        while (ready == 0);
+        mbox_init(MBOX_DOORBELL_AUTO);
+        __enable_irq();
+        stage_main(me, prev, next);
+        // Attention: must wait until boot hart stop print,
+        // because the _postmain_fini will print some dummy '\0', which has no lock-protecting
+        while (finished == 0);
+    }
+    return ret;
+}
+
+int main(void)
+{
+    return smp_main();
+}
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "nmsis_bench.h"
+#include "nnfuse_api.h"
+
+/*
+ * Run the same int8 graph op by op and fused with nnfuse, compare the
+ * outputs which must be bit exact, and report cycles, activation bytes
+ * and D-Cache misses of each op or fused group:
+ *
+ *   in(64x64x8) -> conv3x3(16) -> relu6 -> maxpool2x2
+ *   -> conv3x3(32) -> relu -> avgpool2x2 -> conv1x1(16)
+ *
+ * The conv outputs are 64KB and 32KB, larger than usual L1 D-Cache,
+ * when TILE_IN_DLM is defined, the tile buffer is placed in DLM.
+ */
+#define IN_H                    64
+#define IN_W                    64
+#define IN_C                    8
+#define TILE_SIZE               (16 * 1024)
+#define ACT_SIZE                (64 * 64 * 16)
+
+BENCH_DECLARE_VAR();
+
+static int32_t mults[32], shifts[32], bias[32];
+static int8_t conv1_w[16 * 3 * 3 * IN_C], conv2_w[32 * 3 * 3 * 16], conv3_w[16 * 32];
+
+#define ACT_S8                  {-128, 127}
+#define QUANT                   {mults, shifts}
+
+static const nnfuse_conv_t conv1 = {
+    {0, 0, {1, 1}, {1, 1}, {1, 1}, ACT_S8}, QUANT, {16, 3, 3, IN_C}, {1, 1, 1, 16}, conv1_w, bias
+};
+static const nnfuse_conv_t conv2 = {
+    {0, 0, {1, 1}, {1, 1}, {1, 1}, ACT_S8}, QUANT, {32, 3, 3, 16}, {1, 1, 1, 32}, conv2_w, bias
+};
+static const nnfuse_conv_t conv3 = {
+    {0, 0, {1, 1}, {0, 0}, {1, 1}, ACT_S8}, QUANT, {16, 1, 1, 32}, {1, 1, 1, 16}, conv3_w, bias
+};
+static const nnfuse_pool_t pool2x2 = {
+    {{2, 2}, {0, 0}, ACT_S8}, {1, 2, 2, 1}
+};
+
+static const nnfuse_op_t ops[] = {
+    {NNFUSE_CONV, &conv1, {1, 64, 64, IN_C}, {1, 64, 64, 16}},
+    {NNFUSE_RELU6, NULL, {1, 64, 64, 16}, {1, 64, 64, 16}},
+    {NNFUSE_MAXPOOL, &pool2x2, {1, 64, 64, 16}, {1, 32, 32, 16}},
+    {NNFUSE_CONV, &conv2, {1, 32, 32, 16}, {1, 32, 32, 32}},
+    {NNFUSE_RELU, NULL, {1, 32, 32, 32}, {1, 32, 32, 32}},
+    {NNFUSE_AVGPOOL, &pool2x2, {1, 32, 32, 32}, {1, 16, 16, 32}},
+    {NNFUSE_CONV, &conv3, {1, 16, 16, 32}, {1, 16, 16, 16}},
+};
+
+#define OP_CNT                  (sizeof(ops) / sizeof(ops[0]))
+#define OUT_SIZE                (16 * 16 * 16)
+
+static int8_t input[IN_H * IN_W * IN_C];
+static int8_t act0[ACT_SIZE], act1[ACT_SIZE];
+static int8_t out_ref[OUT_SIZE], out_fused[OUT_SIZE];
+#ifndef TILE_IN_DLM
+static int8_t tile_buf[TILE_SIZE] __attribute__((aligned(8)));
+#endif
+static nnfuse_stats_t stats[OP_CNT];
+static uint32_t seed = 1;
+
+static void fill_s8(int8_t *buf, uint32_t cnt)
+{
+    for (uint32_t i = 0; i < cnt; i++) {
+        seed = seed * 1664525 + 1013904223;
+        buf[i] = (int8_t)(seed >> 24);
+    }
+}
+
+int main(void)
+{
+    nnfuse_graph_t graph = {ops, OP_CNT, NULL, TILE_SIZE, {act0, act1}};
+    int32_t ret;
+
+    BENCH_INIT();
+    HPM_INIT();
+#ifdef TILE_IN_DLM
+    graph.tile = (int8_t *)ONCHIP_DLM_BASE;
+#else
+    graph.tile = tile_buf;
+#endif
+    for (uint32_t i = 0; i < 32; i++) {
+        mults[i] = 1073741824;
+        shifts[i] = -7;
+        bias[i] = (int32_t)(i * 37 % 64) - 32;
+    }
+    fill_s8(conv1_w, sizeof(conv1_w));
+    fill_s8(conv2_w, sizeof(conv2_w));
+    fill_s8(conv3_w, sizeof(conv3_w));
+    fill_s8(input, sizeof(input));
+
+    ret = nnfuse_run(&graph, input, out_ref, 0, stats);
+    if (ret != NNFUSE_OK) {
+        printf("ERROR, unfused graph failed %ld\n", (long)ret);
+        return 1;
+    }
+    nnfuse_report(&graph, stats, "unfused");
+    ret = nnfuse_run(&graph, input, out_fused, 1, stats);
+    if (ret != NNFUSE_OK) {
+        printf("ERROR, fused graph failed %ld\n", (long)ret);
+        return 1;
+    }
+    nnfuse_report(&graph, stats, "fused");
+    if (memcmp(out_ref, out_fused, OUT_SIZE) != 0) {
+        printf("ERROR, fused output mismatch\n");
+        return 1;
+    }
+    printf("Fused output is bit exact\n");
+    return 0;
+}
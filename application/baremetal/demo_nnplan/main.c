@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "riscv_nnfunctions.h"
+#include "nnplan_api.h"
+
+/*
+ * A small int8 CNN with a residual add is described as a layer list, the
+ * scratch sizes come from the NMSIS-NN {API}_get_buffer_size() functions,
+ * then nnplan packs all activations and scratch into one arena.
+ * The model is run with the planned arena and with a naive table where
+ * each buffer has its own memory, the outputs must be the same.
+ *
+ *   in(16x16x3) -> conv3x3(8) -> dwconv3x3 -> add(conv, dwconv) -> maxpool2x2
+ *   -> conv1x1(16) -> avgpool8x8 -> fc(10) -> softmax
+ */
+#define ARENA_MAX               8192
+#define NAIVE_MAX               12288
+
+enum { T_IN, T_CONV, T_DW, T_ADD, T_POOL, T_CONV1, T_AVG, T_FC, T_OUT, TENSOR_CNT };
+
+typedef struct {
+    nmsis_nn_conv_params conv;
+    nmsis_nn_per_channel_quant_params quant;
+    nmsis_nn_dims in, filter, bias, out;
+    const int8_t *weights;
+    const int32_t *bias_data;
+} conv_param_t;
+
+typedef struct {
+    nmsis_nn_dw_conv_params conv;
+    nmsis_nn_per_channel_quant_params quant;
+    nmsis_nn_dims in, filter, bias, out;
+    const int8_t *weights;
+    const int32_t *bias_data;
+} dw_param_t;
+
+typedef struct {
+    nmsis_nn_pool_params pool;
+    nmsis_nn_dims in, filter, out;
+} pool_param_t;
+
+typedef struct {
+    nmsis_nn_fc_params fc;
+    nmsis_nn_per_tensor_quant_params quant;
+    nmsis_nn_dims in, filter, bias, out;
+    const int8_t *weights;
+    const int32_t *bias_data;
+} fc_param_t;
+
+static int32_t mults[16], shifts[16], bias[16];
+static int8_t conv_w[8 * 3 * 3 * 3], dw_w[3 * 3 * 8], conv1_w[16 * 8], fc_w[16 * 10];
+
+#define ACT_S8                  {-128, 127}
+#define QUANT                   {mults, shifts}
+
+static conv_param_t conv_param = {
+    {0, 0, {1, 1}, {1, 1}, {1, 1}, ACT_S8}, QUANT,
+    {1, 16, 16, 3}, {8, 3, 3, 3}, {1, 1, 1, 8}, {1, 16, 16, 8}, conv_w, bias
+};
+static dw_param_t dw_param = {
+    {0, 0, 1, {1, 1}, {1, 1}, {1, 1}, ACT_S8}, QUANT,
+    {1, 16, 16, 8}, {1, 3, 3, 8}, {1, 1, 1, 8}, {1, 16, 16, 8}, dw_w, bias
+};
+static pool_param_t maxpool_param = {
+    {{2, 2}, {0, 0}, ACT_S8}, {1, 16, 16, 8}, {1, 2, 2, 1}, {1, 8, 8, 8}
+};
+static conv_param_t conv1_param = {
+    {0, 0, {1, 1}, {0, 0}, {1, 1}, ACT_S8}, QUANT,
+    {1, 8, 8, 8}, {16, 1, 1, 8}, {1, 1, 1, 16}, {1, 8, 8, 16}, conv1_w, bias
+};
+static pool_param_t avgpool_param = {
+    {{8, 8}, {0, 0}, ACT_S8}, {1, 8, 8, 16}, {1, 8, 8, 1}, {1, 1, 1, 16}
+};
+static fc_param_t fc_param = {
+    {0, 0, 0, ACT_S8}, {1073741824, -4},
+    {1, 1, 1, 16}, {16, 1, 1, 10}, {1, 1, 1, 10}, {1, 1, 1, 10}, fc_w, bias
+};
+
+static riscv_nmsis_nn_status run_conv(const void *param, const nmsis_nn_context *ctx,
+                                      const int8_t *const *inputs, int8_t *output)
+{
+    const conv_param_t *p = param;
+
+    return riscv_convolve_wrapper_s8(ctx, &p->conv, &p->quant, &p->in, inputs[0], &p->filter, p->weights,
+                                     &p->bias, p->bias_data, &p->out, output);
+}
+
+static riscv_nmsis_nn_status run_dw(const void *param, const nmsis_nn_context *ctx,
+                                    const int8_t *const *inputs, int8_t *output)
+{
+    const dw_param_t *p = param;
+
+    return riscv_depthwise_conv_wrapper_s8(ctx, &p->conv, &p->quant, &p->in, inputs[0], &p->filter, p->weights,
+                                           &p->bias, p->bias_data, &p->out, output);
+}
+
+static riscv_nmsis_nn_status run_add(const void *param, const nmsis_nn_context *ctx,
+                                     const int8_t *const *inputs, int8_t *output)
+{
+    /* output = (input1 + input2) / 2 */
+    return riscv_elementwise_add_s8(inputs[0], inputs[1], 0, 1073741824, 0, 0, 1073741824, 0, 20,
+                                    output, 0, 1073741824, -20, -128, 127, 16 * 16 * 8);
+}
+
+static riscv_nmsis_nn_status run_maxpool(const void *param, const nmsis_nn_context *ctx,
+                                         const int8_t *const *inputs, int8_t *output)
+{
+    const pool_param_t *p = param;
+
+    return riscv_max_pool_s8(ctx, &p->pool, &p->in, inputs[0], &p->filter, &p->out, output);
+}
+
+static riscv_nmsis_nn_status run_avgpool(const void *param, const nmsis_nn_context *ctx,
+                                         const int8_t *const *inputs, int8_t *output)
+{
+    const pool_param_t *p = param;
+
+    return riscv_avgpool_s8(ctx, &p->pool, &p->in, inputs[0], &p->filter, &p->out, output);
+}
+
+static riscv_nmsis_nn_status run_fc(const void *param, const nmsis_nn_context *ctx,
+                                    const int8_t *const *inputs, int8_t *output)
+{
+    const fc_param_t *p = param;
+
+    /* the kernel sums are in scratch, which is only valid in this layer, so compute them each time */
+    if (ctx->buf != NULL) {
+        riscv_vector_sum_s8(ctx->buf, p->filter.n, p->out.c, p->weights, p->fc.input_offset,
+                            p->fc.filter_offset, p->bias_data);
+    }
+    return riscv_fully_connected_s8(ctx, &p->fc, &p->quant, &p->in, inputs[0], &p->filter, p->weights,
+                                    &p->bias, p->bias_data, &p->out, output);
+}
+
+static riscv_nmsis_nn_status run_softmax(const void *param, const nmsis_nn_context *ctx,
+                                         const int8_t *const *inputs, int8_t *output)
+{
+    riscv_softmax_s8(inputs[0], 1, 10, 1077952640, 19, -248, output);
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+static const uint32_t tensor_size[TENSOR_CNT] = {
+    16 * 16 * 3, 16 * 16 * 8, 16 * 16 * 8, 16 * 16 * 8, 8 * 8 * 8, 8 * 8 * 16, 16, 10, 10
+};
+
+#define ONE_INPUT(t)            {(t), NNPLAN_NONE}
+
+static nnplan_layer_t layers[] = {
+    {run_conv, &conv_param, ONE_INPUT(T_IN), T_CONV, 0},
+    {run_dw, &dw_param, ONE_INPUT(T_CONV), T_DW, 0},
+    {run_add, NULL, {T_CONV, T_DW}, T_ADD, 0},
+    {run_maxpool, &maxpool_param, ONE_INPUT(T_ADD), T_POOL, 0},
+    {run_conv, &conv1_param, ONE_INPUT(T_POOL), T_CONV1, 0},
+    {run_avgpool, &avgpool_param, ONE_INPUT(T_CONV1), T_AVG, 0},
+    {run_fc, &fc_param, ONE_INPUT(T_AVG), T_FC, 0},
+    {run_softmax, NULL, ONE_INPUT(T_FC), T_OUT, 0},
+};
+
+#define LAYER_CNT               (sizeof(layers) / sizeof(layers[0]))
+
+static uint32_t offsets[TENSOR_CNT + LAYER_CNT];
+static uint32_t naive_offsets[TENSOR_CNT + LAYER_CNT];
+static int8_t arena[ARENA_MAX] __attribute__((aligned(NNPLAN_ALIGN)));
+static int8_t naive_arena[NAIVE_MAX] __attribute__((aligned(NNPLAN_ALIGN)));
+static int8_t input[16 * 16 * 3];
+static int8_t output[10];
+static uint32_t seed = 1;
+
+static int8_t rand_s8(void)
+{
+    seed = seed * 1664525 + 1013904223;
+    return (int8_t)(seed >> 24);
+}
+
+static void fill_s8(int8_t *buf, uint32_t cnt)
+{
+    for (uint32_t i = 0; i < cnt; i++) {
+        buf[i] = rand_s8();
+    }
+}
+
+static void init_model(void)
+{
+    for (uint32_t i = 0; i < 16; i++) {
+        mults[i] = 1073741824;
+        shifts[i] = -6;
+        bias[i] = (int32_t)rand_s8() * 16;
+    }
+    fill_s8(conv_w, sizeof(conv_w));
+    fill_s8(dw_w, sizeof(dw_w));
+    fill_s8(conv1_w, sizeof(conv1_w));
+    fill_s8(fc_w, sizeof(fc_w));
+    fill_s8(input, sizeof(input));
+
+    layers[0].scratch_size = riscv_convolve_wrapper_s8_get_buffer_size(&conv_param.conv, &conv_param.in,
+                                                                       &conv_param.filter, &conv_param.out);
+    layers[1].scratch_size = riscv_depthwise_conv_wrapper_s8_get_buffer_size(&dw_param.conv, &dw_param.in,
+                                                                             &dw_param.filter, &dw_param.out);
+    layers[4].scratch_size = riscv_convolve_wrapper_s8_get_buffer_size(&conv1_param.conv, &conv1_param.in,
+                                                                       &conv1_param.filter, &conv1_param.out);
+    layers[5].scratch_size = riscv_avgpool_s8_get_buffer_size(avgpool_param.out.w, avgpool_param.in.c);
+    layers[6].scratch_size = riscv_fully_connected_s8_get_buffer_size(&fc_param.filter);
+}
+
+static uint64_t run_model(const nnplan_t *plan, int8_t *buf)
+{
+    uint64_t start;
+
+    memcpy(nnplan_tensor(plan, buf, T_IN), input, sizeof(input));
+    start = __get_rv_cycle();
+    if (nnplan_invoke(plan, buf) != RISCV_NMSIS_NN_SUCCESS) {
+        printf("Model invoke failed\n");
+    }
+    return __get_rv_cycle() - start;
+}
+
+int main(void)
+{
+    nnplan_t plan = {layers, tensor_size, LAYER_CNT, TENSOR_CNT, NULL, 0};
+    nnplan_t naive = {layers, tensor_size, LAYER_CNT, TENSOR_CNT, naive_offsets, 0};
+    uint64_t plan_cycles, naive_cycles;
+    uint32_t i, size;
+
+    init_model();
+    if (nnplan_plan(&plan, offsets) != NNPLAN_OK || nnplan_check(&plan) != NNPLAN_OK) {
+        printf("Plan model failed\n");
+        return 1;
+    }
+    /* naive table, each buffer has its own memory */
+    for (i = 0; i < NNPLAN_OFFSET_CNT(&naive); i++) {
+        naive_offsets[i] = naive.arena_size;
+        size = (i < TENSOR_CNT) ? tensor_size[i] : layers[i - TENSOR_CNT].scratch_size;
+        naive.arena_size += (size + NNPLAN_ALIGN - 1) & ~(NNPLAN_ALIGN - 1);
+    }
+    nnplan_dump(&plan, "demo_model");
+    printf("Arena %lu bytes, naive %lu bytes\n", (unsigned long)plan.arena_size, (unsigned long)naive.arena_size);
+    if (plan.arena_size > ARENA_MAX || naive.arena_size > NAIVE_MAX) {
+        printf("ARENA_MAX or NAIVE_MAX is too small\n");
+        return 1;
+    }
+
+    naive_cycles = run_model(&naive, naive_arena);
+    memcpy(output, nnplan_tensor(&naive, naive_arena, T_OUT), sizeof(output));
+    plan_cycles = run_model(&plan, arena);
+    printf("CSV, naive, %lu\n", (unsigned long)naive_cycles);
+    printf("CSV, nnplan, %lu\n", (unsigned long)plan_cycles);
+    if (memcmp(output, nnplan_tensor(&plan, arena, T_OUT), sizeof(output)) != 0) {
+        printf("ERROR, model output with planned arena mismatch\n");
+        return 1;
+    }
+    printf("Model output matched, arena saves %lu bytes\n", (unsigned long)(naive.arena_size - plan.arena_size));
+    return 0;
+}
@@ -0,0 +1,153 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <stdlib.h>
+#include "nuclei_sdk_soc.h"
+#include "overlay_api.h"
+
+/*
+ * Runtime code overlay demo, the same crc and sort code is run from flash
+ * and from the crc and sort overlays loaded into ILM window.
+ *
+ * - phase 1 calls each overlay many times after one load, the load cost is
+ *   paid once and the code runs at ILM speed
+ * - phase 2 alternates crc and sort call by call, each call evicts the other
+ *   overlay, which shows a bad grouping in the load statistics
+ *
+ * In flashxip download mode, the overlays are listed in ilm_overlay.ld of
+ * this directory, in other modes the overlay code runs in place.
+ */
+#define DATA_WORDS          256
+#define PHASE_CALLS         16
+
+OVERLAY_DEFINE(crc);
+OVERLAY_DEFINE(sort);
+
+static uint32_t data[DATA_WORDS];
+static uint32_t work[DATA_WORDS];
+
+__attribute__((always_inline)) static inline uint32_t crc32_calc(const uint32_t *buf, uint32_t words)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < words; i++) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 32; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+__attribute__((always_inline)) static inline void sort_calc(uint32_t *buf, uint32_t words)
+{
+    for (uint32_t i = 1; i < words; i++) {
+        uint32_t key = buf[i];
+        uint32_t j = i;
+        while ((j > 0) && (buf[j - 1] > key)) {
+            buf[j] = buf[j - 1];
+            j--;
+        }
+        buf[j] = key;
+    }
+}
+
+/* copies run from flash */
+__attribute__((noinline)) uint32_t crc32_xip(const uint32_t *buf, uint32_t words)
+{
+    return crc32_calc(buf, words);
+}
+
+__attribute__((noinline)) void sort_xip(uint32_t *buf, uint32_t words)
+{
+    sort_calc(buf, words);
+}
+
+/* copies run from ILM window */
+OVERLAY_TEXT(crc) uint32_t crc32_ovl(const uint32_t *buf, uint32_t words)
+{
+    return crc32_calc(buf, words);
+}
+
+OVERLAY_TEXT(sort) void sort_ovl(uint32_t *buf, uint32_t words)
+{
+    sort_calc(buf, words);
+}
+
+static void fill_work(void)
+{
+    for (int i = 0; i < DATA_WORDS; i++) {
+        work[i] = data[i];
+    }
+}
+
+int main(void)
+{
+    uint64_t start, xip_cycles, ovl_cycles;
+    uint32_t xip_crc = 0, ovl_crc = 0;
+    int errors = 0;
+
+    srand(__RV_CSR_READ(CSR_MCYCLE));
+    for (int i = 0; i < DATA_WORDS; i++) {
+        data[i] = (uint32_t)rand();
+    }
+    printf("Overlay demo, crc overlay %lu bytes, sort overlay %lu bytes\n",
+           (unsigned long)(OVERLAY(crc)->end - OVERLAY(crc)->start),
+           (unsigned long)(OVERLAY(sort)->end - OVERLAY(sort)->start));
+
+    /* phase 1: load once, call many times */
+    start = __get_rv_cycle();
+    for (int i = 0; i < PHASE_CALLS; i++) {
+        xip_crc ^= crc32_xip(data, DATA_WORDS);
+    }
+    xip_cycles = __get_rv_cycle() - start;
+    start = __get_rv_cycle();
+    for (int i = 0; i < PHASE_CALLS; i++) {
+        ovl_crc ^= OVERLAY_CALL(crc, crc32_ovl, data, DATA_WORDS);
+    }
+    ovl_cycles = __get_rv_cycle() - start;
+    errors += (xip_crc != ovl_crc);
+    printf("CSV, phase1_crc, xip %lu, overlay %lu\n", (unsigned long)xip_cycles, (unsigned long)ovl_cycles);
+
+    start = __get_rv_cycle();
+    for (int i = 0; i < PHASE_CALLS; i++) {
+        fill_work();
+        sort_xip(work, DATA_WORDS);
+    }
+    xip_cycles = __get_rv_cycle() - start;
+    xip_crc = crc32_xip(work, DATA_WORDS);
+    start = __get_rv_cycle();
+    for (int i = 0; i < PHASE_CALLS; i++) {
+        fill_work();
+        OVERLAY_CALL(sort, sort_ovl, work, DATA_WORDS);
+    }
+    ovl_cycles = __get_rv_cycle() - start;
+    ovl_crc = crc32_xip(work, DATA_WORDS);
+    errors += (xip_crc != ovl_crc);
+    printf("CSV, phase1_sort, xip %lu, overlay %lu\n", (unsigned long)xip_cycles, (unsigned long)ovl_cycles);
+
+    /* phase 2: alternate overlays call by call */
+    start = __get_rv_cycle();
+    for (int i = 0; i < PHASE_CALLS; i++) {
+        xip_crc = crc32_xip(data, DATA_WORDS);
+        fill_work();
+        sort_xip(work, DATA_WORDS);
+    }
+    xip_cycles = __get_rv_cycle() - start;
+    start = __get_rv_cycle();
+    for (int i = 0; i < PHASE_CALLS; i++) {
+        ovl_crc = OVERLAY_CALL(crc, crc32_ovl, data, DATA_WORDS);
+        fill_work();
+        OVERLAY_CALL(sort, sort_ovl, work, DATA_WORDS);
+    }
+    ovl_cycles = __get_rv_cycle() - start;
+    errors += (xip_crc != ovl_crc);
+    printf("CSV, phase2_mixed, xip %lu, overlay %lu\n", (unsigned long)xip_cycles, (unsigned long)ovl_cycles);
+
+    overlay_dump_stats();
+    if (errors) {
+        printf("overlay result mismatch\n");
+        return -1;
+    }
+    printf("overlay demo finished\n");
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "pmon_api.h"
+
+#if !defined(__riscv_atomic)
+#error "RVA(atomic) extension is required for SMP"
+#endif
+
+#if !defined(SMP_CPU_CNT)
+#warning "This example require CPU SMP feature!"
+#error "SMP_CPU_CNT macro is not defined, please set SMP_CPU_CNT to integer value > 1"
+#endif
+
+#if !defined(__SMPCC_PRESENT) || (__SMPCC_PRESENT != 1)
+#error "This example require SMPCC present!"
+#endif
+
+#ifndef MAX_L2_SIZE_KB
+#define MAX_L2_SIZE_KB          1024
+#endif
+
+/*
+ * All harts run the same three phases, and each phase is tagged by pmon_set_tag,
+ * so the pmon timeline shows how cluster cache behaves in each phase:
+ * - PHASE_FIT: each hart reads its own small buffer, which fits in cluster cache
+ * - PHASE_THRASH: each hart reads its own part of a buffer twice the cluster cache size
+ * - PHASE_SHARE: all harts write the same cache lines
+ */
+#define PHASE_FIT               1
+#define PHASE_THRASH            2
+#define PHASE_SHARE             3
+
+#define PHASE_MS                20
+#define CACHE_LINE_SIZE         64
+#define SMALL_BUF_SIZE          (16 * 1024)
+#define LARGE_BUF_SIZE          (2 * MAX_L2_SIZE_KB * 1024)
+#define SHARE_BUF_SIZE          (4 * CACHE_LINE_SIZE)
+
+static uint8_t small_buf[SMP_CPU_CNT][SMALL_BUF_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
+static uint8_t large_buf[LARGE_BUF_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
+static volatile uint8_t share_buf[SHARE_BUF_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
+
+static volatile uint32_t ready = 0;
+static volatile int32_t barrier_count = 0;
+static volatile uint32_t barrier_gen = 0;
+static volatile uint32_t checksum[SMP_CPU_CNT];
+
+/* wait until all harts arrive */
+static void smp_barrier(void)
+{
+    uint32_t gen = barrier_gen;
+
+    if (__AMOADD_W(&barrier_count, 1) == (SMP_CPU_CNT - 1)) {
+        barrier_count = 0;
+        __SMP_RWMB();
+        barrier_gen = gen + 1;
+    } else {
+        while (barrier_gen == gen);
+    }
+}
+
+static uint32_t read_lines(const volatile uint8_t *buf, unsigned long size)
+{
+    uint32_t sum = 0;
+
+    for (unsigned long i = 0; i < size; i += CACHE_LINE_SIZE) {
+        sum += buf[i];
+    }
+    return sum;
+}
+
+static void run_phase(unsigned long hartid, uint32_t phase)
+{
+    uint64_t end;
+    unsigned long part = LARGE_BUF_SIZE / SMP_CPU_CNT;
+    uint32_t sum = 0;
+
+    pmon_set_tag(phase);
+    smp_barrier();
+    end = SysTimer_GetLoadValue() + (uint64_t)SOC_TIMER_FREQ * PHASE_MS / 1000;
+    while (SysTimer_GetLoadValue() < end) {
+        switch (phase) {
+            case PHASE_FIT:
+                sum += read_lines(small_buf[hartid], SMALL_BUF_SIZE);
+                break;
+            case PHASE_THRASH:
+                sum += read_lines(&large_buf[hartid * part], part);
+                break;
+            default:
+                for (unsigned long i = 0; i < SHARE_BUF_SIZE; i += CACHE_LINE_SIZE) {
+                    share_buf[i] += 1;
+                }
+                break;
+        }
+    }
+    checksum[hartid] += sum;
+    pmon_set_tag(0);
+    smp_barrier();
+}
+
+/* Reimplementation of smp_main for multi-harts */
+int smp_main(void)
+{
+    unsigned long hartid = __get_hart_index();
+    int pairs = 0;
+
+    if (hartid == (BOOT_HARTID & 0xFF)) {
+        printf("SMPCC PMON timeline demo, %d harts, %d PMONs\n", SMP_CPU_CNT, SMPCC_GetPMONNum());
+        /* sample default events of all harts */
+        pairs = pmon_setup((1UL << SMP_CPU_CNT) - 1, NULL, 0);
+        if (pairs < 0) {
+            printf("No PMON available!\n");
+        } else {
+            printf("Sampling %d (client, event) pairs at %d Hz\n", pairs, PMON_SAMPLE_HZ);
+            pmon_on();
+        }
+        ready = 1;
+        __SMP_RWMB();
+    } else {
+        while (ready == 0);
+    }
+
+    run_phase(hartid, PHASE_FIT);
+    run_phase(hartid, PHASE_THRASH);
+    run_phase(hartid, PHASE_SHARE);
+
+    if (hartid == (BOOT_HARTID & 0xFF)) {
+        if (pairs > 0) {
+            pmon_off();
+            /* dump in console, use parse.py and pmon_parse.py to decode it */
+            pmon_collect(2);
+        }
+        printf("PMON timeline demo finished\n");
+        ready = 2;
+        __SMP_RWMB();
+    } else {
+        // Attention: must wait until boot hart stop print,
+        // because the _postmain_fini will print some dummy '\0', which has no lock-protecting
+        while (ready != 2);
+    }
+    return 0;
+}
+
+int main(void)
+{
+    return smp_main();
+}
@@ -0,0 +1,189 @@
+/*
+ * Interrupt entry and context switch benchmark of FreeRTOS port, build it with
+ * and without ECLIC hardware context auto-save to compare the cycles:
+ *   make XLCFG_ECLIC=2 ECLIC_HWCTX=0 run_qemu
+ *   make XLCFG_ECLIC=2 ECLIC_HWCTX=1 run_qemu
+ *
+ * - irq_entry: cycles from pending a non-vector interrupt to its handler
+ * - irq_exit: cycles from the end of handler to the interrupted task
+ * - task_switch: cycles from giving a notification to the woken higher priority task
+ * - task_switch_back: cycles from blocking in higher priority task to the lower one
+ * - isr_to_task: cycles from pending an interrupt to the task woken by its handler
+ *
+ * The cycle read overhead is measured and subtracted from each sample.
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdio.h>
+
+#include "nuclei_sdk_soc.h"
+
+#define BENCH_SAMPLES           64
+#define BENCH_IRQn              SOC_INT30_IRQn
+
+typedef struct {
+    const char *name;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} bench_stat_t;
+
+static bench_stat_t stats[] = {
+    {"irq_entry", 0xFFFFFFFF, 0, 0},
+    {"irq_exit", 0xFFFFFFFF, 0, 0},
+    {"task_switch", 0xFFFFFFFF, 0, 0},
+    {"task_switch_back", 0xFFFFFFFF, 0, 0},
+    {"isr_to_task", 0xFFFFFFFF, 0, 0},
+};
+
+enum {
+    STAT_IRQ_ENTRY,
+    STAT_IRQ_EXIT,
+    STAT_TASK_SWITCH,
+    STAT_TASK_SWITCH_BACK,
+    STAT_ISR_TO_TASK,
+    STAT_NUM,
+};
+
+static TaskHandle_t high_task;
+static volatile uint64_t stamp_trigger, stamp_enter, stamp_leave, stamp_wake, stamp_block;
+static volatile uint32_t irq_hit;
+static volatile uint32_t irq_notify;
+static uint32_t read_cost;
+
+static void stat_update(uint32_t id, uint64_t cycles)
+{
+    bench_stat_t *stat = &stats[id];
+    uint32_t val = (cycles > read_cost) ? (uint32_t)(cycles - read_cost) : 0;
+
+    stat->min = (val < stat->min) ? val : stat->min;
+    stat->max = (val > stat->max) ? val : stat->max;
+    stat->sum += val;
+}
+
+static uint32_t measure_read_cost(void)
+{
+    uint64_t start, end;
+    uint32_t cost = 0xFFFFFFFF;
+
+    for (int i = 0; i < 8; i++) {
+        start = __get_rv_cycle();
+        end = __get_rv_cycle();
+        cost = (end - start < cost) ? (uint32_t)(end - start) : cost;
+    }
+    return cost;
+}
+
+/* non-vector interrupt, entered through irq_entry of FreeRTOS port */
+static void bench_irq_handler(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    stamp_enter = __get_rv_cycle();
+    irq_hit++;
+    if (irq_notify) {
+        vTaskNotifyGiveFromISR(high_task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+    stamp_leave = __get_rv_cycle();
+}
+
+static void high_task_entry(void *param)
+{
+    while (1) {
+        stamp_block = __get_rv_cycle();
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        stamp_wake = __get_rv_cycle();
+    }
+}
+
+static void bench_task_entry(void *param)
+{
+    uint64_t end;
+    uint32_t hit;
+
+    read_cost = measure_read_cost();
+    ECLIC_Register_IRQ(BENCH_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_POSTIVE_EDGE_TRIGGER,
+                       1, 0, (void *)bench_irq_handler);
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        /* interrupt without waking task */
+        irq_notify = 0;
+        hit = irq_hit;
+        stamp_trigger = __get_rv_cycle();
+        ECLIC_SetPendingIRQ(BENCH_IRQn);
+        while (irq_hit == hit);
+        end = __get_rv_cycle();
+        stat_update(STAT_IRQ_ENTRY, stamp_enter - stamp_trigger);
+        stat_update(STAT_IRQ_EXIT, end - stamp_leave);
+
+        /* task to task switch and back, high task is blocked now */
+        stamp_trigger = __get_rv_cycle();
+        xTaskNotifyGive(high_task);
+        end = __get_rv_cycle();
+        stat_update(STAT_TASK_SWITCH, stamp_wake - stamp_trigger);
+        stat_update(STAT_TASK_SWITCH_BACK, end - stamp_block);
+
+        /* interrupt wakes high task */
+        irq_notify = 1;
+        stamp_trigger = __get_rv_cycle();
+        ECLIC_SetPendingIRQ(BENCH_IRQn);
+        while (irq_hit == hit + 1);
+        stat_update(STAT_ISR_TO_TASK, stamp_wake - stamp_trigger);
+    }
+    ECLIC_DisableIRQ(BENCH_IRQn);
+
+#if defined(ECLIC_HW_CTX_AUTO) && defined(CFG_HAS_ECLICV2)
+    printf("Context save: ECLIC hardware auto-save\n");
+#else
+    printf("Context save: software\n");
+#endif
+    printf("%d samples, cycle read cost %lu\n", BENCH_SAMPLES, (unsigned long)read_cost);
+    printf("CSV, Item, Min, Avg, Max\n");
+    for (uint32_t i = 0; i < STAT_NUM; i++) {
+        printf("CSV, %s, %lu, %lu, %lu\n", stats[i].name, (unsigned long)stats[i].min,
+               (unsigned long)(stats[i].sum / BENCH_SAMPLES), (unsigned long)stats[i].max);
+    }
+    printf("Context switch benchmark finished\n");
+    vTaskDelete(NULL);
+}
+
+void vApplicationMallocFailedHook(void)
+{
+    printf("malloc failed\n");
+    while (1);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName)
+{
+    printf("Stack Overflow\n");
+    while (1);
+}
+
+void vApplicationIdleHook(void)
+{
+}
+
+int main(void)
+{
+    CSR_MCFGINFO_Type mcfg_info;
+
+#if defined(CPU_SERIES) && CPU_SERIES == 100
+    mcfg_info.b.clic = 1;
+#else
+    mcfg_info.d = __RV_CSR_READ(CSR_MCFG_INFO);
+#endif
+
+    if (0 == mcfg_info.b.clic) {
+        printf("ECLIC is not present, will not run this example!\r\n");
+        return 0;
+    }
+
+    printf("FreeRTOS interrupt and context switch benchmark\n");
+    xTaskCreate(high_task_entry, "high", 256, NULL, 3, &high_task);
+    xTaskCreate(bench_task_entry, "bench", 512, NULL, 2, NULL);
+    vTaskStartScheduler();
+
+    printf("OS should never run to here\r\n");
+    while (1);
+}
@@ -0,0 +1,145 @@
+/*
+ * High resolution timer demo, FreeRTOS runs with 100Hz tick, which is one of
+ * the periodic timers of hrtimer component, while a periodic timer runs in
+ * timer interrupt every 500us, and a one-shot timer is re-armed every 300us
+ * by its deferred callback run in a task, both are much shorter than a tick.
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdio.h>
+
+#include "nuclei_sdk_soc.h"
+#include "hrtimer_api.h"
+
+#define DEMO_RUN_MS             1000
+#define DEMO_PERIOD_US          500
+#define DEMO_ONESHOT_US         300
+
+static hrtimer_t periodic_timer;
+static hrtimer_t oneshot_timer;
+static TaskHandle_t deferred_task;
+
+static volatile uint32_t periodic_cnt;
+static volatile uint32_t oneshot_cnt;
+static uint64_t oneshot_deadline;
+static uint32_t oneshot_late_max;
+
+static void periodic_callback(hrtimer_t *timer, void *arg)
+{
+    periodic_cnt++;
+}
+
+/* Run in deferred_task, the latency includes the task wakeup */
+static void oneshot_callback(hrtimer_t *timer, void *arg)
+{
+    uint32_t late = (uint32_t)(hrtimer_now() - oneshot_deadline);
+
+    if (late > oneshot_late_max) {
+        oneshot_late_max = late;
+    }
+    oneshot_cnt++;
+    oneshot_deadline += HRTIMER_US(DEMO_ONESHOT_US);
+    hrtimer_start(timer, oneshot_deadline, 0);
+}
+
+/* Override weak hook of hrtimer, wake up the task running deferred callbacks */
+void hrtimer_deferred_notify(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    vTaskNotifyGiveFromISR(deferred_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static void deferred_task_entry(void *param)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        hrtimer_run_deferred();
+    }
+}
+
+static unsigned long counts_to_us(uint64_t counts)
+{
+    return (unsigned long)(counts * 1000000 / SOC_TIMER_FREQ);
+}
+
+static void demo_task_entry(void *param)
+{
+    hrtimer_stats_t stats;
+    TickType_t ticks;
+    uint32_t periodic, oneshot;
+
+    hrtimer_init(&periodic_timer, periodic_callback, NULL, 0);
+    hrtimer_init(&oneshot_timer, oneshot_callback, NULL, HRTIMER_FLAG_DEFERRED);
+
+    ticks = xTaskGetTickCount();
+    oneshot_deadline = hrtimer_now() + HRTIMER_US(DEMO_ONESHOT_US);
+    hrtimer_start(&oneshot_timer, oneshot_deadline, 0);
+    hrtimer_start_rel(&periodic_timer, HRTIMER_US(DEMO_PERIOD_US), HRTIMER_US(DEMO_PERIOD_US));
+    vTaskDelay(pdMS_TO_TICKS(DEMO_RUN_MS));
+    hrtimer_cancel(&periodic_timer);
+    hrtimer_cancel(&oneshot_timer);
+    periodic = periodic_cnt;
+    oneshot = oneshot_cnt;
+    ticks = xTaskGetTickCount() - ticks;
+    hrtimer_get_stats(&stats);
+
+    printf("SysTimer frequency %lu Hz, one count is %lu ns\n", (unsigned long)SOC_TIMER_FREQ,
+           (unsigned long)(1000000000ULL / SOC_TIMER_FREQ));
+    printf("CSV, Timer, Period us, Expected, Fired\n");
+    printf("CSV, tick, %lu, %lu, %lu\n", 1000000UL / configTICK_RATE_HZ,
+           (unsigned long)pdMS_TO_TICKS(DEMO_RUN_MS), (unsigned long)ticks);
+    printf("CSV, periodic, %lu, %lu, %lu\n", (unsigned long)DEMO_PERIOD_US,
+           (unsigned long)(DEMO_RUN_MS * 1000 / DEMO_PERIOD_US), (unsigned long)periodic);
+    printf("CSV, oneshot_deferred, %lu, %lu, %lu\n", (unsigned long)DEMO_ONESHOT_US,
+           (unsigned long)(DEMO_RUN_MS * 1000 / DEMO_ONESHOT_US), (unsigned long)oneshot);
+    printf("CSV, Latency, Counts, us\n");
+    printf("CSV, irq_late_max, %lu, %lu\n", (unsigned long)stats.late_max, counts_to_us(stats.late_max));
+    printf("CSV, deferred_late_max, %lu, %lu\n", (unsigned long)oneshot_late_max, counts_to_us(oneshot_late_max));
+    printf("Timer interrupts %lu, timers fired %lu\n", (unsigned long)stats.irqs, (unsigned long)stats.fired);
+    printf("hrtimer demo finished\n");
+    vTaskDelete(NULL);
+}
+
+void vApplicationMallocFailedHook(void)
+{
+    printf("malloc failed\n");
+    while (1);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName)
+{
+    printf("Stack Overflow\n");
+    while (1);
+}
+
+void vApplicationIdleHook(void)
+{
+    __WFI();
+}
+
+int main(void)
+{
+    CSR_MCFGINFO_Type mcfg_info;
+
+#if defined(CPU_SERIES) && CPU_SERIES == 100
+    mcfg_info.b.clic = 1;
+#else
+    mcfg_info.d = __RV_CSR_READ(CSR_MCFG_INFO);
+#endif
+
+    if (0 == mcfg_info.b.clic) {
+        printf("ECLIC is not present, will not run this example!\r\n");
+        return 0;
+    }
+
+    printf("FreeRTOS hrtimer demo, tick rate %lu Hz\n", (unsigned long)configTICK_RATE_HZ);
+    xTaskCreate(deferred_task_entry, "deferred", 256, NULL, configMAX_PRIORITIES - 1, &deferred_task);
+    xTaskCreate(demo_task_entry, "demo", 512, NULL, 2, NULL);
+    vTaskStartScheduler();
+
+    printf("OS should never run to here\r\n");
+    while (1);
+}
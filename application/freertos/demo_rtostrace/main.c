@@ -0,0 +1,128 @@
+/*
+ * RTOS event trace demo, a low priority task holds a mutex wanted by a high
+ * priority task, while a middle priority task waits on a queue fed by the
+ * high priority task, so priority inheritance, blocking and scheduling
+ * latency can be seen on the timeline.
+ *
+ * Save the console output into trace.log, then run on host:
+ *   python3 Components/profiling/parse.py trace.log
+ *   python3 Components/profiling/rtostrace_convert.py rtostrace.bin -o trace.json
+ * and open trace.json in https://ui.perfetto.dev
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+#include <stdio.h>
+
+#include "nuclei_sdk_soc.h"
+#include "rtostrace_api.h"
+
+#define DEMO_RUN_MS             100
+#define DEMO_LOW_HOLD_US        1500
+#define DEMO_MID_WORK_US        700
+#define DEMO_HIGH_WORK_US       100
+
+/* user event id recorded by RTOSTRACE_USER */
+#define DEMO_EV_ROUND           1
+
+static SemaphoreHandle_t lock;
+static QueueHandle_t msgq;
+
+/* spin without yielding the cpu */
+static void busy_work(uint32_t us)
+{
+    uint64_t end = __get_rv_cycle() + (uint64_t)us * (SystemCoreClock / 1000000);
+
+    while (__get_rv_cycle() < end);
+}
+
+static void low_task_entry(void *param)
+{
+    while (1) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        busy_work(DEMO_LOW_HOLD_US);
+        xSemaphoreGive(lock);
+        vTaskDelay(1);
+    }
+}
+
+static void mid_task_entry(void *param)
+{
+    uint32_t msg;
+
+    while (1) {
+        if (xQueueReceive(msgq, &msg, pdMS_TO_TICKS(3)) == pdPASS) {
+            RTOSTRACE_USER(DEMO_EV_ROUND, msg);
+        }
+        busy_work(DEMO_MID_WORK_US);
+    }
+}
+
+static void high_task_entry(void *param)
+{
+    uint32_t round = 0;
+
+    while (1) {
+        vTaskDelay(2);
+        xSemaphoreTake(lock, portMAX_DELAY);
+        busy_work(DEMO_HIGH_WORK_US);
+        xSemaphoreGive(lock);
+        round++;
+        xQueueSend(msgq, &round, 0);
+    }
+}
+
+static void report_task_entry(void *param)
+{
+    TaskHandle_t *workers = (TaskHandle_t *)param;
+
+    /* keep the last events when the buffer is full */
+    rtostrace_start(RTOSTRACE_MODE_RING);
+    vTaskDelay(pdMS_TO_TICKS(DEMO_RUN_MS));
+    rtostrace_stop();
+    for (int i = 0; i < 3; i++) {
+        vTaskSuspend(workers[i]);
+    }
+    rtostrace_collect(2);
+    printf("rtostrace demo finished\n");
+    vTaskDelete(NULL);
+}
+
+void vApplicationMallocFailedHook(void)
+{
+    printf("malloc failed\n");
+    while (1);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName)
+{
+    printf("Stack Overflow\n");
+    while (1);
+}
+
+int main(void)
+{
+    static TaskHandle_t workers[3];
+
+    lock = xSemaphoreCreateMutex();
+    msgq = xQueueCreate(4, sizeof(uint32_t));
+    if ((lock == NULL) || (msgq == NULL)) {
+        printf("Unable to create mutex or queue\n");
+        return -1;
+    }
+    /* registered names are shown in the trace */
+    vQueueAddToRegistry(lock, "lock");
+    vQueueAddToRegistry(msgq, "msgq");
+
+    printf("FreeRTOS event trace demo, run %d ms\n", DEMO_RUN_MS);
+    xTaskCreate(low_task_entry, "low", 256, NULL, 1, &workers[0]);
+    xTaskCreate(mid_task_entry, "mid", 256, NULL, 2, &workers[1]);
+    xTaskCreate(high_task_entry, "high", 256, NULL, 3, &workers[2]);
+    xTaskCreate(report_task_entry, "report", 512, workers, configMAX_PRIORITIES - 1, NULL);
+    vTaskStartScheduler();
+
+    printf("OS should never run to here\r\n");
+    while (1);
+}
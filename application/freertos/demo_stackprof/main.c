@@ -0,0 +1,167 @@
+/*
+ * Stack sampling profiler demo, FreeRTOS tick hook samples the interrupted
+ * call stack at STACKPROF_SAMPLE_HZ, samples are tagged with the task number
+ * by traceTASK_SWITCHED_IN in FreeRTOSConfig.h, so the folded stacks of the
+ * crc and sort tasks are separated in flame graph.
+ *
+ * Save the console output into prof.log, then run on host:
+ *   python3 Components/profiling/parse.py prof.log
+ *   python3 Components/profiling/stackprof_parse.py stackprof.bin freertos_demo_stackprof.elf > demo.folded
+ *   flamegraph.pl demo.folded > demo.svg
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdio.h>
+
+#include "nuclei_sdk_soc.h"
+#include "stackprof_api.h"
+
+#define DEMO_RUN_MS             2000
+#define DEMO_AGGREGATE_MS       10
+#define DEMO_BUF_SIZE           256
+
+static uint8_t crc_buf[DEMO_BUF_SIZE];
+static uint32_t sort_buf[DEMO_BUF_SIZE];
+static volatile uint32_t sink;
+
+/* workloads of different call depth, not inlined so each one has its own frame */
+__attribute__((noinline)) static uint32_t crc_byte(uint32_t crc, uint8_t byte)
+{
+    crc ^= byte;
+    for (int i = 0; i < 8; i++) {
+        crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+    }
+    return crc;
+}
+
+__attribute__((noinline)) static uint32_t crc_block(const uint8_t *buf, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (uint32_t i = 0; i < len; i++) {
+        crc = crc_byte(crc, buf[i]);
+    }
+    return ~crc;
+}
+
+__attribute__((noinline)) static void sort_fill(uint32_t *buf, uint32_t len, uint32_t seed)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        buf[i] = seed;
+    }
+}
+
+__attribute__((noinline)) static void sort_insertion(uint32_t *buf, uint32_t len)
+{
+    for (uint32_t i = 1; i < len; i++) {
+        uint32_t key = buf[i];
+        uint32_t j = i;
+
+        while (j > 0 && buf[j - 1] > key) {
+            buf[j] = buf[j - 1];
+            j--;
+        }
+        buf[j] = key;
+    }
+}
+
+static void crc_task_entry(void *param)
+{
+    for (uint32_t i = 0; i < DEMO_BUF_SIZE; i++) {
+        crc_buf[i] = (uint8_t)(i * 131 + 7);
+    }
+    while (1) {
+        sink += crc_block(crc_buf, DEMO_BUF_SIZE);
+    }
+}
+
+static void sort_task_entry(void *param)
+{
+    uint32_t seed = 1;
+
+    while (1) {
+        sort_fill(sort_buf, DEMO_BUF_SIZE, seed++);
+        sort_insertion(sort_buf, DEMO_BUF_SIZE);
+        sink += sort_buf[0];
+    }
+}
+
+/* name tags of tasks, tag is the task number set by FreeRTOS */
+static void name_task(TaskHandle_t task)
+{
+    stackprof_set_tag_name(uxTaskGetTaskNumber(task), pcTaskGetName(task));
+}
+
+static void report_task_entry(void *param)
+{
+    TaskHandle_t *workers = (TaskHandle_t *)param;
+
+    name_task(workers[0]);
+    name_task(workers[1]);
+    name_task(xTaskGetIdleTaskHandle());
+    name_task(xTaskGetCurrentTaskHandle());
+
+    stackprof_on();
+    /* move samples out of the ring buffer before it is full */
+    for (uint32_t ms = 0; ms < DEMO_RUN_MS; ms += DEMO_AGGREGATE_MS) {
+        vTaskDelay(pdMS_TO_TICKS(DEMO_AGGREGATE_MS));
+        stackprof_aggregate();
+    }
+    vTaskSuspend(workers[0]);
+    vTaskSuspend(workers[1]);
+    stackprof_collect(2);
+    printf("stackprof demo finished\n");
+    vTaskDelete(NULL);
+}
+
+/* tick hook runs in tick interrupt entered through irq_entry */
+void vApplicationTickHook(void)
+{
+    stackprof_sample();
+}
+
+void vApplicationMallocFailedHook(void)
+{
+    printf("malloc failed\n");
+    while (1);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName)
+{
+    printf("Stack Overflow\n");
+    while (1);
+}
+
+void vApplicationIdleHook(void)
+{
+    stackprof_aggregate();
+    __WFI();
+}
+
+int main(void)
+{
+    static TaskHandle_t workers[2];
+    CSR_MCFGINFO_Type mcfg_info;
+
+#if defined(CPU_SERIES) && CPU_SERIES == 100
+    mcfg_info.b.clic = 1;
+#else
+    mcfg_info.d = __RV_CSR_READ(CSR_MCFG_INFO);
+#endif
+
+    if (0 == mcfg_info.b.clic) {
+        printf("ECLIC is not present, will not run this example!\r\n");
+        return 0;
+    }
+
+    printf("FreeRTOS stack sampling profiler demo, sample rate %lu Hz\n", (unsigned long)configTICK_RATE_HZ);
+    xTaskCreate(crc_task_entry, "crc", 256, NULL, 1, &workers[0]);
+    xTaskCreate(sort_task_entry, "sort", 256, NULL, 1, &workers[1]);
+    xTaskCreate(report_task_entry, "report", 512, workers, configMAX_PRIORITIES - 1, NULL);
+    vTaskStartScheduler();
+
+    printf("OS should never run to here\r\n");
+    while (1);
+}
@@ -554,6 +554,24 @@
  * tskNO_AFFINITY if left undefined. */
 #define configTIMER_SERVICE_TASK_CORE_AFFINITY    tskNO_AFFINITY
 
+/* When using SMP (i.e. configNUMBER_OF_CORES is greater than one), set
+ * configUSE_PER_CORE_READY_LISTS to 1 to give each core its own ready lists,
+ * a core runs the tasks of its own lists first, and only steals tasks from the
+ * lists of other cores when it has nothing else to run at the same priority.
+ * Set it to 0 to compare with the default shared ready lists. The switch
+ * counters can be read by vTaskGetCoreScheduleStats. Defaults to 0 if left
+ * undefined. */
+#ifndef configUSE_PER_CORE_READY_LISTS
+#define configUSE_PER_CORE_READY_LISTS        1
+#endif
+
+/* Nuclei SMP port only, set configUSE_PORT_LOCK_STATS to 1 to count the
+ * acquisitions and contention of the ISR and TASK spinlocks, which can be
+ * read by vPortGetLockStats. Defaults to 0 if left undefined. */
+#ifndef configUSE_PORT_LOCK_STATS
+#define configUSE_PORT_LOCK_STATS                 1
+#endif
+
 
 /******************************************************************************/
 /* ARMv8-M secure side port related definitions. ******************************/
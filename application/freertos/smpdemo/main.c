@@ -84,9 +84,12 @@ converted to ticks using the pdMS_TO_TICKS() macro. */
 #define mainSOFTWARE_TIMER_PERIOD_MS    pdMS_TO_TICKS(500)
 #define TASKDLYMS                       pdMS_TO_TICKS(15)
 #define mainQUEUE_LENGTH                (1)
+/* Dump scheduler and lock counters every 10 timer callbacks */
+#define mainSTATS_DUMP_PERIOD           (10)
 
 static void prvSetupHardware(void);
 static void vExampleTimerCallback(TimerHandle_t xTimer);
+static void prvDumpSchedulerStats(void);
 
 /* The queue used by the queue send and queue receive tasks. */
 static QueueHandle_t xQueue = NULL;
@@ -210,6 +213,45 @@ static void vExampleTimerCallback(TimerHandle_t xTimer)
     ENTER_CRITICAL();
     printf("timers Callback %d on hart %d\r\n", cnt++, __get_hart_id());
     EXIT_CRITICAL();
+    if ((cnt % mainSTATS_DUMP_PERIOD) == 0) {
+        prvDumpSchedulerStats();
+    }
+}
+
+static void prvDumpSchedulerStats(void)
+{
+#if configNUMBER_OF_CORES > 1
+    BaseType_t xCoreID;
+#if configUSE_PORT_LOCK_STATS == 1
+    static const char *pcLockNames[portRTOS_SPINLOCK_COUNT] = {"isr_lock", "task_lock"};
+    PortLockStats_t xLockStats;
+    unsigned long ulLockNum;
+#endif
+#if configUSE_PER_CORE_READY_LISTS == 1
+    TaskCoreScheduleStats_t xSchedStats;
+#endif
+
+    for (xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
+#if configUSE_PORT_LOCK_STATS == 1
+        for (ulLockNum = 0; ulLockNum < portRTOS_SPINLOCK_COUNT; ulLockNum++) {
+            vPortGetLockStats(ulLockNum, xCoreID, &xLockStats);
+            ENTER_CRITICAL();
+            printf("CSV, core%d_%s_acquires, %lu\r\n", (int)xCoreID, pcLockNames[ulLockNum], (unsigned long)xLockStats.ulAcquires);
+            printf("CSV, core%d_%s_contended, %lu\r\n", (int)xCoreID, pcLockNames[ulLockNum], (unsigned long)xLockStats.ulContended);
+            printf("CSV, core%d_%s_spin_cycles, %lu\r\n", (int)xCoreID, pcLockNames[ulLockNum], (unsigned long)xLockStats.ullSpinCycles);
+            EXIT_CRITICAL();
+        }
+#endif
+#if configUSE_PER_CORE_READY_LISTS == 1
+        vTaskGetCoreScheduleStats(xCoreID, &xSchedStats);
+        ENTER_CRITICAL();
+        printf("CSV, core%d_local_switches, %lu\r\n", (int)xCoreID, (unsigned long)xSchedStats.ulLocalSwitches);
+        printf("CSV, core%d_stolen_switches, %lu\r\n", (int)xCoreID, (unsigned long)xSchedStats.ulStolenSwitches);
+        printf("CSV, core%d_yield_requests, %lu\r\n", (int)xCoreID, (unsigned long)xSchedStats.ulYieldRequests);
+        EXIT_CRITICAL();
+#endif
+    }
+#endif
 }
 
 void vApplicationTickHook(void)
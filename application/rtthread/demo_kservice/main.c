@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2019-Present Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Nuclei       compare kernel string services with byte loops
+ */
+
+#include "nuclei_sdk_soc.h"
+#include <rtthread.h>
+#include <stdio.h>
+
+/*
+ * Compare the word at a time rt_strlen, rt_strcmp, rt_strncmp, rt_strncpy
+ * and rt_memcmp of kservice with the byte at a time loops they replaced,
+ * on strings of typical object and device name lengths, and rt_crc32 with
+ * a bitwise CRC-32. The results are checked for all alignments first.
+ * Build with ARCH_EXT=_zba_zbb_zbc_zbs to use Zbb and Zbc instructions.
+ */
+#define BENCH_LOOPS         100
+#define BENCH_MAX_LEN       64
+#define BENCH_OBJECTS       16
+
+struct str_ops
+{
+    rt_size_t (*strlen)(const char *s);
+    rt_int32_t (*strcmp)(const char *cs, const char *ct);
+    rt_int32_t (*strncmp)(const char *cs, const char *ct, rt_ubase_t count);
+    char *(*strncpy)(char *dst, const char *src, rt_ubase_t n);
+    rt_int32_t (*memcmp)(const void *cs, const void *ct, rt_ubase_t count);
+    rt_uint32_t (*crc32)(rt_uint32_t crc, const void *buf, rt_size_t len);
+};
+
+static const rt_uint16_t name_lens[] = {4, 8, 16, 32, 64};
+static const rt_uint16_t crc_lens[] = {16, 64, 256, 1024};
+
+ALIGN(RT_ALIGN_SIZE)
+static char str_a[BENCH_MAX_LEN + 16];
+ALIGN(RT_ALIGN_SIZE)
+static char str_b[BENCH_MAX_LEN + 16];
+ALIGN(RT_ALIGN_SIZE)
+static char str_dst[2][BENCH_MAX_LEN + 16];
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t crc_buf[1024];
+
+static struct rt_semaphore sems[BENCH_OBJECTS];
+static volatile rt_ubase_t sink;
+
+/* byte at a time loops of previous kservice */
+static rt_size_t ref_strlen(const char *s)
+{
+    const char *sc;
+
+    for (sc = s; *sc != '\0'; ++sc)
+        ;
+    return sc - s;
+}
+
+static rt_int32_t ref_strcmp(const char *cs, const char *ct)
+{
+    while (*cs && *cs == *ct)
+    {
+        cs++;
+        ct++;
+    }
+    return (*cs - *ct);
+}
+
+static rt_int32_t ref_strncmp(const char *cs, const char *ct, rt_ubase_t count)
+{
+    signed char res = 0;
+
+    while (count)
+    {
+        if ((res = *cs - *ct++) != 0 || !*cs++)
+            break;
+        count--;
+    }
+    return res;
+}
+
+static char *ref_strncpy(char *dst, const char *src, rt_ubase_t n)
+{
+    char *d = dst;
+
+    if (n != 0)
+    {
+        do
+        {
+            if ((*d++ = *src++) == 0)
+            {
+                while (--n != 0)
+                    *d++ = 0;
+                break;
+            }
+        } while (--n != 0);
+    }
+    return dst;
+}
+
+static rt_int32_t ref_memcmp(const void *cs, const void *ct, rt_ubase_t count)
+{
+    const unsigned char *su1 = cs, *su2 = ct;
+    int res = 0;
+
+    for (; 0 < count; ++su1, ++su2, count--)
+        if ((res = *su1 - *su2) != 0)
+            break;
+    return res;
+}
+
+static rt_uint32_t ref_crc32(rt_uint32_t crc, const void *buf, rt_size_t len)
+{
+    const rt_uint8_t *p = buf;
+
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static const struct str_ops ref_ops = {ref_strlen, ref_strcmp, ref_strncmp, ref_strncpy, ref_memcmp, ref_crc32};
+static const struct str_ops rt_ops = {rt_strlen, rt_strcmp, rt_strncmp, rt_strncpy, rt_memcmp, rt_crc32};
+/* called through volatile pointer, so the calls are not hoisted out of the loops */
+static const struct str_ops *volatile ops_sel;
+
+static void fill_name(char *s, rt_uint16_t len)
+{
+    for (rt_uint16_t i = 0; i < len; i++)
+        s[i] = 'a' + i % 26;
+    s[len] = '\0';
+}
+
+static int sign(int x)
+{
+    return (x > 0) - (x < 0);
+}
+
+/* check the results of kservice against byte loops for all lengths, alignments and differences */
+static int check_ops(void)
+{
+    int errors = 0;
+    char *a, *b;
+
+    for (rt_uint16_t len = 0; len <= 24; len++)
+    {
+        for (int oa = 0; oa < 8; oa++)
+        {
+            for (int ob = 0; ob < 8; ob++)
+            {
+                for (int diff = -1; diff < len; diff++)
+                {
+                    a = str_a + oa;
+                    b = str_b + ob;
+                    fill_name(a, len);
+                    fill_name(b, len);
+                    if (diff >= 0)
+                        b[diff] = (diff & 1) ? '\0' : (char)0xC1;
+                    errors += rt_strlen(a) != ref_strlen(a);
+                    errors += rt_strcmp(a, b) != ref_strcmp(a, b);
+                    errors += rt_strncmp(a, b, len / 2 + 1) != ref_strncmp(a, b, len / 2 + 1);
+                    errors += sign(rt_memcmp(a, b, len)) != sign(ref_memcmp(a, b, len));
+                    rt_memset(str_dst, 0x5A, sizeof(str_dst));
+                    rt_strncpy(str_dst[0] + ob, b, len + 3);
+                    ref_strncpy(str_dst[1] + ob, b, len + 3);
+                    errors += ref_memcmp(str_dst[0], str_dst[1], sizeof(str_dst[0])) != 0;
+                }
+            }
+        }
+    }
+    for (rt_uint16_t i = 0; i < sizeof(crc_buf); i++)
+        crc_buf[i] = (rt_uint8_t)(i * 131 + 7);
+    errors += rt_crc32(0, "123456789", 9) != 0xCBF43926U;
+    for (rt_uint16_t len = 0; len < 40; len++)
+        errors += rt_crc32(0x1234, crc_buf + (len & 7), len) != ref_crc32(0x1234, crc_buf + (len & 7), len);
+    return errors;
+}
+
+static rt_uint32_t bench_op(const struct str_ops *sel, int op, rt_uint16_t len)
+{
+    const struct str_ops *ops;
+    uint64_t start;
+
+    ops_sel = sel;
+    start = __get_rv_cycle();
+    for (int i = 0; i < BENCH_LOOPS; i++)
+    {
+        ops = ops_sel;
+        switch (op)
+        {
+            case 0:
+                sink += ops->strlen(str_a);
+                break;
+            case 1:
+                sink += ops->strcmp(str_a, str_b);
+                break;
+            case 2:
+                sink += ops->strncmp(str_a, str_b, len + 1);
+                break;
+            case 3:
+                sink += (rt_ubase_t)ops->strncpy(str_dst[0], str_a, len + 1);
+                break;
+            case 4:
+                sink += ops->memcmp(str_a, str_b, len);
+                break;
+            default:
+                sink += ops->crc32(0, crc_buf, len);
+                break;
+        }
+    }
+    return (rt_uint32_t)((__get_rv_cycle() - start) / BENCH_LOOPS);
+}
+
+static void bench_object_find(void)
+{
+    static char names[BENCH_OBJECTS][RT_NAME_MAX];
+    uint64_t start;
+
+    for (int i = 0; i < BENCH_OBJECTS; i++)
+    {
+        rt_snprintf(names[i], RT_NAME_MAX, "sem%02d", i);
+        rt_sem_init(&sems[i], names[i], 0, RT_IPC_FLAG_FIFO);
+    }
+    /* the first initialized object is the last one found */
+    start = __get_rv_cycle();
+    for (int i = 0; i < BENCH_LOOPS; i++)
+        sink += (rt_ubase_t)rt_object_find(names[0], RT_Object_Class_Semaphore);
+    printf("CSV, rt_object_find_%d, %lu\n", BENCH_OBJECTS,
+           (unsigned long)((__get_rv_cycle() - start) / BENCH_LOOPS));
+}
+
+int main(void)
+{
+    static const char *op_names[] = {"strlen", "strcmp", "strncmp", "strncpy", "memcmp", "crc32"};
+    int errors;
+
+#ifdef __riscv_zbb
+    printf("Kernel string service benchmark, Zbb enabled");
+#else
+    printf("Kernel string service benchmark, Zbb disabled");
+#endif
+#ifdef __riscv_zbc
+    printf(", Zbc enabled\n");
+#else
+    printf(", Zbc disabled\n");
+#endif
+
+    errors = check_ops();
+    if (errors)
+    {
+        printf("ERROR, %d results are different from byte loops\n", errors);
+        return 1;
+    }
+
+    printf("CSV, Function, Length, Byte loop cycles, Kservice cycles\n");
+    for (int op = 0; op < 5; op++)
+    {
+        for (rt_uint16_t i = 0; i < sizeof(name_lens) / sizeof(name_lens[0]); i++)
+        {
+            fill_name(str_a, name_lens[i]);
+            fill_name(str_b, name_lens[i]);
+            printf("CSV, %s, %u, %lu, %lu\n", op_names[op], name_lens[i],
+                   (unsigned long)bench_op(&ref_ops, op, name_lens[i]),
+                   (unsigned long)bench_op(&rt_ops, op, name_lens[i]));
+        }
+    }
+    for (rt_uint16_t i = 0; i < sizeof(crc_lens) / sizeof(crc_lens[0]); i++)
+    {
+        printf("CSV, %s, %u, %lu, %lu\n", op_names[5], crc_lens[i],
+               (unsigned long)bench_op(&ref_ops, 5, crc_lens[i]),
+               (unsigned long)bench_op(&rt_ops, 5, crc_lens[i]));
+    }
+    bench_object_find();
+
+    printf("Kservice benchmark finished\n");
+#ifdef CFG_SIMULATION
+    // directly exit if in nuclei internally simulation
+    SIMULATION_EXIT(0);
+#endif
+    return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2019-Present Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Nuclei       compare spsc channel with message queue
+ */
+
+#include "nuclei_sdk_soc.h"
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdio.h>
+
+/*
+ * One interrupt service routine produces, one thread consumes.
+ * The software triggered SOC_INT20 interrupt sends BENCH_BURST messages
+ * per round through either a rt_spsc channel or a rt_messagequeue, and a
+ * lower priority thread drains them. For each IPC we report:
+ * - isr_send: average cycles spent in the send call inside the ISR
+ * - latency: average cycles from ISR send to thread receive
+ * - per_msg: average cycles per message for the whole round (throughput)
+ * - irqoff_max: longest interrupt disabled window seen by the kernel
+ */
+#define BENCH_IRQn          SOC_INT20_IRQn
+#define BENCH_IRQ_LEVEL     1
+#define BENCH_ROUNDS        64
+#define BENCH_BURST         8
+#define BENCH_MSGS          (BENCH_ROUNDS * BENCH_BURST)
+/* message sequence used to move consumer over to another IPC */
+#define BENCH_SWITCH        0xFFFFFFFFU
+
+/* consumer runs just below main thread, see RT_MAIN_THREAD_PRIORITY in components.c */
+#ifdef RT_MAIN_THREAD_PRIORITY
+#define CONSUMER_PRIORITY   (RT_MAIN_THREAD_PRIORITY + 1)
+#else
+#define CONSUMER_PRIORITY   ((RT_THREAD_PRIORITY_MAX / 3) + 1)
+#endif
+/* Reserve enough stack if rvv autovectorization enabled,
+ * it will use stack to save and restore rvv registers,
+ * which may corrupt stack, take care */
+#define CONSUMER_STACK_SIZE 1024
+#define CONSUMER_TIMESLICE  5
+
+enum {
+    BENCH_SPSC = 0,
+    BENCH_MQ,
+    BENCH_NUM
+};
+
+static const char *bench_names[BENCH_NUM] = {"spsc", "mq"};
+
+struct bench_msg {
+    rt_uint32_t seq;
+    rt_ubase_t  stamp;
+};
+
+#define BENCH_POOL_MSGS     16
+
+static struct rt_spsc spsc;
+static rt_uint8_t spsc_pool[BENCH_POOL_MSGS * RT_ALIGN(sizeof(struct bench_msg), RT_ALIGN_SIZE)];
+static struct rt_messagequeue mq;
+/* each message queue node carries a next pointer in front of the payload */
+static rt_uint8_t mq_pool[BENCH_POOL_MSGS * (RT_ALIGN(sizeof(struct bench_msg), RT_ALIGN_SIZE) + sizeof(void *))];
+static struct rt_semaphore round_done;
+
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t consumer_stack[CONSUMER_STACK_SIZE];
+static struct rt_thread consumer;
+
+static volatile int bench_mode = BENCH_SPSC;
+static volatile rt_uint32_t isr_seq;
+static volatile rt_uint32_t isr_fail;
+static volatile rt_ubase_t isr_cycles;
+static volatile rt_ubase_t latency_cycles;
+static volatile rt_uint32_t rx_count;
+static volatile rt_uint32_t rx_error;
+
+/* Non-vector interrupt, context is saved by common interrupt entry */
+static void bench_irq_handler(void)
+{
+    struct bench_msg msg;
+    rt_ubase_t start;
+    rt_err_t ret;
+
+    rt_interrupt_enter();
+
+    msg.seq = isr_seq++;
+    start = __read_cycle_csr();
+    msg.stamp = start;
+    if (bench_mode == BENCH_SPSC) {
+        ret = rt_spsc_send(&spsc, &msg, sizeof(msg));
+    } else {
+        ret = rt_mq_send(&mq, &msg, sizeof(msg));
+    }
+    isr_cycles += __read_cycle_csr() - start;
+    if (ret != RT_EOK) {
+        isr_fail++;
+    }
+
+    rt_interrupt_leave();
+}
+
+static void consumer_entry(void *parameter)
+{
+    struct bench_msg msg;
+    rt_uint32_t expect = 0;
+    rt_err_t ret;
+
+    while (1) {
+        if (bench_mode == BENCH_SPSC) {
+            ret = rt_spsc_recv(&spsc, &msg, sizeof(msg), RT_WAITING_FOREVER);
+        } else {
+            ret = rt_mq_recv(&mq, &msg, sizeof(msg), RT_WAITING_FOREVER);
+        }
+        if (ret == RT_EOK && msg.seq == BENCH_SWITCH) {
+            expect = 0;
+            rt_sem_release(&round_done);
+            continue;
+        }
+        latency_cycles += __read_cycle_csr() - msg.stamp;
+        if (ret != RT_EOK || msg.seq != expect) {
+            rx_error++;
+        }
+        expect = msg.seq + 1;
+        rx_count++;
+        if ((rx_count % BENCH_BURST) == 0) {
+            rt_sem_release(&round_done);
+        }
+    }
+}
+
+static void bench_run(int mode)
+{
+    rt_ubase_t start, total;
+    rt_uint32_t i, j;
+
+    bench_mode = mode;
+    isr_seq = 0;
+    isr_fail = 0;
+    isr_cycles = 0;
+    latency_cycles = 0;
+    rx_count = 0;
+    rx_error = 0;
+    rt_hw_irqoff_max_reset();
+
+    start = __read_cycle_csr();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        /* consumer has lower priority, so the burst is queued before it runs */
+        for (j = 0; j < BENCH_BURST; j++) {
+            ECLIC_SetPendingIRQ(BENCH_IRQn);
+        }
+        rt_sem_take(&round_done, RT_WAITING_FOREVER);
+    }
+    total = __read_cycle_csr() - start;
+
+    printf("CSV, %s_isr_send, %lu\n", bench_names[mode], (unsigned long)(isr_cycles / BENCH_MSGS));
+    printf("CSV, %s_latency, %lu\n", bench_names[mode], (unsigned long)(latency_cycles / BENCH_MSGS));
+    printf("CSV, %s_per_msg, %lu\n", bench_names[mode], (unsigned long)(total / BENCH_MSGS));
+    printf("CSV, %s_irqoff_max, %lu\n", bench_names[mode], (unsigned long)rt_hw_irqoff_max_get());
+    if (isr_fail || rx_error || rx_count != BENCH_MSGS) {
+        printf("%s benchmark error: %u send failed, %u receive error, %u received\n",
+               bench_names[mode], isr_fail, rx_error, rx_count);
+    }
+}
+
+int main(void)
+{
+    CSR_MCFGINFO_Type mcfg_info;
+    struct bench_msg msg;
+
+#if defined(CPU_SERIES) && CPU_SERIES == 100
+    mcfg_info.b.clic = 1;
+#else
+    mcfg_info.d = __RV_CSR_READ(CSR_MCFG_INFO);
+#endif
+
+    if (0 == mcfg_info.b.clic) {
+        printf("ECLIC is not present, will not run this example!\r\n");
+        while (1);
+    }
+
+    rt_spsc_init(&spsc, "spsc", spsc_pool, sizeof(struct bench_msg), sizeof(spsc_pool));
+    rt_mq_init(&mq, "mq", mq_pool, sizeof(struct bench_msg), sizeof(mq_pool), RT_IPC_FLAG_FIFO);
+    rt_sem_init(&round_done, "done", 0, RT_IPC_FLAG_FIFO);
+
+    rt_thread_init(&consumer, "consumer", consumer_entry, RT_NULL, consumer_stack,
+                   CONSUMER_STACK_SIZE, CONSUMER_PRIORITY, CONSUMER_TIMESLICE);
+    rt_thread_startup(&consumer);
+
+    ECLIC_Register_IRQ(BENCH_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_POSTIVE_EDGE_TRIGGER,
+                       BENCH_IRQ_LEVEL, 0, (void *)bench_irq_handler);
+
+    printf("RT-Thread ISR to thread IPC benchmark, %d messages, burst %d\n", BENCH_MSGS, BENCH_BURST);
+    bench_run(BENCH_SPSC);
+    /* consumer is blocked on spsc channel now, switch it over to message queue */
+    bench_mode = BENCH_MQ;
+    msg.seq = BENCH_SWITCH;
+    msg.stamp = 0;
+    rt_spsc_send(&spsc, &msg, sizeof(msg));
+    rt_sem_take(&round_done, RT_WAITING_FOREVER);
+    bench_run(BENCH_MQ);
+
+    printf("SPSC benchmark finished\n");
+#ifdef CFG_SIMULATION
+    // directly exit if in nuclei internally simulation
+    SIMULATION_EXIT(0);
+#endif
+    while (1) {
+        rt_thread_mdelay(500);
+    }
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2019-Present Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Nuclei       rt-thread smp scaling benchmark
+ */
+
+#include "nuclei_sdk_soc.h"
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdio.h>
+
+/*
+ * Scaling: WORK_ITEMS pieces of cpu bound work are shared by 1 to RT_CPUS_NR
+ * unbound worker threads, each worker claims the next piece with an atomic
+ * add, so the elapsed time should drop as more cpus join the work.
+ * Pingpong: two threads bound to cpu 0 and cpu 1 wake up each other with
+ * semaphores, each round trip costs two cross cpu wakeups by schedule ipi.
+ * Time is measured with the shared system timer, since cycle counters are
+ * per hart and the main thread may move between harts.
+ */
+#define WORK_ITEMS          32
+#define WORK_LOOPS          4096
+#define PINGPONG_ROUNDS     256
+
+/* main thread priority is RT_THREAD_PRIORITY_MAX / 3 = 2, workers run below it */
+#define WORKER_PRIORITY     3
+/* Reserve enough stack if rvv autovectorization enabled,
+ * it will use stack to save and restore rvv registers,
+ * which may corrupt stack, take care */
+#define WORKER_STACK_SIZE   1024
+#define WORKER_TIMESLICE    5
+
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t worker_stack[RT_CPUS_NR][WORKER_STACK_SIZE];
+static struct rt_thread worker[RT_CPUS_NR];
+static struct rt_semaphore worker_start[RT_CPUS_NR];
+static struct rt_semaphore worker_done;
+
+static volatile int32_t work_next;
+static rt_uint32_t work_result[WORK_ITEMS];
+static rt_uint8_t work_cpu[WORK_ITEMS];
+static rt_uint32_t work_expect[WORK_ITEMS];
+
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t pingpong_stack[2][WORKER_STACK_SIZE];
+static struct rt_thread pingpong[2];
+static struct rt_semaphore ping_sem, pong_sem, pingpong_done;
+
+/* cpu bound work, a simple LCG mixed checksum */
+static rt_uint32_t do_work(rt_uint32_t seed)
+{
+    rt_uint32_t x = seed * 2654435761U + 1;
+    rt_uint32_t sum = 0;
+
+    for (int i = 0; i < WORK_LOOPS; i++) {
+        x = x * 1664525U + 1013904223U;
+        sum ^= (x >> 7) + (sum << 3);
+    }
+    return sum;
+}
+
+static void worker_entry(void *parameter)
+{
+    struct rt_semaphore *start = &worker_start[(unsigned long)parameter];
+    rt_int32_t item;
+
+    while (1) {
+        rt_sem_take(start, RT_WAITING_FOREVER);
+        while ((item = __AMOADD_W(&work_next, 1)) < WORK_ITEMS) {
+            work_result[item] = do_work(item);
+            work_cpu[item] = (rt_uint8_t)rt_hw_cpu_id();
+        }
+        rt_sem_release(&worker_done);
+    }
+}
+
+static void bench_scaling(int workers)
+{
+    rt_uint32_t cpu_items[RT_CPUS_NR] = {0};
+    uint64_t start, cost;
+    int i, errors = 0;
+
+    work_next = 0;
+    __SMP_RWMB();
+    start = SysTimer_GetLoadValue();
+    for (i = 0; i < workers; i++) {
+        rt_sem_release(&worker_start[i]);
+    }
+    for (i = 0; i < workers; i++) {
+        rt_sem_take(&worker_done, RT_WAITING_FOREVER);
+    }
+    cost = SysTimer_GetLoadValue() - start;
+
+    for (i = 0; i < WORK_ITEMS; i++) {
+        if (work_result[i] != work_expect[i]) {
+            errors++;
+        }
+        if (work_cpu[i] < RT_CPUS_NR) {
+            cpu_items[work_cpu[i]]++;
+        }
+    }
+
+    printf("CSV, smp_workers%d_timer_ticks, %lu\n", workers, (unsigned long)cost);
+    for (i = 0; i < RT_CPUS_NR; i++) {
+        printf("CSV, smp_workers%d_cpu%d_items, %u\n", workers, i, (unsigned int)cpu_items[i]);
+    }
+    if (errors) {
+        printf("workers %d: %d work results mismatch\n", workers, errors);
+    }
+}
+
+static void ping_entry(void *parameter)
+{
+    for (int i = 0; i < PINGPONG_ROUNDS; i++) {
+        rt_sem_release(&ping_sem);
+        rt_sem_take(&pong_sem, RT_WAITING_FOREVER);
+    }
+    rt_sem_release(&pingpong_done);
+}
+
+static void pong_entry(void *parameter)
+{
+    for (int i = 0; i < PINGPONG_ROUNDS; i++) {
+        rt_sem_take(&ping_sem, RT_WAITING_FOREVER);
+        rt_sem_release(&pong_sem);
+    }
+}
+
+static void bench_pingpong(void)
+{
+    uint64_t start, cost;
+
+    rt_sem_init(&ping_sem, "ping", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&pong_sem, "pong", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&pingpong_done, "ppdone", 0, RT_IPC_FLAG_FIFO);
+
+    rt_thread_init(&pingpong[0], "ping", ping_entry, RT_NULL, pingpong_stack[0],
+                   WORKER_STACK_SIZE, WORKER_PRIORITY, WORKER_TIMESLICE);
+    rt_thread_init(&pingpong[1], "pong", pong_entry, RT_NULL, pingpong_stack[1],
+                   WORKER_STACK_SIZE, WORKER_PRIORITY, WORKER_TIMESLICE);
+    rt_thread_control(&pingpong[0], RT_THREAD_CTRL_BIND_CPU, (void *)0);
+    rt_thread_control(&pingpong[1], RT_THREAD_CTRL_BIND_CPU, (void *)1);
+
+    start = SysTimer_GetLoadValue();
+    rt_thread_startup(&pingpong[1]);
+    rt_thread_startup(&pingpong[0]);
+    rt_sem_take(&pingpong_done, RT_WAITING_FOREVER);
+    cost = SysTimer_GetLoadValue() - start;
+
+    printf("CSV, smp_pingpong_round_timer_ticks, %lu\n", (unsigned long)(cost / PINGPONG_ROUNDS));
+}
+
+int main(void)
+{
+    CSR_MCFGINFO_Type mcfg_info;
+    unsigned long i;
+    char name[RT_NAME_MAX];
+
+#if defined(CPU_SERIES) && CPU_SERIES == 100
+    mcfg_info.b.clic = 1;
+#else
+    mcfg_info.d = __RV_CSR_READ(CSR_MCFG_INFO);
+#endif
+
+    if (0 == mcfg_info.b.clic) {
+        printf("ECLIC is not present, will not run this example!\r\n");
+        while (1);
+    }
+
+    printf("RT-Thread SMP scaling benchmark, %d cpus, %d work items, timer freq %lu Hz\n",
+           RT_CPUS_NR, WORK_ITEMS, (unsigned long)SOC_TIMER_FREQ);
+
+    for (i = 0; i < WORK_ITEMS; i++) {
+        work_expect[i] = do_work(i);
+    }
+
+    rt_sem_init(&worker_done, "wdone", 0, RT_IPC_FLAG_FIFO);
+    for (i = 0; i < RT_CPUS_NR; i++) {
+        rt_sprintf(name, "wstart%d", (int)i);
+        rt_sem_init(&worker_start[i], name, 0, RT_IPC_FLAG_FIFO);
+        rt_sprintf(name, "worker%d", (int)i);
+        rt_thread_init(&worker[i], name, worker_entry, (void *)i, worker_stack[i],
+                       WORKER_STACK_SIZE, WORKER_PRIORITY, WORKER_TIMESLICE);
+        rt_thread_startup(&worker[i]);
+    }
+
+    for (i = 1; i <= RT_CPUS_NR; i++) {
+        bench_scaling(i);
+    }
+
+    bench_pingpong();
+
+    printf("RT-Thread SMP benchmark finished\n");
+#ifdef CFG_SIMULATION
+    // directly exit if in nuclei internally simulation
+    SIMULATION_EXIT(0);
+#endif
+    while (1) {
+        rt_thread_mdelay(500);
+    }
+}
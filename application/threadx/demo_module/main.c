@@ -0,0 +1,145 @@
+/* Benchmark of ThreadX user mode modules isolated by PMP, two instances of the module in
+   bench_module.S measure the kernel call round trip through ecall, and the switch between
+   modules, which reprograms the PMP entries of module data, the same operations between
+   kernel threads are measured for reference.  */
+#include "tx_api.h"
+#include "txm_module.h"
+#include <stdio.h>
+
+#if !defined(__PMP_PRESENT) || (__PMP_PRESENT != 1)
+#error "This example require CPU PMP feature"
+#endif
+
+#define BENCH_LOOPS             100
+#define BENCH_STACK_SIZE        1024
+#define BENCH_PRIORITY          5
+#define REF_PRIORITY            10
+#define MODULE_MEMORY_SIZE      (24 * 1024)
+#define OBJECT_MEMORY_SIZE      (4 * 1024)
+
+/* Layout of the start of module data area, written by bench_module.S */
+typedef struct {
+    ULONG done;
+    ULONG identify_cycles;
+    ULONG relinquish_cycles;
+    ULONG loops;
+} bench_result_t;
+
+extern UCHAR bench_module_preamble[];
+
+TX_THREAD               bench_thread;
+TX_THREAD               ref_thread[2];
+TXM_MODULE_INSTANCE     bench_module[2];
+UCHAR                   bench_stack[BENCH_STACK_SIZE];
+UCHAR                   ref_stack[2][BENCH_STACK_SIZE];
+/* Module data and thread stacks are allocated here, aligned to PMP regions */
+UCHAR                   module_memory[MODULE_MEMORY_SIZE];
+UCHAR                   object_memory[OBJECT_MEMORY_SIZE];
+
+bench_result_t          ref_result[2];
+
+static void ref_thread_entry(ULONG index)
+{
+    bench_result_t *result = &ref_result[index];
+    ULONG start;
+
+    tx_thread_relinquish();
+    start = __RV_CSR_READ(CSR_CYCLE);
+    for (ULONG i = 0; i < BENCH_LOOPS; i++) {
+        tx_thread_identify();
+    }
+    result->identify_cycles = __RV_CSR_READ(CSR_CYCLE) - start;
+    start = __RV_CSR_READ(CSR_CYCLE);
+    for (ULONG i = 0; i < BENCH_LOOPS; i++) {
+        tx_thread_relinquish();
+    }
+    result->relinquish_cycles = __RV_CSR_READ(CSR_CYCLE) - start;
+    result->loops = BENCH_LOOPS;
+    result->done = 1;
+}
+
+static void bench_wait(bench_result_t *r0, bench_result_t *r1)
+{
+    while ((r0->done == 0) || (r1->done == 0)) {
+        tx_thread_sleep(1);
+    }
+}
+
+static void bench_print(const char *name, bench_result_t *result)
+{
+    /* Each relinquish of one thread is followed by the one of the other thread */
+    printf("CSV, %s_call, %lu\n", name, (unsigned long)(result->identify_cycles / result->loops));
+    printf("CSV, %s_switch, %lu\n", name, (unsigned long)(result->relinquish_cycles / (2 * result->loops)));
+}
+
+static void bench_thread_entry(ULONG input)
+{
+    bench_result_t *result[2];
+    UINT status;
+
+    tx_thread_resume(&ref_thread[0]);
+    tx_thread_resume(&ref_thread[1]);
+    bench_wait(&ref_result[0], &ref_result[1]);
+
+    for (int i = 0; i < 2; i++) {
+        status = txm_module_manager_in_place_load(&bench_module[i], "bench module", bench_module_preamble);
+        if (status == TX_SUCCESS) {
+            status = txm_module_manager_start(&bench_module[i]);
+        }
+        if (status != TX_SUCCESS) {
+            printf("ERROR, module %d load and start failed, status 0x%x\n", i, status);
+            return;
+        }
+        result[i] = (bench_result_t *)bench_module[i].txm_module_instance_module_data_base_address;
+    }
+    bench_wait(result[0], result[1]);
+
+    printf("CSV, Benchmark, Cycles\n");
+    bench_print("kernel", &ref_result[0]);
+    bench_print("module", result[0]);
+    for (int i = 0; i < 2; i++) {
+        txm_module_manager_stop(&bench_module[i]);
+        txm_module_manager_unload(&bench_module[i]);
+    }
+    printf("Module benchmark finished\n");
+}
+
+int main(void)
+{
+    CSR_MCFGINFO_Type mcfg_info;
+
+#if defined(CPU_SERIES) && CPU_SERIES == 100
+    mcfg_info.b.clic = 1;
+#else
+    mcfg_info.d = __RV_CSR_READ(CSR_MCFG_INFO);
+#endif
+
+    if (0 == mcfg_info.b.clic) {
+        printf("ECLIC is not present, will not run this example!\r\n");
+        return 0;
+    }
+    if ((__RV_CSR_READ(CSR_MISA) & (1UL << ('U' - 'A'))) == 0) {
+        printf("User mode is not present, will not run this example!\r\n");
+        return 0;
+    }
+    /* Modules read cycle counter in user mode */
+    __RV_CSR_SET(CSR_MCOUNTEREN, MCOUNTEREN_CY);
+
+    printf("ThreadX module benchmark, %d loops\n", BENCH_LOOPS);
+    /* Enter the ThreadX kernel.  */
+    tx_kernel_enter();
+    return 0;
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    txm_module_manager_initialize(module_memory, MODULE_MEMORY_SIZE);
+    txm_module_manager_object_pool_create(object_memory, OBJECT_MEMORY_SIZE);
+
+    for (ULONG i = 0; i < 2; i++) {
+        tx_thread_create(&ref_thread[i], "ref", ref_thread_entry, i, ref_stack[i], BENCH_STACK_SIZE,
+                         REF_PRIORITY, REF_PRIORITY, TX_NO_TIME_SLICE, TX_DONT_START);
+    }
+    tx_thread_create(&bench_thread, "bench", bench_thread_entry, 0, bench_stack, BENCH_STACK_SIZE,
+                     BENCH_PRIORITY, BENCH_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
@@ -0,0 +1 @@
+COMMON_FLAGS += -fno-tree-tail-merge
@@ -226,6 +226,11 @@ UINT    status;
         printf("           thread 5 events received:      %10lu, thread 5 cpu %u\n", thread_5_counter  , thread_5.tx_thread_smp_core_mapped);
         printf("           thread 6 mutex obtained:       %10lu, thread 6 cpu %u\n", thread_6_counter  , thread_6.tx_thread_smp_core_mapped);
         printf("           thread 7 mutex obtained:       %10lu, thread 7 cpu %u\n\n", thread_7_counter, thread_7.tx_thread_smp_core_mapped);
+#ifdef TX_THREAD_SMP_ENABLE_PROTECT_STAT
+        /* Show how cores competed for the ThreadX SMP protection since last print.  */
+        _tx_thread_smp_protect_stat_dump();
+        _tx_thread_smp_protect_stat_reset();
+#endif
 
         /* Sleep for 10 ticks.  */
         tx_thread_sleep(10);
@@ -309,6 +309,14 @@
 #define TX_TIMER_ENABLE_PERFORMANCE_INFO
 */
 
+/* Determine if SMP protection lock statistics gathering is required by the application. When the
+   following is defined, the Nuclei SMP port records per-core acquire count, spin and hold cycles
+   of the ThreadX SMP protection, which can be printed by _tx_thread_smp_protect_stat_dump. */
+
+/*
+#define TX_THREAD_SMP_ENABLE_PROTECT_STAT
+*/
+
 /*  Override options for byte pool searches of multiple blocks. */
 
 /*
@@ -0,0 +1,323 @@
+#include <stdio.h>
+#include <stddef.h>
+#include "ctest.h"
+#include "nuclei_sdk_soc.h"
+
+#ifdef __riscv_atomic
+
+/*
+ * Functional tests run on boot hart only, stress tests run on all harts when
+ * SMP_CPU_CNT > 1, such as make SMP=2 DOWNLOAD=sram, other harts enter
+ * smp_main of this file and wait for stress jobs dispatched by boot hart.
+ * Each stress test runs with 1 to SMP_CPU_CNT harts and prints cycles per
+ * operation for scaling.
+ */
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#define STRESS_HARTS        SMP_CPU_CNT
+#else
+#define STRESS_HARTS        1
+#endif
+#define STRESS_LOOPS        1000
+#define STRESS_WRITE_RATIO  4
+
+CTEST(smpsync, layout)
+{
+    ASSERT_EQUAL(__alignof__(SMP_TicketLock_Type), __SMPSYNC_CACHELINE_SIZE);
+    ASSERT_EQUAL(offsetof(SMP_TicketLock_Type, owner), __SMPSYNC_CACHELINE_SIZE);
+    ASSERT_EQUAL(offsetof(SMP_Barrier_Type, sense), __SMPSYNC_CACHELINE_SIZE);
+    ASSERT_EQUAL(sizeof(SMP_MCSNode_Type) % __SMPSYNC_CACHELINE_SIZE, 0);
+    ASSERT_EQUAL(sizeof(SMP_RWLock_Type) % __SMPSYNC_CACHELINE_SIZE, 0);
+}
+
+CTEST(smpsync, barrier_single)
+{
+    SMP_Barrier_Type bar;
+    uint32_t sense = 0;
+
+    SMP_Barrier_Init(&bar, 1);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQUAL(SMP_Barrier_Wait(&bar, &sense), 1);
+        ASSERT_EQUAL(bar.count, 0);
+        ASSERT_EQUAL(bar.sense, sense);
+    }
+    ASSERT_EQUAL(sense, 1);
+}
+
+CTEST(smpsync, ticketlock)
+{
+    SMP_TicketLock_Type lock;
+
+    SMP_TicketLock_Init(&lock);
+    ASSERT_FALSE(SMP_TicketLock_IsLocked(&lock));
+    SMP_TicketLock_Acquire(&lock);
+    ASSERT_TRUE(SMP_TicketLock_IsLocked(&lock));
+    ASSERT_FALSE(SMP_TicketLock_TryAcquire(&lock));
+    SMP_TicketLock_Release(&lock);
+    ASSERT_FALSE(SMP_TicketLock_IsLocked(&lock));
+    ASSERT_TRUE(SMP_TicketLock_TryAcquire(&lock));
+    SMP_TicketLock_Release(&lock);
+    ASSERT_EQUAL(lock.next, 2);
+    ASSERT_EQUAL(lock.owner, 2);
+}
+
+CTEST(smpsync, mcslock)
+{
+    SMP_MCSLock_Type lock;
+    SMP_MCSNode_Type node, other;
+
+    SMP_MCSLock_Init(&lock);
+    SMP_MCSLock_Acquire(&lock, &node);
+    ASSERT_TRUE(lock.tail == &node);
+    ASSERT_FALSE(SMP_MCSLock_TryAcquire(&lock, &other));
+    SMP_MCSLock_Release(&lock, &node);
+    ASSERT_TRUE(lock.tail == NULL);
+    ASSERT_TRUE(SMP_MCSLock_TryAcquire(&lock, &other));
+    SMP_MCSLock_Release(&lock, &other);
+    ASSERT_TRUE(lock.tail == NULL);
+}
+
+CTEST(smpsync, seqlock)
+{
+    SMP_SeqLock_Type lock;
+    uint32_t seq;
+
+    SMP_SeqLock_Init(&lock);
+    seq = SMP_SeqLock_ReadBegin(&lock);
+    ASSERT_FALSE(SMP_SeqLock_ReadRetry(&lock, seq));
+    SMP_SeqLock_WriteBegin(&lock);
+    ASSERT_EQUAL(lock.seq & 0x1, 1);
+    SMP_SeqLock_WriteEnd(&lock);
+    ASSERT_TRUE(SMP_SeqLock_ReadRetry(&lock, seq));
+    seq = SMP_SeqLock_ReadBegin(&lock);
+    ASSERT_EQUAL(seq, 2);
+    ASSERT_FALSE(SMP_SeqLock_ReadRetry(&lock, seq));
+}
+
+CTEST(smpsync, rwlock)
+{
+    SMP_RWLock_Type lock;
+
+    SMP_RWLock_Init(&lock);
+    SMP_RWLock_ReadAcquire(&lock);
+    ASSERT_TRUE(SMP_RWLock_TryReadAcquire(&lock));
+    ASSERT_EQUAL(lock.state, 2);
+    ASSERT_FALSE(SMP_RWLock_TryWriteAcquire(&lock));
+    SMP_RWLock_ReadRelease(&lock);
+    SMP_RWLock_ReadRelease(&lock);
+    SMP_RWLock_WriteAcquire(&lock);
+    ASSERT_EQUAL(lock.state, SMP_RWLOCK_WRITER);
+    ASSERT_FALSE(SMP_RWLock_TryReadAcquire(&lock));
+    ASSERT_FALSE(SMP_RWLock_TryWriteAcquire(&lock));
+    SMP_RWLock_WriteRelease(&lock);
+    ASSERT_EQUAL(lock.state, 0);
+    /* pending writer blocks new readers */
+    lock.state = SMP_RWLOCK_PENDING;
+    ASSERT_FALSE(SMP_RWLock_TryReadAcquire(&lock));
+    ASSERT_TRUE(SMP_RWLock_TryWriteAcquire(&lock));
+    SMP_RWLock_WriteRelease(&lock);
+}
+
+#if __SMPSYNC_STATS
+CTEST(smpsync, stats)
+{
+    SMP_TicketLock_Type lock;
+
+    SMP_TicketLock_Init(&lock);
+    SMP_SyncStat_Clear(&lock.stat);
+    for (int i = 0; i < 10; i++) {
+        SMP_TicketLock_Acquire(&lock);
+        SMP_TicketLock_Release(&lock);
+    }
+    ASSERT_EQUAL(lock.stat.acquires, 10);
+    ASSERT_EQUAL(lock.stat.contended, 0);
+}
+#endif
+
+/* ======================== stress tests on all harts ======================== */
+enum {
+    STRESS_TICKET,
+    STRESS_MCS,
+    STRESS_RWLOCK,
+    STRESS_SEQLOCK,
+    STRESS_BARRIER,
+};
+
+/* all harts meet at job_bar to start and finish a job */
+static SMP_Barrier_Type job_bar = SMP_BARRIER_INITIALIZER(STRESS_HARTS);
+static volatile uint32_t job_id;
+static volatile uint32_t job_harts;
+static uint32_t boot_sense;
+
+static SMP_TicketLock_Type stress_ticket;
+static SMP_MCSLock_Type stress_mcs;
+static SMP_MCSNode_Type stress_nodes[STRESS_HARTS];
+static SMP_RWLock_Type stress_rwlock;
+static SMP_SeqLock_Type stress_seqlock;
+static SMP_Barrier_Type stress_bar;
+/* updated with plain load and store under lock, a broken lock loses counts */
+static volatile uint32_t stress_counter;
+static volatile uint32_t stress_data[2];
+static volatile int32_t stress_errors;
+
+static void stress_run(uint32_t job, uint32_t slot)
+{
+    uint32_t sense = 0, seq, data0, data1;
+    uint32_t harts = job_harts;
+
+    for (uint32_t i = 0; i < STRESS_LOOPS; i++) {
+        switch (job) {
+            case STRESS_TICKET:
+                SMP_TicketLock_Acquire(&stress_ticket);
+                stress_counter = stress_counter + 1;
+                SMP_TicketLock_Release(&stress_ticket);
+                break;
+            case STRESS_MCS:
+                SMP_MCSLock_Acquire(&stress_mcs, &stress_nodes[slot]);
+                stress_counter = stress_counter + 1;
+                SMP_MCSLock_Release(&stress_mcs, &stress_nodes[slot]);
+                break;
+            case STRESS_RWLOCK:
+                if ((i % STRESS_WRITE_RATIO) == 0) {
+                    SMP_RWLock_WriteAcquire(&stress_rwlock);
+                    stress_counter = stress_counter + 1;
+                    stress_data[0] = stress_counter;
+                    stress_data[1] = stress_counter;
+                    SMP_RWLock_WriteRelease(&stress_rwlock);
+                } else {
+                    SMP_RWLock_ReadAcquire(&stress_rwlock);
+                    if (stress_data[0] != stress_data[1]) {
+                        __AMOADD_W(&stress_errors, 1);
+                    }
+                    SMP_RWLock_ReadRelease(&stress_rwlock);
+                }
+                break;
+            case STRESS_SEQLOCK:
+                if ((i % STRESS_WRITE_RATIO) == 0) {
+                    SMP_SeqLock_WriteBegin(&stress_seqlock);
+                    stress_counter = stress_counter + 1;
+                    stress_data[0] = stress_counter;
+                    stress_data[1] = stress_counter;
+                    SMP_SeqLock_WriteEnd(&stress_seqlock);
+                } else {
+                    do {
+                        seq = SMP_SeqLock_ReadBegin(&stress_seqlock);
+                        data0 = stress_data[0];
+                        data1 = stress_data[1];
+                    } while (SMP_SeqLock_ReadRetry(&stress_seqlock, seq));
+                    if (data0 != data1) {
+                        __AMOADD_W(&stress_errors, 1);
+                    }
+                }
+                break;
+            case STRESS_BARRIER:
+                __AMOADD_W((volatile int32_t *)&stress_counter, 1);
+                SMP_Barrier_Wait(&stress_bar, &sense);
+                /* no hart can pass next barrier before this hart arrives */
+                data0 = stress_counter;
+                if ((data0 < (i + 1) * harts) || (data0 >= (i + 2) * harts)) {
+                    __AMOADD_W(&stress_errors, 1);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* slot of boot hart is 0 */
+static uint32_t stress_slot(void)
+{
+    return (uint32_t)((__get_hart_id() + STRESS_HARTS - BOOT_HARTID) % STRESS_HARTS);
+}
+
+/* Run job on first harts, return cycles per loop */
+static unsigned long stress_dispatch(uint32_t job, uint32_t harts)
+{
+    uint64_t start;
+
+    SMP_TicketLock_Init(&stress_ticket);
+    SMP_MCSLock_Init(&stress_mcs);
+    SMP_RWLock_Init(&stress_rwlock);
+    SMP_SeqLock_Init(&stress_seqlock);
+    SMP_Barrier_Init(&stress_bar, harts);
+    stress_counter = 0;
+    stress_data[0] = 0;
+    stress_data[1] = 0;
+    stress_errors = 0;
+    job_id = job;
+    job_harts = harts;
+
+    SMP_Barrier_Wait(&job_bar, &boot_sense);
+    start = __get_rv_cycle();
+    stress_run(job, stress_slot());
+    SMP_Barrier_Wait(&job_bar, &boot_sense);
+    return (unsigned long)((__get_rv_cycle() - start) / STRESS_LOOPS);
+}
+
+static void stress_scaling(const char *name, uint32_t job, uint32_t writers_only)
+{
+    unsigned long cycles;
+    uint32_t expected;
+
+    for (uint32_t harts = 1; harts <= STRESS_HARTS; harts++) {
+        cycles = stress_dispatch(job, harts);
+        printf("CSV, smpsync, %s, harts %lu, cycles per loop %lu\n", name, (unsigned long)harts, cycles);
+        expected = harts * STRESS_LOOPS;
+        if (writers_only) {
+            expected = harts * ((STRESS_LOOPS + STRESS_WRITE_RATIO - 1) / STRESS_WRITE_RATIO);
+        }
+        ASSERT_EQUAL(stress_counter, expected);
+        ASSERT_EQUAL(stress_errors, 0);
+    }
+}
+
+CTEST(smpsync, stress_ticketlock)
+{
+    stress_scaling("ticketlock", STRESS_TICKET, 0);
+}
+
+CTEST(smpsync, stress_mcslock)
+{
+    stress_scaling("mcslock", STRESS_MCS, 0);
+}
+
+CTEST(smpsync, stress_rwlock)
+{
+    stress_scaling("rwlock", STRESS_RWLOCK, 1);
+}
+
+CTEST(smpsync, stress_seqlock)
+{
+    stress_scaling("seqlock", STRESS_SEQLOCK, 1);
+}
+
+CTEST(smpsync, stress_barrier)
+{
+    stress_scaling("barrier", STRESS_BARRIER, 0);
+}
+
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+int main(void);
+
+/* Reimplementation of smp_main, other harts run stress jobs dispatched by boot hart */
+int smp_main(void)
+{
+    uint32_t sense = 0;
+    uint32_t slot;
+
+    if (__get_hart_id() == BOOT_HARTID) {
+        return main();
+    }
+    slot = stress_slot();
+    while (1) {
+        SMP_Barrier_Wait(&job_bar, &sense);
+        if (slot < job_harts) {
+            stress_run(job_id, slot);
+        }
+        SMP_Barrier_Wait(&job_bar, &sense);
+    }
+    return 0;
+}
+#endif
+
+#endif
@@ -0,0 +1,306 @@
+#!/bin/env python3
+
+import os
+import sys
+import json
+import time
+import queue
+import shlex
+import signal
+import argparse
+import threading
+import subprocess
+
+SCRIPT_DIR = os.path.dirname(os.path.realpath(__file__))
+
+SDK_ROOT = os.path.abspath(os.path.join(SCRIPT_DIR, "../../../../"))
+
+DEFAULT_SUITE = os.path.join(SCRIPT_DIR, "suite.json")
+DEFAULT_BASELINE = os.path.join(SCRIPT_DIR, "baseline.json")
+
+# QEMU must run in instruction count mode, so cycles are the same on any machine
+ICOUNT_MAKEOPT = "ICOUNT_OPT=shift=0"
+DEFAULT_FAIL_MARKERS = ["MCAUSE:", "MEPC"]
+
+STATUS_OK = "OK"
+STATUS_IMPROVED = "IMPROVED"
+STATUS_REGRESSED = "REGRESSED"
+STATUS_NEW = "NEW"
+STATUS_MISSING = "MISSING"
+
+
+def load_json(jsonfile):
+    if os.path.isfile(jsonfile) == False:
+        return dict()
+    with open(jsonfile, "r") as jf:
+        return json.load(jf)
+
+def save_json(jsonfile, data):
+    with open(jsonfile, "w") as jf:
+        json.dump(data, jf, indent=4, sort_keys=True)
+        jf.write("\n")
+
+def to_number(text):
+    try:
+        value = float(text)
+    except ValueError:
+        return None
+    if value != value or value in (float("inf"), float("-inf")):
+        return None
+    return int(value) if value.is_integer() and "." not in text else value
+
+def parse_metrics(lines):
+    """
+    Parses benchmark lines printed by applications into metrics.
+
+    - ``CSV, name, value`` is metric ``name``
+    - ``CSV, name, v1, v2, ...`` is metric ``name.<column>`` for each value, the column names
+      are from the last CSV line with no numeric values, such as ``CSV, Benchmark, Iterations, Cycles``,
+      otherwise the column index starting from 1 is used
+    - ``STAT, name, loops, sumcycles`` printed by ``BENCH_STAT`` is metric ``name`` of average cycles
+
+    A name seen more than once gets ``#<n>`` suffix from the second one.
+
+    Returns:
+        dict: metric name to value.
+    """
+    metrics = dict()
+    header = []
+    for line in lines:
+        fields = [field.strip() for field in line.strip().split(",")]
+        if len(fields) < 3 or fields[0] not in ("CSV", "STAT") or fields[1] == "":
+            continue
+        values = [to_number(field) for field in fields[2:]]
+        if fields[0] == "STAT":
+            if len(values) < 2 or None in values[:2] or values[0] == 0:
+                continue
+            found = {fields[1]: round(values[1] / values[0], 2)}
+        elif all(value is None for value in values):
+            header = fields[2:]
+            continue
+        elif len(values) == 1:
+            found = {fields[1]: values[0]}
+        else:
+            found = dict()
+            for idx, value in enumerate(values):
+                if value is None:
+                    continue
+                column = header[idx] if idx < len(header) and header[idx] != "" else str(idx + 1)
+                found["%s.%s" % (fields[1], column)] = value
+        for name, value in found.items():
+            key = name
+            cnt = 1
+            while key in metrics:
+                cnt += 1
+                key = "%s#%d" % (name, cnt)
+            metrics[key] = value
+    return metrics
+
+def run_make(appdir, makeopts, target, logfile, timeout, markers=None, fail_markers=None, show_output=False):
+    """
+    Runs make target in appdir and saves output into logfile, when markers are given,
+    make is killed as soon as any of them or fail markers appear, since ``run_qemu`` never exits.
+
+    Returns:
+        tuple: (status, lines), status is True if make exited with 0 or a marker appeared.
+    """
+    cmd = ["make", "-C", appdir] + makeopts + target.split()
+    lines = []
+    lineq = queue.Queue()
+    status = False
+    with open(logfile, "w") as lf:
+        lf.write("Run command: %s\n" % (" ".join(cmd)))
+        proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, stdin=subprocess.DEVNULL,
+                                universal_newlines=True, errors="replace", start_new_session=True)
+
+        def reader():
+            for line in proc.stdout:
+                lineq.put(line)
+            lineq.put(None)
+
+        threading.Thread(target=reader, daemon=True).start()
+        deadline = time.time() + timeout
+        while True:
+            remain = deadline - time.time()
+            if remain <= 0:
+                print("ERROR: %s %s timeout after %d seconds" % (appdir, target, timeout))
+                break
+            try:
+                line = lineq.get(timeout=remain)
+            except queue.Empty:
+                continue
+            if line is None:
+                proc.wait()
+                status = markers is None and proc.returncode == 0
+                break
+            lf.write(line)
+            lines.append(line)
+            if show_output:
+                sys.stdout.write(line)
+            if fail_markers and any(marker in line for marker in fail_markers):
+                print("ERROR: %s failed, found %s" % (appdir, line.strip()))
+                break
+            if markers and any(marker in line for marker in markers):
+                status = True
+                break
+        if proc.poll() is None:
+            # kill make and qemu started by it
+            os.killpg(proc.pid, signal.SIGKILL)
+            proc.wait()
+    return status, lines
+
+def run_case(casename, casecfg, makeopts, logdir, parallel, timeout, show_output):
+    appdir = os.path.join(SDK_ROOT, casecfg["appdir"])
+    caseopts = makeopts + shlex.split(casecfg.get("make_options", "")) + [ICOUNT_MAKEOPT]
+    os.makedirs(logdir, exist_ok=True)
+    buildlog = os.path.join(logdir, "build.log")
+    runlog = os.path.join(logdir, "run.log")
+    buildopts = caseopts + ([parallel] if parallel else [])
+    print("Build %s in %s with %s" % (casename, casecfg["appdir"], " ".join(caseopts)))
+    status, _ = run_make(appdir, buildopts, "clean all", buildlog, timeout, show_output=show_output)
+    if status == False:
+        print("ERROR: failed to build %s, see %s" % (casename, buildlog))
+        return None
+    print("Run %s on qemu" % (casename))
+    fail_markers = DEFAULT_FAIL_MARKERS + casecfg.get("fail", [])
+    status, lines = run_make(appdir, caseopts, "run_qemu", runlog, casecfg.get("timeout", timeout),
+                             casecfg["done"], fail_markers, show_output)
+    if status == False:
+        print("ERROR: failed to run %s, see %s" % (casename, runlog))
+        return None
+    metrics = parse_metrics(lines)
+    selected = casecfg.get("metrics", None)
+    if selected is not None:
+        metrics = {name: metrics[name] for name in selected if name in metrics}
+    return metrics
+
+def compare_metrics(metrics, baseline, casecfg, tolerance):
+    """
+    Compares the metrics against baseline, a metric regressed when it is worse than baseline
+    by more than its tolerance in ratio, lower value is better unless it is listed in ``higher``.
+
+    Returns:
+        list: (name, baseline value, value, change in ratio, status) of each metric.
+    """
+    results = []
+    selected = casecfg.get("metrics", dict())
+    higher = casecfg.get("higher", [])
+    for name in sorted(set(metrics) | set(baseline)):
+        tol = selected.get(name, dict()).get("tolerance", casecfg.get("tolerance", tolerance))
+        base = baseline.get(name, None)
+        value = metrics.get(name, None)
+        if value is None:
+            results.append((name, base, value, None, STATUS_MISSING))
+            continue
+        if base is None:
+            results.append((name, base, value, None, STATUS_NEW))
+            continue
+        if base == 0:
+            change = 0.0 if value == 0 else float("inf")
+        else:
+            change = (value - base) / abs(base)
+        worse = -change if name in higher else change
+        if worse > tol:
+            status = STATUS_REGRESSED
+        elif worse < -tol:
+            status = STATUS_IMPROVED
+        else:
+            status = STATUS_OK
+        results.append((name, base, value, change, status))
+    return results
+
+def print_results(cfgname, casename, results):
+    for name, base, value, change, status in results:
+        changestr = "%+.2f%%" % (change * 100) if change is not None else "-"
+        print("%-10s %-12s %-32s %14s %14s %10s  %s" % (cfgname, casename, name,
+              "-" if base is None else base, "-" if value is None else value, changestr, status))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Nuclei SDK QEMU Performance Regression Checker")
+    parser.add_argument('--suite', default=DEFAULT_SUITE, help="Suite JSON configuration file, default %(default)s")
+    parser.add_argument('--baseline', default=DEFAULT_BASELINE, help="Baseline JSON file, default %(default)s")
+    parser.add_argument('--logdir', default="logs/perfregress", help="logs directory, default %(default)s")
+    parser.add_argument('--configs', help="Configurations to run separated by comma, default all in suite")
+    parser.add_argument('--cases', help="Cases to run separated by comma, default all in suite")
+    parser.add_argument('--make_options', default="", help="Extra make options passed to all cases")
+    parser.add_argument('--parallel', default="-j", help="parallel value passed to make when build, default %(default)s")
+    parser.add_argument('--timeout', type=int, help="Build and run timeout of each case in seconds, overwrite the suite one")
+    parser.add_argument('--update', action='store_true', help="If specified, save measured metrics as new baseline")
+    parser.add_argument('--allow_new', action='store_true', help="If specified, metrics not in baseline are not treated as failure")
+    parser.add_argument('--verbose', action='store_true', help="If specified, will show detailed build/run messsage")
+    args = parser.parse_args()
+
+    suite = load_json(args.suite)
+    if len(suite.get("cases", dict())) == 0:
+        print("No cases found in %s, please check!" % (args.suite))
+        sys.exit(1)
+    if args.update == False and os.path.isfile(args.baseline) == False:
+        # Without a recorded baseline nothing can be checked, don't run the cases for nothing
+        print("ERROR: baseline %s not found, please run with --update to record it first" % (args.baseline))
+        sys.exit(1)
+    baselines = load_json(args.baseline)
+    configs = suite.get("configs", {"default": ""})
+    cases = suite["cases"]
+    selcfgs = args.configs.split(",") if args.configs else list(configs)
+    selcases = args.cases.split(",") if args.cases else list(cases)
+    for names, known, kind in ((selcfgs, configs, "configuration"), (selcases, cases, "case")):
+        for name in names:
+            if name not in known:
+                print("ERROR: %s is not a %s in %s" % (name, kind, args.suite))
+                sys.exit(1)
+    tolerance = suite.get("tolerance", 0.02)
+    timeout = args.timeout if args.timeout else suite.get("timeout", 600)
+
+    start_time = time.time()
+    failed = []
+    regressed = []
+    unchecked = []
+    report = dict()
+    for cfgname in selcfgs:
+        makeopts = shlex.split(suite.get("make_options", "")) + shlex.split(configs[cfgname]) + \
+                   shlex.split(args.make_options)
+        report[cfgname] = dict()
+        for casename in selcases:
+            logdir = os.path.join(args.logdir, cfgname, casename)
+            metrics = run_case(casename, cases[casename], makeopts, logdir, args.parallel, timeout, args.verbose)
+            if metrics is None or len(metrics) == 0:
+                if metrics is not None:
+                    print("ERROR: no metrics found in %s run log" % (casename))
+                failed.append("%s/%s" % (cfgname, casename))
+                continue
+            baseline = baselines.get(cfgname, dict()).get(casename, dict())
+            results = compare_metrics(metrics, baseline, cases[casename], tolerance)
+            print_results(cfgname, casename, results)
+            report[cfgname][casename] = {name: {"baseline": base, "value": value, "status": status}
+                                         for name, base, value, _, status in results}
+            if args.update:
+                baselines.setdefault(cfgname, dict())[casename] = metrics
+                continue
+            for name, _, _, _, status in results:
+                if status in (STATUS_REGRESSED, STATUS_MISSING):
+                    regressed.append("%s/%s/%s" % (cfgname, casename, name))
+                elif status == STATUS_NEW and not args.allow_new:
+                    # A metric without baseline is not checked, so it must not pass silently
+                    unchecked.append("%s/%s/%s" % (cfgname, casename, name))
+
+    os.makedirs(args.logdir, exist_ok=True)
+    save_json(os.path.join(args.logdir, "perfregress.json"), report)
+    if args.update:
+        save_json(args.baseline, baselines)
+        print("Baseline %s updated" % (args.baseline))
+    runtime = round(time.time() - start_time, 2)
+    print("Performance regression check cost about %s seconds, report saved in %s" % (runtime, args.logdir))
+    for item in failed:
+        print("FAIL: %s" % (item))
+    for item in regressed:
+        print("REGRESSED: %s" % (item))
+    for item in unchecked:
+        print("NO BASELINE: %s" % (item))
+    if unchecked:
+        print("Metrics above have no baseline in %s, please run with --update to record baseline, " \
+              "or pass --allow_new to skip them" % (args.baseline))
+    if failed or regressed or unchecked:
+        sys.exit(1)
+    print("No performance regression found")
+    sys.exit(0)